@@ -144,6 +144,58 @@ void FHEW_BINGATE_STD128(benchmark::State& state) {
 
 BENCHMARK(FHEW_BINGATE_STD128)->Unit(benchmark::kMicrosecond)->MinTime(10.0);
 
+// benchmark for binary gates with the fused GINX accumulator update
+void FHEW_BINGATE_FUSED_STD128(benchmark::State& state) {
+  BinFHEContext cc = GenerateFHEWContext(STD128);
+  cc.SetGINXMode(GINX_FUSED);
+
+  LWEPrivateKey sk = cc.KeyGen();
+
+  cc.BTKeyGen(sk);
+
+  LWECiphertext ct1 = cc.Encrypt(sk, 1);
+  LWECiphertext ct2 = cc.Encrypt(sk, 1);
+
+  while (state.KeepRunning()) {
+    LWECiphertext ct11 = cc.EvalBinGate(AND, ct1, ct2);
+  }
+}
+
+BENCHMARK(FHEW_BINGATE_FUSED_STD128)
+    ->Unit(benchmark::kMicrosecond)
+    ->MinTime(10.0);
+
+// benchmark for a layer of independent binary gates bootstrapped in parallel;
+// the reported items per second is the gate throughput
+void FHEW_BINGATE_BATCH_STD128(benchmark::State& state) {
+  BinFHEContext cc = GenerateFHEWContext(STD128);
+
+  LWEPrivateKey sk = cc.KeyGen();
+
+  cc.BTKeyGen(sk);
+
+  uint32_t size = state.range(0);
+  std::vector<BINGATE> gates(size, AND);
+  std::vector<LWECiphertext> ct1s(size);
+  std::vector<LWECiphertext> ct2s(size);
+  for (uint32_t i = 0; i < size; i++) {
+    ct1s[i] = cc.Encrypt(sk, 1);
+    ct2s[i] = cc.Encrypt(sk, 1);
+  }
+
+  while (state.KeepRunning()) {
+    std::vector<LWECiphertext> ct11 = cc.EvalBinGateBatch(gates, ct1s, ct2s);
+  }
+
+  state.SetItemsProcessed(state.iterations() * size);
+}
+
+BENCHMARK(FHEW_BINGATE_BATCH_STD128)
+    ->Unit(benchmark::kMicrosecond)
+    ->Arg(16)
+    ->Arg(64)
+    ->MinTime(10.0);
+
 // benchmark for key switching
 void FHEW_KEYSWITCH_STD128(benchmark::State& state) {
   BinFHEContext cc = GenerateFHEWContext(STD128);
@@ -0,0 +1,319 @@
+/*
+ * @file binfhe-phases : benchmarks of the phases of FHEW bootstrapping
+ * @author  TPOC: contact@palisade-crypto.org
+ *
+ * @copyright Copyright (c) 2019, Duality Technologies Inc.
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution. THIS SOFTWARE IS
+ * PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/*
+ * This file benchmarks the phases of FHEW bootstrapping separately: the
+ * blind rotation, one accumulator update (external product), the signed
+ * digit decomposition, a forward and inverse NTT, the LWE key switching and
+ * the modulus switching, together with whole gates and the gate throughput
+ * of EvalBinGateBatch for an increasing number of threads. Every parameter
+ * set is run with AP, GINX, and GINX with the fused accumulator update.
+ * Names have the form FHEW_<PHASE>/<PARAMSET>/<METHOD>, so a single phase or
+ * parameter set can be selected with --benchmark_filter.
+ */
+
+#define PROFILE
+#include "benchmark/benchmark.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "binfhecontext.h"
+#include "utils/parallel.h"
+
+using namespace lbcrypto;
+
+/*
+ * Context setup utility methods
+ */
+
+// bootstrapping variants covered by the benchmarks
+enum BenchMethod { BENCH_AP, BENCH_GINX, BENCH_GINX_FUSED };
+
+struct BenchContext {
+  BinFHEContext cc;
+  LWEPrivateKey sk;
+  RingGSWEvalKey EK;
+};
+
+// generating the bootstrapping keys takes much longer than most phases, so
+// the keys are kept for all benchmarks of a (parameter set, method) pair.
+// The benchmarks are registered grouped by pair, and only the context of the
+// current pair is kept: the refreshing keys of the large AP parameter sets
+// take several GB each.
+std::shared_ptr<BenchContext> GetBenchContext(BINFHEPARAMSET set,
+                                              BenchMethod method) {
+  static std::shared_ptr<BenchContext> current;
+  static std::pair<int, int> currentKey(-1, -1);
+  std::pair<int, int> key(set, method);
+  if (current != nullptr && currentKey == key) return current;
+
+  // the keys of the previous pair are freed before the new ones are made
+  current.reset();
+  currentKey = key;
+  auto entry = std::make_shared<BenchContext>();
+  entry->cc.GenerateBinFHEContext(set, method == BENCH_AP ? AP : GINX);
+  entry->cc.SetGINXMode(method == BENCH_GINX_FUSED ? GINX_FUSED
+                                                   : GINX_SEQUENTIAL);
+  entry->sk = entry->cc.KeyGen();
+  entry->cc.BTKeyGen(entry->sk);
+  entry->EK.BSkey = entry->cc.GetRefreshKey();
+  entry->EK.KSkey = entry->cc.GetSwitchKey();
+  current = entry;
+  return current;
+}
+
+// a random vector; the running time of the phases does not depend on the
+// values
+NativeVector RandomVector(uint32_t size, const NativeInteger &modulus) {
+  DiscreteUniformGeneratorImpl<NativeVector> dug;
+  dug.SetModulus(modulus);
+  return dug.GenerateVector(size);
+}
+
+// a fresh accumulator holding a random test vector
+std::shared_ptr<RingGSWCiphertext> RandomAccumulator(
+    const std::shared_ptr<RingGSWCryptoParams> params) {
+  auto acc = std::make_shared<RingGSWCiphertext>(1, 2);
+  for (uint32_t j = 0; j < 2; j++) {
+    (*acc)[0][j] = NativePoly(params->GetPolyParams(), COEFFICIENT, false);
+    (*acc)[0][j].SetValues(RandomVector(params->GetLWEParams()->GetN(),
+                                        params->GetLWEParams()->GetQ()),
+                           COEFFICIENT);
+    (*acc)[0][j].SetFormat(EVALUATION);
+  }
+  return acc;
+}
+
+/*
+ * FHEW phase benchmarks
+ */
+
+// benchmark for a whole binary gate
+void FHEW_BINGATE(benchmark::State &state, BINFHEPARAMSET set,
+                  BenchMethod method) {
+  auto ctx = GetBenchContext(set, method);
+
+  LWECiphertext ct1 = ctx->cc.Encrypt(ctx->sk, 1);
+  LWECiphertext ct2 = ctx->cc.Encrypt(ctx->sk, 1);
+
+  while (state.KeepRunning()) {
+    LWECiphertext ct11 = ctx->cc.EvalBinGate(AND, ct1, ct2);
+  }
+}
+
+// benchmark for the blind rotation, i.e., all accumulator updates of a gate
+void FHEW_BLINDROTATE(benchmark::State &state, BINFHEPARAMSET set,
+                      BenchMethod method) {
+  auto ctx = GetBenchContext(set, method);
+  auto params = ctx->cc.GetParams();
+  auto scheme = ctx->cc.GetRingGSWScheme();
+
+  NativeVector a = RandomVector(params->GetLWEParams()->Getn(),
+                                params->GetLWEParams()->Getq());
+  auto acc = RandomAccumulator(params);
+  RingGSWACCScratch scratch(params);
+
+  while (state.KeepRunning()) {
+    scheme->BlindRotate(params, ctx->EK, a, acc, &scratch);
+  }
+}
+
+// benchmark for one accumulator update (external product with a RingGSW
+// ciphertext of the refreshing key); the fused GINX update covers both keys
+// of a secret key coefficient
+void FHEW_ACCUPDATE(benchmark::State &state, BINFHEPARAMSET set,
+                    BenchMethod method) {
+  auto ctx = GetBenchContext(set, method);
+  auto params = ctx->cc.GetParams();
+  auto scheme = ctx->cc.GetRingGSWScheme();
+
+  auto acc = RandomAccumulator(params);
+  RingGSWACCScratch scratch(params);
+  NativeInteger a(1);
+
+  while (state.KeepRunning()) {
+    if (method == BENCH_AP) {
+      scheme->AddToACCAP(params, ctx->EK.BSkey->GetCiphertextData(0, 1, 0),
+                         acc, &scratch);
+    } else if (method == BENCH_GINX) {
+      scheme->AddToACCGINX(params, ctx->EK.BSkey->GetCiphertextData(0, 0, 0),
+                           a, acc, &scratch);
+    } else {
+      scheme->AddToACCGINXFused(
+          params, ctx->EK.BSkey->GetCiphertextData(0, 0, 0),
+          ctx->EK.BSkey->GetCiphertextData(0, 1, 0), a, acc, &scratch);
+    }
+  }
+}
+
+// benchmark for the signed digit decomposition of the accumulator
+void FHEW_DECOMPOSE(benchmark::State &state, BINFHEPARAMSET set,
+                    BenchMethod method) {
+  auto ctx = GetBenchContext(set, method);
+  auto params = ctx->cc.GetParams();
+  auto scheme = ctx->cc.GetRingGSWScheme();
+
+  auto acc = RandomAccumulator(params);
+  std::vector<NativePoly> ct = {(*acc)[0][0], (*acc)[0][1]};
+  for (auto &poly : ct) poly.SetFormat(COEFFICIENT);
+  RingGSWACCScratch scratch(params);
+
+  while (state.KeepRunning()) {
+    scheme->SignedDigitDecompose(params, ct, &scratch.dct);
+  }
+}
+
+// benchmark for a forward and an inverse NTT of one ring element
+void FHEW_NTT(benchmark::State &state, BINFHEPARAMSET set,
+              BenchMethod method) {
+  auto ctx = GetBenchContext(set, method);
+  auto params = ctx->cc.GetParams();
+
+  NativePoly poly(params->GetPolyParams(), COEFFICIENT, false);
+  poly.SetValues(RandomVector(params->GetLWEParams()->GetN(),
+                              params->GetLWEParams()->GetQ()),
+                 COEFFICIENT);
+
+  while (state.KeepRunning()) {
+    poly.SetFormat(EVALUATION);
+    poly.SetFormat(COEFFICIENT);
+  }
+}
+
+// benchmark for key switching from dimension N to n
+void FHEW_KEYSWITCH(benchmark::State &state, BINFHEPARAMSET set,
+                    BenchMethod method) {
+  auto ctx = GetBenchContext(set, method);
+  auto lweparams = ctx->cc.GetParams()->GetLWEParams();
+
+  auto ctQN = std::make_shared<LWECiphertextImpl>(
+      RandomVector(lweparams->GetN(), lweparams->GetQ()), NativeInteger(0));
+
+  while (state.KeepRunning()) {
+    std::shared_ptr<LWECiphertextImpl> eQ =
+        ctx->cc.GetLWEScheme()->KeySwitch(lweparams, ctx->EK.KSkey, ctQN);
+  }
+}
+
+// benchmark for modulus switching from Q to q
+void FHEW_MODSWITCH(benchmark::State &state, BINFHEPARAMSET set,
+                    BenchMethod method) {
+  auto ctx = GetBenchContext(set, method);
+  auto lweparams = ctx->cc.GetParams()->GetLWEParams();
+
+  auto ctQ = std::make_shared<LWECiphertextImpl>(
+      RandomVector(lweparams->Getn(), lweparams->GetQ()), NativeInteger(0));
+
+  while (state.KeepRunning()) {
+    std::shared_ptr<LWECiphertextImpl> eq =
+        ctx->cc.GetLWEScheme()->ModSwitch(lweparams, ctQ);
+  }
+}
+
+// benchmark for the gate throughput of EvalBinGateBatch with state.range(0)
+// threads; the reported items per second is the number of gates per second
+void FHEW_BINGATE_THREADS(benchmark::State &state, BINFHEPARAMSET set,
+                          BenchMethod method) {
+  auto ctx = GetBenchContext(set, method);
+
+  int threads = state.range(0);
+  PalisadeParallelControls.SetNumThreads(threads);
+
+  uint32_t size = 4 * threads;
+  std::vector<BINGATE> gates(size, AND);
+  std::vector<LWECiphertext> ct1s(size);
+  std::vector<LWECiphertext> ct2s(size);
+  for (uint32_t i = 0; i < size; i++) {
+    ct1s[i] = ctx->cc.Encrypt(ctx->sk, 1);
+    ct2s[i] = ctx->cc.Encrypt(ctx->sk, 1);
+  }
+
+  while (state.KeepRunning()) {
+    std::vector<LWECiphertext> ct11 =
+        ctx->cc.EvalBinGateBatch(gates, ct1s, ct2s);
+  }
+
+  state.SetItemsProcessed(state.iterations() * size);
+  PalisadeParallelControls.Enable();
+}
+
+int main(int argc, char **argv) {
+  typedef void (*PhaseFunc)(benchmark::State &, BINFHEPARAMSET, BenchMethod);
+  const std::vector<std::pair<std::string, PhaseFunc>> phases = {
+      {"FHEW_BINGATE", FHEW_BINGATE},
+      {"FHEW_BLINDROTATE", FHEW_BLINDROTATE},
+      {"FHEW_ACCUPDATE", FHEW_ACCUPDATE},
+      {"FHEW_DECOMPOSE", FHEW_DECOMPOSE},
+      {"FHEW_NTT", FHEW_NTT},
+      {"FHEW_KEYSWITCH", FHEW_KEYSWITCH},
+      {"FHEW_MODSWITCH", FHEW_MODSWITCH},
+  };
+  const std::vector<std::pair<std::string, BINFHEPARAMSET>> sets = {
+      {"TOY", TOY},
+      {"MEDIUM", MEDIUM},
+      {"STD128", STD128},
+      {"STD192", STD192},
+      {"STD256", STD256},
+      {"STD128Q", STD128Q},
+      {"STD192Q", STD192Q},
+      {"STD256Q", STD256Q},
+  };
+  const std::vector<std::pair<std::string, BenchMethod>> methods = {
+      {"AP", BENCH_AP},
+      {"GINX", BENCH_GINX},
+      {"GINX_FUSED", BENCH_GINX_FUSED},
+  };
+
+  int machineThreads = PalisadeParallelControls.GetMachineThreads();
+
+  // all benchmarks of a (parameter set, method) pair are registered together,
+  // so that GetBenchContext generates the keys of each pair once
+  for (const auto &set : sets) {
+    for (const auto &method : methods) {
+      std::string suffix = "/" + set.first + "/" + method.first;
+      for (const auto &phase : phases) {
+        benchmark::RegisterBenchmark((phase.first + suffix).c_str(),
+                                     phase.second, set.second, method.second)
+            ->Unit(benchmark::kMicrosecond);
+      }
+      auto *scaling = benchmark::RegisterBenchmark(
+          ("FHEW_BINGATE_THREADS" + suffix).c_str(), FHEW_BINGATE_THREADS,
+          set.second, method.second);
+      scaling->Unit(benchmark::kMicrosecond)->UseRealTime();
+      for (int threads = 1; threads < machineThreads; threads <<= 1)
+        scaling->Arg(threads);
+      scaling->Arg(machineThreads);
+    }
+  }
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
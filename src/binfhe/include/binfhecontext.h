@@ -104,6 +104,20 @@ class BinFHEContext : public Serializable {
    */
   void GenerateBinFHEContext(BINFHEPARAMSET set, BINFHEMETHOD method = GINX);
 
+  /**
+   * Selects the accumulator update used by GINX bootstrapping; GINX_FUSED
+   * needs half the NTTs of the default GINX_SEQUENTIAL. The keys are the
+   * same for both modes, so the mode can be changed at any time.
+   *
+   * @param mode the accumulator update
+   */
+  void SetGINXMode(GINXMODE mode) {
+    if (m_params == nullptr)
+      PALISADE_THROW(config_error,
+                     "The crypto context has not been generated");
+    m_params->SetGINXMode(mode);
+  }
+
   /**
    * Gets the refreshing key (used for serialization).
    *
@@ -136,13 +150,18 @@ class BinFHEContext : public Serializable {
   LWEPrivateKey KeyGenN() const;
 
   /**
-   * Encrypts a bit using a secret key (symmetric key encryption)
+   * Encrypts a message using a secret key (symmetric key encryption); by
+   * default a bit is encrypted modulo q
    *
    * @param sk - the secret key
    * @param &m - the plaintext
+   * @param p - plaintext modulus (4 for bits)
+   * @param &mod - ciphertext modulus; 0 means q
    * @return a shared pointer to the ciphertext
    */
-  LWECiphertext Encrypt(ConstLWEPrivateKey sk, const LWEPlaintext &m) const;
+  LWECiphertext Encrypt(ConstLWEPrivateKey sk, const LWEPlaintext &m,
+                        const LWEPlaintextModulus &p = 4,
+                        const NativeInteger &mod = 0) const;
 
   /**
    * Decrypts a ciphertext using a secret key
@@ -150,9 +169,10 @@ class BinFHEContext : public Serializable {
    * @param sk the secret key
    * @param ct the ciphertext
    * @param *result plaintext result
+   * @param p - plaintext modulus (4 for bits)
    */
   void Decrypt(ConstLWEPrivateKey sk, ConstLWECiphertext ct,
-               LWEPlaintext *result) const;
+               LWEPlaintext *result, const LWEPlaintextModulus &p = 4) const;
 
   /**
    * Generates a switching key to go from a secret key with (Q,N) to a secret
@@ -179,6 +199,50 @@ class BinFHEContext : public Serializable {
    */
   void BTKeyLoad(const RingGSWEvalKey &key) { m_BTKey = key; }
 
+  /**
+   * Writes the bootstrapping keys to a file in a compact binary format: a
+   * header describing the parameters followed by the raw NTT-domain
+   * coefficients of the refreshing key and the rows of the switching key,
+   * each starting at a 64-byte aligned offset
+   *
+   * @param filename name of the file
+   * @return false if the file could not be written
+   */
+  bool BTKeySaveBinary(const std::string &filename) const;
+
+  /**
+   * Loads bootstrapping keys written by BTKeySaveBinary. The file is
+   * memory-mapped read-only, so the keys are not copied and the pages are
+   * shared by all processes loading the same file. The header has to match
+   * the parameters of the current context.
+   *
+   * @param filename name of the file
+   * @return false if the file could not be opened
+   */
+  bool BTKeyLoadBinary(const std::string &filename);
+
+  /**
+   * Writes ciphertexts to a file as a packed LWECiphertextBatch
+   *
+   * @param &cts the ciphertexts; all have the same dimension and modulus
+   * @param filename name of the file
+   * @return false if the file could not be written
+   */
+  bool CiphertextBatchSaveBinary(const std::vector<LWECiphertext> &cts,
+                                 const std::string &filename) const;
+
+  /**
+   * Loads a ciphertext batch written by CiphertextBatchSaveBinary. The file
+   * is memory-mapped read-only and the ciphertexts are read in place; the
+   * dimension of the ciphertexts has to match the current context.
+   *
+   * @param filename name of the file
+   * @param *batch the loaded batch
+   * @return false if the file could not be opened
+   */
+  bool CiphertextBatchLoadBinary(const std::string &filename,
+                                 LWECiphertextBatch *batch) const;
+
   /**
    * Clear the bootstrapping keys in the current context
    */
@@ -198,6 +262,56 @@ class BinFHEContext : public Serializable {
   LWECiphertext EvalBinGate(const BINGATE gate, ConstLWECiphertext ct1,
                             ConstLWECiphertext ct2) const;
 
+  /**
+   * Evaluates a 3-input gate with a single bootstrapping
+   *
+   * @param gate the gate; can be MAJORITY (on regular bit encryptions), AND3,
+   * or OR3 (on bits encrypted with plaintext modulus 6)
+   * @param &cts the three input ciphertexts
+   * @return a shared pointer to the resulting ciphertext
+   */
+  LWECiphertext EvalBinGate(const BINGATE gate,
+                            const std::vector<LWECiphertext> &cts) const;
+
+  /**
+   * Computes the weighted sum of ciphertexts without bootstrapping
+   *
+   * @param &cts the input ciphertexts
+   * @param &weights the integer weights
+   * @return a shared pointer to the resulting ciphertext
+   */
+  LWECiphertext EvalWeightedSum(const std::vector<LWECiphertext> &cts,
+                                const std::vector<int64_t> &weights) const;
+
+  /**
+   * Evaluates [sum_i weights[i] * m_i >= threshold] with a single
+   * bootstrapping; the inputs are bits encrypted with plaintext modulus p,
+   * and the parameters are checked against the noise and range bounds
+   *
+   * @param &cts the input ciphertexts
+   * @param &weights the integer weights
+   * @param threshold the threshold
+   * @param p the plaintext modulus of the inputs
+   * @return a shared pointer to the resulting bit encryption
+   */
+  LWECiphertext EvalThreshold(const std::vector<LWECiphertext> &cts,
+                              const std::vector<int64_t> &weights,
+                              int64_t threshold,
+                              const LWEPlaintextModulus &p = 4) const;
+
+  /**
+   * Evaluates a batch of independent binary gates, such as all gates in one
+   * layer of a circuit; the gates are bootstrapped in parallel
+   *
+   * @param &gates the gates; can be AND, OR, NAND, NOR, XOR, or XNOR
+   * @param &ct1s first ciphertexts of each gate
+   * @param &ct2s second ciphertexts of each gate
+   * @return a vector of the resulting ciphertexts (in the order of gates)
+   */
+  std::vector<LWECiphertext> EvalBinGateBatch(
+      const std::vector<BINGATE> &gates, const std::vector<LWECiphertext> &ct1s,
+      const std::vector<LWECiphertext> &ct2s) const;
+
   /**
    * Evaluates NOT gate
    *
@@ -206,6 +320,38 @@ class BinFHEContext : public Serializable {
    */
   LWECiphertext EvalNOT(ConstLWECiphertext ct1) const;
 
+  /**
+   * Evaluates a function given by a lookup table over a small plaintext space
+   * (programmable bootstrapping)
+   *
+   * @param ct the input ciphertext, encrypted with plaintext modulus
+   * LUT.size()
+   * @param &LUT the lookup table; exact for messages in [0, p/2), and for all
+   * messages if the table is negacyclic (LUT[m + p/2] = -LUT[m] mod p)
+   * @return a shared pointer to the resulting ciphertext
+   */
+  LWECiphertext EvalFunc(ConstLWECiphertext ct,
+                         const std::vector<NativeInteger> &LUT) const;
+
+  /**
+   * Rounds the phase of a ciphertext with a larger modulus (a multiple of q
+   * not exceeding Q) down to a multiple of q
+   *
+   * @param ct the input ciphertext
+   * @return a shared pointer to the resulting ciphertext
+   */
+  LWECiphertext EvalFloor(ConstLWECiphertext ct) const;
+
+  /**
+   * Evaluates the sign (most significant bit) of a ciphertext with a modulus
+   * of at least q
+   *
+   * @param ct the input ciphertext
+   * @return a shared pointer to the resulting bit encryption (1 for negative
+   * values)
+   */
+  LWECiphertext EvalSign(ConstLWECiphertext ct) const;
+
   const std::shared_ptr<RingGSWCryptoParams> GetParams() { return m_params; }
 
   const std::shared_ptr<LWEEncryptionScheme> GetLWEScheme() {
@@ -44,6 +44,27 @@
 
 namespace lbcrypto {
 
+/**
+ * @brief Scratch polynomials used by the accumulator updates in bootstrapping.
+ * They are allocated once per bootstrapping (or once per thread in batch
+ * evaluation) so that the main accumulation loop does not allocate memory
+ */
+struct RingGSWACCScratch {
+  explicit RingGSWACCScratch(const std::shared_ptr<RingGSWCryptoParams> params)
+      : ct(2), dct(params->GetDigitsG2()) {
+    const shared_ptr<ILNativeParams> polyParams = params->GetPolyParams();
+    for (uint32_t i = 0; i < ct.size(); i++)
+      ct[i] = NativePoly(polyParams, COEFFICIENT, true);
+    for (uint32_t i = 0; i < dct.size(); i++)
+      dct[i] = NativePoly(polyParams, COEFFICIENT, true);
+  }
+
+  // copy of the accumulator in the COEFFICIENT representation
+  std::vector<NativePoly> ct;
+  // signed digit decomposition of the accumulator (digitsG2 polynomials)
+  std::vector<NativePoly> dct;
+};
+
 /**
  * @brief Ring GSW accumulator schemes described in
  * https://eprint.iacr.org/2014/816 and "Bootstrapping in FHEW-like
@@ -85,6 +106,129 @@ class RingGSWAccumulatorScheme {
       const std::shared_ptr<const LWECiphertextImpl> ct2,
       const std::shared_ptr<LWEEncryptionScheme> LWEscheme) const;
 
+  /**
+   * Evaluates a 3-input gate with a single bootstrapping; MAJORITY takes
+   * regular bit encryptions, while AND3 and OR3 take bits encrypted with
+   * plaintext modulus 6
+   *
+   * @param params a shared pointer to RingGSW scheme parameters
+   * @param gate the gate; can be MAJORITY, AND3, or OR3
+   * @param &EK a shared pointer to the bootstrapping keys
+   * @param &cts the three input ciphertexts
+   * @param lwescheme a shared pointer to additive LWE scheme
+   * @return a shared pointer to the resulting ciphertext
+   */
+  std::shared_ptr<LWECiphertextImpl> EvalBinGate(
+      const std::shared_ptr<RingGSWCryptoParams> params, const BINGATE gate,
+      const RingGSWEvalKey &EK,
+      const std::vector<std::shared_ptr<LWECiphertextImpl>> &cts,
+      const std::shared_ptr<LWEEncryptionScheme> LWEscheme) const;
+
+  /**
+   * Evaluates a threshold function of a weighted sum of bits with a single
+   * bootstrapping: the result encrypts 1 if sum_i weights[i] * m_i >=
+   * threshold and 0 otherwise. The inputs are bits encrypted with plaintext
+   * modulus p; all possible sums below (resp. at or above) the threshold have
+   * to fit in p/2 consecutive values, and the noise of the sum (estimated from
+   * the LWE parameters) has to stay below the rounding margin q/(2p)
+   *
+   * @param params a shared pointer to RingGSW scheme parameters
+   * @param &EK a shared pointer to the bootstrapping keys
+   * @param &cts the input ciphertexts
+   * @param &weights the integer weights
+   * @param threshold the threshold
+   * @param &p the plaintext modulus of the inputs
+   * @param lwescheme a shared pointer to additive LWE scheme
+   * @return a shared pointer to the resulting bit encryption
+   */
+  std::shared_ptr<LWECiphertextImpl> EvalThreshold(
+      const std::shared_ptr<RingGSWCryptoParams> params,
+      const RingGSWEvalKey &EK,
+      const std::vector<std::shared_ptr<LWECiphertextImpl>> &cts,
+      const std::vector<int64_t> &weights, int64_t threshold,
+      const LWEPlaintextModulus &p,
+      const std::shared_ptr<LWEEncryptionScheme> LWEscheme) const;
+
+  /**
+   * Evaluates a batch of independent binary gates (e.g., one layer of a
+   * circuit); the bootstrapping of different gates is run in parallel, with
+   * each thread reusing its own accumulator
+   *
+   * @param params a shared pointer to RingGSW scheme parameters
+   * @param &gates the gates; can be AND, OR, NAND, NOR, XOR, or XNOR
+   * @param &EK a shared pointer to the bootstrapping keys
+   * @param &ct1s first ciphertexts of each gate
+   * @param &ct2s second ciphertexts of each gate
+   * @param lwescheme a shared pointer to additive LWE scheme
+   * @return a vector of the resulting ciphertexts
+   */
+  std::vector<std::shared_ptr<LWECiphertextImpl>> EvalBinGateBatch(
+      const std::shared_ptr<RingGSWCryptoParams> params,
+      const std::vector<BINGATE> &gates, const RingGSWEvalKey &EK,
+      const std::vector<std::shared_ptr<LWECiphertextImpl>> &ct1s,
+      const std::vector<std::shared_ptr<LWECiphertextImpl>> &ct2s,
+      const std::shared_ptr<LWEEncryptionScheme> LWEscheme) const;
+
+  /**
+   * Evaluates an arbitrary function over a small plaintext space using
+   * programmable bootstrapping; the input ciphertext encrypts m modulo p with
+   * scaling q/p, where p (a power of two) is the size of the lookup table.
+   * As the accumulator is negacyclic, the lookup table is evaluated exactly
+   * for m in [0, p/2), while for m in [p/2, p) the result is -LUT[m - p/2]
+   * mod p; hence the whole table is supported only for negacyclic functions
+   *
+   * @param params a shared pointer to RingGSW scheme parameters
+   * @param &EK a shared pointer to the bootstrapping keys
+   * @param ct the input ciphertext (modulo q)
+   * @param &LUT the lookup table; LUT[m] is the output for the message m
+   * @param lwescheme a shared pointer to additive LWE scheme
+   * @return a shared pointer to the resulting ciphertext (modulo q, scaling
+   * q/p)
+   */
+  std::shared_ptr<LWECiphertextImpl> EvalFunc(
+      const std::shared_ptr<RingGSWCryptoParams> params,
+      const RingGSWEvalKey &EK,
+      const std::shared_ptr<const LWECiphertextImpl> ct,
+      const std::vector<NativeInteger> &LUT,
+      const std::shared_ptr<LWEEncryptionScheme> LWEscheme) const;
+
+  /**
+   * Homomorphically clears the lower log(q) bits of the phase of a ciphertext
+   * with a larger modulus Q' (a multiple of q not exceeding Q), i.e., rounds
+   * the phase down to a multiple of q, using two bootstrapping operations.
+   * The result may be off by a multiple of q when the lower bits are within
+   * the bootstrapping noise of 0 or q/2
+   *
+   * @param params a shared pointer to RingGSW scheme parameters
+   * @param &EK a shared pointer to the bootstrapping keys
+   * @param ct the input ciphertext (modulo Q')
+   * @param lwescheme a shared pointer to additive LWE scheme
+   * @return a shared pointer to the resulting ciphertext (modulo Q')
+   */
+  std::shared_ptr<LWECiphertextImpl> EvalFloor(
+      const std::shared_ptr<RingGSWCryptoParams> params,
+      const RingGSWEvalKey &EK,
+      const std::shared_ptr<const LWECiphertextImpl> ct,
+      const std::shared_ptr<LWEEncryptionScheme> LWEscheme) const;
+
+  /**
+   * Evaluates the most significant bit of the phase of a ciphertext with a
+   * modulus Q' >= q, i.e., the sign of a message encoded in [-Q'/2, Q'/2);
+   * the ciphertext is switched to modulus q and bootstrapped
+   *
+   * @param params a shared pointer to RingGSW scheme parameters
+   * @param &EK a shared pointer to the bootstrapping keys
+   * @param ct the input ciphertext (modulo Q')
+   * @param lwescheme a shared pointer to additive LWE scheme
+   * @return a shared pointer to the resulting bit encryption (1 for negative
+   * values)
+   */
+  std::shared_ptr<LWECiphertextImpl> EvalSign(
+      const std::shared_ptr<RingGSWCryptoParams> params,
+      const RingGSWEvalKey &EK,
+      const std::shared_ptr<const LWECiphertextImpl> ct,
+      const std::shared_ptr<LWEEncryptionScheme> LWEscheme) const;
+
   /**
    * Evaluates NOT gate
    *
@@ -96,6 +240,83 @@ class RingGSWAccumulatorScheme {
       const std::shared_ptr<RingGSWCryptoParams> params,
       const std::shared_ptr<const LWECiphertextImpl> ct1) const;
 
+  /**
+   * Blind rotation: multiplies the test vector in the accumulator by
+   * X^{-<a, s>} using the refreshing key (the accumulator updates of
+   * bootstrapping, without the sample extraction and key switching)
+   *
+   * @param params a shared pointer to RingGSW scheme parameters
+   * @param &EK a shared pointer to the bootstrapping keys
+   * @param &a the "a" part of the input ciphertext (modulo q)
+   * @param acc accumulator holding the test vector in the EVALUATION
+   * representation; overwritten with the rotated test vector
+   * @param *scratch preallocated scratch polynomials for accumulator updates
+   */
+  void BlindRotate(const std::shared_ptr<RingGSWCryptoParams> params,
+                   const RingGSWEvalKey &EK, const NativeVector &a,
+                   std::shared_ptr<RingGSWCiphertext> acc,
+                   RingGSWACCScratch *scratch) const;
+
+  /**
+   * Main accumulator function used in bootstrapping - AP variant
+   *
+   * @param params a shared pointer to RingGSW scheme parameters
+   * @param *input input ciphertext (a RingGSW ciphertext of the refreshing
+   * key, see RingGSWBTKey::GetCiphertextData)
+   * @param acc previous value of the accumulator
+   * @param *scratch preallocated scratch polynomials
+   */
+  void AddToACCAP(const std::shared_ptr<RingGSWCryptoParams> params,
+                  const NativeInteger *input,
+                  std::shared_ptr<RingGSWCiphertext> acc,
+                  RingGSWACCScratch *scratch) const;
+
+  /**
+   * Main accumulator function used in bootstrapping - GINX variant
+   *
+   * @param params a shared pointer to RingGSW scheme parameters
+   * @param *input input ciphertext (a RingGSW ciphertext of the refreshing
+   * key, see RingGSWBTKey::GetCiphertextData)
+   * @param &a integer a in each step of GINX accumulation
+   * @param acc previous value of the accumulator
+   * @param *scratch preallocated scratch polynomials
+   */
+  void AddToACCGINX(const std::shared_ptr<RingGSWCryptoParams> params,
+                    const NativeInteger *input, const NativeInteger &a,
+                    std::shared_ptr<RingGSWCiphertext> acc,
+                    RingGSWACCScratch *scratch) const;
+
+  /**
+   * GINX accumulator update for both refreshing keys of a secret key
+   * coefficient: computes acc += (X^{-a} - 1) * (acc x input0) +
+   * (X^a - 1) * (acc x input1) with a single decomposition of acc
+   *
+   * @param params a shared pointer to RingGSW scheme parameters
+   * @param *input0 RingGSW ciphertext of the refreshing key for s_i = 1
+   * @param *input1 RingGSW ciphertext of the refreshing key for s_i = -1
+   * @param &a integer a in each step of GINX accumulation
+   * @param acc previous value of the accumulator
+   * @param *scratch preallocated scratch polynomials
+   */
+  void AddToACCGINXFused(const std::shared_ptr<RingGSWCryptoParams> params,
+                         const NativeInteger *input0,
+                         const NativeInteger *input1, const NativeInteger &a,
+                         std::shared_ptr<RingGSWCiphertext> acc,
+                         RingGSWACCScratch *scratch) const;
+
+  /**
+   * Takes an RLWE ciphertext input and outputs a vector of its digits, i.e., an
+   * RLWE' ciphertext
+   *
+   * @param params a shared pointer to RingGSW scheme parameters
+   * @param &input input RLWE ciphertext
+   * @param *output output RLWE' ciphertext; every coefficient is overwritten
+   */
+  void SignedDigitDecompose(
+      const std::shared_ptr<RingGSWCryptoParams> params,
+      const std::vector<NativePoly> &input,
+      std::vector<NativePoly> *output) const;
+
  private:
   /**
    * Generates a refreshing key - GINX variant
@@ -154,40 +375,90 @@ class RingGSWAccumulatorScheme {
       const NativePoly &skFFT, const LWEPlaintext &m) const;
 
   /**
-   * Main accumulator function used in bootstrapping - AP variant
+   * Evaluates a binary gate using the supplied accumulator as scratch space;
+   * assumes the inputs have already been validated
    *
    * @param params a shared pointer to RingGSW scheme parameters
-   * @param &input input ciphertext
-   * @param acc previous value of the accumulator
+   * @param gate the gate; can be AND, OR, NAND, NOR, XOR, or XNOR
+   * @param &EK a shared pointer to the bootstrapping keys
+   * @param ct1 first ciphertext
+   * @param ct2 second ciphertext
+   * @param lwescheme a shared pointer to additive LWE scheme
+   * @param acc accumulator (a 1 x 2 RingGSW ciphertext) that gets overwritten
+   * @param *scratch preallocated scratch polynomials for accumulator updates
+   * @return a shared pointer to the resulting ciphertext
    */
-  void AddToACCAP(const std::shared_ptr<RingGSWCryptoParams> params,
-                  const RingGSWCiphertext &input,
-                  std::shared_ptr<RingGSWCiphertext> acc) const;
+  std::shared_ptr<LWECiphertextImpl> EvalBinGateCore(
+      const std::shared_ptr<RingGSWCryptoParams> params, const BINGATE gate,
+      const RingGSWEvalKey &EK,
+      const std::shared_ptr<const LWECiphertextImpl> ct1,
+      const std::shared_ptr<const LWECiphertextImpl> ct2,
+      const std::shared_ptr<LWEEncryptionScheme> LWEscheme,
+      std::shared_ptr<RingGSWCiphertext> acc,
+      RingGSWACCScratch *scratch) const;
 
   /**
-   * Main accumulator function used in bootstrapping - GINX variant
+   * Bootstraps a (linear combination of) bit encryption(s) to a bit
+   * encryption: the phases in [q1, q1 + q/2) are mapped to 0 and the other
+   * phases to 1
    *
    * @param params a shared pointer to RingGSW scheme parameters
-   * @param &input input ciphertext
-   * @param &a integer a in each step of GINX accumulation
-   * @param acc previous value of the accumulator
+   * @param &EK a shared pointer to the bootstrapping keys
+   * @param &a the "a" part of the input ciphertext (modulo q)
+   * @param &b the "b" part of the input ciphertext (modulo q)
+   * @param &q1 the start of the range mapped to 0
+   * @param lwescheme a shared pointer to additive LWE scheme
+   * @param acc accumulator (a 1 x 2 RingGSW ciphertext) that gets overwritten
+   * @param *scratch preallocated scratch polynomials for accumulator updates
+   * @return a shared pointer to the resulting ciphertext
    */
-  void AddToACCGINX(const std::shared_ptr<RingGSWCryptoParams> params,
-                    const RingGSWCiphertext &input, const NativeInteger &a,
-                    std::shared_ptr<RingGSWCiphertext> acc) const;
+  std::shared_ptr<LWECiphertextImpl> BootstrapGate(
+      const std::shared_ptr<RingGSWCryptoParams> params,
+      const RingGSWEvalKey &EK, const NativeVector &a, const NativeInteger &b,
+      const NativeInteger &q1,
+      const std::shared_ptr<LWEEncryptionScheme> LWEscheme,
+      std::shared_ptr<RingGSWCiphertext> acc,
+      RingGSWACCScratch *scratch) const;
 
   /**
-   * Takes an RLWE ciphertext input and outputs a vector of its digits, i.e., an
-   * RLWE' ciphertext
+   * Runs the accumulator on a test vector and key-switches the result; the
+   * output is an LWE ciphertext (modulo Q, dimension n) of the constant
+   * coefficient of the test vector rotated by -a*s
    *
    * @param params a shared pointer to RingGSW scheme parameters
-   * @param &input input RLWE ciphertext
-   * @param *output input RLWE ciphertext
+   * @param &EK a shared pointer to the bootstrapping keys
+   * @param &a the "a" part of the input ciphertext (modulo q)
+   * @param m the test vector (N coefficients modulo Q)
+   * @param lwescheme a shared pointer to additive LWE scheme
+   * @param acc accumulator (a 1 x 2 RingGSW ciphertext) that gets overwritten
+   * @param *scratch preallocated scratch polynomials for accumulator updates
+   * @return a shared pointer to the resulting ciphertext
    */
-  inline void SignedDigitDecompose(
+  std::shared_ptr<LWECiphertextImpl> BootstrapCore(
       const std::shared_ptr<RingGSWCryptoParams> params,
-      const std::vector<NativePoly> &input,
-      std::vector<NativePoly> *output) const;
+      const RingGSWEvalKey &EK, const NativeVector &a, NativeVector m,
+      const std::shared_ptr<LWEEncryptionScheme> LWEscheme,
+      std::shared_ptr<RingGSWCiphertext> acc,
+      RingGSWACCScratch *scratch) const;
+
+  /**
+   * Bootstraps the residue modulo q of a ciphertext through a negacyclic
+   * function F, i.e., F(x + q/2) = -F(x), given by its values on [0, q/2)
+   *
+   * @param params a shared pointer to RingGSW scheme parameters
+   * @param &EK a shared pointer to the bootstrapping keys
+   * @param ct the input ciphertext (modulo a multiple of q)
+   * @param &f the values of F on [0, q/2), as integers modulo mod
+   * @param &mod the modulus of the output ciphertext
+   * @param lwescheme a shared pointer to additive LWE scheme
+   * @return a shared pointer to the resulting ciphertext (modulo mod)
+   */
+  std::shared_ptr<LWECiphertextImpl> BootstrapFunc(
+      const std::shared_ptr<RingGSWCryptoParams> params,
+      const RingGSWEvalKey &EK,
+      const std::shared_ptr<const LWECiphertextImpl> ct,
+      const std::vector<NativeInteger> &f, const NativeInteger &mod,
+      const std::shared_ptr<LWEEncryptionScheme> LWEscheme) const;
 };
 
 }  // namespace lbcrypto
@@ -39,6 +39,18 @@
 
 namespace lbcrypto {
 
+/**
+ * Scale-and-round operation used in modulus switching: computes Round(q/Q * v)
+ * mod q
+ *
+ * @param &v the input integer modulo Q
+ * @param &q the new modulus
+ * @param &Q the old modulus
+ * @return the rounded integer modulo q
+ */
+NativeInteger RoundqQ(const NativeInteger& v, const NativeInteger& q,
+                      const NativeInteger& Q);
+
 /**
  * @brief Additive LWE scheme
  */
@@ -65,17 +77,20 @@ class LWEEncryptionScheme {
       const std::shared_ptr<LWECryptoParams> params) const;
 
   /**
-   * Encrypts a bit using a secret key (symmetric key encryption)
+   * Encrypts a message modulo p using a secret key (symmetric key
+   * encryption); the message is scaled by mod/p
    *
    * @param params a shared pointer to LWE scheme parameters
    * @param sk - the secret key
    * @param &m - the plaintext
+   * @param p - plaintext modulus; the default value encrypts a bit
+   * @param &mod - ciphertext modulus; 0 means the modulus of the secret key
    * @return a shared pointer to the ciphertext
    */
   std::shared_ptr<LWECiphertextImpl> Encrypt(
       const std::shared_ptr<LWECryptoParams> params,
-      const std::shared_ptr<const LWEPrivateKeyImpl> sk,
-      const LWEPlaintext& m) const;
+      const std::shared_ptr<const LWEPrivateKeyImpl> sk, const LWEPlaintext& m,
+      const LWEPlaintextModulus& p = 4, const NativeInteger& mod = 0) const;
 
   /**
    * Decrypts the ciphertext using secret key sk
@@ -84,11 +99,12 @@ class LWEEncryptionScheme {
    * @param sk the secret key
    * @param ct the ciphertext
    * @param *result plaintext result
+   * @param p - plaintext modulus; the default value decrypts a bit
    */
   void Decrypt(const std::shared_ptr<LWECryptoParams> params,
                const std::shared_ptr<const LWEPrivateKeyImpl> sk,
                const std::shared_ptr<const LWECiphertextImpl> ct,
-               LWEPlaintext* result) const;
+               LWEPlaintext* result, const LWEPlaintextModulus& p = 4) const;
 
   /**
    * Changes an LWE ciphertext modulo Q into an LWE ciphertext modulo q
@@ -101,6 +117,31 @@ class LWEEncryptionScheme {
       const std::shared_ptr<LWECryptoParams> params,
       const std::shared_ptr<const LWECiphertextImpl> ctQ) const;
 
+  /**
+   * Changes an LWE ciphertext into an LWE ciphertext modulo q; the input
+   * modulus is taken from the ciphertext
+   *
+   * @param &q the new modulus
+   * @param ct the input ciphertext
+   * @return resulting ciphertext
+   */
+  std::shared_ptr<LWECiphertextImpl> ModSwitch(
+      const NativeInteger& q,
+      const std::shared_ptr<const LWECiphertextImpl> ct) const;
+
+  /**
+   * Computes the weighted sum of LWE ciphertexts, i.e., an encryption of
+   * sum_i weights[i] * m_i; no bootstrapping is performed, so the noise grows
+   * with the norm of the weights
+   *
+   * @param &cts the input ciphertexts (all with the same modulus)
+   * @param &weights the integer weights
+   * @return a shared pointer to the resulting ciphertext
+   */
+  std::shared_ptr<LWECiphertextImpl> EvalWeightedSum(
+      const std::vector<std::shared_ptr<LWECiphertextImpl>>& cts,
+      const std::vector<int64_t>& weights) const;
+
   /**
    * Generates a switching key to go from a secret key with (Q,N) to a secret
    * key with (q,n)
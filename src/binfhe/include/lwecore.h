@@ -27,14 +27,21 @@
 #ifndef BINFHE_LWECORE_H
 #define BINFHE_LWECORE_H
 
+#include <cstring>
+#include <istream>
+#include <ostream>
+
 #include "math/backend.h"
 #include "math/discretegaussiangenerator.h"
 #include "utils/serializable.h"
+#include "utils/slaballocator.h"
 
 namespace lbcrypto {
 
 typedef int64_t LWEPlaintext;
 
+typedef int64_t LWEPlaintextModulus;
+
 /**
  * @brief Class that stores all parameters for the LWE scheme
  */
@@ -274,6 +281,345 @@ class LWECiphertextImpl : public Serializable {
   NativeInteger m_b;
 };
 
+/**
+ * @brief A packed batch of LWE ciphertexts with the same dimension and
+ * modulus, used to exchange large numbers of ciphertexts
+ *
+ * The serialized form is a 64-byte header with the dimension n, the modulus
+ * and the number of ciphertexts, followed by one row per ciphertext holding
+ * the n words of "a" and then "b". A word is the smallest of 2, 4 or 8 bytes
+ * that holds the values modulo the modulus, so ciphertexts modulo q = 512
+ * take 2 bytes per coefficient. A batch can wrap a serialized buffer, e.g.,
+ * a memory-mapped file or a received message, without copying it.
+ */
+class LWECiphertextBatch {
+ public:
+  LWECiphertextBatch()
+      : m_n(0), m_wordSize(0), m_count(0), m_rowBytes(0), m_data(nullptr) {}
+
+  /**
+   * Packs ciphertexts into a new batch
+   *
+   * @param &cts the ciphertexts; all have the same dimension and modulus
+   */
+  explicit LWECiphertextBatch(
+      const std::vector<std::shared_ptr<LWECiphertextImpl>> &cts)
+      : LWECiphertextBatch() {
+    uint32_t n = 0;
+    NativeInteger modulus(0);
+    if (cts.size() > 0) {
+      n = cts[0]->GetA().GetLength();
+      modulus = cts[0]->GetA().GetModulus();
+    }
+    for (const auto &ct : cts) {
+      if (ct->GetA().GetLength() != n || ct->GetA().GetModulus() != modulus)
+        PALISADE_THROW(config_error,
+                       "All ciphertexts of a batch must have the same "
+                       "dimension and modulus");
+    }
+
+    Header header;
+    InitHeader(&header, n, modulus, cts.size());
+    size_t bytes = sizeof(header) + header.count * RowBytes(header);
+    auto slab = std::make_shared<AlignedSlab>(1, bytes);
+    char *buffer = slab->GetData();
+    std::memcpy(buffer, &header, sizeof(header));
+    SetLayout(header, slab, buffer);
+
+    char *rows = buffer + sizeof(header);
+    for (size_t i = 0; i < m_count; i++) {
+      const NativeVector &a = cts[i]->GetA();
+      switch (m_wordSize) {
+        case 2:
+          PackRow<uint16_t>(a, cts[i]->GetB(), rows);
+          break;
+        case 4:
+          PackRow<uint32_t>(a, cts[i]->GetB(), rows);
+          break;
+        default:
+          PackRow<uint64_t>(a, cts[i]->GetB(), rows);
+      }
+      rows += RowBytes(header);
+    }
+  }
+
+  /**
+   * Wraps a serialized batch without copying it; the header and all
+   * coefficients are validated, so the buffer may come from an untrusted
+   * source, but it has to stay unchanged as long as the batch is used
+   *
+   * @param storage owner of the buffer; kept alive as long as the batch
+   * @param *data the serialized batch
+   * @param size the size of the buffer in bytes
+   */
+  explicit LWECiphertextBatch(const std::shared_ptr<const void> &storage,
+                              const void *data, size_t size)
+      : LWECiphertextBatch() {
+    Header header;
+    if (size < sizeof(header))
+      PALISADE_THROW(deserialize_error, "Ciphertext batch is truncated");
+    std::memcpy(&header, data, sizeof(header));
+    ValidateHeader(header);
+    // the row count comes from untrusted input: check it without overflow
+    if ((size - sizeof(header)) / RowBytes(header) < header.count)
+      PALISADE_THROW(deserialize_error, "Ciphertext batch is truncated");
+    SetLayout(header, storage, static_cast<const char *>(data));
+    ValidateRows();
+  }
+
+  /**
+   * Reads a serialized batch from a stream into a new buffer
+   *
+   * @param &in the input stream
+   * @return the batch
+   */
+  static LWECiphertextBatch Load(std::istream &in) {
+    Header header;
+    if (!in.read(reinterpret_cast<char *>(&header), sizeof(header)))
+      PALISADE_THROW(deserialize_error, "Ciphertext batch is truncated");
+    ValidateHeader(header);
+    size_t rowBytes = RowBytes(header);
+    if (header.count > (SIZE_MAX - sizeof(header)) / rowBytes)
+      PALISADE_THROW(deserialize_error, "Ciphertext batch is too large");
+    size_t bytes = sizeof(header) + header.count * rowBytes;
+    auto slab = std::make_shared<AlignedSlab>(1, bytes);
+    char *buffer = slab->GetData();
+    std::memcpy(buffer, &header, sizeof(header));
+    if (!in.read(buffer + sizeof(header), bytes - sizeof(header)))
+      PALISADE_THROW(deserialize_error, "Ciphertext batch is truncated");
+    return LWECiphertextBatch(slab, buffer, bytes);
+  }
+
+  /**
+   * Writes the serialized batch to a stream
+   *
+   * @param &out the output stream
+   * @return false if the stream failed
+   */
+  bool Save(std::ostream &out) const {
+    if (m_data == nullptr) return false;
+    out.write(m_data, GetSizeInBytes());
+    return !out.fail();
+  }
+
+  /**
+   * @return the serialized batch
+   */
+  const char *GetData() const { return m_data; }
+
+  /**
+   * @return the size of the serialized batch in bytes
+   */
+  size_t GetSizeInBytes() const {
+    return (m_data == nullptr) ? 0 : sizeof(Header) + m_count * m_rowBytes;
+  }
+
+  size_t GetCount() const { return m_count; }
+
+  uint32_t Getn() const { return m_n; }
+
+  const NativeInteger &GetModulus() const { return m_modulus; }
+
+  /**
+   * @return the size of a coefficient in bytes
+   */
+  uint32_t GetWordSize() const { return m_wordSize; }
+
+  /**
+   * Reads coefficient j of "a" of the i-th ciphertext in place
+   */
+  NativeInteger GetA(size_t i, uint32_t j) const {
+    CheckIndex(i);
+    if (j >= m_n)
+      PALISADE_THROW(config_error, "Coefficient index out of range");
+    return NativeInteger(ReadWord(GetRow(i) + (size_t)j * m_wordSize));
+  }
+
+  /**
+   * Reads "b" of the i-th ciphertext in place
+   */
+  NativeInteger GetB(size_t i) const {
+    CheckIndex(i);
+    return NativeInteger(ReadWord(GetRow(i) + (size_t)m_n * m_wordSize));
+  }
+
+  /**
+   * Unpacks the i-th ciphertext
+   */
+  std::shared_ptr<LWECiphertextImpl> GetCiphertext(size_t i) const {
+    CheckIndex(i);
+    NativeVector a(m_n, m_modulus);
+    const char *row = GetRow(i);
+    switch (m_wordSize) {
+      case 2:
+        UnpackRow<uint16_t>(row, &a);
+        break;
+      case 4:
+        UnpackRow<uint32_t>(row, &a);
+        break;
+      default:
+        UnpackRow<uint64_t>(row, &a);
+    }
+    return std::make_shared<LWECiphertextImpl>(a, GetB(i));
+  }
+
+  /**
+   * Unpacks all ciphertexts
+   */
+  std::vector<std::shared_ptr<LWECiphertextImpl>> GetCiphertexts() const {
+    std::vector<std::shared_ptr<LWECiphertextImpl>> cts(m_count);
+    for (size_t i = 0; i < m_count; i++) cts[i] = GetCiphertext(i);
+    return cts;
+  }
+
+ private:
+  struct Header {
+    char magic[8];
+    uint32_t version;
+    // size of a coefficient in bytes
+    uint32_t wordSize;
+    uint64_t endianness;
+    uint64_t modulus;
+    uint64_t count;
+    uint32_t n;
+    uint32_t reserved[5];
+  };
+
+  static const char *Magic() { return "PALLWEBT"; }
+
+  static const uint32_t VERSION = 1;
+
+  static const uint64_t ENDIANNESS = 0x0102030405060708ULL;
+
+  static uint32_t WordSize(const NativeInteger &modulus) {
+    uint64_t q = modulus.ConvertToInt();
+    if (q <= ((uint64_t)1 << 16)) return 2;
+    if (q <= ((uint64_t)1 << 32)) return 4;
+    return 8;
+  }
+
+  static size_t RowBytes(const Header &header) {
+    return ((size_t)header.n + 1) * header.wordSize;
+  }
+
+  static void InitHeader(Header *header, uint32_t n,
+                         const NativeInteger &modulus, size_t count) {
+    std::memset(header, 0, sizeof(*header));
+    std::memcpy(header->magic, Magic(), sizeof(header->magic));
+    header->version = VERSION;
+    header->wordSize = WordSize(modulus);
+    header->endianness = ENDIANNESS;
+    header->modulus = modulus.ConvertToInt();
+    header->count = count;
+    header->n = n;
+  }
+
+  static void ValidateHeader(const Header &header) {
+    if (std::memcmp(header.magic, Magic(), sizeof(header.magic)) != 0)
+      PALISADE_THROW(deserialize_error, "Data is not a ciphertext batch");
+    if (header.version > VERSION)
+      PALISADE_THROW(deserialize_error,
+                     "Ciphertext batch version " +
+                         std::to_string(header.version) +
+                         " is from a later version of the library");
+    if (header.endianness != ENDIANNESS)
+      PALISADE_THROW(deserialize_error,
+                     "Ciphertext batch was written on a platform with a "
+                     "different byte order");
+    if (header.modulus < 2)
+      PALISADE_THROW(deserialize_error,
+                     "Invalid modulus of the ciphertext batch");
+    if (header.wordSize != WordSize(NativeInteger(header.modulus)))
+      PALISADE_THROW(deserialize_error,
+                     "Unexpected word size of the ciphertext batch");
+  }
+
+  void SetLayout(const Header &header,
+                 const std::shared_ptr<const void> &storage,
+                 const char *data) {
+    m_n = header.n;
+    m_modulus = NativeInteger(header.modulus);
+    m_wordSize = header.wordSize;
+    m_count = header.count;
+    m_rowBytes = RowBytes(header);
+    m_storage = storage;
+    m_data = data;
+  }
+
+  // checks that every coefficient is reduced modulo the modulus, so the
+  // accessors can return the stored words without reducing them
+  void ValidateRows() const {
+    uint64_t q = m_modulus.ConvertToInt();
+    size_t words = m_count * ((size_t)m_n + 1);
+    const char *p = m_data + sizeof(Header);
+    for (size_t k = 0; k < words; k++, p += m_wordSize) {
+      if (ReadWord(p) >= q)
+        PALISADE_THROW(deserialize_error,
+                       "Coefficient of the ciphertext batch is not reduced "
+                       "modulo the modulus");
+    }
+  }
+
+  void CheckIndex(size_t i) const {
+    if (i >= m_count)
+      PALISADE_THROW(config_error, "Ciphertext index out of range");
+  }
+
+  const char *GetRow(size_t i) const {
+    return m_data + sizeof(Header) + i * m_rowBytes;
+  }
+
+  uint64_t ReadWord(const char *p) const {
+    switch (m_wordSize) {
+      case 2: {
+        uint16_t w;
+        std::memcpy(&w, p, sizeof(w));
+        return w;
+      }
+      case 4: {
+        uint32_t w;
+        std::memcpy(&w, p, sizeof(w));
+        return w;
+      }
+      default: {
+        uint64_t w;
+        std::memcpy(&w, p, sizeof(w));
+        return w;
+      }
+    }
+  }
+
+  template <class Word>
+  static void PackRow(const NativeVector &a, const NativeInteger &b,
+                      char *row) {
+    uint32_t n = a.GetLength();
+    for (uint32_t j = 0; j < n; j++) {
+      Word w = a[j].ConvertToInt();
+      std::memcpy(row + j * sizeof(Word), &w, sizeof(Word));
+    }
+    Word w = b.ConvertToInt();
+    std::memcpy(row + n * sizeof(Word), &w, sizeof(Word));
+  }
+
+  template <class Word>
+  void UnpackRow(const char *row, NativeVector *a) const {
+    for (uint32_t j = 0; j < m_n; j++) {
+      Word w;
+      std::memcpy(&w, row + j * sizeof(Word), sizeof(Word));
+      (*a)[j] = w;
+    }
+  }
+
+  uint32_t m_n;
+  NativeInteger m_modulus;
+  uint32_t m_wordSize;
+  size_t m_count;
+  size_t m_rowBytes;
+  // owner of the buffer (an AlignedSlab or a memory mapping)
+  std::shared_ptr<const void> m_storage;
+  const char *m_data;
+};
+
 /**
  * @brief Class that stores the LWE scheme secret key; contains a vector
  */
@@ -338,45 +684,189 @@ class LWEPrivateKeyImpl : public Serializable {
 
 /**
  * @brief Class that stores the LWE scheme switching key
+ *
+ * The key consists of N x expKS x baseKS LWE ciphertexts of dimension n; they
+ * are kept in one contiguous 64-byte aligned buffer indexed by (i, digit,
+ * value) so that key switching streams through memory. Each row stores the
+ * n words of "a" followed by "b" and is padded to a multiple of 64 bytes.
  */
 class LWESwitchingKey : public Serializable {
  public:
-  LWESwitchingKey(){};
+  LWESwitchingKey()
+      : m_N(0),
+        m_baseKS(0),
+        m_expKS(0),
+        m_n(0),
+        m_rowSize(0),
+        m_data(nullptr) {}
+
+  /**
+   * Allocates a switching key with all entries set to zero
+   *
+   * @param N dimension of the secret key being switched from
+   * @param baseKS the base used for key switching
+   * @param expKS the number of digits in base baseKS
+   * @param n dimension of the secret key being switched to
+   * @param &modulus the modulus of the key entries
+   */
+  explicit LWESwitchingKey(uint32_t N, uint32_t baseKS, uint32_t expKS,
+                           uint32_t n, const NativeInteger &modulus) {
+    Allocate(N, baseKS, expKS, n, modulus);
+  }
+
+  /**
+   * Wraps an existing read-only buffer, e.g., a memory-mapped key file,
+   * without copying it; the rows of such a key must not be modified
+   *
+   * @param N dimension of the secret key being switched from
+   * @param baseKS the base used for key switching
+   * @param expKS the number of digits in base baseKS
+   * @param n dimension of the secret key being switched to
+   * @param &modulus the modulus of the key entries
+   * @param storage owner of the buffer; kept alive as long as the key
+   * @param *data the rows in the layout of GetRow
+   */
+  explicit LWESwitchingKey(uint32_t N, uint32_t baseKS, uint32_t expKS,
+                           uint32_t n, const NativeInteger &modulus,
+                           const std::shared_ptr<const void> &storage,
+                           const uint64_t *data)
+      : m_N(N),
+        m_baseKS(baseKS),
+        m_expKS(expKS),
+        m_n(n),
+        m_rowSize(RowSize(n)),
+        m_modulus(modulus),
+        m_storage(storage),
+        m_data(const_cast<uint64_t *>(data)) {}
 
   explicit LWESwitchingKey(
       const std::vector<std::vector<std::vector<LWECiphertextImpl>>> &key)
-      : m_key(key){};
+      : LWESwitchingKey() {
+    SetElements(key);
+  }
 
-  explicit LWESwitchingKey(const LWESwitchingKey &rhs) {
-    this->m_key = rhs.m_key;
+  explicit LWESwitchingKey(const LWESwitchingKey &rhs) : LWESwitchingKey() {
+    *this = rhs;
   }
 
-  explicit LWESwitchingKey(const LWESwitchingKey &&rhs) {
-    this->m_key = std::move(rhs.m_key);
+  explicit LWESwitchingKey(const LWESwitchingKey &&rhs) : LWESwitchingKey() {
+    *this = rhs;
   }
 
   const LWESwitchingKey &operator=(const LWESwitchingKey &rhs) {
-    this->m_key = rhs.m_key;
+    if (this != &rhs) {
+      Allocate(rhs.m_N, rhs.m_baseKS, rhs.m_expKS, rhs.m_n, rhs.m_modulus);
+      if (GetSize() > 0)
+        std::memcpy(m_data, rhs.m_data, GetSize() * sizeof(uint64_t));
+    }
     return *this;
   }
 
   const LWESwitchingKey &operator=(const LWESwitchingKey &&rhs) {
-    this->m_key = std::move(rhs.m_key);
-    return *this;
+    return *this = rhs;
   }
 
-  const std::vector<std::vector<std::vector<LWECiphertextImpl>>> &GetElements()
+  /**
+   * Gets a row of the switching key: the encryption of value * baseKS^digit
+   * times the i-th coefficient of the old secret key
+   *
+   * @return a pointer to the n words of "a" followed by "b"
+   */
+  uint64_t *GetRow(uint32_t i, uint32_t digit, uint32_t value) {
+    return m_data +
+           (((size_t)i * m_expKS + digit) * m_baseKS + value) * m_rowSize;
+  }
+
+  const uint64_t *GetRow(uint32_t i, uint32_t digit, uint32_t value) const {
+    return m_data +
+           (((size_t)i * m_expKS + digit) * m_baseKS + value) * m_rowSize;
+  }
+
+  /**
+   * Builds the switching key as a vector of LWE ciphertexts indexed by
+   * [i][value][digit] (the layout used before the key was flattened)
+   */
+  std::vector<std::vector<std::vector<LWECiphertextImpl>>> GetElements()
       const {
-    return m_key;
+    std::vector<std::vector<std::vector<LWECiphertextImpl>>> key(m_N);
+    for (uint32_t i = 0; i < m_N; i++) {
+      key[i].resize(m_baseKS);
+      for (uint32_t v = 0; v < m_baseKS; v++) {
+        key[i][v].resize(m_expKS);
+        for (uint32_t j = 0; j < m_expKS; j++) {
+          const uint64_t *row = GetRow(i, j, v);
+          NativeVector a(m_n, m_modulus);
+          for (uint32_t k = 0; k < m_n; k++) a[k] = row[k];
+          key[i][v][j] = LWECiphertextImpl(a, NativeInteger(row[m_n]));
+        }
+      }
+    }
+    return key;
   }
 
   void SetElements(
       const std::vector<std::vector<std::vector<LWECiphertextImpl>>> &key) {
-    m_key = key;
+    uint32_t N = key.size();
+    uint32_t baseKS = (N > 0) ? key[0].size() : 0;
+    uint32_t expKS = (baseKS > 0) ? key[0][0].size() : 0;
+    uint32_t n = 0;
+    NativeInteger modulus(0);
+    if (expKS > 0) {
+      n = key[0][0][0].GetA().GetLength();
+      modulus = key[0][0][0].GetA().GetModulus();
+    }
+    Allocate(N, baseKS, expKS, n, modulus);
+    for (uint32_t i = 0; i < N; i++)
+      for (uint32_t v = 0; v < baseKS; v++)
+        for (uint32_t j = 0; j < expKS; j++) {
+          uint64_t *row = GetRow(i, j, v);
+          const LWECiphertextImpl &ct = key[i][v][j];
+          for (uint32_t k = 0; k < n; k++)
+            row[k] = ct.GetA()[k].ConvertToInt();
+          row[n] = ct.GetB().ConvertToInt();
+        }
+  }
+
+  /**
+   * @return the flat buffer of all rows
+   */
+  const uint64_t *GetData() const { return m_data; }
+
+  /**
+   * @return the number of words in the flat buffer
+   */
+  size_t GetSize() const {
+    return (size_t)m_N * m_expKS * m_baseKS * m_rowSize;
+  }
+
+  uint32_t GetN() const { return m_N; }
+
+  uint32_t GetBaseKS() const { return m_baseKS; }
+
+  uint32_t GetExpKS() const { return m_expKS; }
+
+  uint32_t Getn() const { return m_n; }
+
+  uint32_t GetRowSize() const { return m_rowSize; }
+
+  /**
+   * @return the number of words per row for a key switching to dimension n:
+   * n + 1 rounded up to a multiple of 64 bytes
+   */
+  static uint32_t RowSize(uint32_t n) {
+    return AlignedSlab::RegionSize((n + 1) * sizeof(uint64_t)) /
+           sizeof(uint64_t);
   }
 
+  const NativeInteger &GetModulus() const { return m_modulus; }
+
   bool operator==(const LWESwitchingKey &other) const {
-    return m_key == other.m_key;
+    return m_N == other.m_N && m_baseKS == other.m_baseKS &&
+           m_expKS == other.m_expKS && m_n == other.m_n &&
+           m_modulus == other.m_modulus &&
+           (GetSize() == 0 ||
+            std::memcmp(GetData(), other.GetData(),
+                        GetSize() * sizeof(uint64_t)) == 0);
   }
 
   bool operator!=(const LWESwitchingKey &other) const {
@@ -385,7 +875,7 @@ class LWESwitchingKey : public Serializable {
 
   template <class Archive>
   void save(Archive &ar, std::uint32_t const version) const {
-    ar(::cereal::make_nvp("k", m_key));
+    ar(::cereal::make_nvp("k", GetElements()));
   }
 
   template <class Archive>
@@ -396,14 +886,51 @@ class LWESwitchingKey : public Serializable {
                          " is from a later version of the library");
     };
 
-    ar(::cereal::make_nvp("k", m_key));
+    std::vector<std::vector<std::vector<LWECiphertextImpl>>> key;
+    ar(::cereal::make_nvp("k", key));
+    SetElements(key);
   }
 
   std::string SerializedObjectName() const { return "LWEPrivateKey"; }
   static uint32_t SerializedVersion() { return 1; }
 
  private:
-  std::vector<std::vector<std::vector<LWECiphertextImpl>>> m_key;
+  void Allocate(uint32_t N, uint32_t baseKS, uint32_t expKS, uint32_t n,
+                const NativeInteger &modulus) {
+    m_N = N;
+    m_baseKS = baseKS;
+    m_expKS = expKS;
+    m_n = n;
+    m_modulus = modulus;
+    m_rowSize = RowSize(n);
+    if (GetSize() == 0) {
+      m_storage.reset();
+      m_data = nullptr;
+      return;
+    }
+    std::shared_ptr<AlignedSlab> slab =
+        std::make_shared<AlignedSlab>(1, GetSize() * sizeof(uint64_t));
+    std::memset(slab->GetData(), 0, GetSize() * sizeof(uint64_t));
+    m_data = reinterpret_cast<uint64_t *>(slab->GetData());
+    m_storage = slab;
+  }
+
+  // dimension of the secret key being switched from
+  uint32_t m_N;
+  // base used in key switching
+  uint32_t m_baseKS;
+  // number of digits in base m_baseKS
+  uint32_t m_expKS;
+  // dimension of the secret key being switched to
+  uint32_t m_n;
+  // number of words per row (n + 1 rounded up to a multiple of 64 bytes)
+  uint32_t m_rowSize;
+  // modulus of the key entries
+  NativeInteger m_modulus;
+  // owner of the flat buffer (an aligned slab or a memory mapping)
+  std::shared_ptr<const void> m_storage;
+  // flat buffer holding all rows
+  uint64_t *m_data;
 };
 
 }  // namespace lbcrypto
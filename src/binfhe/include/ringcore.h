@@ -37,14 +37,21 @@
 
 namespace lbcrypto {
 
-// enum for all supported binary gates
-enum BINGATE { OR, AND, NOR, NAND, XOR, XNOR };
+// enum for all supported binary gates; MAJORITY, AND3, and OR3 take three
+// inputs
+enum BINGATE { OR, AND, NOR, NAND, XOR, XNOR, MAJORITY, AND3, OR3 };
 
 // Two variants of FHEW are supported based on the bootstrapping technique used:
 // AP and GINX Please see "Bootstrapping in FHEW-like Cryptosystems" for details
 // on both bootstrapping techniques
 enum BINFHEMETHOD { AP, GINX };
 
+// Variants of the GINX accumulator update: GINX_SEQUENTIAL runs one external
+// product for each of the two refreshing keys of a secret key coefficient;
+// GINX_FUSED decomposes the accumulator once per coefficient and multiplies
+// the decomposition by both keys, halving the number of NTTs
+enum GINXMODE { GINX_SEQUENTIAL, GINX_FUSED };
+
 /**
  * @brief Class that stores all parameters for the RingGSW scheme used in
  * bootstrapping
@@ -52,7 +59,12 @@ enum BINFHEMETHOD { AP, GINX };
 class RingGSWCryptoParams : public Serializable {
  public:
   RingGSWCryptoParams()
-      : m_baseG(0), m_digitsG(0), m_digitsG2(0), m_baseR(0), m_method(GINX) {}
+      : m_baseG(0),
+        m_digitsG(0),
+        m_digitsG2(0),
+        m_baseR(0),
+        m_method(GINX),
+        m_ginxMode(GINX_SEQUENTIAL) {}
 
   /**
    * Main constructor for RingGSWCryptoParams
@@ -68,7 +80,8 @@ class RingGSWCryptoParams : public Serializable {
       : m_LWEParams(lweparams),
         m_baseG(baseG),
         m_baseR(baseR),
-        m_method(method) {
+        m_method(method),
+        m_ginxMode(GINX_SEQUENTIAL) {
     if (!IsPowerOfTwo(baseG)) {
       PALISADE_THROW(config_error, "Gadget base should be a power of two.");
     }
@@ -118,14 +131,20 @@ class RingGSWCryptoParams : public Serializable {
       vTemp = vTemp.ModMul(NativeInteger(m_baseG), Q);
     }
 
-    // Sets the gate constants for supported binary operations
+    // Sets the gate constants for supported binary operations; AND3 and OR3
+    // expect bits encrypted with plaintext modulus 6 (scaling q/6), so that
+    // the sums 0..3 fit in half of Z_q
+    NativeInteger q6 = q / NativeInteger(6);
     m_gateConst = {
-        NativeInteger(5) * (q >> 3),  // OR
-        NativeInteger(7) * (q >> 3),  // AND
-        NativeInteger(1) * (q >> 3),  // NOR
-        NativeInteger(3) * (q >> 3),  // NAND
-        NativeInteger(5) * (q >> 3),  // XOR
-        NativeInteger(1) * (q >> 3)   // XNOR
+        NativeInteger(5) * (q >> 3),             // OR
+        NativeInteger(7) * (q >> 3),             // AND
+        NativeInteger(1) * (q >> 3),             // NOR
+        NativeInteger(3) * (q >> 3),             // NAND
+        NativeInteger(5) * (q >> 3),             // XOR
+        NativeInteger(1) * (q >> 3),             // XNOR
+        NativeInteger(7) * (q >> 3),             // MAJORITY
+        q - ((q - NativeInteger(5) * q6) >> 1),  // AND3
+        q - ((q - q6) >> 1)                      // OR3
     };
 
     // Computes polynomials X^m - 1 that are needed in the accumulator for the
@@ -177,6 +196,14 @@ class RingGSWCryptoParams : public Serializable {
 
   BINFHEMETHOD GetMethod() const { return m_method; }
 
+  GINXMODE GetGINXMode() const { return m_ginxMode; }
+
+  /**
+   * Selects the GINX accumulator update; both modes use the same keys, so
+   * the mode is an evaluation setting and is not serialized
+   */
+  void SetGINXMode(GINXMODE mode) { m_ginxMode = mode; }
+
   bool operator==(const RingGSWCryptoParams& other) const {
     return *m_LWEParams == *other.m_LWEParams && m_baseR == other.m_baseR &&
            m_baseG == other.m_baseG && m_method == other.m_method;
@@ -246,6 +273,9 @@ class RingGSWCryptoParams : public Serializable {
 
   // Bootstrapping method (AP or GINX)
   BINFHEMETHOD m_method;
+
+  // Accumulator update used for GINX bootstrapping
+  GINXMODE m_ginxMode;
 };
 
 /**
@@ -340,67 +370,283 @@ class RingGSWCiphertext : public Serializable {
 
 /**
  * @brief Class that stores the refreshing key (used in bootstrapping)
- * A three-dimensional vector of RingGSW ciphertexts
+ * A three-dimensional array of RingGSW ciphertexts. The coefficients of all
+ * polynomials (in the EVALUATION representation) are stored in one flat
+ * 64-byte aligned buffer, followed by one byte per ciphertext that records
+ * whether it was set. The buffer can also be a read-only memory mapping of a
+ * key file; copies of a read-only key share the mapping.
  */
 class RingGSWBTKey : public Serializable {
  public:
-  RingGSWBTKey() {}
+  RingGSWBTKey()
+      : m_dim1(0),
+        m_dim2(0),
+        m_dim3(0),
+        m_rows(0),
+        m_cols(0),
+        m_data(nullptr),
+        m_isSet(nullptr),
+        m_readOnly(false) {}
 
-  explicit RingGSWBTKey(uint32_t dim1, uint32_t dim2, uint32_t dim3) {
-    m_key.resize(dim1);
-    for (uint32_t i = 0; i < dim1; i++) {
-      m_key[i].resize(dim2);
-      for (uint32_t j = 0; j < dim2; j++) m_key[i][j].resize(dim3);
-    }
-  };
+  /**
+   * Allocates a refreshing key with all coefficients set to zero
+   *
+   * @param dim1, dim2, dim3 dimensions of the array of RingGSW ciphertexts
+   * @param rows, cols dimensions of each RingGSW ciphertext
+   * @param polyParams parameters of the polynomials
+   */
+  explicit RingGSWBTKey(uint32_t dim1, uint32_t dim2, uint32_t dim3,
+                        uint32_t rows, uint32_t cols,
+                        const shared_ptr<ILNativeParams> polyParams)
+      : RingGSWBTKey() {
+    Allocate(dim1, dim2, dim3, rows, cols, polyParams);
+  }
+
+  /**
+   * Wraps an existing read-only buffer, e.g., a memory-mapped key file,
+   * without copying it
+   *
+   * @param dim1, dim2, dim3 dimensions of the array of RingGSW ciphertexts
+   * @param rows, cols dimensions of each RingGSW ciphertext
+   * @param polyParams parameters of the polynomials
+   * @param storage owner of the buffer; kept alive as long as the key
+   * @param *data the coefficients in the layout of GetCiphertextData
+   * @param *isSet one byte per ciphertext, nonzero if it was set
+   */
+  explicit RingGSWBTKey(uint32_t dim1, uint32_t dim2, uint32_t dim3,
+                        uint32_t rows, uint32_t cols,
+                        const shared_ptr<ILNativeParams> polyParams,
+                        const std::shared_ptr<const void>& storage,
+                        const NativeInteger* data, const uint8_t* isSet)
+      : m_dim1(dim1),
+        m_dim2(dim2),
+        m_dim3(dim3),
+        m_rows(rows),
+        m_cols(cols),
+        m_polyParams(polyParams),
+        m_storage(storage),
+        m_data(const_cast<NativeInteger*>(data)),
+        m_isSet(const_cast<uint8_t*>(isSet)),
+        m_readOnly(true) {}
 
   explicit RingGSWBTKey(
       const std::vector<std::vector<std::vector<RingGSWCiphertext>>>& key)
-      : m_key(key){};
+      : RingGSWBTKey() {
+    SetElements(key);
+  }
 
-  explicit RingGSWBTKey(const RingGSWBTKey& rhs) { this->m_key = rhs.m_key; }
+  explicit RingGSWBTKey(const RingGSWBTKey& rhs) : RingGSWBTKey() {
+    *this = rhs;
+  }
 
-  explicit RingGSWBTKey(const RingGSWBTKey&& rhs) {
-    this->m_key = std::move(rhs.m_key);
+  explicit RingGSWBTKey(RingGSWBTKey&& rhs) : RingGSWBTKey() {
+    *this = std::move(rhs);
   }
 
+  /**
+   * Copies a writable key; a read-only key is immutable, so the copy shares
+   * its buffer
+   */
   const RingGSWBTKey& operator=(const RingGSWBTKey& rhs) {
-    this->m_key = rhs.m_key;
+    if (this == &rhs) return *this;
+    if (rhs.m_readOnly) {
+      CopyLayout(rhs);
+      m_storage = rhs.m_storage;
+      m_data = rhs.m_data;
+      m_isSet = rhs.m_isSet;
+      m_readOnly = true;
+      return *this;
+    }
+    Allocate(rhs.m_dim1, rhs.m_dim2, rhs.m_dim3, rhs.m_rows, rhs.m_cols,
+             rhs.m_polyParams);
+    if (GetSize() > 0) {
+      std::memcpy(static_cast<void*>(m_data), rhs.m_data,
+                  GetSize() * sizeof(NativeInteger));
+      std::memcpy(m_isSet, rhs.m_isSet, GetCount());
+    }
     return *this;
   }
 
-  const RingGSWBTKey& operator=(const RingGSWBTKey&& rhs) {
-    this->m_key = std::move(rhs.m_key);
+  const RingGSWBTKey& operator=(RingGSWBTKey&& rhs) {
+    if (this == &rhs) return *this;
+    CopyLayout(rhs);
+    m_storage = std::move(rhs.m_storage);
+    m_data = rhs.m_data;
+    m_isSet = rhs.m_isSet;
+    m_readOnly = rhs.m_readOnly;
+    rhs.Allocate(0, 0, 0, 0, 0, nullptr);
     return *this;
   }
 
-  const std::vector<std::vector<std::vector<RingGSWCiphertext>>>& GetElements()
+  /**
+   * Gets the RingGSW ciphertext at index (i, j, k)
+   *
+   * @return a pointer to rows x cols polynomials of N coefficients each,
+   * stored row by row
+   */
+  const NativeInteger* GetCiphertextData(uint32_t i, uint32_t j,
+                                         uint32_t k) const {
+    return m_data + (((size_t)i * m_dim2 + j) * m_dim3 + k) * m_rows *
+                        m_cols * GetRingDimension();
+  }
+
+  /**
+   * Copies a RingGSW ciphertext into the key at index (i, j, k)
+   */
+  void SetCiphertext(uint32_t i, uint32_t j, uint32_t k,
+                     const RingGSWCiphertext& ct) {
+    if (m_readOnly) {
+      std::string errMsg = "ERROR: The refreshing key is read-only.";
+      PALISADE_THROW(config_error, errMsg);
+    }
+    uint32_t N = GetRingDimension();
+    NativeInteger* dst =
+        const_cast<NativeInteger*>(GetCiphertextData(i, j, k));
+    for (uint32_t l = 0; l < m_rows; l++) {
+      for (uint32_t c = 0; c < m_cols; c++, dst += N) {
+        if (ct[l][c].GetFormat() == EVALUATION) {
+          std::memcpy(static_cast<void*>(dst), &ct[l][c][0],
+                      N * sizeof(NativeInteger));
+        } else {
+          NativePoly poly = ct[l][c];
+          poly.SetFormat(EVALUATION);
+          std::memcpy(static_cast<void*>(dst), &poly[0],
+                      N * sizeof(NativeInteger));
+        }
+      }
+    }
+    m_isSet[Index(i, j, k)] = 1;
+  }
+
+  /**
+   * @return true if the RingGSW ciphertext at index (i, j, k) was set
+   */
+  bool IsSet(uint32_t i, uint32_t j, uint32_t k) const {
+    return m_isSet[Index(i, j, k)] != 0;
+  }
+
+  /**
+   * Builds the RingGSW ciphertext at index (i, j, k)
+   */
+  std::shared_ptr<RingGSWCiphertext> GetCiphertext(uint32_t i, uint32_t j,
+                                                   uint32_t k) const {
+    uint32_t N = GetRingDimension();
+    const NativeInteger* src = GetCiphertextData(i, j, k);
+    auto ct = std::make_shared<RingGSWCiphertext>(m_rows, m_cols);
+    for (uint32_t l = 0; l < m_rows; l++) {
+      for (uint32_t c = 0; c < m_cols; c++, src += N) {
+        NativeVector values(N, m_polyParams->GetModulus());
+        for (uint32_t x = 0; x < N; x++) values[x] = src[x];
+        (*ct)[l][c] = NativePoly(m_polyParams, EVALUATION, false);
+        (*ct)[l][c].SetValues(std::move(values), EVALUATION);
+      }
+    }
+    return ct;
+  }
+
+  /**
+   * Builds the refreshing key as a vector of RingGSW ciphertexts (the layout
+   * used before the key was flattened); entries that were never set are
+   * returned as empty ciphertexts
+   */
+  std::vector<std::vector<std::vector<RingGSWCiphertext>>> GetElements()
       const {
-    return m_key;
+    std::vector<std::vector<std::vector<RingGSWCiphertext>>> key(m_dim1);
+    for (uint32_t i = 0; i < m_dim1; i++) {
+      key[i].resize(m_dim2);
+      for (uint32_t j = 0; j < m_dim2; j++) {
+        key[i][j].resize(m_dim3);
+        for (uint32_t k = 0; k < m_dim3; k++) {
+          if (IsSet(i, j, k)) key[i][j][k] = *GetCiphertext(i, j, k);
+        }
+      }
+    }
+    return key;
   }
 
   void SetElements(
       const std::vector<std::vector<std::vector<RingGSWCiphertext>>>& key) {
-    m_key = key;
+    uint32_t dim1 = key.size();
+    uint32_t dim2 = (dim1 > 0) ? key[0].size() : 0;
+    uint32_t dim3 = (dim2 > 0) ? key[0][0].size() : 0;
+    // the dimensions of the ciphertexts are taken from the first non-empty one
+    const RingGSWCiphertext* first = nullptr;
+    for (uint32_t i = 0; i < dim1 && first == nullptr; i++)
+      for (uint32_t j = 0; j < dim2 && first == nullptr; j++)
+        for (uint32_t k = 0; k < dim3 && first == nullptr; k++)
+          if (!key[i][j][k].GetElements().empty()) first = &key[i][j][k];
+    if (first == nullptr) {
+      Allocate(0, 0, 0, 0, 0, nullptr);
+      return;
+    }
+    Allocate(dim1, dim2, dim3, first->GetElements().size(),
+             (*first)[0].size(), (*first)[0][0].GetParams());
+    for (uint32_t i = 0; i < dim1; i++)
+      for (uint32_t j = 0; j < dim2; j++)
+        for (uint32_t k = 0; k < dim3; k++)
+          if (!key[i][j][k].GetElements().empty())
+            SetCiphertext(i, j, k, key[i][j][k]);
   }
 
-  std::vector<std::vector<RingGSWCiphertext>>& operator[](uint32_t i) {
-    return m_key[i];
+  uint32_t GetDim1() const { return m_dim1; }
+
+  uint32_t GetDim2() const { return m_dim2; }
+
+  uint32_t GetDim3() const { return m_dim3; }
+
+  uint32_t GetRows() const { return m_rows; }
+
+  uint32_t GetCols() const { return m_cols; }
+
+  uint32_t GetRingDimension() const {
+    return (m_polyParams == nullptr) ? 0 : m_polyParams->GetRingDimension();
+  }
+
+  const shared_ptr<ILNativeParams> GetPolyParams() const {
+    return m_polyParams;
   }
 
-  const std::vector<std::vector<RingGSWCiphertext>>& operator[](usint i) const {
-    return m_key[i];
+  /**
+   * @return the flat buffer of all coefficients
+   */
+  const NativeInteger* GetData() const { return m_data; }
+
+  /**
+   * @return one byte per ciphertext, in the order of GetCiphertextData,
+   * that is nonzero if the ciphertext was set
+   */
+  const uint8_t* GetSetFlags() const { return m_isSet; }
+
+  /**
+   * @return the number of RingGSW ciphertexts
+   */
+  size_t GetCount() const { return (size_t)m_dim1 * m_dim2 * m_dim3; }
+
+  /**
+   * @return the number of coefficients in the flat buffer
+   */
+  size_t GetSize() const {
+    return (size_t)m_dim1 * m_dim2 * m_dim3 * m_rows * m_cols *
+           GetRingDimension();
   }
 
   bool operator==(const RingGSWBTKey& other) const {
-    return m_key == other.m_key;
+    return m_dim1 == other.m_dim1 && m_dim2 == other.m_dim2 &&
+           m_dim3 == other.m_dim3 && m_rows == other.m_rows &&
+           m_cols == other.m_cols &&
+           GetRingDimension() == other.GetRingDimension() &&
+           (GetSize() == 0 ||
+            (m_polyParams->GetModulus() == other.m_polyParams->GetModulus() &&
+             std::memcmp(m_data, other.m_data,
+                         GetSize() * sizeof(NativeInteger)) == 0 &&
+             std::memcmp(m_isSet, other.m_isSet, GetCount()) == 0));
   }
 
   bool operator!=(const RingGSWBTKey& other) const { return !(*this == other); }
 
   template <class Archive>
   void save(Archive& ar, std::uint32_t const version) const {
-    ar(::cereal::make_nvp("key", m_key));
+    ar(::cereal::make_nvp("key", GetElements()));
   }
 
   template <class Archive>
@@ -410,14 +656,70 @@ class RingGSWBTKey : public Serializable {
                      "serialized object version " + std::to_string(version) +
                          " is from a later version of the library");
     };
-    ar(::cereal::make_nvp("key", m_key));
+    std::vector<std::vector<std::vector<RingGSWCiphertext>>> key;
+    ar(::cereal::make_nvp("key", key));
+    SetElements(key);
   }
 
   std::string SerializedObjectName() const { return "RingGSWBTKey"; }
   static uint32_t SerializedVersion() { return 1; }
 
  private:
-  std::vector<std::vector<std::vector<RingGSWCiphertext>>> m_key;
+  size_t Index(uint32_t i, uint32_t j, uint32_t k) const {
+    return ((size_t)i * m_dim2 + j) * m_dim3 + k;
+  }
+
+  void CopyLayout(const RingGSWBTKey& rhs) {
+    m_dim1 = rhs.m_dim1;
+    m_dim2 = rhs.m_dim2;
+    m_dim3 = rhs.m_dim3;
+    m_rows = rhs.m_rows;
+    m_cols = rhs.m_cols;
+    m_polyParams = rhs.m_polyParams;
+  }
+
+  void Allocate(uint32_t dim1, uint32_t dim2, uint32_t dim3, uint32_t rows,
+                uint32_t cols, const shared_ptr<ILNativeParams> polyParams) {
+    m_dim1 = dim1;
+    m_dim2 = dim2;
+    m_dim3 = dim3;
+    m_rows = rows;
+    m_cols = cols;
+    m_polyParams = polyParams;
+    m_readOnly = false;
+    if (GetSize() == 0) {
+      m_storage.reset();
+      m_data = nullptr;
+      m_isSet = nullptr;
+      return;
+    }
+    // the flags of the ciphertexts follow the coefficients
+    size_t dataBytes = GetSize() * sizeof(NativeInteger);
+    std::shared_ptr<AlignedSlab> slab =
+        std::make_shared<AlignedSlab>(1, dataBytes + GetCount());
+    std::memset(slab->GetData(), 0, dataBytes + GetCount());
+    m_data = reinterpret_cast<NativeInteger*>(slab->GetData());
+    m_isSet = reinterpret_cast<uint8_t*>(slab->GetData() + dataBytes);
+    m_storage = slab;
+  }
+
+  // dimensions of the array of RingGSW ciphertexts
+  uint32_t m_dim1;
+  uint32_t m_dim2;
+  uint32_t m_dim3;
+  // dimensions of each RingGSW ciphertext
+  uint32_t m_rows;
+  uint32_t m_cols;
+  // parameters of the polynomials
+  shared_ptr<ILNativeParams> m_polyParams;
+  // owner of the flat buffer (an aligned slab or a memory mapping)
+  std::shared_ptr<const void> m_storage;
+  // flat buffer holding all coefficients
+  NativeInteger* m_data;
+  // one byte per ciphertext, nonzero if it was set
+  uint8_t* m_isSet;
+  // true if the buffer is not owned by the key (e.g., memory-mapped)
+  bool m_readOnly;
 };
 
 // The struct for storing bootstrapping keys
@@ -26,8 +26,98 @@
  */
 #include "binfhecontext.h"
 
+#include <cstring>
+#include <fstream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace lbcrypto {
 
+namespace {
+
+const char BTKEY_MAGIC[8] = {'P', 'A', 'L', 'B', 'T', 'K', 'E', 'Y'};
+const uint32_t BTKEY_VERSION = 1;
+const uint64_t BTKEY_ENDIANNESS = 0x0102030405060708ULL;
+
+// header of the binary bootstrapping key format; the refreshing key, the
+// switching key and the flags of the set refreshing key entries follow at
+// 64-byte aligned offsets
+struct BTKeyFileHeader {
+  char magic[8];
+  uint32_t version;
+  // size of a coefficient of the refreshing key in bytes
+  uint32_t wordSize;
+  uint64_t endianness;
+  // refreshing key
+  uint32_t bsDim1;
+  uint32_t bsDim2;
+  uint32_t bsDim3;
+  uint32_t bsRows;
+  uint32_t bsCols;
+  uint32_t ringDim;
+  uint64_t Q;
+  uint64_t bsOffset;
+  uint64_t bsBytes;
+  // switching key
+  uint32_t ksN;
+  uint32_t ksBaseKS;
+  uint32_t ksExpKS;
+  uint32_t ksn;
+  uint32_t ksRowSize;
+  uint32_t reserved;
+  uint64_t ksModulus;
+  uint64_t ksOffset;
+  uint64_t ksBytes;
+  // one byte per RingGSW ciphertext of the refreshing key
+  uint64_t setOffset;
+  uint64_t setBytes;
+};
+
+// maps a file read-only (or reads it into an aligned buffer where memory
+// mapping is not available); storage owns the mapping
+bool MapFile(const std::string &filename, std::shared_ptr<const void> *storage,
+             const char **data, size_t *size) {
+#ifndef _WIN32
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) return false;
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size == 0) {
+    close(fd);
+    return false;
+  }
+  size_t fileSize = st.st_size;
+  void *addr = mmap(nullptr, fileSize, PROT_READ, MAP_SHARED, fd, 0);
+  // the mapping stays valid after the descriptor is closed
+  close(fd);
+  if (addr == MAP_FAILED) return false;
+  *storage = std::shared_ptr<const void>(addr, [fileSize](const void *p) {
+    munmap(const_cast<void *>(p), fileSize);
+  });
+  *data = static_cast<const char *>(addr);
+  *size = fileSize;
+#else
+  std::ifstream in(filename, std::ios::binary | std::ios::ate);
+  if (!in.is_open()) return false;
+  size_t fileSize = in.tellg();
+  in.seekg(0);
+  std::shared_ptr<AlignedSlab> slab =
+      std::make_shared<AlignedSlab>(1, fileSize);
+  in.read(slab->GetData(), fileSize);
+  if (in.fail()) return false;
+  *data = slab->GetData();
+  *size = fileSize;
+  *storage = slab;
+#endif
+  return true;
+}
+
+}  // namespace
+
 void BinFHEContext::GenerateBinFHEContext(uint32_t n, uint32_t N,
                                           const NativeInteger &q,
                                           const NativeInteger &Q, double std,
@@ -123,13 +213,16 @@ LWEPrivateKey BinFHEContext::KeyGenN() const {
 }
 
 LWECiphertext BinFHEContext::Encrypt(ConstLWEPrivateKey sk,
-                                     const LWEPlaintext &m) const {
-  return m_LWEscheme->Encrypt(m_params->GetLWEParams(), sk, m);
+                                     const LWEPlaintext &m,
+                                     const LWEPlaintextModulus &p,
+                                     const NativeInteger &mod) const {
+  return m_LWEscheme->Encrypt(m_params->GetLWEParams(), sk, m, p, mod);
 }
 
 void BinFHEContext::Decrypt(ConstLWEPrivateKey sk, ConstLWECiphertext ct,
-                            LWEPlaintext *result) const {
-  return m_LWEscheme->Decrypt(m_params->GetLWEParams(), sk, ct, result);
+                            LWEPlaintext *result,
+                            const LWEPlaintextModulus &p) const {
+  return m_LWEscheme->Decrypt(m_params->GetLWEParams(), sk, ct, result, p);
 }
 
 std::shared_ptr<LWESwitchingKey> BinFHEContext::KeySwitchGen(
@@ -142,6 +235,186 @@ void BinFHEContext::BTKeyGen(ConstLWEPrivateKey sk) {
   return;
 }
 
+bool BinFHEContext::BTKeySaveBinary(const std::string &filename) const {
+  if (m_BTKey.BSkey == nullptr || m_BTKey.KSkey == nullptr)
+    PALISADE_THROW(config_error, "Bootstrapping keys have not been generated");
+
+  const RingGSWBTKey &bsKey = *m_BTKey.BSkey;
+  const LWESwitchingKey &ksKey = *m_BTKey.KSkey;
+
+  BTKeyFileHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, BTKEY_MAGIC, sizeof(header.magic));
+  header.version = BTKEY_VERSION;
+  header.wordSize = sizeof(NativeInteger);
+  header.endianness = BTKEY_ENDIANNESS;
+  header.bsDim1 = bsKey.GetDim1();
+  header.bsDim2 = bsKey.GetDim2();
+  header.bsDim3 = bsKey.GetDim3();
+  header.bsRows = bsKey.GetRows();
+  header.bsCols = bsKey.GetCols();
+  header.ringDim = bsKey.GetRingDimension();
+  header.Q = bsKey.GetPolyParams()->GetModulus().ConvertToInt();
+  header.bsOffset = AlignedSlab::RegionSize(sizeof(header));
+  header.bsBytes = bsKey.GetSize() * sizeof(NativeInteger);
+  header.ksN = ksKey.GetN();
+  header.ksBaseKS = ksKey.GetBaseKS();
+  header.ksExpKS = ksKey.GetExpKS();
+  header.ksn = ksKey.Getn();
+  header.ksRowSize = ksKey.GetRowSize();
+  header.ksModulus = ksKey.GetModulus().ConvertToInt();
+  header.ksOffset = header.bsOffset + AlignedSlab::RegionSize(header.bsBytes);
+  header.ksBytes = ksKey.GetSize() * sizeof(uint64_t);
+  header.setOffset = header.ksOffset + AlignedSlab::RegionSize(header.ksBytes);
+  header.setBytes = bsKey.GetCount();
+
+  std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+  if (!out.is_open()) return false;
+
+  const char zeros[AlignedSlab::ALIGNMENT] = {};
+  out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  out.write(zeros, header.bsOffset - sizeof(header));
+  out.write(reinterpret_cast<const char *>(bsKey.GetData()), header.bsBytes);
+  out.write(zeros, header.ksOffset - header.bsOffset - header.bsBytes);
+  out.write(reinterpret_cast<const char *>(ksKey.GetData()), header.ksBytes);
+  out.write(zeros, header.setOffset - header.ksOffset - header.ksBytes);
+  out.write(reinterpret_cast<const char *>(bsKey.GetSetFlags()),
+            header.setBytes);
+  out.close();
+
+  return !out.fail();
+}
+
+bool BinFHEContext::BTKeyLoadBinary(const std::string &filename) {
+  if (m_params == nullptr)
+    PALISADE_THROW(config_error, "The crypto context has not been generated");
+
+  std::shared_ptr<const void> storage;
+  const char *file = nullptr;
+  size_t fileSize = 0;
+  if (!MapFile(filename, &storage, &file, &fileSize)) return false;
+
+  BTKeyFileHeader header;
+  if (fileSize < sizeof(header))
+    PALISADE_THROW(deserialize_error, "Bootstrapping key file is truncated");
+  std::memcpy(&header, file, sizeof(header));
+
+  if (std::memcmp(header.magic, BTKEY_MAGIC, sizeof(header.magic)) != 0)
+    PALISADE_THROW(deserialize_error,
+                   "File is not a binary bootstrapping key file");
+  if (header.version > BTKEY_VERSION)
+    PALISADE_THROW(deserialize_error,
+                   "Bootstrapping key file version " +
+                       std::to_string(header.version) +
+                       " is from a later version of the library");
+  if (header.endianness != BTKEY_ENDIANNESS ||
+      header.wordSize != sizeof(NativeInteger))
+    PALISADE_THROW(deserialize_error,
+                   "Bootstrapping key file was written on a platform with a "
+                   "different word size or byte order");
+  // written so that crafted offsets and sizes cannot wrap around
+  if (header.bsOffset % AlignedSlab::ALIGNMENT != 0 ||
+      header.ksOffset % AlignedSlab::ALIGNMENT != 0 ||
+      header.bsOffset > fileSize ||
+      header.bsBytes > fileSize - header.bsOffset ||
+      header.ksOffset > fileSize ||
+      header.ksBytes > fileSize - header.ksOffset ||
+      header.setOffset > fileSize ||
+      header.setBytes > fileSize - header.setOffset)
+    PALISADE_THROW(deserialize_error, "Bootstrapping key file is truncated");
+
+  const std::shared_ptr<LWECryptoParams> lweParams = m_params->GetLWEParams();
+  uint32_t N = lweParams->GetN();
+  uint32_t n = lweParams->Getn();
+  const NativeInteger &Q = lweParams->GetQ();
+
+  uint32_t dim1 = 1, dim2 = 2, dim3 = n;
+  if (m_params->GetMethod() == AP) {
+    dim1 = n;
+    dim2 = m_params->GetBaseR();
+    dim3 = m_params->GetDigitsR().size();
+  }
+
+  if (header.ringDim != N || header.Q != Q.ConvertToInt() ||
+      header.bsDim1 != dim1 || header.bsDim2 != dim2 ||
+      header.bsDim3 != dim3 || header.bsRows != m_params->GetDigitsG2() ||
+      header.bsCols != 2)
+    PALISADE_THROW(config_error,
+                   "The refreshing key in the file does not match the "
+                   "parameters of the crypto context");
+
+  if ((size_t)dim1 * dim2 * dim3 * header.bsRows * header.bsCols * N *
+          sizeof(NativeInteger) !=
+      header.bsBytes ||
+      (size_t)dim1 * dim2 * dim3 != header.setBytes)
+    PALISADE_THROW(deserialize_error,
+                   "Unexpected size of the refreshing key in the file");
+
+  // the key switching reads expKS digits and rows of RowSize(n) words, so
+  // both are checked before the key is built over the mapping
+  if (header.ksN != N || header.ksn != n ||
+      header.ksBaseKS != lweParams->GetBaseKS() ||
+      header.ksExpKS != lweParams->GetDigitsKS().size() ||
+      header.ksRowSize != LWESwitchingKey::RowSize(n) ||
+      header.ksModulus != Q.ConvertToInt())
+    PALISADE_THROW(config_error,
+                   "The switching key in the file does not match the "
+                   "parameters of the crypto context");
+  if ((size_t)N * header.ksExpKS * header.ksBaseKS * header.ksRowSize *
+          sizeof(uint64_t) !=
+      header.ksBytes)
+    PALISADE_THROW(deserialize_error,
+                   "Unexpected size of the switching key in the file");
+
+  auto bsKey = std::make_shared<RingGSWBTKey>(
+      dim1, dim2, dim3, header.bsRows, header.bsCols,
+      m_params->GetPolyParams(), storage,
+      reinterpret_cast<const NativeInteger *>(file + header.bsOffset),
+      reinterpret_cast<const uint8_t *>(file + header.setOffset));
+  auto ksKey = std::make_shared<LWESwitchingKey>(
+      header.ksN, header.ksBaseKS, header.ksExpKS, header.ksn,
+      NativeInteger(header.ksModulus), storage,
+      reinterpret_cast<const uint64_t *>(file + header.ksOffset));
+
+  m_BTKey.BSkey = bsKey;
+  m_BTKey.KSkey = ksKey;
+
+  return true;
+}
+
+bool BinFHEContext::CiphertextBatchSaveBinary(
+    const std::vector<LWECiphertext> &cts, const std::string &filename) const {
+  LWECiphertextBatch batch(cts);
+
+  std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+  if (!out.is_open()) return false;
+  batch.Save(out);
+  out.close();
+
+  return !out.fail();
+}
+
+bool BinFHEContext::CiphertextBatchLoadBinary(
+    const std::string &filename, LWECiphertextBatch *batch) const {
+  if (m_params == nullptr)
+    PALISADE_THROW(config_error, "The crypto context has not been generated");
+
+  std::shared_ptr<const void> storage;
+  const char *file = nullptr;
+  size_t fileSize = 0;
+  if (!MapFile(filename, &storage, &file, &fileSize)) return false;
+
+  LWECiphertextBatch mapped(storage, file, fileSize);
+  if (mapped.GetCount() > 0 &&
+      mapped.Getn() != m_params->GetLWEParams()->Getn())
+    PALISADE_THROW(config_error,
+                   "The dimension of the ciphertexts in the batch does not "
+                   "match the crypto context");
+  *batch = mapped;
+
+  return true;
+}
+
 LWECiphertext BinFHEContext::EvalBinGate(const BINGATE gate,
                                          ConstLWECiphertext ct1,
                                          ConstLWECiphertext ct2) const {
@@ -149,8 +422,47 @@ LWECiphertext BinFHEContext::EvalBinGate(const BINGATE gate,
                                       m_LWEscheme);
 }
 
+LWECiphertext BinFHEContext::EvalBinGate(
+    const BINGATE gate, const std::vector<LWECiphertext> &cts) const {
+  return m_RingGSWscheme->EvalBinGate(m_params, gate, m_BTKey, cts,
+                                      m_LWEscheme);
+}
+
+LWECiphertext BinFHEContext::EvalWeightedSum(
+    const std::vector<LWECiphertext> &cts,
+    const std::vector<int64_t> &weights) const {
+  return m_LWEscheme->EvalWeightedSum(cts, weights);
+}
+
+LWECiphertext BinFHEContext::EvalThreshold(
+    const std::vector<LWECiphertext> &cts, const std::vector<int64_t> &weights,
+    int64_t threshold, const LWEPlaintextModulus &p) const {
+  return m_RingGSWscheme->EvalThreshold(m_params, m_BTKey, cts, weights,
+                                        threshold, p, m_LWEscheme);
+}
+
+std::vector<LWECiphertext> BinFHEContext::EvalBinGateBatch(
+    const std::vector<BINGATE> &gates, const std::vector<LWECiphertext> &ct1s,
+    const std::vector<LWECiphertext> &ct2s) const {
+  return m_RingGSWscheme->EvalBinGateBatch(m_params, gates, m_BTKey, ct1s,
+                                           ct2s, m_LWEscheme);
+}
+
 LWECiphertext BinFHEContext::EvalNOT(ConstLWECiphertext ct) const {
   return m_RingGSWscheme->EvalNOT(m_params, ct);
 }
 
+LWECiphertext BinFHEContext::EvalFunc(
+    ConstLWECiphertext ct, const std::vector<NativeInteger> &LUT) const {
+  return m_RingGSWscheme->EvalFunc(m_params, m_BTKey, ct, LUT, m_LWEscheme);
+}
+
+LWECiphertext BinFHEContext::EvalFloor(ConstLWECiphertext ct) const {
+  return m_RingGSWscheme->EvalFloor(m_params, m_BTKey, ct, m_LWEscheme);
+}
+
+LWECiphertext BinFHEContext::EvalSign(ConstLWECiphertext ct) const {
+  return m_RingGSWscheme->EvalSign(m_params, m_BTKey, ct, m_LWEscheme);
+}
+
 }  // namespace lbcrypto
@@ -36,10 +36,69 @@
  *
  */
 
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
 #include "fhew.h"
 
 namespace lbcrypto {
 
+namespace {
+
+// Computes prod = sum_l dct[l] * key[l][j], i.e., column j of the product of
+// the decomposed accumulator with a RingGSW ciphertext of the refreshing key.
+// For small moduli (digitsG2 * Q^2 < 2^64, i.e., STD128, STD128Q, STD256 and
+// STD256Q among the predefined parameter sets) the residues fit in 32 bits:
+// their products are summed in 64 bits without any reduction and reduced once
+// per coefficient. The 31-bit and larger Q of TOY, MEDIUM, STD192 and STD192Q
+// use the per-digit modular reduction.
+void KeyProduct(const std::vector<NativePoly> &dct, const NativeInteger *key,
+                uint32_t j, uint32_t N, const NativeInteger &Q,
+                const NativeInteger &mu, NativeInteger *prod) {
+  uint32_t digitsG2 = dct.size();
+
+  if (2 * Q.GetMSB() + GetMSB64(digitsG2) > 64) {
+    const NativeVector &dct0 = dct[0].GetValues();
+    const NativeInteger *key0 = key + j * N;
+    for (uint32_t k = 0; k < N; k++)
+      prod[k] = dct0[k].ModMulFast(key0[k], Q, mu);
+    for (uint32_t l = 1; l < digitsG2; l++) {
+      const NativeVector &dctl = dct[l].GetValues();
+      const NativeInteger *keyl = key + (2 * l + j) * N;
+      for (uint32_t k = 0; k < N; k++)
+        prod[k].ModAddFastEq(dctl[k].ModMulFast(keyl[k], Q, mu), Q);
+    }
+    return;
+  }
+
+  // the 32-bit casts let the compiler use 32x32->64-bit vector multiplies
+  uint64_t *sum = reinterpret_cast<uint64_t *>(prod);
+  const uint64_t *dct0 = reinterpret_cast<const uint64_t *>(&dct[0][0]);
+  const uint64_t *key0 = reinterpret_cast<const uint64_t *>(key + j * N);
+  for (uint32_t k = 0; k < N; k++)
+    sum[k] = uint64_t(uint32_t(dct0[k])) * uint32_t(key0[k]);
+  for (uint32_t l = 1; l < digitsG2; l++) {
+    const uint64_t *dctl = reinterpret_cast<const uint64_t *>(&dct[l][0]);
+    const uint64_t *keyl =
+        reinterpret_cast<const uint64_t *>(key + (2 * l + j) * N);
+    for (uint32_t k = 0; k < N; k++)
+      sum[k] += uint64_t(uint32_t(dctl[k])) * uint32_t(keyl[k]);
+  }
+
+  // Barrett reduction with floor(2^64 / Q); the quotient estimate is at most
+  // one too small, so one conditional subtraction is enough
+  uint64_t q = Q.ConvertToInt();
+  uint64_t ratio = uint64_t((DoubleNativeInt(1) << 64) / q);
+  for (uint32_t k = 0; k < N; k++) {
+    uint64_t hi = uint64_t((DoubleNativeInt(sum[k]) * ratio) >> 64);
+    uint64_t r = sum[k] - hi * q;
+    sum[k] = (r >= q) ? r - q : r;
+  }
+}
+
+}  // namespace
+
 // Encryption as described in Section 5 of https://eprint.iacr.org/2014/816
 std::shared_ptr<RingGSWCiphertext> RingGSWAccumulatorScheme::EncryptAP(
     const std::shared_ptr<RingGSWCryptoParams> params, const NativePoly &skNTT,
@@ -178,7 +237,9 @@ RingGSWEvalKey RingGSWAccumulatorScheme::KeyGenAP(
   uint32_t baseR = params->GetBaseR();
   std::vector<NativeInteger> digitsR = params->GetDigitsR();
 
-  ek.BSkey = std::make_shared<RingGSWBTKey>(n, baseR, digitsR.size());
+  ek.BSkey = std::make_shared<RingGSWBTKey>(n, baseR, digitsR.size(),
+                                            params->GetDigitsG2(), 2,
+                                            params->GetPolyParams());
 
   NativeInteger qHalf = q >> 1;
 
@@ -191,9 +252,11 @@ RingGSWEvalKey RingGSWAccumulatorScheme::KeyGenAP(
           signedSK = LWEsk->GetElement()[i].ConvertToInt();
         else
           signedSK = (int32_t)LWEsk->GetElement()[i].ConvertToInt() - qInt;
-        (*ek.BSkey)[i][j][k] = *(EncryptAP(
-            params, skNPoly,
-            signedSK * (int32_t)j * (int32_t)digitsR[k].ConvertToInt()));
+        ek.BSkey->SetCiphertext(
+            i, j, k,
+            *(EncryptAP(params, skNPoly,
+                        signedSK * (int32_t)j *
+                            (int32_t)digitsR[k].ConvertToInt())));
       }
 
   return ek;
@@ -219,7 +282,8 @@ RingGSWEvalKey RingGSWAccumulatorScheme::KeyGenGINX(
   uint64_t q = params->GetLWEParams()->Getq().ConvertToInt();
   uint32_t n = params->GetLWEParams()->Getn();
 
-  ek.BSkey = std::make_shared<RingGSWBTKey>(1, 2, n);
+  ek.BSkey = std::make_shared<RingGSWBTKey>(
+      1, 2, n, params->GetDigitsG2(), 2, params->GetPolyParams());
 
   uint64_t qHalf = (q >> 1);
 
@@ -231,16 +295,16 @@ RingGSWEvalKey RingGSWAccumulatorScheme::KeyGenGINX(
     if (s > (int64_t)qHalf) s = s - q;
     switch (s) {
       case 0:
-        (*ek.BSkey)[0][0][i] = *(EncryptGINX(params, skNPoly, 0));
-        (*ek.BSkey)[0][1][i] = *(EncryptGINX(params, skNPoly, 0));
+        ek.BSkey->SetCiphertext(0, 0, i, *(EncryptGINX(params, skNPoly, 0)));
+        ek.BSkey->SetCiphertext(0, 1, i, *(EncryptGINX(params, skNPoly, 0)));
         break;
       case 1:
-        (*ek.BSkey)[0][0][i] = *(EncryptGINX(params, skNPoly, 1));
-        (*ek.BSkey)[0][1][i] = *(EncryptGINX(params, skNPoly, 0));
+        ek.BSkey->SetCiphertext(0, 0, i, *(EncryptGINX(params, skNPoly, 1)));
+        ek.BSkey->SetCiphertext(0, 1, i, *(EncryptGINX(params, skNPoly, 0)));
         break;
       case -1:
-        (*ek.BSkey)[0][0][i] = *(EncryptGINX(params, skNPoly, 0));
-        (*ek.BSkey)[0][1][i] = *(EncryptGINX(params, skNPoly, 1));
+        ek.BSkey->SetCiphertext(0, 0, i, *(EncryptGINX(params, skNPoly, 0)));
+        ek.BSkey->SetCiphertext(0, 1, i, *(EncryptGINX(params, skNPoly, 1)));
         break;
       default:
         std::string errMsg =
@@ -269,8 +333,9 @@ void RingGSWAccumulatorScheme::SignedDigitDecompose(
 
   // Signed digit decomposition
   for (uint32_t j = 0; j < 2; j++) {
+    const NativeVector &inputj = input[j].GetValues();
     for (uint32_t k = 0; k < N; k++) {
-      NativeInteger t = input[j][k];
+      const NativeInteger &t = inputj[k];
       if (t < QHalf)
         d += t.ConvertToInt();
       else
@@ -285,32 +350,38 @@ void RingGSWAccumulatorScheme::SignedDigitDecompose(
         d >>= gBits;
 
         if (r >= 0)
-          (*output)[j + 2 * l][k] += NativeInteger(r);
+          (*output)[j + 2 * l][k] = NativeInteger(r);
         else
-          (*output)[j + 2 * l][k] +=
+          (*output)[j + 2 * l][k] =
               NativeInteger((int64_t)r + (int64_t)Q.ConvertToInt());
       }
     }
   }
+
+  // the output polynomials may be reused scratch space that was left in the
+  // EVALUATION representation; all their values are now coefficients
+  for (uint32_t i = 0; i < output->size(); i++)
+    (*output)[i].OverrideFormat(COEFFICIENT);
 }
 
 // AP Accumulation as described in "Bootstrapping in FHEW-like Cryptosystems"
 void RingGSWAccumulatorScheme::AddToACCAP(
     const std::shared_ptr<RingGSWCryptoParams> params,
-    const RingGSWCiphertext &input,
-    std::shared_ptr<RingGSWCiphertext> acc) const {
+    const NativeInteger *input, std::shared_ptr<RingGSWCiphertext> acc,
+    RingGSWACCScratch *scratch) const {
+  uint32_t N = params->GetLWEParams()->GetN();
   uint32_t digitsG2 = params->GetDigitsG2();
-  const shared_ptr<ILNativeParams> polyParams = params->GetPolyParams();
-
-  std::vector<NativePoly> ct = acc->GetElements()[0];
-  std::vector<NativePoly> dct(digitsG2);
+  NativeInteger Q = params->GetLWEParams()->GetQ();
+  NativeInteger mu = Q.ComputeMu();
 
-  // initialize dct to zeros
-  for (uint32_t i = 0; i < digitsG2; i++)
-    dct[i] = NativePoly(polyParams, COEFFICIENT, true);
+  std::vector<NativePoly> &ct = scratch->ct;
+  std::vector<NativePoly> &dct = scratch->dct;
 
-  // calls 2 NTTs
-  for (uint32_t i = 0; i < 2; i++) ct[i].SetFormat(COEFFICIENT);
+  // calls 2 NTTs; the copies reuse the memory of the scratch polynomials
+  for (uint32_t i = 0; i < 2; i++) {
+    ct[i] = (*acc)[0][i];
+    ct[i].SetFormat(COEFFICIENT);
+  }
 
   SignedDigitDecompose(params, ct, &dct);
 
@@ -318,58 +389,96 @@ void RingGSWAccumulatorScheme::AddToACCAP(
   for (uint32_t j = 0; j < digitsG2; j++) dct[j].SetFormat(EVALUATION);
 
   // acc = dct * input (matrix product);
-  // uses in-place * operators for the last call to dct[i] to gain performance
-  // improvement
-  for (uint32_t j = 0; j < 2; j++) {
-    (*acc)[0][j].SetValuesToZero();
-    for (uint32_t l = 0; l < digitsG2; l++) {
-      if (j < 1)
-        (*acc)[0][j] += dct[l] * input[l][j];
-      else
-        (*acc)[0][j] += (dct[l] *= input[l][j]);
-    }
-  }
+  // the products are accumulated directly in the accumulator
+  for (uint32_t j = 0; j < 2; j++)
+    KeyProduct(dct, input, j, N, Q, mu, &(*acc)[0][j][0]);
 }
 
 // GINX Accumulation as described in "Bootstrapping in FHEW-like Cryptosystems"
 void RingGSWAccumulatorScheme::AddToACCGINX(
     const std::shared_ptr<RingGSWCryptoParams> params,
-    const RingGSWCiphertext &input, const NativeInteger &a,
-    std::shared_ptr<RingGSWCiphertext> acc) const {
+    const NativeInteger *input, const NativeInteger &a,
+    std::shared_ptr<RingGSWCiphertext> acc, RingGSWACCScratch *scratch) const {
   uint32_t N = params->GetLWEParams()->GetN();
   uint32_t digitsG2 = params->GetDigitsG2();
   int64_t q = params->GetLWEParams()->Getq().ConvertToInt();
-  const shared_ptr<ILNativeParams> polyParams = params->GetPolyParams();
-
-  std::vector<NativePoly> ct = acc->GetElements()[0];
-  std::vector<NativePoly> dct(digitsG2);
+  NativeInteger Q = params->GetLWEParams()->GetQ();
+  NativeInteger mu = Q.ComputeMu();
 
-  // initialize dct to zeros
-  for (uint32_t i = 0; i < digitsG2; i++)
-    dct[i] = NativePoly(polyParams, COEFFICIENT, true);
+  std::vector<NativePoly> &ct = scratch->ct;
+  std::vector<NativePoly> &dct = scratch->dct;
 
-  // calls 2 NTTs
-  for (uint32_t i = 0; i < 2; i++) ct[i].SetFormat(COEFFICIENT);
+  // calls 2 NTTs; the copies reuse the memory of the scratch polynomials
+  for (uint32_t i = 0; i < 2; i++) {
+    ct[i] = (*acc)[0][i];
+    ct[i].SetFormat(COEFFICIENT);
+  }
 
   SignedDigitDecompose(params, ct, &dct);
 
   for (uint32_t j = 0; j < digitsG2; j++) dct[j].SetFormat(EVALUATION);
 
   uint64_t mm = a.ConvertToInt() * (2 * N / q);
-  const NativePoly &monomial = params->GetMonomial(mm);
+  const NativeVector &monomial = params->GetMonomial(mm).GetValues();
 
-  // acc = dct * input (matrix product);
-  // uses in-place * operators for the last call to dct[i] to gain performance
-  // improvement
+  // acc += (dct * input) * monomial (matrix product);
+  // ct is not needed after the decomposition, so its memory holds the product
   for (uint32_t j = 0; j < 2; j++) {
-    NativePoly temp1 = (j < 1) ? dct[0] * input[0][j] : (dct[0] *= input[0][j]);
-    for (uint32_t l = 1; l < digitsG2; l++) {
-      if (j < 1)
-        temp1 += dct[l] * input[l][j];
-      else
-        temp1 += (dct[l] *= input[l][j]);
+    NativeInteger *prod = &ct[j][0];
+    KeyProduct(dct, input, j, N, Q, mu, prod);
+    NativeInteger *accj = &(*acc)[0][j][0];
+    for (uint32_t k = 0; k < N; k++)
+      accj[k].ModAddFastEq(prod[k].ModMulFast(monomial[k], Q, mu), Q);
+  }
+}
+
+// The external product is linear in the RingGSW ciphertext, so the
+// decomposition of acc is shared by the products with both keys; at most one
+// of the keys encrypts 1, hence adding both updates to the old acc matches
+// the two sequential updates
+void RingGSWAccumulatorScheme::AddToACCGINXFused(
+    const std::shared_ptr<RingGSWCryptoParams> params,
+    const NativeInteger *input0, const NativeInteger *input1,
+    const NativeInteger &a, std::shared_ptr<RingGSWCiphertext> acc,
+    RingGSWACCScratch *scratch) const {
+  uint32_t N = params->GetLWEParams()->GetN();
+  uint32_t digitsG2 = params->GetDigitsG2();
+  int64_t q = params->GetLWEParams()->Getq().ConvertToInt();
+  NativeInteger Q = params->GetLWEParams()->GetQ();
+  NativeInteger mu = Q.ComputeMu();
+
+  std::vector<NativePoly> &ct = scratch->ct;
+  std::vector<NativePoly> &dct = scratch->dct;
+
+  // calls 2 NTTs; the copies reuse the memory of the scratch polynomials
+  for (uint32_t i = 0; i < 2; i++) {
+    ct[i] = (*acc)[0][i];
+    ct[i].SetFormat(COEFFICIENT);
+  }
+
+  SignedDigitDecompose(params, ct, &dct);
+
+  for (uint32_t j = 0; j < digitsG2; j++) dct[j].SetFormat(EVALUATION);
+
+  // X^{-a} - 1 for the first key and X^a - 1 for the second one
+  uint64_t factor = 2 * N / q;
+  uint64_t aInt = a.ConvertToInt();
+  const NativeVector *monomial[2] = {
+      &params->GetMonomial(((q - aInt) % q) * factor).GetValues(),
+      &params->GetMonomial(aInt * factor).GetValues()};
+  const NativeInteger *input[2] = {input0, input1};
+
+  // acc += (dct * input[t]) * monomial[t] for both keys;
+  // ct is not needed after the decomposition, so its memory holds the product
+  for (uint32_t j = 0; j < 2; j++) {
+    NativeInteger *prod = &ct[j][0];
+    NativeInteger *accj = &(*acc)[0][j][0];
+    for (uint32_t t = 0; t < 2; t++) {
+      KeyProduct(dct, input[t], j, N, Q, mu, prod);
+      const NativeVector &mono = *monomial[t];
+      for (uint32_t k = 0; k < N; k++)
+        accj[k].ModAddFastEq(prod[k].ModMulFast(mono[k], Q, mu), Q);
     }
-    (*acc)[0][j] += (temp1 *= monomial);
   }
 }
 
@@ -380,13 +489,10 @@ std::shared_ptr<LWECiphertextImpl> RingGSWAccumulatorScheme::EvalBinGate(
     const std::shared_ptr<const LWECiphertextImpl> ct1,
     const std::shared_ptr<const LWECiphertextImpl> ct2,
     const std::shared_ptr<LWEEncryptionScheme> LWEscheme) const {
-  NativeInteger q = params->GetLWEParams()->Getq();
-  NativeInteger Q = params->GetLWEParams()->GetQ();
-  uint32_t n = params->GetLWEParams()->Getn();
-  uint32_t N = params->GetLWEParams()->GetN();
-  uint32_t baseR = params->GetBaseR();
-  std::vector<NativeInteger> digitsR = params->GetDigitsR();
-  const shared_ptr<ILNativeParams> polyParams = params->GetPolyParams();
+  if ((gate == MAJORITY) || (gate == AND3) || (gate == OR3)) {
+    std::string errMsg = "ERROR: 3-input gates require three ciphertexts.";
+    PALISADE_THROW(config_error, errMsg);
+  }
 
   if (ct1 == ct2) {
     std::string errMsg =
@@ -394,6 +500,192 @@ std::shared_ptr<LWECiphertextImpl> RingGSWAccumulatorScheme::EvalBinGate(
     PALISADE_THROW(config_error, errMsg);
   }
 
+  RingGSWACCScratch scratch(params);
+  return EvalBinGateCore(params, gate, EK, ct1, ct2, LWEscheme,
+                         std::make_shared<RingGSWCiphertext>(1, 2), &scratch);
+}
+
+// Evaluates a layer of independent gates; the refreshing and switching keys are
+// only read, so the gates can be bootstrapped concurrently
+std::vector<std::shared_ptr<LWECiphertextImpl>>
+RingGSWAccumulatorScheme::EvalBinGateBatch(
+    const std::shared_ptr<RingGSWCryptoParams> params,
+    const std::vector<BINGATE> &gates, const RingGSWEvalKey &EK,
+    const std::vector<std::shared_ptr<LWECiphertextImpl>> &ct1s,
+    const std::vector<std::shared_ptr<LWECiphertextImpl>> &ct2s,
+    const std::shared_ptr<LWEEncryptionScheme> LWEscheme) const {
+  uint32_t size = gates.size();
+
+  if ((ct1s.size() != size) || (ct2s.size() != size)) {
+    std::string errMsg =
+        "ERROR: The number of gates and ciphertexts should be the same.";
+    PALISADE_THROW(config_error, errMsg);
+  }
+
+  // the inputs are checked before any gate is bootstrapped
+  for (uint32_t i = 0; i < size; i++) {
+    if ((gates[i] == MAJORITY) || (gates[i] == AND3) || (gates[i] == OR3)) {
+      std::string errMsg = "ERROR: 3-input gates require three ciphertexts.";
+      PALISADE_THROW(config_error, errMsg);
+    }
+    if ((ct1s[i] == nullptr) || (ct2s[i] == nullptr)) {
+      std::string errMsg = "ERROR: The input ciphertexts must not be null.";
+      PALISADE_THROW(config_error, errMsg);
+    }
+    if (ct1s[i] == ct2s[i]) {
+      std::string errMsg =
+          "ERROR: Please only use independent ciphertexts as inputs.";
+      PALISADE_THROW(config_error, errMsg);
+    }
+  }
+
+  std::vector<std::shared_ptr<LWECiphertextImpl>> result(size);
+
+  // bootstrapping can still throw, e.g., for ciphertexts of other parameters
+  OMPExceptionHandler handler;
+#pragma omp parallel
+  {
+    // every thread reuses its accumulator and scratch polynomials for all
+    // gates it is assigned; a thread that fails to allocate them skips its
+    // gates, as every thread has to reach the loop
+    std::shared_ptr<RingGSWCiphertext> acc;
+    std::unique_ptr<RingGSWACCScratch> scratch;
+    handler.Run([&] {
+      acc = std::make_shared<RingGSWCiphertext>(1, 2);
+      scratch.reset(new RingGSWACCScratch(params));
+    });
+#pragma omp for schedule(dynamic)
+    for (uint32_t i = 0; i < size; i++) {
+      if (scratch == nullptr) continue;
+      handler.Run([&] {
+        result[i] = EvalBinGateCore(params, gates[i], EK, ct1s[i], ct2s[i],
+                                    LWEscheme, acc, scratch.get());
+      });
+    }
+  }
+  handler.Rethrow();
+
+  return result;
+}
+
+// The inputs of a 3-input gate are added up and bootstrapped once, as for
+// 2-input gates; the gate constant selects which sums are mapped to 1
+std::shared_ptr<LWECiphertextImpl> RingGSWAccumulatorScheme::EvalBinGate(
+    const std::shared_ptr<RingGSWCryptoParams> params, const BINGATE gate,
+    const RingGSWEvalKey &EK,
+    const std::vector<std::shared_ptr<LWECiphertextImpl>> &cts,
+    const std::shared_ptr<LWEEncryptionScheme> LWEscheme) const {
+  if ((gate != MAJORITY) && (gate != AND3) && (gate != OR3)) {
+    std::string errMsg =
+        "ERROR: Only MAJORITY, AND3, and OR3 are supported as 3-input gates.";
+    PALISADE_THROW(config_error, errMsg);
+  }
+
+  if (cts.size() != 3) {
+    std::string errMsg = "ERROR: 3-input gates require three ciphertexts.";
+    PALISADE_THROW(config_error, errMsg);
+  }
+
+  if ((cts[0] == cts[1]) || (cts[0] == cts[2]) || (cts[1] == cts[2])) {
+    std::string errMsg =
+        "ERROR: Please only use independent ciphertexts as inputs.";
+    PALISADE_THROW(config_error, errMsg);
+  }
+
+  std::shared_ptr<LWECiphertextImpl> sum =
+      LWEscheme->EvalWeightedSum(cts, {1, 1, 1});
+
+  RingGSWACCScratch scratch(params);
+  return BootstrapGate(params, EK, sum->GetA(), sum->GetB(),
+                       params->GetGateConst()[gate], LWEscheme,
+                       std::make_shared<RingGSWCiphertext>(1, 2), &scratch);
+}
+
+// The sums S are encoded as S * floor(q/p); the range mapped to 0 is centered
+// so that both boundaries are at least floor(q/p)/2 away from any valid sum
+std::shared_ptr<LWECiphertextImpl> RingGSWAccumulatorScheme::EvalThreshold(
+    const std::shared_ptr<RingGSWCryptoParams> params,
+    const RingGSWEvalKey &EK,
+    const std::vector<std::shared_ptr<LWECiphertextImpl>> &cts,
+    const std::vector<int64_t> &weights, int64_t threshold,
+    const LWEPlaintextModulus &p,
+    const std::shared_ptr<LWEEncryptionScheme> LWEscheme) const {
+  const std::shared_ptr<LWECryptoParams> LWEParams = params->GetLWEParams();
+  NativeInteger q = LWEParams->Getq();
+  uint32_t n = LWEParams->Getn();
+
+  if ((p < 2) || (q < NativeInteger(p))) {
+    std::string errMsg =
+        "ERROR: The plaintext modulus should be between 2 and q.";
+    PALISADE_THROW(config_error, errMsg);
+  }
+
+  for (uint32_t i = 0; i < cts.size(); i++) {
+    for (uint32_t j = i + 1; j < cts.size(); j++) {
+      if (cts[i] == cts[j]) {
+        std::string errMsg =
+            "ERROR: Please only use independent ciphertexts as inputs.";
+        PALISADE_THROW(config_error, errMsg);
+      }
+    }
+  }
+
+  int64_t sumMin = 0;
+  int64_t sumMax = 0;
+  double norm2 = 0;
+  for (int64_t w : weights) {
+    if (w < 0)
+      sumMin += w;
+    else
+      sumMax += w;
+    norm2 += (double)w * w;
+  }
+
+  if ((2 * (threshold - sumMin) > p) || (2 * (sumMax - threshold + 1) > p)) {
+    std::string errMsg =
+        "ERROR: The range of the weighted sum does not fit in the plaintext "
+        "modulus.";
+    PALISADE_THROW(config_error, errMsg);
+  }
+
+  // the input noise is estimated as the larger of the noise of a fresh
+  // encryption and the rounding noise of the final modulus switching in
+  // bootstrapping (n ternary key digits times a uniform error in [-1/2, 1/2])
+  int64_t delta = (q / NativeInteger(p)).ConvertToInt();
+  double sigma = std::max(LWEParams->GetDgg().GetStd(),
+                          std::sqrt((2.0 * n / 3.0 + 1.0) / 12.0));
+  if (4.0 * sigma * std::sqrt(norm2) > delta / 2.0) {
+    std::string errMsg =
+        "ERROR: The noise of the weighted sum is too large for the LWE "
+        "parameters.";
+    PALISADE_THROW(config_error, errMsg);
+  }
+
+  std::shared_ptr<LWECiphertextImpl> sum =
+      LWEscheme->EvalWeightedSum(cts, weights);
+
+  // the sums below the threshold are mapped to 0, i.e., the range
+  // [(threshold - 1/2) * delta - q/2, (threshold - 1/2) * delta)
+  int64_t qInt = q.ConvertToInt();
+  int64_t q1 = ((2 * threshold - 1) * delta - qInt) / 2 % qInt;
+  if (q1 < 0) q1 += qInt;
+
+  RingGSWACCScratch scratch(params);
+  return BootstrapGate(params, EK, sum->GetA(), sum->GetB(), NativeInteger(q1),
+                       LWEscheme, std::make_shared<RingGSWCiphertext>(1, 2),
+                       &scratch);
+}
+
+std::shared_ptr<LWECiphertextImpl> RingGSWAccumulatorScheme::EvalBinGateCore(
+    const std::shared_ptr<RingGSWCryptoParams> params, const BINGATE gate,
+    const RingGSWEvalKey &EK,
+    const std::shared_ptr<const LWECiphertextImpl> ct1,
+    const std::shared_ptr<const LWECiphertextImpl> ct2,
+    const std::shared_ptr<LWEEncryptionScheme> LWEscheme,
+    std::shared_ptr<RingGSWCiphertext> acc, RingGSWACCScratch *scratch) const {
+  NativeInteger q = params->GetLWEParams()->Getq();
+  uint32_t n = params->GetLWEParams()->Getn();
+
   NativeVector a(n, q);
   NativeInteger b;
 
@@ -412,9 +704,22 @@ std::shared_ptr<LWECiphertextImpl> RingGSWAccumulatorScheme::EvalBinGate(
     b = ct1->GetB().ModAddFast(ct2->GetB(), q);
   }
 
+  return BootstrapGate(params, EK, a, b, params->GetGateConst()[gate],
+                       LWEscheme, acc, scratch);
+}
+
+std::shared_ptr<LWECiphertextImpl> RingGSWAccumulatorScheme::BootstrapGate(
+    const std::shared_ptr<RingGSWCryptoParams> params,
+    const RingGSWEvalKey &EK, const NativeVector &a, const NativeInteger &b,
+    const NativeInteger &q1,
+    const std::shared_ptr<LWEEncryptionScheme> LWEscheme,
+    std::shared_ptr<RingGSWCiphertext> acc, RingGSWACCScratch *scratch) const {
+  NativeInteger q = params->GetLWEParams()->Getq();
+  NativeInteger Q = params->GetLWEParams()->GetQ();
+  uint32_t N = params->GetLWEParams()->GetN();
+
   // Specifies the range [q1,q2) that will be used for mapping
   uint32_t qHalf = q.ConvertToInt() >> 1;
-  NativeInteger q1 = params->GetGateConst()[gate];
   NativeInteger q2 = q1.ModAddFast(NativeInteger(qHalf), q);
 
   // depending on whether the value is the range, it will be set
@@ -436,20 +741,28 @@ std::shared_ptr<LWECiphertextImpl> RingGSWAccumulatorScheme::EvalBinGate(
       m[j * factor] = ((temp >= q2) && (temp < q1)) ? Q8 : Q8Neg;
   }
 
-  std::vector<NativePoly> res(2);
-  res[0] = NativePoly(
-      polyParams, EVALUATION,
-      true);  // no need to do NTT as all coefficients of this poly are zero
-  res[1] = NativePoly(polyParams, COEFFICIENT, false);
-  res[1].SetValues(m, COEFFICIENT);
-  res[1].SetFormat(EVALUATION);
+  std::shared_ptr<LWECiphertextImpl> eQ =
+      BootstrapCore(params, EK, a, std::move(m), LWEscheme, acc, scratch);
+
+  // we add Q/8 to "b" to to map back to Q/4 (i.e., mod 2) arithmetic.
+  eQ->SetB(Q8.ModAddFast(eQ->GetB(), Q));
+
+  // Modulus switching
+  return LWEscheme->ModSwitch(params->GetLWEParams(), eQ);
+}
+
+void RingGSWAccumulatorScheme::BlindRotate(
+    const std::shared_ptr<RingGSWCryptoParams> params,
+    const RingGSWEvalKey &EK, const NativeVector &a,
+    std::shared_ptr<RingGSWCiphertext> acc, RingGSWACCScratch *scratch) const {
+  NativeInteger q = params->GetLWEParams()->Getq();
+  uint32_t n = params->GetLWEParams()->Getn();
+  uint32_t baseR = params->GetBaseR();
+  const std::vector<NativeInteger> &digitsR = params->GetDigitsR();
 
   // main accumulation computation
   // the following loop is the bottleneck of bootstrapping/binary gate
   // evaluation
-  std::shared_ptr<RingGSWCiphertext> acc =
-      std::make_shared<RingGSWCiphertext>(1, 2);
-  (*acc)[0] = std::move(res);
 
   if (params->GetMethod() == AP) {
     for (uint32_t i = 0; i < n; i++) {
@@ -457,17 +770,48 @@ std::shared_ptr<LWECiphertextImpl> RingGSWAccumulatorScheme::EvalBinGate(
       for (uint32_t k = 0; k < digitsR.size();
            k++, aI /= NativeInteger(baseR)) {
         uint32_t a0 = (aI.Mod(baseR)).ConvertToInt();
-        if (a0) this->AddToACCAP(params, (*EK.BSkey)[i][a0][k], acc);
+        if (a0)
+          this->AddToACCAP(params, EK.BSkey->GetCiphertextData(i, a0, k), acc,
+                           scratch);
       }
     }
+  } else if (params->GetGINXMode() == GINX_FUSED) {
+    for (uint32_t i = 0; i < n; i++) {
+      // X^0 - 1 = 0, so a zero coefficient leaves acc unchanged
+      if (a[i] == NativeInteger(0)) continue;
+      this->AddToACCGINXFused(params, EK.BSkey->GetCiphertextData(0, 0, i),
+                              EK.BSkey->GetCiphertextData(0, 1, i), a[i], acc,
+                              scratch);
+    }
   } else {  // if GINX
     for (uint32_t i = 0; i < n; i++) {
-      this->AddToACCGINX(params, (*EK.BSkey)[0][0][i], q.ModSub(a[i], q),
-                         acc);  // handles -a*E(1)
-      this->AddToACCGINX(params, (*EK.BSkey)[0][1][i], a[i],
-                         acc);  // handles -a*E(-1) = a*E(1)
+      this->AddToACCGINX(params, EK.BSkey->GetCiphertextData(0, 0, i),
+                         q.ModSub(a[i], q), acc,
+                         scratch);  // handles -a*E(1)
+      this->AddToACCGINX(params, EK.BSkey->GetCiphertextData(0, 1, i), a[i],
+                         acc,
+                         scratch);  // handles -a*E(-1) = a*E(1)
     }
   }
+}
+
+std::shared_ptr<LWECiphertextImpl> RingGSWAccumulatorScheme::BootstrapCore(
+    const std::shared_ptr<RingGSWCryptoParams> params,
+    const RingGSWEvalKey &EK, const NativeVector &a, NativeVector m,
+    const std::shared_ptr<LWEEncryptionScheme> LWEscheme,
+    std::shared_ptr<RingGSWCiphertext> acc, RingGSWACCScratch *scratch) const {
+  NativeInteger Q = params->GetLWEParams()->GetQ();
+  uint32_t N = params->GetLWEParams()->GetN();
+  const shared_ptr<ILNativeParams> polyParams = params->GetPolyParams();
+
+  (*acc)[0][0] = NativePoly(
+      polyParams, EVALUATION,
+      true);  // no need to do NTT as all coefficients of this poly are zero
+  (*acc)[0][1] = NativePoly(polyParams, COEFFICIENT, false);
+  (*acc)[0][1].SetValues(std::move(m), COEFFICIENT);
+  (*acc)[0][1].SetFormat(EVALUATION);
+
+  BlindRotate(params, EK, a, acc, scratch);
 
   NativeInteger bNew;
   NativeVector aNew(N, Q);
@@ -481,19 +825,164 @@ std::shared_ptr<LWECiphertextImpl> RingGSWAccumulatorScheme::EvalBinGate(
 
   temp = (*acc)[0][1];
   temp.SetFormat(COEFFICIENT);
-  // we add Q/8 to "b" to to map back to Q/4 (i.e., mod 2) arithmetic.
-  bNew = Q8.ModAddFast(temp[0], Q);
+  bNew = temp[0];
 
   std::shared_ptr<const LWECiphertextImpl> eQN =
       std::make_shared<LWECiphertextImpl>(
           LWECiphertextImpl(std::move(aNew), std::move(bNew)));
 
   // Key switching
-  const std::shared_ptr<const LWECiphertextImpl> eQ =
-      LWEscheme->KeySwitch(params->GetLWEParams(), EK.KSkey, eQN);
+  return LWEscheme->KeySwitch(params->GetLWEParams(), EK.KSkey, eQN);
+}
+
+// Programmable bootstrapping: the test vector holds the lookup table (scaled
+// to Q) instead of the +-Q/8 constants used for binary gates
+std::shared_ptr<LWECiphertextImpl> RingGSWAccumulatorScheme::EvalFunc(
+    const std::shared_ptr<RingGSWCryptoParams> params,
+    const RingGSWEvalKey &EK,
+    const std::shared_ptr<const LWECiphertextImpl> ct,
+    const std::vector<NativeInteger> &LUT,
+    const std::shared_ptr<LWEEncryptionScheme> LWEscheme) const {
+  NativeInteger q = params->GetLWEParams()->Getq();
+  uint64_t p = LUT.size();
+
+  if ((p < 2) || (p & (p - 1)) || (q < NativeInteger(p))) {
+    std::string errMsg =
+        "ERROR: The size of the lookup table should be a power of two between "
+        "2 and q.";
+    PALISADE_THROW(config_error, errMsg);
+  }
+
+  if (ct->GetA().GetModulus() != q) {
+    std::string errMsg = "ERROR: EvalFunc expects a ciphertext modulo q.";
+    PALISADE_THROW(config_error, errMsg);
+  }
+
+  uint64_t qInt = q.ConvertToInt();
+  uint64_t qHalf = qInt >> 1;
+  NativeInteger delta = q / NativeInteger(p);
+
+  // the phase x in [0, q/2) is rounded to the message m = Round(p/q * x);
+  // m = p/2 is only reached close to q/2, where the negacyclic extension of
+  // the table applies
+  std::vector<NativeInteger> f(qHalf);
+  for (uint64_t x = 0; x < qHalf; x++) {
+    uint64_t m = (x * p + qHalf) / qInt;
+    if (m < (p >> 1))
+      f[x] = LUT[m].Mod(p) * delta;
+    else
+      f[x] = NativeInteger(0).ModSub(LUT[0].Mod(p) * delta, q);
+  }
+
+  return BootstrapFunc(params, EK, ct, f, q, LWEscheme);
+}
+
+// Clears the lower bits of the phase x with two negacyclic bootstraps of
+// r = x mod q: the first one maps r to [q/4, 3q/4), where the second one can
+// return r itself
+std::shared_ptr<LWECiphertextImpl> RingGSWAccumulatorScheme::EvalFloor(
+    const std::shared_ptr<RingGSWCryptoParams> params,
+    const RingGSWEvalKey &EK,
+    const std::shared_ptr<const LWECiphertextImpl> ct,
+    const std::shared_ptr<LWEEncryptionScheme> LWEscheme) const {
+  NativeInteger q = params->GetLWEParams()->Getq();
+  NativeInteger Q = params->GetLWEParams()->GetQ();
+  NativeInteger mod = ct->GetA().GetModulus();
+
+  if ((mod < q) || (mod > Q) || (mod.Mod(q) != 0)) {
+    std::string errMsg =
+        "ERROR: EvalFloor expects a ciphertext modulus that is a multiple of q "
+        "not exceeding Q.";
+    PALISADE_THROW(config_error, errMsg);
+  }
+
+  uint64_t qHalf = q.ConvertToInt() >> 1;
+  uint64_t qQuarter = qHalf >> 1;
+
+  // -q/4 for r in [0, q/2) and q/4 for r in [q/2, q)
+  std::vector<NativeInteger> f1(qHalf, mod - NativeInteger(qQuarter));
+  std::shared_ptr<LWECiphertextImpl> ct1 =
+      BootstrapFunc(params, EK, ct, f1, mod, LWEscheme);
+  ct1 = std::make_shared<LWECiphertextImpl>(
+      LWECiphertextImpl(ct->GetA() - ct1->GetA(),
+                        ct->GetB().ModSub(ct1->GetB(), mod)));
+
+  // the identity on [q/4, 3q/4), extended negacyclically
+  std::vector<NativeInteger> f2(qHalf);
+  for (uint64_t x = 0; x < qHalf; x++)
+    f2[x] = (x >= qQuarter) ? NativeInteger(x)
+                            : mod - NativeInteger(x + qHalf);
+  std::shared_ptr<LWECiphertextImpl> ct2 =
+      BootstrapFunc(params, EK, ct1, f2, mod, LWEscheme);
+
+  return std::make_shared<LWECiphertextImpl>(
+      LWECiphertextImpl(ct1->GetA() - ct2->GetA(),
+                        ct1->GetB().ModSub(ct2->GetB(), mod)));
+}
+
+std::shared_ptr<LWECiphertextImpl> RingGSWAccumulatorScheme::EvalSign(
+    const std::shared_ptr<RingGSWCryptoParams> params,
+    const RingGSWEvalKey &EK,
+    const std::shared_ptr<const LWECiphertextImpl> ct,
+    const std::shared_ptr<LWEEncryptionScheme> LWEscheme) const {
+  NativeInteger q = params->GetLWEParams()->Getq();
+  NativeInteger mod = ct->GetA().GetModulus();
+
+  if (mod < q) {
+    std::string errMsg =
+        "ERROR: EvalSign expects a ciphertext modulus of at least q.";
+    PALISADE_THROW(config_error, errMsg);
+  }
+
+  std::shared_ptr<const LWECiphertextImpl> ctq = ct;
+  if (mod != q) ctq = LWEscheme->ModSwitch(q, ct);
+
+  // -q/8 for x in [0, q/2) and q/8 for x in [q/2, q); adding q/8 maps the
+  // result to 0 and q/4 (i.e., the bits 0 and 1)
+  NativeInteger q8 = q >> 3;
+  std::vector<NativeInteger> f(q.ConvertToInt() >> 1, q - q8);
+  std::shared_ptr<LWECiphertextImpl> result =
+      BootstrapFunc(params, EK, ctq, f, q, LWEscheme);
+  result->SetB(result->GetB().ModAddFast(q8, q));
+
+  return result;
+}
+
+std::shared_ptr<LWECiphertextImpl> RingGSWAccumulatorScheme::BootstrapFunc(
+    const std::shared_ptr<RingGSWCryptoParams> params,
+    const RingGSWEvalKey &EK,
+    const std::shared_ptr<const LWECiphertextImpl> ct,
+    const std::vector<NativeInteger> &f, const NativeInteger &mod,
+    const std::shared_ptr<LWEEncryptionScheme> LWEscheme) const {
+  NativeInteger q = params->GetLWEParams()->Getq();
+  NativeInteger Q = params->GetLWEParams()->GetQ();
+  uint32_t n = params->GetLWEParams()->Getn();
+  uint32_t N = params->GetLWEParams()->GetN();
+
+  // only the residue of the phase modulo q is bootstrapped
+  NativeVector a(n, q);
+  for (uint32_t i = 0; i < n; i++) a[i] = ct->GetA()[i].Mod(q);
+  NativeInteger b = ct->GetB().Mod(q);
+
+  uint32_t qHalf = q.ConvertToInt() >> 1;
+  uint32_t factor = (2 * N / q.ConvertToInt());
+
+  // the coefficient j of the test vector is F(b - j), scaled from mod to Q
+  NativeVector m(N, Q);
+  for (uint32_t j = 0; j < qHalf; j++) {
+    uint32_t x = b.ModSub(j, q).ConvertToInt();
+    NativeInteger value =
+        (x < qHalf) ? f[x] : NativeInteger(0).ModSub(f[x - qHalf], mod);
+    m[j * factor] = RoundqQ(value, Q, mod);
+  }
+
+  RingGSWACCScratch scratch(params);
+  std::shared_ptr<LWECiphertextImpl> eQ =
+      BootstrapCore(params, EK, a, std::move(m), LWEscheme,
+                    std::make_shared<RingGSWCiphertext>(1, 2), &scratch);
 
   // Modulus switching
-  return LWEscheme->ModSwitch(params->GetLWEParams(), eQ);
+  return LWEscheme->ModSwitch(mod, eQ);
 }
 
 // Evaluation of the NOT operation; no key material is needed
@@ -31,6 +31,9 @@
  *
  */
 
+#include <cstdlib>
+#include <limits>
+
 #include "lwe.h"
 #include "math/ternaryuniformgenerator.h"
 #include "math/binaryuniformgenerator.h"
@@ -54,15 +57,27 @@ std::shared_ptr<LWEPrivateKeyImpl> LWEEncryptionScheme::KeyGenN(
 
 // classical LWE encryption
 // a is a randomly uniform vector of dimension n; with integers mod q
-// b = a*s + e + m floor(q/4) is an integer mod q
+// b = a*s + e + m floor(q/p) is an integer mod q
 std::shared_ptr<LWECiphertextImpl> LWEEncryptionScheme::Encrypt(
     const std::shared_ptr<LWECryptoParams> params,
-    const std::shared_ptr<const LWEPrivateKeyImpl> sk,
-    const LWEPlaintext &m) const {
-  NativeInteger q = sk->GetElement().GetModulus();
+    const std::shared_ptr<const LWEPrivateKeyImpl> sk, const LWEPlaintext &m,
+    const LWEPlaintextModulus &p, const NativeInteger &mod) const {
+  NativeInteger q = (mod == 0) ? sk->GetElement().GetModulus() : mod;
   uint32_t n = sk->GetElement().GetLength();
 
-  NativeInteger b = (m % 4) * (q >> 2) + params->GetDgg().GenerateInteger(q);
+  if ((p < 2) || (q < NativeInteger(p))) {
+    std::string errMsg =
+        "ERROR: The plaintext modulus should be between 2 and the ciphertext "
+        "modulus.";
+    PALISADE_THROW(config_error, errMsg);
+  }
+
+  // the secret key stores negative values using its own modulus
+  NativeVector s = sk->GetElement();
+  if (s.GetModulus() != q) s.SwitchModulus(q);
+
+  NativeInteger b = NativeInteger(((m % p) + p) % p) * (q / NativeInteger(p)) +
+                    params->GetDgg().GenerateInteger(q);
 
   DiscreteUniformGeneratorImpl<NativeVector> dug;
   dug.SetModulus(q);
@@ -70,7 +85,6 @@ std::shared_ptr<LWECiphertextImpl> LWEEncryptionScheme::Encrypt(
 
   NativeInteger mu = q.ComputeMu();
 
-  const NativeVector &s = sk->GetElement();
   for (uint32_t i = 0; i < n; ++i) {
     b += a[i].ModMulFast(s[i], q, mu);
   }
@@ -80,20 +94,21 @@ std::shared_ptr<LWECiphertextImpl> LWEEncryptionScheme::Encrypt(
 }
 
 // classical LWE decryption
-// m_result = Round(4/q * (b - a*s))
+// m_result = Round(p/q * (b - a*s))
 void LWEEncryptionScheme::Decrypt(
     const std::shared_ptr<LWECryptoParams> params,
     const std::shared_ptr<const LWEPrivateKeyImpl> sk,
-    const std::shared_ptr<const LWECiphertextImpl> ct,
-    LWEPlaintext *result) const {
-  // TODO in the future we should add a check to make sure sk parameters match
-  // the ct parameters
-
+    const std::shared_ptr<const LWECiphertextImpl> ct, LWEPlaintext *result,
+    const LWEPlaintextModulus &p) const {
   // Create local variables to speed up the computations
-  NativeVector a = ct->GetA();
+  const NativeVector &a = ct->GetA();
   uint32_t n = sk->GetElement().GetLength();
+  NativeInteger q = a.GetModulus();
+
+  // the ciphertext modulus can differ from the one of the secret key, e.g.,
+  // for ciphertexts encrypted with a larger modulus
   NativeVector s = sk->GetElement();
-  NativeInteger q = sk->GetElement().GetModulus();
+  if (s.GetModulus() != q) s.SwitchModulus(q);
 
   NativeInteger mu = q.ComputeMu();
 
@@ -108,11 +123,11 @@ void LWEEncryptionScheme::Decrypt(
   r.ModSubFastEq(inner, q);
 
   // Alternatively, rounding can be done as
-  //*result = (r.MultiplyAndRound(NativeInteger(4),q)).ConvertToInt();
+  //*result = (r.MultiplyAndRound(NativeInteger(p),q)).ConvertToInt();
   // But the method below is a more efficient way of doing the rounding
-  // the idea is that Round(4/q x) = q/8 + Floor(4/q x)
-  r.ModAddFastEq((q >> 3), q);
-  *result = ((NativeInteger(4) * r) / q).ConvertToInt();
+  // the idea is that Round(p/q x) = q/(2p) + Floor(p/q x)
+  r.ModAddFastEq(q / NativeInteger(2 * p), q);
+  *result = ((NativeInteger(p) * r) / q).ConvertToInt();
 
   return;
 }
@@ -144,6 +159,57 @@ std::shared_ptr<LWECiphertextImpl> LWEEncryptionScheme::ModSwitch(
   return std::make_shared<LWECiphertextImpl>(LWECiphertextImpl(a, b));
 }
 
+std::shared_ptr<LWECiphertextImpl> LWEEncryptionScheme::ModSwitch(
+    const NativeInteger &q,
+    const std::shared_ptr<const LWECiphertextImpl> ct) const {
+  uint32_t n = ct->GetA().GetLength();
+  NativeInteger Q = ct->GetA().GetModulus();
+
+  NativeVector a(n, q);
+
+  for (uint32_t i = 0; i < n; ++i) a[i] = RoundqQ(ct->GetA()[i], q, Q);
+
+  NativeInteger b = RoundqQ(ct->GetB(), q, Q);
+
+  return std::make_shared<LWECiphertextImpl>(LWECiphertextImpl(a, b));
+}
+
+std::shared_ptr<LWECiphertextImpl> LWEEncryptionScheme::EvalWeightedSum(
+    const std::vector<std::shared_ptr<LWECiphertextImpl>> &cts,
+    const std::vector<int64_t> &weights) const {
+  if (cts.empty() || (cts.size() != weights.size())) {
+    std::string errMsg =
+        "ERROR: The number of ciphertexts and weights should be the same and "
+        "positive.";
+    PALISADE_THROW(config_error, errMsg);
+  }
+
+  NativeInteger q = cts[0]->GetA().GetModulus();
+  uint32_t n = cts[0]->GetA().GetLength();
+
+  NativeVector a(n, q);
+  NativeInteger b(0);
+
+  for (uint32_t i = 0; i < cts.size(); i++) {
+    if ((cts[i]->GetA().GetModulus() != q) ||
+        (cts[i]->GetA().GetLength() != n)) {
+      std::string errMsg =
+          "ERROR: All ciphertexts should have the same modulus and dimension.";
+      PALISADE_THROW(config_error, errMsg);
+    }
+
+    // negative weights are represented modulo q
+    NativeInteger w = NativeInteger(std::abs(weights[i])).Mod(q);
+    if (weights[i] < 0) w = NativeInteger(0).ModSub(w, q);
+
+    a += cts[i]->GetA().ModMul(w);
+    b.ModAddFastEq(cts[i]->GetB().ModMul(w, q), q);
+  }
+
+  return std::make_shared<LWECiphertextImpl>(
+      LWECiphertextImpl(std::move(a), std::move(b)));
+}
+
 // Switching key as described in Section 3 of https://eprint.iacr.org/2014/816
 std::shared_ptr<LWESwitchingKey> LWEEncryptionScheme::KeySwitchGen(
     const std::shared_ptr<LWECryptoParams> params,
@@ -169,32 +235,29 @@ std::shared_ptr<LWESwitchingKey> LWEEncryptionScheme::KeySwitchGen(
 
   NativeInteger mu = Q.ComputeMu();
 
-  std::vector<std::vector<std::vector<LWECiphertextImpl>>> resultVec(N);
+  auto result = std::make_shared<LWESwitchingKey>(N, baseKS, expKS, n, Q);
 
 #pragma omp parallel for
   for (uint32_t i = 0; i < N; ++i) {
-    std::vector<std::vector<LWECiphertextImpl>> vector1(baseKS);
     for (uint32_t j = 0; j < baseKS; ++j) {
-      std::vector<LWECiphertextImpl> vector2(expKS);
       for (uint32_t k = 0; k < expKS; ++k) {
         NativeInteger b = (params->GetDgg().GenerateInteger(Q))
                               .ModAdd(oldSK[i].ModMul(j * digitsKS[k], Q), Q);
 
         NativeVector a = dug.GenerateVector(n);
 
+        uint64_t *row = result->GetRow(i, k, j);
         for (uint32_t i = 0; i < n; ++i) {
           b += a[i].ModMulFast(newSK[i], Q, mu);
+          row[i] = a[i].ConvertToInt();
         }
         b.ModEq(Q);
-
-        vector2[k] = std::move(LWECiphertextImpl(a, b));
+        row[n] = b.ConvertToInt();
       }
-      vector1[j] = std::move(vector2);
     }
-    resultVec[i] = std::move(vector1);
   }
 
-  return std::make_shared<LWESwitchingKey>(LWESwitchingKey(resultVec));
+  return result;
 }
 
 // the key switching operation as described in Section 3 of
@@ -210,21 +273,37 @@ std::shared_ptr<LWECiphertextImpl> LWEEncryptionScheme::KeySwitch(
   std::vector<NativeInteger> digitsKS = params->GetDigitsKS();
   uint32_t expKS = digitsKS.size();
 
-  // creates an empty vector
-  NativeVector a(n, Q);
-  NativeInteger b = ctQN->GetB();
-  NativeVector aOld = ctQN->GetA();
+  uint64_t modulus = Q.ConvertToInt();
+  // the selected rows are added without reduction as long as the sums cannot
+  // overflow; the result is negated at the end
+  uint64_t maxTerms = std::numeric_limits<uint64_t>::max() / modulus - 1;
+  uint64_t terms = 0;
+
+  std::vector<uint64_t> sum(n + 1, 0);
+  uint64_t *sumPtr = &sum[0];
+  uint32_t size = sum.size();
+
+  const NativeVector &aOld = ctQN->GetA();
 
   for (uint32_t i = 0; i < N; ++i) {
     NativeInteger atmp = aOld[i];
     for (uint32_t j = 0; j < expKS; ++j, atmp /= baseKS) {
       uint64_t a0 = (atmp % baseKS).ConvertToInt();
-      for (uint32_t k = 0; k < n; ++k)
-        a[k].ModSubFastEq((K->GetElements()[i][a0][j]).GetA()[k], Q);
-      b.ModSubFastEq((K->GetElements()[i][a0][j]).GetB(), Q);
+      const uint64_t *row = K->GetRow(i, j, a0);
+#pragma omp simd
+      for (uint32_t k = 0; k < size; ++k) sumPtr[k] += row[k];
+      if (++terms == maxTerms) {
+        for (uint32_t k = 0; k < size; ++k) sumPtr[k] %= modulus;
+        terms = 0;
+      }
     }
   }
 
+  NativeVector a(n, Q);
+  for (uint32_t k = 0; k < n; ++k)
+    a[k] = NativeInteger(0).ModSub(NativeInteger(sum[k] % modulus), Q);
+  NativeInteger b = ctQN->GetB().ModSub(NativeInteger(sum[n] % modulus), Q);
+
   return std::make_shared<LWECiphertextImpl>(LWECiphertextImpl(a, b));
 }
 };  // namespace lbcrypto
@@ -25,6 +25,11 @@
  *
  */
 
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
 #include "include/gtest/gtest.h"
 #include "binfhecontext.h"
 
@@ -39,6 +44,33 @@ class UnitTestFHEW : public ::testing::Test {
     // (right before the destructor).
   }
 };
+
+// Runs the bootstrapping tests for both the AP and GINX accumulators
+class UnitTestFHEWMethod : public ::testing::TestWithParam<BINFHEMETHOD> {};
+
+INSTANTIATE_TEST_CASE_P(AccumulatorMethods, UnitTestFHEWMethod,
+                        ::testing::Values(AP, GINX));
+
+// Returns the truth-table output of a binary gate for the bits m1 and m2
+static LWEPlaintext ExpectedGateBit(BINGATE gate, LWEPlaintext m1,
+                                    LWEPlaintext m2) {
+  switch (gate) {
+    case OR:
+      return m1 | m2;
+    case AND:
+      return m1 & m2;
+    case NOR:
+      return 1 - (m1 | m2);
+    case NAND:
+      return 1 - (m1 & m2);
+    case XOR:
+      return m1 ^ m2;
+    case XNOR:
+      return 1 - (m1 ^ m2);
+    default:
+      return 0;
+  }
+}
 /*---------------------------------------	TESTING METHODS OF FHEW
  * --------------------------------------------*/
 
@@ -78,6 +110,35 @@ TEST(UnitTestFHEWAP, KeySwitch) {
   EXPECT_EQ(0, resultAfterKeySwitch0) << "Failed key switching test";
 }
 
+// Checks that the flat switching key matches its nested representation
+TEST(UnitTestFHEWAP, SwitchingKeyLayout) {
+  auto cc = BinFHEContext();
+
+  cc.GenerateBinFHEContext(TOY, AP);
+
+  auto params = cc.GetParams()->GetLWEParams();
+
+  auto sk = cc.KeyGen();
+  auto skN = cc.KeyGenN();
+
+  auto keySwitchHint = cc.KeySwitchGen(sk, skN);
+
+  auto elements = keySwitchHint->GetElements();
+
+  EXPECT_EQ(params->GetN(), elements.size());
+  EXPECT_EQ(params->GetBaseKS(), elements[0].size());
+  EXPECT_EQ(params->GetDigitsKS().size(), elements[0][0].size());
+  EXPECT_EQ(params->Getn(), elements[0][0][0].GetA().GetLength());
+
+  // row (i, digit, value) holds entry [i][value][digit]
+  const uint64_t *row = keySwitchHint->GetRow(3, 1, 2);
+  EXPECT_EQ(elements[3][2][1].GetA()[5].ConvertToInt(), row[5]);
+  EXPECT_EQ(elements[3][2][1].GetB().ConvertToInt(), row[params->Getn()]);
+
+  LWESwitchingKey rebuilt(elements);
+  EXPECT_EQ(*keySwitchHint, rebuilt) << "Failed switching key layout test";
+}
+
 // Checks the mod switching operation
 TEST(UnitTestFHEWAP, ModSwitch) {
   auto cc = BinFHEContext();
@@ -566,3 +627,402 @@ TEST(UnitTestFHEWGINX, XNOR) {
   EXPECT_EQ(0, result10) << failed;
   EXPECT_EQ(1, result00) << failed;
 }
+
+// Checks batch evaluation of independent gates against the truth tables
+TEST_P(UnitTestFHEWMethod, EvalBinGateBatch) {
+  BINFHEMETHOD method = GetParam();
+  auto cc = BinFHEContext();
+  cc.GenerateBinFHEContext(TOY, method);
+
+  auto sk = cc.KeyGen();
+
+  cc.BTKeyGen(sk);
+
+  std::vector<BINGATE> allGates = {OR, AND, NOR, NAND, XOR, XNOR};
+
+  std::vector<BINGATE> gates;
+  std::vector<LWECiphertext> ct1s;
+  std::vector<LWECiphertext> ct2s;
+  std::vector<LWEPlaintext> expected;
+
+  for (auto gate : allGates) {
+    for (LWEPlaintext m1 = 0; m1 < 2; m1++) {
+      for (LWEPlaintext m2 = 0; m2 < 2; m2++) {
+        gates.push_back(gate);
+        ct1s.push_back(cc.Encrypt(sk, m1));
+        ct2s.push_back(cc.Encrypt(sk, m2));
+        expected.push_back(ExpectedGateBit(gate, m1, m2));
+      }
+    }
+  }
+
+  auto results = cc.EvalBinGateBatch(gates, ct1s, ct2s);
+
+  ASSERT_EQ(gates.size(), results.size()) << "EvalBinGateBatch failed";
+
+  for (size_t i = 0; i < results.size(); i++) {
+    LWEPlaintext result;
+    cc.Decrypt(sk, results[i], &result);
+    EXPECT_EQ(expected[i], result) << "EvalBinGateBatch failed for gate " << i;
+  }
+
+  // null inputs are rejected before any gate is bootstrapped
+  auto ct = ct2s.back();
+  ct2s.back() = nullptr;
+  EXPECT_THROW(cc.EvalBinGateBatch(gates, ct1s, ct2s), config_error);
+  ct2s.back() = ct;
+
+  // mismatched input sizes are rejected
+  ct2s.pop_back();
+  EXPECT_THROW(cc.EvalBinGateBatch(gates, ct1s, ct2s), config_error);
+}
+
+// Checks programmable bootstrapping for a table that is only defined on the
+// lower half of the plaintext space and for a negacyclic table
+TEST_P(UnitTestFHEWMethod, EvalFunc) {
+  BINFHEMETHOD method = GetParam();
+  auto cc = BinFHEContext();
+  cc.GenerateBinFHEContext(TOY, method);
+
+  auto sk = cc.KeyGen();
+
+  cc.BTKeyGen(sk);
+
+  LWEPlaintextModulus p = 8;
+
+  std::vector<NativeInteger> lut = {3, 1, 6, 2, 0, 0, 0, 0};
+  for (LWEPlaintext m = 0; m < p / 2; m++) {
+    auto ct = cc.Encrypt(sk, m, p);
+    LWEPlaintext result;
+    cc.Decrypt(sk, cc.EvalFunc(ct, lut), &result, p);
+    EXPECT_EQ(lut[m].ConvertToInt(), (uint64_t)result)
+        << "EvalFunc failed for m = " << m;
+  }
+
+  std::vector<NativeInteger> negacyclic = {1, 2, 3, 0, 7, 6, 5, 0};
+  for (LWEPlaintext m = 0; m < p; m++) {
+    auto ct = cc.Encrypt(sk, m, p);
+    LWEPlaintext result;
+    cc.Decrypt(sk, cc.EvalFunc(ct, negacyclic), &result, p);
+    EXPECT_EQ(negacyclic[m].ConvertToInt(), (uint64_t)result)
+        << "EvalFunc failed for negacyclic table and m = " << m;
+  }
+
+  lut.pop_back();
+  EXPECT_THROW(cc.EvalFunc(cc.Encrypt(sk, 1, p), lut), config_error);
+}
+
+// Checks EvalFloor and EvalSign for ciphertexts modulo 4q, where the phase is
+// encrypted directly (plaintext modulus 4q)
+TEST_P(UnitTestFHEWMethod, EvalFloorSign) {
+  BINFHEMETHOD method = GetParam();
+  auto cc = BinFHEContext();
+  cc.GenerateBinFHEContext(TOY, method);
+
+  auto sk = cc.KeyGen();
+
+  cc.BTKeyGen(sk);
+
+  NativeInteger q = cc.GetParams()->GetLWEParams()->Getq();
+  NativeInteger mod = q << 2;
+  LWEPlaintextModulus p = mod.ConvertToInt();
+  LWEPlaintext qInt = q.ConvertToInt();
+
+  for (LWEPlaintext k = 0; k < 4; k++) {
+    for (LWEPlaintext r : {100, 200, 300, 400}) {
+      auto ct = cc.Encrypt(sk, k * qInt + r, p, mod);
+      LWEPlaintext result;
+      cc.Decrypt(sk, cc.EvalFloor(ct), &result, 4);
+      EXPECT_EQ(k, result) << "EvalFloor failed for " << k * qInt + r;
+    }
+  }
+
+  for (LWEPlaintext x : {100, 500, 900, 1200, 1600, 1950}) {
+    auto ct = cc.Encrypt(sk, x, p, mod);
+    LWEPlaintext result;
+    cc.Decrypt(sk, cc.EvalSign(ct), &result);
+    EXPECT_EQ(x >= p / 2 ? 1 : 0, result) << "EvalSign failed for " << x;
+  }
+}
+
+// Checks the 3-input gates and threshold evaluation on all input combinations
+TEST_P(UnitTestFHEWMethod, MultiInputGates) {
+  BINFHEMETHOD method = GetParam();
+  auto cc = BinFHEContext();
+  cc.GenerateBinFHEContext(TOY, method);
+
+  auto sk = cc.KeyGen();
+
+  cc.BTKeyGen(sk);
+
+  for (LWEPlaintext i = 0; i < 8; i++) {
+    LWEPlaintext m1 = i & 1;
+    LWEPlaintext m2 = (i >> 1) & 1;
+    LWEPlaintext m3 = (i >> 2) & 1;
+    LWEPlaintext sum = m1 + m2 + m3;
+    std::string input = std::to_string(m1) + std::to_string(m2) +
+                        std::to_string(m3);
+
+    LWEPlaintext result;
+    std::vector<LWECiphertext> bits = {
+        cc.Encrypt(sk, m1), cc.Encrypt(sk, m2), cc.Encrypt(sk, m3)};
+    cc.Decrypt(sk, cc.EvalBinGate(MAJORITY, bits), &result);
+    EXPECT_EQ(sum >= 2 ? 1 : 0, result) << "MAJORITY failed for " << input;
+
+    std::vector<LWECiphertext> bits6 = {cc.Encrypt(sk, m1, 6),
+                                        cc.Encrypt(sk, m2, 6),
+                                        cc.Encrypt(sk, m3, 6)};
+    cc.Decrypt(sk, cc.EvalBinGate(AND3, bits6), &result);
+    EXPECT_EQ(sum == 3 ? 1 : 0, result) << "AND3 failed for " << input;
+    cc.Decrypt(sk, cc.EvalBinGate(OR3, bits6), &result);
+    EXPECT_EQ(sum >= 1 ? 1 : 0, result) << "OR3 failed for " << input;
+
+    // 2*m1 - m2 + m3 >= 1 needs sums in [-1, 3], i.e., plaintext modulus 8
+    std::vector<LWECiphertext> bits8 = {cc.Encrypt(sk, m1, 8),
+                                        cc.Encrypt(sk, m2, 8),
+                                        cc.Encrypt(sk, m3, 8)};
+    cc.Decrypt(sk, cc.EvalThreshold(bits8, {2, -1, 1}, 1, 8), &result);
+    EXPECT_EQ(2 * m1 - m2 + m3 >= 1 ? 1 : 0, result)
+        << "EvalThreshold failed for " << input;
+  }
+
+  auto ct1 = cc.Encrypt(sk, 1);
+  auto ct2 = cc.Encrypt(sk, 0);
+  auto ct3 = cc.Encrypt(sk, 1);
+
+  // the weighted sum is decrypted directly without bootstrapping
+  LWEPlaintext result;
+  cc.Decrypt(sk, cc.EvalWeightedSum({ct1, ct2, ct3}, {1, 1, 1}), &result);
+  EXPECT_EQ(2, result) << "EvalWeightedSum failed";
+
+  // three bits do not fit in half of Z_q with plaintext modulus 4
+  EXPECT_THROW(cc.EvalThreshold({ct1, ct2, ct3}, {1, 1, 1}, 3, 4),
+               config_error);
+  // the noise of large weights exceeds the rounding margin
+  EXPECT_THROW(cc.EvalThreshold({ct1, ct2}, {50, -50}, 1, 128), config_error);
+  EXPECT_THROW(cc.EvalBinGate(AND, {ct1, ct2, ct3}), config_error);
+  EXPECT_THROW(cc.EvalBinGate(MAJORITY, ct1, ct2), config_error);
+}
+
+// Checks the gates on STD128Q, whose 25-bit Q takes the unreduced 64-bit
+// accumulation path of the key products (digitsG2 * Q^2 < 2^64)
+TEST_P(UnitTestFHEWMethod, KeyProductSmallModulus) {
+  BINFHEMETHOD method = GetParam();
+  auto cc = BinFHEContext();
+  cc.GenerateBinFHEContext(STD128Q, method);
+
+  auto sk = cc.KeyGen();
+
+  cc.BTKeyGen(sk);
+
+  for (auto gate : {AND, NAND, XOR}) {
+    for (LWEPlaintext i = 0; i < 4; i++) {
+      LWEPlaintext m1 = i & 1;
+      LWEPlaintext m2 = i >> 1;
+      LWEPlaintext result;
+      cc.Decrypt(sk,
+                 cc.EvalBinGate(gate, cc.Encrypt(sk, m1), cc.Encrypt(sk, m2)),
+                 &result);
+      EXPECT_EQ(ExpectedGateBit(gate, m1, m2), result)
+          << "gate " << gate << " failed for " << m1 << m2;
+    }
+  }
+}
+
+// Checks that bootstrapping keys written in the binary format can be mapped
+// into a fresh context with the same parameters
+TEST_P(UnitTestFHEWMethod, BTKeyBinary) {
+  BINFHEMETHOD method = GetParam();
+  auto cc = BinFHEContext();
+  cc.GenerateBinFHEContext(TOY, method);
+
+  auto sk = cc.KeyGen();
+
+  cc.BTKeyGen(sk);
+
+  std::string filename = "btkey-test-" + std::to_string(method) + ".bin";
+  ASSERT_TRUE(cc.BTKeySaveBinary(filename));
+
+  auto cc2 = BinFHEContext();
+  cc2.GenerateBinFHEContext(TOY, method);
+  ASSERT_TRUE(cc2.BTKeyLoadBinary(filename));
+
+  EXPECT_EQ(*cc.GetRefreshKey(), *cc2.GetRefreshKey())
+      << "Refreshing key changed by the binary format";
+  EXPECT_EQ(*cc.GetSwitchKey(), *cc2.GetSwitchKey())
+      << "Switching key changed by the binary format";
+
+  // copies of the mapped key share the mapping, and moves keep the buffer
+  const RingGSWBTKey &mappedKey = *cc2.GetRefreshKey();
+  RingGSWBTKey copied(mappedKey);
+  EXPECT_EQ(mappedKey.GetData(), copied.GetData())
+      << "Copying the mapped refreshing key copied the mapping";
+  RingGSWBTKey moved(std::move(copied));
+  EXPECT_EQ(mappedKey.GetData(), moved.GetData())
+      << "Moving the refreshing key copied the buffer";
+  EXPECT_TRUE(copied.GetData() == nullptr);
+  EXPECT_EQ(mappedKey, moved);
+
+  auto ct1 = cc.Encrypt(sk, 1);
+  auto ct2 = cc.Encrypt(sk, 0);
+  auto ct3 = cc.Encrypt(sk, 1);
+
+  LWEPlaintext result;
+  cc.Decrypt(sk, cc2.EvalBinGate(NAND, ct1, ct2), &result);
+  EXPECT_EQ(1, result) << "NAND failed with the loaded keys";
+  cc.Decrypt(sk, cc2.EvalBinGate(AND, ct1, ct3), &result);
+  EXPECT_EQ(1, result) << "AND failed with the loaded keys";
+
+  // the key of the other method has different dimensions
+  auto cc3 = BinFHEContext();
+  cc3.GenerateBinFHEContext(TOY, method == AP ? GINX : AP);
+  EXPECT_THROW(cc3.BTKeyLoadBinary(filename), config_error);
+
+  // crafted headers: a wrapping refreshing key offset at byte 56 and a
+  // digit count of the switching key at byte 80 that exceeds the context's
+  std::string data;
+  {
+    std::ifstream in(filename, std::ios::binary);
+    data.assign(std::istreambuf_iterator<char>(in),
+                std::istreambuf_iterator<char>());
+  }
+  std::string craftedName = "btkey-crafted-" + std::to_string(method) + ".bin";
+  auto loadCrafted = [&](size_t pos, const void *value, size_t bytes) {
+    std::string crafted = data;
+    crafted.replace(pos, bytes, static_cast<const char *>(value), bytes);
+    std::ofstream out(craftedName, std::ios::binary | std::ios::trunc);
+    out.write(crafted.data(), crafted.size());
+    out.close();
+    return cc2.BTKeyLoadBinary(craftedName);
+  };
+  uint64_t hugeOffset = ~uint64_t(63);
+  EXPECT_THROW(loadCrafted(56, &hugeOffset, sizeof(hugeOffset)),
+               deserialize_error);
+  uint32_t expKS = cc.GetParams()->GetLWEParams()->GetDigitsKS().size() + 1;
+  EXPECT_THROW(loadCrafted(80, &expKS, sizeof(expKS)), config_error);
+  std::remove(craftedName.c_str());
+
+  std::remove(filename.c_str());
+
+  EXPECT_FALSE(cc2.BTKeyLoadBinary(filename));
+}
+
+// Checks that the refreshing key tracks which ciphertexts were set, also for
+// a ciphertext with all coefficients zero
+TEST(UnitTestFHEW, RefreshKeySetEntries) {
+  auto cc = BinFHEContext();
+  cc.GenerateBinFHEContext(TOY);
+
+  auto params = cc.GetParams()->GetPolyParams();
+  RingGSWBTKey key(1, 1, 2, 2, 2, params);
+  RingGSWCiphertext zero(2, 2);
+  for (uint32_t l = 0; l < 2; l++)
+    for (uint32_t c = 0; c < 2; c++)
+      zero[l][c] = NativePoly(params, EVALUATION, true);
+  key.SetCiphertext(0, 0, 0, zero);
+
+  EXPECT_TRUE(key.IsSet(0, 0, 0));
+  EXPECT_FALSE(key.IsSet(0, 0, 1));
+  auto elements = key.GetElements();
+  EXPECT_EQ(zero, elements[0][0][0]) << "Zero ciphertext was dropped";
+  EXPECT_TRUE(elements[0][0][1].GetElements().empty())
+      << "Unset ciphertext was returned";
+
+  RingGSWBTKey rebuilt(elements);
+  EXPECT_EQ(key, rebuilt) << "Set entries changed by GetElements";
+}
+
+// Checks that ciphertexts survive the packed batch format, both through a
+// stream and through a memory-mapped file
+TEST(UnitTestFHEW, CiphertextBatch) {
+  auto cc = BinFHEContext();
+  cc.GenerateBinFHEContext(TOY);
+
+  auto sk = cc.KeyGen();
+
+  const uint32_t count = 20;
+  std::vector<LWECiphertext> cts;
+  for (uint32_t i = 0; i < count; i++) cts.push_back(cc.Encrypt(sk, i % 2));
+
+  LWECiphertextBatch batch(cts);
+  uint32_t n = cc.GetParams()->GetLWEParams()->Getn();
+  EXPECT_EQ(count, batch.GetCount());
+  EXPECT_EQ(n, batch.Getn());
+  EXPECT_EQ(2u, batch.GetWordSize()) << "q = 512 should be packed in 16 bits";
+  EXPECT_EQ(64 + count * (n + 1) * 2, batch.GetSizeInBytes());
+  EXPECT_EQ(cts[3]->GetA()[5], batch.GetA(3, 5));
+  EXPECT_EQ(cts[3]->GetB(), batch.GetB(3));
+  EXPECT_THROW(batch.GetA(count, 0), config_error);
+  EXPECT_THROW(batch.GetA(0, n), config_error);
+  EXPECT_THROW(batch.GetB(count), config_error);
+
+  std::stringstream s;
+  ASSERT_TRUE(batch.Save(s));
+  auto loaded = LWECiphertextBatch::Load(s).GetCiphertexts();
+  ASSERT_EQ(count, loaded.size());
+  for (uint32_t i = 0; i < count; i++) {
+    EXPECT_EQ(*cts[i], *loaded[i]) << "Ciphertext " << i << " mismatch";
+    LWEPlaintext result;
+    cc.Decrypt(sk, loaded[i], &result);
+    EXPECT_EQ(LWEPlaintext(i % 2), result)
+        << "Decryption of ciphertext " << i << " failed";
+  }
+
+  std::string filename = "ctbatch-test.bin";
+  ASSERT_TRUE(cc.CiphertextBatchSaveBinary(cts, filename));
+  LWECiphertextBatch mapped;
+  ASSERT_TRUE(cc.CiphertextBatchLoadBinary(filename, &mapped));
+  ASSERT_EQ(count, mapped.GetCount());
+  for (uint32_t i = 0; i < count; i++)
+    EXPECT_EQ(*cts[i], *mapped.GetCiphertext(i))
+        << "Ciphertext " << i << " mismatch in the mapped batch";
+
+  // ciphertexts of a different dimension
+  auto cc2 = BinFHEContext();
+  cc2.GenerateBinFHEContext(MEDIUM);
+  EXPECT_THROW(cc2.CiphertextBatchLoadBinary(filename, &mapped), config_error);
+  std::remove(filename.c_str());
+
+  std::string data = s.str();
+  EXPECT_THROW(LWECiphertextBatch(nullptr, data.data(), data.size() - 1),
+               deserialize_error);
+  // a coefficient of the last ciphertext that is not reduced modulo q
+  std::string unreduced = data;
+  uint16_t q = 512;
+  unreduced.replace(unreduced.size() - 2, 2,
+                    reinterpret_cast<const char *>(&q), 2);
+  EXPECT_THROW(LWECiphertextBatch(nullptr, unreduced.data(), unreduced.size()),
+               deserialize_error);
+  data[0] = 'X';
+  EXPECT_THROW(LWECiphertextBatch(nullptr, data.data(), data.size()),
+               deserialize_error);
+}
+
+// Checks the truth tables of the binary gates with the fused GINX
+// accumulator update
+TEST(UnitTestFHEWGINX, FusedAccumulator) {
+  auto cc = BinFHEContext();
+  cc.GenerateBinFHEContext(TOY, GINX);
+  cc.SetGINXMode(GINX_FUSED);
+
+  auto sk = cc.KeyGen();
+
+  cc.BTKeyGen(sk);
+
+  const std::vector<BINGATE> gates = {OR, AND, NOR, NAND, XOR, XNOR};
+  const std::vector<std::string> names = {"OR",   "AND", "NOR",
+                                          "NAND", "XOR", "XNOR"};
+  for (size_t g = 0; g < gates.size(); g++) {
+    for (LWEPlaintext i = 0; i < 4; i++) {
+      LWEPlaintext m1 = i & 1;
+      LWEPlaintext m2 = i >> 1;
+      LWEPlaintext result;
+      cc.Decrypt(sk,
+                 cc.EvalBinGate(gates[g], cc.Encrypt(sk, m1),
+                                cc.Encrypt(sk, m2)),
+                 &result);
+      EXPECT_EQ(ExpectedGateBit(gates[g], m1, m2), result)
+          << names[g] << " failed for " << m1 << m2;
+    }
+  }
+}
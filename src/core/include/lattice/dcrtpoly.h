@@ -1280,6 +1280,32 @@ class DCRTPolyImpl : public ILElement<DCRTPolyImpl<VecType>, VecType> {
    */
   void SwitchFormat();
 
+  /**
+   * @brief Switches the format of several DCRTPolys at once; the towers of
+   * all of them go through one fused batched transform.
+   *
+   * @param &polys the DCRTPolys to convert.
+   */
+  static void SwitchFormat(const std::vector<DCRTPolyImpl *> &polys);
+
+  /**
+   * @brief Moves all towers into one 64-byte aligned slab of L x N words,
+   * tower i being the i-th N-word region. The towers remain ordinary
+   * NativePolys, so all operations keep working; in-place operations and
+   * assignments preserve the layout, and copies of a flat DCRTPoly are flat
+   * again and copied with a single memcpy. Operations that allocate new
+   * towers return to the per-tower layout; Flatten() can be called again.
+   */
+  void Flatten();
+
+  /**
+   * @brief Checks whether the towers are stored contiguously as produced by
+   * Flatten().
+   *
+   * @return true if the element uses the flat layout.
+   */
+  bool IsFlat() const;
+
   /**
    * @brief Switch modulus and adjust the values
    *
@@ -1533,6 +1559,9 @@ class DCRTPolyImpl : public ILElement<DCRTPolyImpl<VecType>, VecType> {
 
   // Either Format::EVALUATION (0) or Format::COEFFICIENT (1)
   Format m_format;
+
+  // makes the towers flat copies of the towers of a flat element
+  void CopyFlat(const DCRTPolyImpl &element);
 };
 }  // namespace lbcrypto
 
@@ -33,6 +33,7 @@
 #include "../utils/inttypes.h"
 #include "../math/nbtheory.h"
 #include "../lattice/ilparams.h"
+#include "../math/transfrm.h"
 
 namespace lbcrypto {
 
@@ -250,6 +251,26 @@ class ILDCRTParams : public ElemParams<IntType> {
     return resParams;
   }
 
+  /**
+   * @brief Pre-warms the NTT table registry for every tower, so that later
+   * transforms (including those running in parallel) only perform lock-free
+   * lookups.
+   *
+   * @return handles to the NTT tables of each tower; a handle is nullptr for
+   * a tower without a root of unity.
+   */
+  std::vector<const NTTTables<NativeVector> *> PreComputeNTTTables() const {
+    std::vector<const NTTTables<NativeVector> *> handles(m_parms.size(),
+                                                         nullptr);
+    for (size_t i = 0; i < m_parms.size(); i++) {
+      const NativeInteger &root = m_parms[i]->GetRootOfUnity();
+      if (root == NativeInteger(0) || root == NativeInteger(1)) continue;
+      handles[i] = ChineseRemainderTransformFTT<NativeVector>::GetTables(
+          root, m_parms[i]->GetCyclotomicOrder(), m_parms[i]->GetModulus());
+    }
+    return handles;
+  }
+
   /**
    * @brief Simple getter method for the original modulus, not the ciphertex
    * modulus.
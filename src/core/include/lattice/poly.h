@@ -401,6 +401,23 @@ class PolyImpl : public ILElement<PolyImpl<VecType>, VecType> {
    */
   void SetValues(const VecType &values, Format format);
 
+  /**
+   * @brief Set method of the values that takes over the storage of values,
+   * e.g., a vector placed in a region of an AlignedSlab.
+   *
+   * @param values is the set of values of the vector.
+   * @param format is the format, either COEFFICIENT or EVALUATION.
+   */
+  void SetValues(VecType &&values, Format format);
+
+  /**
+   * @brief Changes the format flag without transforming the values; used when
+   * the values were overwritten in place in a different representation.
+   *
+   * @param format is the format, either COEFFICIENT or EVALUATION.
+   */
+  void OverrideFormat(const Format format) { m_format = format; }
+
   /**
    * @brief Sets all values of element to zero.
    */
@@ -665,6 +682,15 @@ class PolyImpl : public ILElement<PolyImpl<VecType>, VecType> {
    */
   void SwitchFormat();
 
+  /**
+   * @brief Converts several polynomials from Coefficient to Evaluation format
+   * or vice versa (each one in its own direction) with one fused batched
+   * transform, e.g., all towers of a DCRTPoly.
+   *
+   * @param &polys the polynomials to convert.
+   */
+  static void SwitchFormat(const std::vector<PolyImpl *> &polys);
+
   /**
    * @brief Make the element values sparse. Sets every index not equal to zero
    * mod the wFactor to zero.
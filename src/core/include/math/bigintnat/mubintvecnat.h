@@ -37,6 +37,7 @@
 #include "../interface.h"
 #include "../../utils/serializable.h"
 #include "../../utils/inttypes.h"
+#include "../../utils/slaballocator.h"
 
 #include "../../utils/blockAllocator/xvector.h"
 
@@ -146,6 +147,20 @@ class NativeVector
    */
   NativeVector(usint length, const IntegerType &modulus);
 
+#if BLOCK_VECTOR_ALLOCATION != 1
+  /**
+   * Constructor that places the entries with the given allocator, e.g., in a
+   * region of an AlignedSlab shared with other vectors.
+   *
+   * @param length is the length of the native vector, in terms of the number of
+   * entries.
+   * @param modulus is the modulus of the ring.
+   * @param alloc is the allocator of the entries.
+   */
+  NativeVector(usint length, const IntegerType &modulus,
+               const lbcrypto::SlabAllocator<IntegerType> &alloc);
+#endif
+
   /**
    * Basic constructor for copying a vector
    *
@@ -302,6 +317,18 @@ class NativeVector
    */
   size_t GetLength() const { return this->m_data.size(); }
 
+#if BLOCK_VECTOR_ALLOCATION != 1
+  /**
+   * Gets the allocator of the entries.
+   *
+   * @return the allocator, which refers to a slab if the vector was
+   * constructed with one.
+   */
+  lbcrypto::SlabAllocator<IntegerType> GetAllocator() const {
+    return this->m_data.get_allocator();
+  }
+#endif
+
   // MODULAR ARITHMETIC OPERATIONS
 
   /**
@@ -648,7 +675,7 @@ class NativeVector
   // m_data is a pointer to the vector
 
 #if BLOCK_VECTOR_ALLOCATION != 1
-  std::vector<IntegerType> m_data;
+  std::vector<IntegerType, lbcrypto::SlabAllocator<IntegerType>> m_data;
 #else
   xvector<IntegerType> m_data;
 #endif
@@ -0,0 +1,108 @@
+/**
+ * @file rnsbaseconv.h This file contains the fast RNS base conversion
+ * kernels for native integer vectors.
+ * @author  TPOC: contact@palisade-crypto.org
+ *
+ * @copyright Copyright (c) 2019, New Jersey Institute of Technology (NJIT)
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution. THIS SOFTWARE IS
+ * PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef LBCRYPTO_MATH_RNSBASECONV_H
+#define LBCRYPTO_MATH_RNSBASECONV_H
+
+#include <cstdint>
+
+#include "backend.h"
+
+/**
+ * @namespace lbcrypto
+ * The namespace of lbcrypto
+ */
+namespace lbcrypto {
+
+/**
+ * @brief One fast base conversion of n coefficients from the moduli q_i to
+ * the moduli p_j.
+ *
+ * The conversion computes, for every coefficient k,
+ *   y_j[k] = \sum_i [x_i[k] * twist_i]_{q_i} * matrix_{j,i} mod p_j,
+ * i.e., the product of the n x sizeFrom matrix of (twisted) residues with
+ * the sizeFrom x sizeTo matrix of constants, reduced per column. If qModTo
+ * is set, the number of q-overflows alpha = Round(\sum_i [x_i twist_i]_{q_i}
+ * / q_i) is subtracted as well, y_j -= alpha * qModTo_j mod p_j, which makes
+ * the conversion exact (HPS).
+ */
+struct RNSBaseConvItem {
+  // number of coefficients
+  usint n;
+  // source residues: sizeFrom rows of n values
+  usint sizeFrom;
+  const uint64_t *const *from;
+  const uint64_t *fromModuli;
+  // optional factors twist_i mod q_i and their Shoup precomputations; the
+  // residues are used as they are if twist is nullptr
+  const uint64_t *twist;
+  const uint64_t *twistPrecon;
+  // target residues: sizeTo rows of n values
+  usint sizeTo;
+  uint64_t *const *to;
+  const uint64_t *toModuli;
+  // Barrett constants floor(2^128 / p_j)
+  const DoubleNativeInt *toModuliMu;
+  // constants in target-major order: matrix[j * sizeFrom + i]
+  const uint64_t *matrix;
+  // optional q mod p_j for the exact conversion
+  const uint64_t *qModTo;
+};
+
+/**
+ * @brief Fast RNS base conversion kernel shared by the CRT basis switching
+ * operations of DCRTPoly (HPS, BEHZ and hybrid key switching).
+ *
+ * The coefficients are processed in blocks that fit in the L1 cache: the
+ * twisted residues of a block are computed once and reused for every
+ * target modulus, and each dot product is accumulated lazily in 128 bits
+ * and reduced once. The AVX2 and AVX-512 variants accumulate several
+ * coefficients at a time, splitting each 64x64-bit product into 32-bit
+ * halves so that no carries have to be propagated; the instruction set
+ * follows NumberTheoreticTransformNat::GetKernel(). No memory is allocated
+ * per coefficient.
+ */
+class RNSBaseConversionNat {
+ public:
+  /**
+   * Runs a fast base conversion. Uses all OpenMP threads unless called from
+   * inside a parallel region. The rows of the targets may not overlap with
+   * the rows of the sources.
+   *
+   * @param &item describes the conversion.
+   */
+  static void FastBaseConv(const RNSBaseConvItem &item);
+
+  /**
+   * Number of coefficients per block.
+   */
+  static const usint BLOCK_SIZE = 64;
+};
+
+}  // namespace lbcrypto
+
+#endif
@@ -28,10 +28,12 @@
 #ifndef LBCRYPTO_MATH_TRANSFRM_H
 #define LBCRYPTO_MATH_TRANSFRM_H
 
+#include <atomic>
 #include <chrono>
 #include <complex>
 #include <fstream>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <thread>
 #include <time.h>
@@ -41,6 +43,7 @@
 #include "../utils/utilities.h"
 #include "backend.h"
 #include "nbtheory.h"
+#include "transfrmnat.h"
 
 #ifdef WITH_INTEL_HEXL
 #include "hexl/hexl.hpp"
@@ -249,8 +252,53 @@ class NumberTheoreticTransform {
       VecType *element);
 };
 
+/**
+ * @brief Precomputed tables for the negacyclic transform modulo a prime q in
+ * ring dimension n.
+ *
+ * Instances are created by ChineseRemainderTransformFTT and are never
+ * modified or freed once published, so a pointer to them is a stable handle
+ * that can be kept across transforms and shared between threads.
+ */
+template <typename VecType>
+struct NTTTables {
+  using IntType = typename VecType::Integer;
+
+  // the prime modulus q
+  IntType modulus;
+  // the 2n-th root of unity the tables were built from
+  IntType rootOfUnity;
+  // cyclotomic order 2n
+  usint cycloOrder;
+  // powers of the root of unity and of its inverse in bit-reversed order
+  VecType rootOfUnityReverseTable;
+  VecType rootOfUnityInverseReverseTable;
+  // n^{-1} mod q
+  IntType cycloOrderInverse;
+  // Shoup precomputations; only populated for native integers
+  NativeVector rootOfUnityPreconReverseTable;
+  NativeVector rootOfUnityInversePreconReverseTable;
+  NativeInteger cycloOrderInversePrecon;
+#ifdef WITH_INTEL_HEXL
+  std::unique_ptr<intel::hexl::NTT> intelNtt;
+#endif
+};
+
 /**
  * @brief Golden Chinese Remainder Transform FFT implemetation.
+ *
+ * The precomputed tables are kept in a registry keyed by (modulus, cyclotomic
+ * order). Lookups are lock-free: readers load an immutable snapshot of the
+ * registry, while the rare insertions build the new tables outside of any
+ * lock and publish a new snapshot under a mutex.
+ *
+ * A snapshot replaced by an insertion or by Reset() is freed as soon as a
+ * writer observes no lookup in flight, so at most one live snapshot plus the
+ * ones retired during overlapping lookups are kept. Each insertion copies the
+ * current snapshot, which costs O(k) for k registered tables. The tables
+ * themselves are never freed, since handles to them are cached by the
+ * element parameters; their number is bounded by the number of distinct
+ * (modulus, order) pairs registered between resets.
  */
 template <typename VecType>
 class ChineseRemainderTransformFTT {
@@ -329,6 +377,81 @@ class ChineseRemainderTransformFTT {
                                                     const usint CycloOrder,
                                                     VecType *element);
 
+  /**
+   * In-place Forward Transform using previously obtained tables; no registry
+   * lookup is performed.
+   *
+   * @param &tables is the handle returned by GetTables().
+   * @param[in,out] &element is the input to the transform of type VecType and
+   * length n; its modulus must match the tables.
+   * @return none
+   */
+  static void ForwardTransformToBitReverseInPlace(
+      const NTTTables<VecType> &tables, VecType *element);
+
+  /**
+   * In-place Inverse Transform using previously obtained tables; no registry
+   * lookup is performed.
+   *
+   * @param &tables is the handle returned by GetTables().
+   * @param[in,out] &element is the input to the transform of type VecType and
+   * length n; its modulus must match the tables.
+   * @return none
+   */
+  static void InverseTransformFromBitReverseInPlace(
+      const NTTTables<VecType> &tables, VecType *element);
+
+  /**
+   * Batched in-place Forward Transform of several vectors, e.g., all towers of
+   * a DCRTPoly. For native vectors of equal length the transforms are fused
+   * and split by (vector, block) across all threads; other vectors are
+   * transformed one per thread.
+   *
+   * @param &tables are the handles returned by GetTables(), one per vector.
+   * @param &elements are the inputs/outputs of the transforms.
+   * @return none
+   */
+  static void ForwardTransformToBitReverseInPlace(
+      const std::vector<const NTTTables<VecType> *> &tables,
+      const std::vector<VecType *> &elements);
+
+  /**
+   * Batched in-place Inverse Transform of several vectors; see the batched
+   * ForwardTransformToBitReverseInPlace().
+   *
+   * @param &tables are the handles returned by GetTables(), one per vector.
+   * @param &elements are the inputs/outputs of the transforms.
+   * @return none
+   */
+  static void InverseTransformFromBitReverseInPlace(
+      const std::vector<const NTTTables<VecType> *> &tables,
+      const std::vector<VecType *> &elements);
+
+  /**
+   * Looks up the tables for a (modulus, cyclotomic order) pair without
+   * computing them. Lock-free.
+   *
+   * @param &modulus is q, the prime modulus.
+   * @param CycloOrder is a power-of-two, equal to 2n.
+   * @return a stable handle to the tables, or nullptr if they were not
+   * precomputed.
+   */
+  static const NTTTables<VecType> *FindTables(const IntType &modulus,
+                                              const usint CycloOrder);
+
+  /**
+   * Returns the tables for a (modulus, cyclotomic order) pair, computing and
+   * registering them first if needed.
+   *
+   * @param &rootOfUnity is the 2n-th root of unity in Z_q.
+   * @param CycloOrder is a power-of-two, equal to 2n.
+   * @param &modulus is q, the prime modulus.
+   * @return a stable handle to the tables.
+   */
+  static const NTTTables<VecType> *GetTables(const IntType &rootOfUnity,
+                                             const usint CycloOrder,
+                                             const IntType &modulus);
+
   /**
    * Precomputation of root of unity tables for transforms in the ring
    * Z_q[X]/(X^n+1)
@@ -357,28 +480,46 @@ class ChineseRemainderTransformFTT {
                          std::vector<IntType> &moduliChain);
 
   /**
-   * Reset cached values for the root of unity tables to empty.
+   * Reset cached values for the root of unity tables to empty. Handles
+   * obtained before the reset stay valid, but are no longer returned by
+   * lookups, and registering the same pair again allocates new tables.
    */
   static void Reset();
 
-  // private:
-  static std::map<IntType, VecType> m_cycloOrderInverseTableByModulus;
-  static std::map<IntType, NativeVector>
-      m_cycloOrderInversePreconTableByModulus;
-  static std::map<IntType, VecType> m_rootOfUnityReverseTableByModulus;
-  static std::map<IntType, VecType> m_rootOfUnityInverseReverseTableByModulus;
-  static std::map<IntType, NativeVector>
-      m_rootOfUnityPreconReverseTableByModulus;
-  static std::map<IntType, NativeVector>
-      m_rootOfUnityInversePreconReverseTableByModulus;
+ private:
+  using TablesKey = std::pair<IntType, usint>;
+  // sorted by key; searched with a binary search
+  using TablesSnapshot =
+      std::vector<std::pair<TablesKey, const NTTTables<VecType> *>>;
+
+  // owns every table set ever published, so that handles are never freed
+  // under their users, plus the current snapshot and the retired snapshots
+  // that may still be read by a lookup in flight
+  struct TablesStorage {
+    std::vector<std::unique_ptr<NTTTables<VecType>>> tables;
+    std::unique_ptr<TablesSnapshot> current;
+    std::vector<std::unique_ptr<TablesSnapshot>> retired;
+  };
+
+  static TablesStorage &Storage();
+
+  // replaces the current snapshot and frees the retired ones if no lookup is
+  // in flight; must be called with m_tablesMutex held
+  static void Publish(std::unique_ptr<TablesSnapshot> next);
+
+  static const NTTTables<VecType> *AddTables(const IntType &rootOfUnity,
+                                             const usint CycloOrder,
+                                             const IntType &modulus);
+
+  static void CheckTables(const NTTTables<VecType> &tables,
+                          const VecType &element);
 
-#ifdef WITH_INTEL_HEXL
-  // Key is <modulus, CycloOrderHalf>
-  static std::unordered_map<std::pair<uint64_t, uint64_t>, intel::hexl::NTT,
-                            HashPair>
-      m_IntelNtt;
-  static std::mutex m_mtxIntelNTT;
-#endif
+  // current immutable snapshot of the registry; nullptr when empty
+  static std::atomic<const TablesSnapshot *> m_tables;
+  // number of lookups currently reading a snapshot
+  static std::atomic<size_t> m_readers;
+  // serializes insertions into the registry
+  static std::mutex m_tablesMutex;
 };
 
 // struct used as a key in BlueStein transform
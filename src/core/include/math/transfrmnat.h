@@ -0,0 +1,196 @@
+/**
+ * @file transfrmnat.h This file contains the lazy-butterfly NTT kernels
+ * for native integer vectors.
+ * @author  TPOC: contact@palisade-crypto.org
+ *
+ * @copyright Copyright (c) 2019, New Jersey Institute of Technology (NJIT)
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution. THIS SOFTWARE IS
+ * PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef LBCRYPTO_MATH_TRANSFRMNAT_H
+#define LBCRYPTO_MATH_TRANSFRMNAT_H
+
+#include <cstdint>
+#include <vector>
+
+#include "backend.h"
+
+/**
+ * @namespace lbcrypto
+ * The namespace of lbcrypto
+ */
+namespace lbcrypto {
+
+/**
+ * @brief Instruction set used by the native NTT kernels.
+ */
+enum NTTKernelType { NTT_SCALAR = 0, NTT_AVX2 = 1, NTT_AVX512 = 2 };
+
+/**
+ * @brief One vector of a batched native transform, together with its tables.
+ *
+ * For forward transforms the tables are the root of unity tables; for
+ * inverse transforms they are the inverse root of unity tables, and
+ * cycloOrderInv/preconCycloOrderInv hold n^{-1} mod q and its Shoup
+ * precomputation.
+ */
+struct NTTBatchItem {
+  const uint64_t *rootOfUnity;
+  const uint64_t *preconRoot;
+  uint64_t cycloOrderInv;
+  uint64_t preconCycloOrderInv;
+  uint64_t modulus;
+  uint64_t *element;
+};
+
+/**
+ * @brief Number Theoretic Transform kernels for native 64-bit moduli.
+ *
+ * The kernels implement the Cooley-Tukey (forward) and Gentleman-Sande
+ * (inverse) negacyclic transforms with the lazy butterflies described in
+ * https://arxiv.org/pdf/1205.2926.pdf (Dave Harvey, FASTER ARITHMETIC FOR
+ * NUMBER-THEORETIC TRANSFORMS): intermediate values are kept in [0, 4q) and
+ * only reduced to [0, q) once at the end of the transform. The root of unity
+ * tables and their Shoup precomputations are the same ones built by
+ * ChineseRemainderTransformFTT::PreCompute().
+ *
+ * The AVX2 and AVX-512 kernels are compiled with function-level target
+ * attributes and selected at runtime, so no special compiler flags are needed
+ * and the library still runs on machines without these extensions.
+ */
+class NumberTheoreticTransformNat {
+ public:
+  /**
+   * In-place forward transform in the ring Z_q[X]/(X^n+1) with bit-reversed
+   * output.
+   *
+   * @param &rootOfUnityTable is the bit-reversed table of powers of the 2n-th
+   * root of unity.
+   * @param &preconRootOfUnityTable is the Shoup precomputation of
+   * rootOfUnityTable.
+   * @param[in,out] *element is the input/output of the transform, of length n.
+   */
+  static void ForwardTransformToBitReverseInPlace(
+      const NativeVector &rootOfUnityTable,
+      const NativeVector &preconRootOfUnityTable, NativeVector *element);
+
+  /**
+   * In-place inverse transform in the ring Z_q[X]/(X^n+1) with bit-reversed
+   * input.
+   *
+   * @param &rootOfUnityInverseTable is the bit-reversed table of powers of the
+   * inverse of the 2n-th root of unity.
+   * @param &preconRootOfUnityInverseTable is the Shoup precomputation of
+   * rootOfUnityInverseTable.
+   * @param &cycloOrderInv is n^{-1} mod q.
+   * @param &preconCycloOrderInv is the Shoup precomputation of cycloOrderInv.
+   * @param[in,out] *element is the input/output of the transform, of length n.
+   */
+  static void InverseTransformFromBitReverseInPlace(
+      const NativeVector &rootOfUnityInverseTable,
+      const NativeVector &preconRootOfUnityInverseTable,
+      const NativeInteger &cycloOrderInv,
+      const NativeInteger &preconCycloOrderInv, NativeVector *element);
+
+  /**
+   * Raw-pointer variant of ForwardTransformToBitReverseInPlace() operating on
+   * n coefficients in [0, q).
+   */
+  static void ForwardTransformToBitReverseInPlace(const uint64_t *rootOfUnity,
+                                                  const uint64_t *preconRoot,
+                                                  uint64_t modulus, usint n,
+                                                  uint64_t *element);
+
+  /**
+   * Raw-pointer variant of InverseTransformFromBitReverseInPlace() operating
+   * on n coefficients in [0, q).
+   */
+  static void InverseTransformFromBitReverseInPlace(
+      const uint64_t *rootOfUnityInverse, const uint64_t *preconRootInverse,
+      uint64_t cycloOrderInv, uint64_t preconCycloOrderInv, uint64_t modulus,
+      usint n, uint64_t *element);
+
+  /**
+   * Batched in-place forward transform of several vectors of the same length,
+   * e.g., all towers of a DCRTPoly. When there are fewer vectors than
+   * threads, each vector is split into blocks: the stages that mix blocks are
+   * run for all (vector, block) pairs with a barrier in between, and the
+   * remaining stages of every block run as independent tasks on contiguous
+   * data. Uses all OpenMP threads unless called from inside a parallel
+   * region.
+   *
+   * @param &items are the vectors and their tables.
+   * @param n is the length of every vector.
+   */
+  static void ForwardTransformToBitReverseInPlace(
+      const std::vector<NTTBatchItem> &items, usint n);
+
+  /**
+   * Batched in-place inverse transform of several vectors of the same length;
+   * see the batched ForwardTransformToBitReverseInPlace().
+   *
+   * @param &items are the vectors and their inverse tables.
+   * @param n is the length of every vector.
+   */
+  static void InverseTransformFromBitReverseInPlace(
+      const std::vector<NTTBatchItem> &items, usint n);
+
+  /**
+   * Lazy butterflies keep values in [0, 4q), so the modulus has to satisfy
+   * 4q < 2^64.
+   *
+   * @param &modulus is the modulus q.
+   * @return true if the kernels can be used with this modulus.
+   */
+  static bool IsSupportedModulus(const NativeInteger &modulus) {
+    return modulus.ConvertToInt() < (uint64_t(1) << MAX_MODULUS_BITS);
+  }
+
+  /**
+   * @return true if the running CPU supports the given kernel.
+   */
+  static bool IsKernelAvailable(NTTKernelType kernel);
+
+  /**
+   * @return the widest kernel supported by the running CPU.
+   */
+  static NTTKernelType GetBestAvailableKernel();
+
+  /**
+   * @return the kernel currently used by the transforms.
+   */
+  static NTTKernelType GetKernel();
+
+  /**
+   * Overrides the kernel used by the transforms, e.g., for benchmarking or
+   * testing. Requesting a kernel the CPU does not support throws a
+   * math_error.
+   *
+   * @param kernel is the kernel to use.
+   */
+  static void SetKernel(NTTKernelType kernel);
+
+  static const usint MAX_MODULUS_BITS = 62;
+};
+
+}  // namespace lbcrypto
+
+#endif
@@ -27,10 +27,39 @@
 #ifndef SRC_CORE_LIB_UTILS_PARALLEL_H_
 #define SRC_CORE_LIB_UTILS_PARALLEL_H_
 
+#include <exception>
 #include "omp.h"
 //#include <iostream>
 namespace lbcrypto {
 
+/**
+ * @brief Carries exceptions out of OpenMP regions. An exception must not
+ * leave a parallel region, so each iteration runs its body through Run,
+ * which keeps the first exception thrown by any thread; Rethrow, called
+ * after the region, throws it in the calling thread.
+ */
+class OMPExceptionHandler {
+ public:
+  template <typename Function>
+  void Run(Function func) {
+    try {
+      func();
+    } catch (...) {
+#pragma omp critical(OMPExceptionHandler)
+      {
+        if (!m_error) m_error = std::current_exception();
+      }
+    }
+  }
+
+  void Rethrow() const {
+    if (m_error) std::rethrow_exception(m_error);
+  }
+
+ private:
+  std::exception_ptr m_error;
+};
+
 class ParallelControls {
   int machineThreads;
 
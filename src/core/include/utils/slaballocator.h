@@ -0,0 +1,198 @@
+/**
+ * @file slaballocator.h Aligned slabs shared by several vectors.
+ * @author  TPOC: contact@palisade-crypto.org
+ *
+ * @copyright Copyright (c) 2019, New Jersey Institute of Technology (NJIT)
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution. THIS SOFTWARE IS
+ * PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#ifndef LBCRYPTO_UTILS_SLABALLOCATOR_H
+#define LBCRYPTO_UTILS_SLABALLOCATOR_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#include "vectorpool.h"
+
+namespace lbcrypto {
+
+/**
+ * @brief One 64-byte aligned allocation split into equally sized regions,
+ * e.g., one region per tower of a DCRTPoly. Each region can be handed out to
+ * at most one vector at a time. Acquire and Release may be called
+ * concurrently, e.g., from tower loops run with OpenMP.
+ */
+class AlignedSlab {
+ public:
+  static const size_t ALIGNMENT = 64;
+
+  /**
+   * @param regions is the number of regions.
+   * @param regionBytes is the minimum size of each region; it is rounded up
+   * to a multiple of ALIGNMENT so that every region is aligned.
+   */
+  AlignedSlab(size_t regions, size_t regionBytes)
+      : m_regionBytes(RegionSize(regionBytes)), m_inUse(regions) {
+    for (auto &inUse : m_inUse) inUse.store(0, std::memory_order_relaxed);
+    m_buffer.reset(new char[regions * m_regionBytes + ALIGNMENT]);
+    uintptr_t address = reinterpret_cast<uintptr_t>(m_buffer.get());
+    m_data = m_buffer.get() + (ALIGNMENT - address % ALIGNMENT) % ALIGNMENT;
+  }
+
+  /**
+   * @return the size of a region that holds at least bytes bytes.
+   */
+  static size_t RegionSize(size_t bytes) {
+    return (bytes + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+  }
+
+  char *GetData() { return m_data; }
+
+  size_t GetRegionBytes() const { return m_regionBytes; }
+
+  size_t GetRegions() const { return m_inUse.size(); }
+
+  /**
+   * @return the start of the region.
+   */
+  const char *GetRegion(size_t region) const {
+    return m_data + region * m_regionBytes;
+  }
+
+  /**
+   * Hands out a region if it is free and large enough.
+   *
+   * @return the start of the region, or nullptr.
+   */
+  void *Acquire(size_t region, size_t bytes) {
+    if (region >= m_inUse.size() || bytes > m_regionBytes) {
+      return nullptr;
+    }
+    uint8_t expected = 0;
+    if (!m_inUse[region].compare_exchange_strong(expected, 1,
+                                                 std::memory_order_acquire)) {
+      return nullptr;
+    }
+    return m_data + region * m_regionBytes;
+  }
+
+  /**
+   * Returns a region to the slab.
+   *
+   * @return false if p does not point into the slab.
+   */
+  bool Release(const void *p) {
+    const char *ptr = static_cast<const char *>(p);
+    if (ptr < m_data || ptr >= m_data + m_inUse.size() * m_regionBytes) {
+      return false;
+    }
+    m_inUse[(ptr - m_data) / m_regionBytes].store(0,
+                                                  std::memory_order_release);
+    return true;
+  }
+
+ private:
+  std::unique_ptr<char[]> m_buffer;
+  char *m_data;
+  size_t m_regionBytes;
+  // one byte per region, so that regions never share a flag word
+  std::vector<std::atomic<uint8_t>> m_inUse;
+};
+
+/**
+ * @brief STL allocator that places a vector into one region of an
+ * AlignedSlab and falls back to the VectorMemoryPool otherwise.
+ *
+ * A default-constructed allocator never uses a slab. Copies of a
+ * container get an allocator without a slab, while assignments keep the slab
+ * region of the target, so the layout of a slab is preserved when values are
+ * assigned into it.
+ */
+template <class T>
+class SlabAllocator {
+ public:
+  typedef T value_type;
+  typedef std::true_type propagate_on_container_swap;
+
+  SlabAllocator() : m_region(0) {}
+
+  SlabAllocator(const std::shared_ptr<AlignedSlab> &slab, size_t region)
+      : m_slab(slab), m_region(region) {}
+
+  template <class U>
+  SlabAllocator(const SlabAllocator<U> &other)
+      : m_slab(other.m_slab), m_region(other.m_region) {}
+
+  T *allocate(size_t n) {
+    if (m_slab != nullptr) {
+      void *p = m_slab->Acquire(m_region, n * sizeof(T));
+      if (p != nullptr) {
+        return static_cast<T *>(p);
+      }
+    }
+    return static_cast<T *>(VectorMemoryPool::Allocate(n * sizeof(T)));
+  }
+
+  void deallocate(T *p, size_t n) {
+    if (m_slab != nullptr && m_slab->Release(p)) {
+      return;
+    }
+    VectorMemoryPool::Deallocate(p, n * sizeof(T));
+  }
+
+  SlabAllocator select_on_container_copy_construction() const {
+    return SlabAllocator();
+  }
+
+  /**
+   * @return the slab the allocator places vectors in, or nullptr.
+   */
+  const std::shared_ptr<AlignedSlab> &GetSlab() const { return m_slab; }
+
+  size_t GetRegion() const { return m_region; }
+
+  template <class U>
+  bool operator==(const SlabAllocator<U> &other) const {
+    return m_slab == other.m_slab && m_region == other.m_region;
+  }
+
+  template <class U>
+  bool operator!=(const SlabAllocator<U> &other) const {
+    return !(*this == other);
+  }
+
+ private:
+  template <class U>
+  friend class SlabAllocator;
+
+  std::shared_ptr<AlignedSlab> m_slab;
+  size_t m_region;
+};
+
+}  // namespace lbcrypto
+
+#endif  // LBCRYPTO_UTILS_SLABALLOCATOR_H
@@ -0,0 +1,129 @@
+/**
+ * @file vectorpool.h Per-thread pool for the storage of native vectors.
+ * @author  TPOC: contact@palisade-crypto.org
+ *
+ * @copyright Copyright (c) 2019, New Jersey Institute of Technology (NJIT)
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution. THIS SOFTWARE IS
+ * PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef LBCRYPTO_UTILS_VECTORPOOL_H
+#define LBCRYPTO_UTILS_VECTORPOOL_H
+
+#include <atomic>
+#include <cstddef>
+
+namespace lbcrypto {
+
+/**
+ * @brief Per-thread cache of vector storage for operations that create and
+ * drop many same-sized temporaries, e.g., key switching.
+ *
+ * While at least one ScopedVectorPool is alive, the storage of NativeVectors
+ * released on any thread is kept in a lock-free cache of that thread, keyed
+ * by its exact size, and reused by the next allocation of the same size on
+ * that thread. Only power-of-two sizes of at least MIN_POOLED_BYTES are
+ * pooled, which covers the towers of power-of-two cyclotomic rings. The
+ * cache of each thread is bounded by GetMaxCachedBytes(); storage beyond the
+ * bound goes back to the heap.
+ *
+ * When the last ScopedVectorPool ends, the caches of all threads become
+ * stale: each thread, e.g., an OpenMP worker, frees its cache at its next
+ * allocation or deallocation, or when it exits. Release() frees the cache of
+ * the calling thread right away.
+ */
+class VectorMemoryPool {
+ public:
+  static const size_t MIN_POOLED_BYTES = 4096;
+
+  /**
+   * Allocates bytes bytes, from the cache of the calling thread if possible.
+   */
+  static void *Allocate(size_t bytes);
+
+  /**
+   * Releases storage obtained from Allocate() or from ::operator new with the
+   * same size.
+   */
+  static void Deallocate(void *p, size_t bytes);
+
+  /**
+   * @return true if a ScopedVectorPool is alive on any thread.
+   */
+  static bool IsActive() {
+    return s_activeScopes.load(std::memory_order_relaxed) > 0;
+  }
+
+  /**
+   * @return the number of times the last ScopedVectorPool has ended; caches
+   * filled in an earlier generation are freed.
+   */
+  static size_t GetGeneration() {
+    return s_generation.load(std::memory_order_acquire);
+  }
+
+  /**
+   * @return the number of bytes cached by the calling thread.
+   */
+  static size_t GetCachedBytes();
+
+  /**
+   * Frees the cache of the calling thread.
+   */
+  static void Release();
+
+  static size_t GetMaxCachedBytes() {
+    return s_maxCachedBytes.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Sets the bound of the cache of each thread; 0 disables caching.
+   */
+  static void SetMaxCachedBytes(size_t bytes) {
+    s_maxCachedBytes.store(bytes, std::memory_order_relaxed);
+  }
+
+ private:
+  friend class ScopedVectorPool;
+
+  static std::atomic<int> s_activeScopes;
+  static std::atomic<size_t> s_generation;
+  static std::atomic<size_t> s_maxCachedBytes;
+};
+
+/**
+ * @brief Enables the VectorMemoryPool for the lifetime of the object.
+ */
+class ScopedVectorPool {
+ public:
+  ScopedVectorPool() { VectorMemoryPool::s_activeScopes++; }
+  ~ScopedVectorPool() {
+    if (--VectorMemoryPool::s_activeScopes == 0) {
+      VectorMemoryPool::s_generation.fetch_add(1, std::memory_order_release);
+    }
+  }
+
+  ScopedVectorPool(const ScopedVectorPool &) = delete;
+  ScopedVectorPool &operator=(const ScopedVectorPool &) = delete;
+};
+
+}  // namespace lbcrypto
+
+#endif  // LBCRYPTO_UTILS_VECTORPOOL_H
@@ -25,6 +25,7 @@
  *
  */
 
+#include <cstring>
 #include <fstream>
 #include <memory>
 
@@ -33,6 +34,7 @@
 #endif
 
 #include "lattice/dcrtpoly.h"
+#include "math/rnsbaseconv.h"
 #include "utils/debug.h"
 
 using std::shared_ptr;
@@ -40,6 +42,60 @@ using std::string;
 
 namespace lbcrypto {
 
+namespace {
+
+inline uint64_t *TowerData(PolyImpl<NativeVector> &tower) {
+  return reinterpret_cast<uint64_t *>(&tower[0]);
+}
+
+inline const uint64_t *TowerData(const PolyImpl<NativeVector> &tower) {
+  return reinterpret_cast<const uint64_t *>(&tower[0]);
+}
+
+// the flattened tables of one fast base conversion (see RNSBaseConvItem)
+struct BaseConvTables {
+  BaseConvTables(usint sizeFrom, usint sizeTo)
+      : from(sizeFrom),
+        fromModuli(sizeFrom),
+        twist(sizeFrom),
+        twistPrecon(sizeFrom),
+        to(sizeTo),
+        toModuli(sizeTo),
+        toModuliMu(sizeTo),
+        matrix(sizeFrom * sizeTo) {}
+
+  // twisted selects whether the residues are multiplied by twist first;
+  // the conversion is exact if qModTo is filled
+  RNSBaseConvItem Item(usint n, bool twisted) const {
+    RNSBaseConvItem item;
+    item.n = n;
+    item.sizeFrom = from.size();
+    item.from = from.data();
+    item.fromModuli = fromModuli.data();
+    item.twist = twisted ? twist.data() : nullptr;
+    item.twistPrecon = twisted ? twistPrecon.data() : nullptr;
+    item.sizeTo = to.size();
+    item.to = to.data();
+    item.toModuli = toModuli.data();
+    item.toModuliMu = toModuliMu.data();
+    item.matrix = matrix.data();
+    item.qModTo = qModTo.empty() ? nullptr : qModTo.data();
+    return item;
+  }
+
+  std::vector<const uint64_t *> from;
+  std::vector<uint64_t> fromModuli;
+  std::vector<uint64_t> twist;
+  std::vector<uint64_t> twistPrecon;
+  std::vector<uint64_t *> to;
+  std::vector<uint64_t> toModuli;
+  std::vector<DoubleNativeInt> toModuliMu;
+  std::vector<uint64_t> matrix;
+  std::vector<uint64_t> qModTo;
+};
+
+}  // namespace
+
 /*CONSTRUCTORS*/
 template <typename VecType>
 DCRTPolyImpl<VecType>::DCRTPolyImpl() {
@@ -66,7 +122,11 @@ DCRTPolyImpl<VecType>::DCRTPolyImpl(
 template <typename VecType>
 DCRTPolyImpl<VecType>::DCRTPolyImpl(const DCRTPolyImpl &element) {
   m_format = element.m_format;
-  m_vectors = element.m_vectors;
+  if (element.IsFlat()) {
+    CopyFlat(element);
+  } else {
+    m_vectors = element.m_vectors;
+  }
   m_params = element.m_params;
 }
 
@@ -726,7 +786,11 @@ template <typename VecType>
 const DCRTPolyImpl<VecType> &DCRTPolyImpl<VecType>::operator=(
     const DCRTPolyImpl &rhs) {
   if (this != &rhs) {
-    m_vectors = rhs.m_vectors;
+    if (rhs.IsFlat() && !IsFlat()) {
+      CopyFlat(rhs);
+    } else {
+      m_vectors = rhs.m_vectors;
+    }
     m_format = rhs.m_format;
     m_params = rhs.m_params;
   }
@@ -1743,32 +1807,29 @@ DCRTPolyImpl<VecType> DCRTPolyImpl<VecType>::ApproxSwitchCRTBasis(
   // Creates a DCRTPoly with towers from params, and initializes element to 0.
   DCRTPolyType ans(paramsTo, m_format, true);
 
-  usint ringDimension = GetRingDimension();
   usint nTowersFrom = (m_vectors.size() > paramsFrom->GetParams().size())
                           ? paramsFrom->GetParams().size()
                           : m_vectors.size();
   usint nTowersTo = ans.m_vectors.size();
 
-#pragma omp parallel for
-  for (usint rIndex = 0; rIndex < ringDimension; rIndex++) {
-    vector<DoubleNativeInt> sum(nTowersTo);
-    for (usint j = 0; j < nTowersFrom; j++) {
-      const NativeInteger &ai = m_vectors[j].GetValues()[rIndex];
-      NativeInteger tmp1 = ai.ModMulFastConst(
-          hatInvModFrom[j], paramsFrom->GetParams()[j]->GetModulus(),
-          hatInvModFromPrecon[j]);
-      for (usint i = 0; i < nTowersTo; i++) {
-        sum[i] += Mul128(tmp1.ConvertToInt(), hatModTo[j][i].ConvertToInt());
-      }
-    }
-
-    for (usint i = 0; i < nTowersTo; i++) {
-      ans.m_vectors[i].at(rIndex) = NativeInteger(BarrettUint128ModUint64(
-          sum[i], paramsTo->GetParams()[i]->GetModulus().ConvertToInt(),
-          modBarretPrecon[i]));
-    }
+  BaseConvTables tables(nTowersFrom, nTowersTo);
+  for (usint i = 0; i < nTowersFrom; i++) {
+    tables.from[i] = TowerData(m_vectors[i]);
+    tables.fromModuli[i] =
+        paramsFrom->GetParams()[i]->GetModulus().ConvertToInt();
+    tables.twist[i] = hatInvModFrom[i].ConvertToInt();
+    tables.twistPrecon[i] = hatInvModFromPrecon[i].ConvertToInt();
+  }
+  for (usint j = 0; j < nTowersTo; j++) {
+    tables.to[j] = TowerData(ans.m_vectors[j]);
+    tables.toModuli[j] = paramsTo->GetParams()[j]->GetModulus().ConvertToInt();
+    tables.toModuliMu[j] = modBarretPrecon[j];
+    for (usint i = 0; i < nTowersFrom; i++)
+      tables.matrix[j * nTowersFrom + i] = hatModTo[i][j].ConvertToInt();
   }
 
+  RNSBaseConversionNat::FastBaseConv(tables.Item(GetRingDimension(), true));
+
   return std::move(ans);
 }
 
@@ -1898,60 +1959,29 @@ DCRTPolyImpl<VecType> DCRTPolyImpl<VecType>::SwitchCRTBasis(
     const std::vector<NativeInteger> &qInvModqiPrecon) const {
   DCRTPolyType ans(params, m_format, true);
 
-  usint ringDimension = GetRingDimension();
   usint nTowers = m_vectors.size();
   usint nTowersNew = ans.m_vectors.size();
 
-  std::vector<NativeInteger> mu(nTowersNew);
-  for (usint i = 0; i < nTowersNew; i++) {
-    const NativeInteger &si = ans.m_vectors[i].GetModulus();
-    mu[i] = si.ComputeMu();
+  BaseConvTables tables(nTowers, nTowersNew);
+  for (usint i = 0; i < nTowers; i++) {
+    tables.from[i] = TowerData(m_vectors[i]);
+    tables.fromModuli[i] = m_vectors[i].GetModulus().ConvertToInt();
+    tables.twist[i] = qInvModqi[i].ConvertToInt();
+    tables.twistPrecon[i] = qInvModqiPrecon[i].ConvertToInt();
   }
-
-#pragma omp parallel for
-  for (usint rIndex = 0; rIndex < ringDimension; rIndex++) {
-    std::vector<NativeInteger> xInvVector(nTowers);
-    double nu = 0.0;
-
-    // Compute alpha and vector of x_i terms
-    for (usint vIndex = 0; vIndex < nTowers; vIndex++) {
-      const NativeInteger &xi = m_vectors[vIndex].GetValues()[rIndex];
-      const NativeInteger &qi = m_vectors[vIndex].GetModulus();
-
-      // computes [xi (q/qi)^{-1}]_qi
-      xInvVector[vIndex] =
-          xi.ModMulFastConst(qInvModqi[vIndex], qi, qInvModqiPrecon[vIndex]);
-
-      // computes [xi (q/qi)^{-1}]_qi / qi to keep track of the number of
-      // q-overflows
-      nu +=
-          (double)xInvVector[vIndex].ConvertToInt() / (double)qi.ConvertToInt();
-    }
-
-    // alpha corresponds to the number of overflows
-    NativeInteger alpha = std::llround(nu);
-
-    for (usint newvIndex = 0; newvIndex < nTowersNew; newvIndex++) {
-      DoubleNativeInt curValue = 0;
-
-      const NativeInteger &si = ans.m_vectors[newvIndex].GetModulus();
-
-      // first round - compute "fast conversion"
-      for (usint vIndex = 0; vIndex < nTowers; vIndex++) {
-        curValue += Mul128(xInvVector[vIndex].ConvertToInt(),
-                           qDivqiModsi[newvIndex][vIndex].ConvertToInt());
-      }
-
-      const NativeInteger &curNativeValue =
-          NativeInteger(BarrettUint128ModUint64(curValue, si.ConvertToInt(),
-                                                siModulimu[newvIndex]));
-
-      // second round - remove q-overflows
-      ans.m_vectors[newvIndex].at(rIndex) = curNativeValue.ModSubFast(
-          alpha.ModMulFast(qModsi[newvIndex], si, mu[newvIndex]), si);
-    }
+  tables.qModTo.resize(nTowersNew);
+  for (usint j = 0; j < nTowersNew; j++) {
+    tables.to[j] = TowerData(ans.m_vectors[j]);
+    tables.toModuli[j] = ans.m_vectors[j].GetModulus().ConvertToInt();
+    tables.toModuliMu[j] = siModulimu[j];
+    tables.qModTo[j] = qModsi[j].ConvertToInt();
+    for (usint i = 0; i < nTowers; i++)
+      tables.matrix[j * nTowers + i] = qDivqiModsi[j][i].ConvertToInt();
   }
 
+  // the fast conversion followed by the removal of the alpha q-overflows
+  RNSBaseConversionNat::FastBaseConv(tables.Item(GetRingDimension(), true));
+
   return std::move(ans);
 }
 
@@ -2135,20 +2165,6 @@ void DCRTPolyImpl<VecType>::FastBaseConvqToBskMontgomery(
 
   // ----------------------- step 0 -----------------------
 
-  // first we twist xi by mtilde*(q/qi)^-1 mod qi
-  NativeInteger *ximtildeqiDivqModqi = new NativeInteger[n * numq];
-  for (uint32_t i = 0; i < numq; i++) {
-    const NativeInteger &currentmtildeqDivqiModqi = mtildeqDivqiModqi[i];
-    const NativeInteger &currentmtildeqDivqiModqiPrecon =
-        mtildeqDivqiModqiPrecon[i];
-
-#pragma omp parallel for
-    for (uint32_t k = 0; k < n; k++) {
-      ximtildeqiDivqModqi[i * n + k] = m_vectors[i][k].ModMulFastConst(
-          currentmtildeqDivqiModqi, qModuli[i], currentmtildeqDivqiModqiPrecon);
-    }
-  }
-
   for (uint32_t j = 0; j < numBsk + 1; j++) {
     if (j < numBsk) {
       // TODO check this
@@ -2159,19 +2175,24 @@ void DCRTPolyImpl<VecType>::FastBaseConvqToBskMontgomery(
       PolyType newvec(m_params->GetParams()[0], m_format, true);
       m_vectors[numq + j] = std::move(newvec);
     }
+  }
 
-#pragma omp parallel for
-    for (uint32_t k = 0; k < n; k++) {
-      DoubleNativeInt result = 0;
-      for (uint32_t i = 0; i < numq; i++) {
-        const NativeInteger &qDivqiModBjValue = qDivqiModBj[i][j];
-        result += Mul128(ximtildeqiDivqModqi[i * n + k].ConvertToInt(),
-                         qDivqiModBjValue.ConvertToInt());
-      }
-      m_vectors[numq + j][k] = BarrettUint128ModUint64(
-          result, BskmtildeModuli[j].ConvertToInt(), BskmtildeModulimu[j]);
-    }
+  // twist xi by mtilde*(q/qi)^-1 mod qi and convert to {Bsk U mtilde}
+  BaseConvTables tables(numq, numBsk + 1);
+  for (uint32_t i = 0; i < numq; i++) {
+    tables.from[i] = TowerData(m_vectors[i]);
+    tables.fromModuli[i] = qModuli[i].ConvertToInt();
+    tables.twist[i] = mtildeqDivqiModqi[i].ConvertToInt();
+    tables.twistPrecon[i] = mtildeqDivqiModqiPrecon[i].ConvertToInt();
+  }
+  for (uint32_t j = 0; j < numBsk + 1; j++) {
+    tables.to[j] = TowerData(m_vectors[numq + j]);
+    tables.toModuli[j] = BskmtildeModuli[j].ConvertToInt();
+    tables.toModuliMu[j] = BskmtildeModulimu[j];
+    for (uint32_t i = 0; i < numq; i++)
+      tables.matrix[j * numq + i] = qDivqiModBj[i][j].ConvertToInt();
   }
+  RNSBaseConversionNat::FastBaseConv(tables.Item(n, true));
 
   // now we have input in Basis (q U Bsk U mtilde)
   // next we perform Small Motgomery Reduction mod q
@@ -2229,9 +2250,7 @@ void DCRTPolyImpl<VecType>::FastBaseConvqToBskMontgomery(
   m_format = EVALUATION;
 
   delete[] r_m_tildes;
-  delete[] ximtildeqiDivqModqi;
   r_m_tildes = nullptr;
-  ximtildeqiDivqModqi = nullptr;
 }
 
 // Source: Jean-Claude Bajard, Julien Eynard, Anwar Hasan, and Vincent Zucca.
@@ -2266,7 +2285,7 @@ void DCRTPolyImpl<VecType>::FastRNSFloorq(
   uint32_t n = GetLength();
 
   // Twist xi by t*(q/qi)^-1 mod qi
-  NativeInteger *txiqiDivqModqi = new NativeInteger[n * numBsk];
+  std::vector<uint64_t> txiqiDivqModqi(n * numBsk);
 
   for (uint32_t i = 0; i < numq; i++) {
     const NativeInteger &currenttqDivqiModqi = tqDivqiModqi[i];
@@ -2280,19 +2299,19 @@ void DCRTPolyImpl<VecType>::FastRNSFloorq(
     }
   }
 
+  BaseConvTables tables(numq, numBsk);
+  for (uint32_t i = 0; i < numq; i++) {
+    tables.from[i] = TowerData(m_vectors[i]);
+    tables.fromModuli[i] = qModuli[i].ConvertToInt();
+  }
   for (uint32_t j = 0; j < numBsk; j++) {
-#pragma omp parallel for
-    for (uint32_t k = 0; k < n; k++) {
-      DoubleNativeInt aq = 0;
-      for (uint32_t i = 0; i < numq; i++) {
-        const NativeInteger &qDivqiModBjValue = qDivqiModBj[i][j];
-        NativeInteger &xi = m_vectors[i][k];
-        aq += Mul128(xi.ConvertToInt(), qDivqiModBjValue.ConvertToInt());
-      }
-      txiqiDivqModqi[j * n + k] = BarrettUint128ModUint64(
-          aq, BskModuli[j].ConvertToInt(), BskModulimu[j]);
-    }
+    tables.to[j] = &txiqiDivqModqi[j * n];
+    tables.toModuli[j] = BskModuli[j].ConvertToInt();
+    tables.toModuliMu[j] = BskModulimu[j];
+    for (uint32_t i = 0; i < numq; i++)
+      tables.matrix[j * numq + i] = qDivqiModBj[i][j].ConvertToInt();
   }
+  RNSBaseConversionNat::FastBaseConv(tables.Item(n, false));
 
   // now we have FastBaseConv( |t*ct|q, q, Bsk ) in txiqiDivqModqi
 
@@ -2303,13 +2322,12 @@ void DCRTPolyImpl<VecType>::FastRNSFloorq(
     for (uint32_t k = 0; k < n; k++) {
       // Not worthy to use lazy reduction here
       m_vectors[i + numq][k].ModMulFastEq(t, BskModuli[i]);
-      m_vectors[i + numq][k].ModSubEq(txiqiDivqModqi[i * n + k], BskModuli[i]);
+      m_vectors[i + numq][k].ModSubEq(
+          NativeInteger(txiqiDivqModqi[i * n + k]), BskModuli[i]);
       m_vectors[i + numq][k].ModMulFastConstEq(currentqInvModBski, BskModuli[i],
                                                currentqInvModBskiPrecon);
     }
   }
-  delete[] txiqiDivqModqi;
-  txiqiDivqModqi = nullptr;
 }
 
 // Source: Jean-Claude Bajard, Julien Eynard, Anwar Hasan, and Vincent Zucca.
@@ -2344,44 +2362,32 @@ void DCRTPolyImpl<VecType>::FastBaseConvSK(
 
   uint32_t n = GetLength();
 
-  for (uint32_t i = 0; i < numBsk - 1; i++) {  // exclude msk residue
-    const NativeInteger &currentBDivBiModBi = BDivBiModBi[i];
-    const NativeInteger &currentBDivBiModBiPrecon = BDivBiModBiPrecon[i];
-#pragma omp parallel for
-    for (uint32_t k = 0; k < n; k++) {
-      m_vectors[numq + i][k].ModMulFastConstEq(currentBDivBiModBi, BskModuli[i],
-                                               currentBDivBiModBiPrecon);
-    }
-  }
-
-  for (uint32_t j = 0; j < numq; j++) {
-#pragma omp parallel for
-    for (uint32_t k = 0; k < n; k++) {
-      DoubleNativeInt result = 0;
-      for (uint32_t i = 0; i < numBsk - 1; i++) {  // exclude msk residue
-        const NativeInteger &currentBDivBiModqj = BDivBiModqj[i][j];
-        const NativeInteger &xi = m_vectors[numq + i][k];
-        result += Mul128(xi.ConvertToInt(), currentBDivBiModqj.ConvertToInt());
-      }
-      m_vectors[j][k] = BarrettUint128ModUint64(
-          result, qModuli[j].ConvertToInt(), qModulimu[j]);
-    }
-  }
-
-  // calculate alphaskx
-  // FastBaseConv(x, B, msk)
-  NativeInteger *alphaskxVector = new NativeInteger[n];
-#pragma omp parallel for
-  for (uint32_t k = 0; k < n; k++) {
-    DoubleNativeInt result = 0;
-    for (uint32_t i = 0; i < numBsk - 1; i++) {
-      const NativeInteger &currentBDivBiModmsk = BDivBiModmsk[i];
-      result += Mul128(m_vectors[numq + i][k].ConvertToInt(),
-                       currentBDivBiModmsk.ConvertToInt());
+  // FastBaseConv(x, B, q) and FastBaseConv(x, B, msk) in one pass; the last
+  // target is alphaskx
+  std::vector<NativeInteger> alphaskxVector(n);
+  BaseConvTables tables(numBsk - 1, numq + 1);  // exclude msk residue
+  for (uint32_t i = 0; i < numBsk - 1; i++) {
+    tables.from[i] = TowerData(m_vectors[numq + i]);
+    tables.fromModuli[i] = BskModuli[i].ConvertToInt();
+    tables.twist[i] = BDivBiModBi[i].ConvertToInt();
+    tables.twistPrecon[i] = BDivBiModBiPrecon[i].ConvertToInt();
+  }
+  for (uint32_t j = 0; j <= numq; j++) {
+    if (j < numq) {
+      tables.to[j] = TowerData(m_vectors[j]);
+      tables.toModuli[j] = qModuli[j].ConvertToInt();
+      tables.toModuliMu[j] = qModulimu[j];
+    } else {
+      tables.to[j] = reinterpret_cast<uint64_t *>(alphaskxVector.data());
+      tables.toModuli[j] = BskModuli[numBsk - 1].ConvertToInt();
+      tables.toModuliMu[j] = BskModulimu[numBsk - 1];
     }
-    alphaskxVector[k] = BarrettUint128ModUint64(
-        result, BskModuli[numBsk - 1].ConvertToInt(), BskModulimu[numBsk - 1]);
+    for (uint32_t i = 0; i < numBsk - 1; i++)
+      tables.matrix[j * (numBsk - 1) + i] =
+          (j < numq) ? BDivBiModqj[i][j].ConvertToInt()
+                     : BDivBiModmsk[i].ConvertToInt();
   }
+  RNSBaseConversionNat::FastBaseConv(tables.Item(n, true));
 
   // subtract xsk
 #pragma omp parallel for
@@ -2427,9 +2433,6 @@ void DCRTPolyImpl<VecType>::FastBaseConvSK(
     else
       m_vectors.erase(starti, starti + numBsk);
   }
-
-  delete[] alphaskxVector;
-  alphaskxVector = nullptr;
 }
 
 // Source: Halevi S., Polyakov Y., and Shoup V.
@@ -2511,10 +2514,103 @@ void DCRTPolyImpl<VecType>::SwitchFormat() {
     m_format = COEFFICIENT;
   }
 
-#pragma omp parallel for
+  std::vector<PolyType *> towers(m_vectors.size());
   for (usint i = 0; i < m_vectors.size(); i++) {
-    m_vectors[i].SwitchFormat();
+    towers[i] = &m_vectors[i];
   }
+  PolyType::SwitchFormat(towers);
+}
+
+template <typename VecType>
+void DCRTPolyImpl<VecType>::SwitchFormat(
+    const std::vector<DCRTPolyImpl *> &polys) {
+  std::vector<PolyType *> towers;
+  for (DCRTPolyImpl *poly : polys) {
+    poly->m_format = (poly->m_format == COEFFICIENT) ? EVALUATION : COEFFICIENT;
+    for (usint i = 0; i < poly->m_vectors.size(); i++) {
+      towers.push_back(&poly->m_vectors[i]);
+    }
+  }
+  PolyType::SwitchFormat(towers);
+}
+
+template <typename VecType>
+bool DCRTPolyImpl<VecType>::IsFlat() const {
+  if (m_vectors.empty() || m_vectors[0].IsEmpty()) {
+    return false;
+  }
+  usint n = m_vectors[0].GetLength();
+  size_t regionBytes = AlignedSlab::RegionSize(n * sizeof(NativeInteger));
+  auto slab = m_vectors[0].GetValues().GetAllocator().GetSlab();
+  if (slab == nullptr || slab->GetRegions() != m_vectors.size() ||
+      slab->GetRegionBytes() != regionBytes) {
+    return false;
+  }
+  // every tower must own its region of the same slab; an allocator that
+  // refers to the slab may still have fallen back to the vector pool
+  for (usint i = 0; i < m_vectors.size(); i++) {
+    if (m_vectors[i].IsEmpty() || m_vectors[i].GetLength() != n) {
+      return false;
+    }
+    const NativeVector &values = m_vectors[i].GetValues();
+    auto alloc = values.GetAllocator();
+    if (alloc.GetSlab() != slab || alloc.GetRegion() != i ||
+        reinterpret_cast<const char *>(&values[0]) != slab->GetRegion(i)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename VecType>
+void DCRTPolyImpl<VecType>::Flatten() {
+  if (m_vectors.empty() || IsFlat()) {
+    return;
+  }
+  for (usint i = 0; i < m_vectors.size(); i++) {
+    if (m_vectors[i].IsEmpty()) {
+      PALISADE_THROW(not_available_error, "DCRTPoly::Flatten: empty tower");
+    }
+  }
+
+  usint n = m_vectors[0].GetLength();
+  auto slab = std::make_shared<AlignedSlab>(m_vectors.size(),
+                                            n * sizeof(NativeInteger));
+  for (usint i = 0; i < m_vectors.size(); i++) {
+    const NativeVector &values = m_vectors[i].GetValues();
+    if (values.GetLength() != n) {
+      PALISADE_THROW(math_error,
+                     "DCRTPoly::Flatten: towers of different lengths");
+    }
+    NativeVector flat(n, values.GetModulus(),
+                      SlabAllocator<NativeInteger>(slab, i));
+    std::copy(&values[0], &values[0] + n, &flat[0]);
+    m_vectors[i].SetValues(std::move(flat), m_vectors[i].GetFormat());
+  }
+}
+
+template <typename VecType>
+void DCRTPolyImpl<VecType>::CopyFlat(const DCRTPolyImpl &element) {
+  usint towers = element.m_vectors.size();
+  usint n = element.m_vectors[0].GetLength();
+  auto slab = std::make_shared<AlignedSlab>(towers, n * sizeof(NativeInteger));
+
+  std::vector<PolyType> vectors;
+  vectors.reserve(towers);
+  for (usint i = 0; i < towers; i++) {
+    const PolyType &tower = element.m_vectors[i];
+    NativeVector values(n, tower.GetModulus(),
+                        SlabAllocator<NativeInteger>(slab, i));
+    vectors.push_back(PolyType(tower.GetParams(), tower.GetFormat(), false));
+    vectors.back().SetValues(std::move(values), tower.GetFormat());
+  }
+
+  // IsFlat() checked that the source slab has the same number and size of
+  // regions, so both slabs are laid out identically
+  auto src = element.m_vectors[0].GetValues().GetAllocator().GetSlab();
+  std::memcpy(slab->GetData(), src->GetRegion(0),
+              (towers - 1) * slab->GetRegionBytes() + n * sizeof(NativeInteger));
+  m_vectors = std::move(vectors);
 }
 
 #ifdef OUT
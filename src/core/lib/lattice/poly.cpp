@@ -471,6 +471,20 @@ void PolyImpl<VecType>::SetValues(const VecType &values, Format format) {
   m_format = format;
 }
 
+template <typename VecType>
+void PolyImpl<VecType>::SetValues(VecType &&values, Format format) {
+  if (m_params->GetRootOfUnity() == Integer(0)) {
+    PALISADE_THROW(type_error, "Polynomial has a 0 root of unity");
+  }
+  if (m_params->GetRingDimension() != values.GetLength() ||
+      m_params->GetModulus() != values.GetModulus()) {
+    PALISADE_THROW(type_error,
+                   "Parameter mismatch on SetValues for Polynomial");
+  }
+  m_values = make_unique<VecType>(std::move(values));
+  m_format = format;
+}
+
 template <typename VecType>
 void PolyImpl<VecType>::SetValuesToZero() {
   m_values = make_unique<VecType>(m_params->GetRingDimension(),
@@ -805,28 +819,67 @@ void PolyImpl<VecType>::SwitchFormat() {
     return;
   }
 
-  VecType newValues(m_params->GetCyclotomicOrder() / 2);
-
   if (m_format == COEFFICIENT) {
     m_format = EVALUATION;
 
     DEBUG("transform to evaluation m_values was" << *m_values);
 
-    ChineseRemainderTransformFTT<VecType>::ForwardTransformToBitReverse(
-        *m_values, m_params->GetRootOfUnity(), m_params->GetCyclotomicOrder(),
-        &newValues);
-    DEBUG("m_values now " << newValues);
+    ChineseRemainderTransformFTT<VecType>::ForwardTransformToBitReverseInPlace(
+        m_params->GetRootOfUnity(), m_params->GetCyclotomicOrder(),
+        &(*m_values));
+    DEBUG("m_values now " << *m_values);
   } else {
     m_format = COEFFICIENT;
     DEBUG("transform to coefficient m_values was" << *m_values);
 
-    ChineseRemainderTransformFTT<VecType>::InverseTransformFromBitReverse(
-        *m_values, m_params->GetRootOfUnity(), m_params->GetCyclotomicOrder(),
-        &newValues);
-    DEBUG("m_values now " << newValues);
+    ChineseRemainderTransformFTT<VecType>::InverseTransformFromBitReverseInPlace(
+        m_params->GetRootOfUnity(), m_params->GetCyclotomicOrder(),
+        &(*m_values));
+    DEBUG("m_values now " << *m_values);
+  }
+}
+
+template <typename VecType>
+void PolyImpl<VecType>::SwitchFormat(const std::vector<PolyImpl *> &polys) {
+  std::vector<const NTTTables<VecType> *> forwardTables, inverseTables;
+  std::vector<VecType *> forwardValues, inverseValues;
+  std::vector<PolyImpl *> others;
+
+  for (PolyImpl *poly : polys) {
+    const Integer &rootOfUnity = poly->m_params->GetRootOfUnity();
+    // empty polynomials, arbitrary cyclotomics and trivial roots of unity
+    // keep the single-polynomial path
+    if (poly->m_values == nullptr ||
+        poly->m_params->OrderIsPowerOfTwo() == false ||
+        rootOfUnity == Integer(0) || rootOfUnity == Integer(1)) {
+      others.push_back(poly);
+      continue;
+    }
+
+    const NTTTables<VecType> *tables =
+        ChineseRemainderTransformFTT<VecType>::GetTables(
+            rootOfUnity, poly->m_params->GetCyclotomicOrder(),
+            poly->m_values->GetModulus());
+    if (poly->m_format == COEFFICIENT) {
+      poly->m_format = EVALUATION;
+      forwardTables.push_back(tables);
+      forwardValues.push_back(&(*poly->m_values));
+    } else {
+      poly->m_format = COEFFICIENT;
+      inverseTables.push_back(tables);
+      inverseValues.push_back(&(*poly->m_values));
+    }
   }
 
-  *m_values = newValues;
+  ChineseRemainderTransformFTT<VecType>::ForwardTransformToBitReverseInPlace(
+      forwardTables, forwardValues);
+  ChineseRemainderTransformFTT<VecType>::InverseTransformFromBitReverseInPlace(
+      inverseTables, inverseValues);
+
+#pragma omp parallel for
+  for (usint i = 0; i < others.size(); i++) {
+    others[i]->SwitchFormat();
+  }
 }
 
 template <typename VecType>
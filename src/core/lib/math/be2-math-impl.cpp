@@ -41,6 +41,7 @@ template class DiscreteGaussianGeneratorImpl<M2Vector>;
 template class BinaryUniformGeneratorImpl<M2Vector>;
 template class TernaryUniformGeneratorImpl<M2Vector>;
 template class DiscreteUniformGeneratorImpl<M2Vector>;
+template class NumberTheoreticTransform<M2Vector>;
 template class ChineseRemainderTransformFTT<M2Vector>;
 template class ChineseRemainderTransformArb<M2Vector>;
 
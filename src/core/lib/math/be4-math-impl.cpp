@@ -43,6 +43,7 @@ template class DiscreteGaussianGeneratorImpl<M4Vector>;
 template class BinaryUniformGeneratorImpl<M4Vector>;
 template class TernaryUniformGeneratorImpl<M4Vector>;
 template class DiscreteUniformGeneratorImpl<M4Vector>;
+template class NumberTheoreticTransform<M4Vector>;
 template class ChineseRemainderTransformFTT<M4Vector>;
 template class ChineseRemainderTransformArb<M4Vector>;
 
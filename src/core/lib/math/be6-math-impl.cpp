@@ -45,6 +45,7 @@ template class DiscreteGaussianGeneratorImpl<M6Vector>;
 template class BinaryUniformGeneratorImpl<M6Vector>;
 template class TernaryUniformGeneratorImpl<M6Vector>;
 template class DiscreteUniformGeneratorImpl<M6Vector>;
+template class NumberTheoreticTransform<M6Vector>;
 template class ChineseRemainderTransformFTT<M6Vector>;
 template class ChineseRemainderTransformArb<M6Vector>;
 
@@ -43,6 +43,7 @@ template class DiscreteGaussianGeneratorImpl<NativeVector>;
 template class BinaryUniformGeneratorImpl<NativeVector>;
 template class TernaryUniformGeneratorImpl<NativeVector>;
 template class DiscreteUniformGeneratorImpl<NativeVector>;
+template class NumberTheoreticTransform<NativeVector>;
 template class ChineseRemainderTransformFTT<NativeVector>;
 template class ChineseRemainderTransformArb<NativeVector>;
 
@@ -59,6 +59,17 @@ NativeVector<IntegerType>::NativeVector(usint length,
   this->m_data.resize(length);
 }
 
+#if BLOCK_VECTOR_ALLOCATION != 1
+template <class IntegerType>
+NativeVector<IntegerType>::NativeVector(
+    usint length, const IntegerType &modulus,
+    const lbcrypto::SlabAllocator<IntegerType> &alloc)
+    : m_data(alloc) {
+  this->SetModulus(modulus);
+  this->m_data.resize(length);
+}
+#endif
+
 template <class IntegerType>
 NativeVector<IntegerType>::NativeVector(const NativeVector &bigVector) {
   m_modulus = bigVector.m_modulus;
@@ -66,8 +77,8 @@ NativeVector<IntegerType>::NativeVector(const NativeVector &bigVector) {
 }
 
 template <class IntegerType>
-NativeVector<IntegerType>::NativeVector(NativeVector &&bigVector) {
-  m_data = std::move(bigVector.m_data);
+NativeVector<IntegerType>::NativeVector(NativeVector &&bigVector)
+    : m_data(std::move(bigVector.m_data)) {
   m_modulus = bigVector.m_modulus;
 }
 
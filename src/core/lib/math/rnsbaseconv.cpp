@@ -0,0 +1,298 @@
+/*
+ * @file rnsbaseconv.cpp This file contains the fast RNS base conversion
+ * kernels for native integer vectors.
+ * @author  TPOC: contact@palisade-crypto.org
+ *
+ * @copyright Copyright (c) 2019, New Jersey Institute of Technology (NJIT)
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution. THIS SOFTWARE IS
+ * PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <cmath>
+
+#include "math/rnsbaseconv.h"
+#include "math/transfrmnat.h"
+#include "utils/parallel.h"
+#include "utils/utilities.h"
+#include "utils/vectorpool.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define PALISADE_BASECONV_X86_KERNELS
+// g++ 12 reports the _mm512_undefined_* placeholders used by the set1
+// intrinsics as maybe-uninitialized
+#if !defined(__clang__) && __GNUC__ >= 12
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+#include <immintrin.h>
+#endif
+
+namespace lbcrypto {
+
+namespace {
+
+/*
+ * Computes the dot products sum[k] = \sum_i rows[i][k] * c[i] of count
+ * coefficients without reduction.
+ */
+typedef void (*DotFunc)(const uint64_t *const *rows, const uint64_t *c,
+                        usint sizeFrom, usint count, DoubleNativeInt *sum);
+
+void DotScalar(const uint64_t *const *rows, const uint64_t *c, usint sizeFrom,
+               usint count, DoubleNativeInt *sum) {
+  for (usint k = 0; k < count; ++k) {
+    sum[k] = 0;
+  }
+  for (usint i = 0; i < sizeFrom; ++i) {
+    const uint64_t *x = rows[i];
+    const uint64_t ci = c[i];
+    for (usint k = 0; k < count; ++k) {
+      sum[k] += Mul128(x[k], ci);
+    }
+  }
+}
+
+/*
+ * The vector kernels split x = xHi 2^32 + xLo and c = cHi 2^32 + cLo and
+ * accumulate the four 32x32->64-bit partial products by their 32-bit
+ * halves, so every accumulator grows by less than 3 * 2^32 per term and no
+ * carries have to be propagated until the final sum is assembled.
+ */
+inline DoubleNativeInt Combine(uint64_t a0, uint64_t a1, uint64_t a2,
+                               uint64_t a3) {
+  return DoubleNativeInt(a0) + (DoubleNativeInt(a1) << 32) +
+         (DoubleNativeInt(a2) << 64) + (DoubleNativeInt(a3) << 96);
+}
+
+#ifdef PALISADE_BASECONV_X86_KERNELS
+
+#define PALISADE_TARGET_AVX2 __attribute__((target("avx2")))
+#define PALISADE_TARGET_AVX512 __attribute__((target("avx512f")))
+
+PALISADE_TARGET_AVX2 void DotAVX2(const uint64_t *const *rows,
+                                  const uint64_t *c, usint sizeFrom,
+                                  usint count, DoubleNativeInt *sum) {
+  const __m256i lowMask = _mm256_set1_epi64x(0xFFFFFFFF);
+  usint k = 0;
+  for (; k + 4 <= count; k += 4) {
+    __m256i a0 = _mm256_setzero_si256();
+    __m256i a1 = a0, a2 = a0, a3 = a0;
+    for (usint i = 0; i < sizeFrom; ++i) {
+      __m256i x =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i *>(rows[i] + k));
+      __m256i xHi = _mm256_srli_epi64(x, 32);
+      __m256i cLo = _mm256_set1_epi64x(c[i]);
+      __m256i cHi = _mm256_set1_epi64x(c[i] >> 32);
+      __m256i lolo = _mm256_mul_epu32(x, cLo);
+      __m256i lohi = _mm256_mul_epu32(x, cHi);
+      __m256i hilo = _mm256_mul_epu32(xHi, cLo);
+      __m256i hihi = _mm256_mul_epu32(xHi, cHi);
+      a0 = _mm256_add_epi64(a0, _mm256_and_si256(lolo, lowMask));
+      a1 = _mm256_add_epi64(
+          a1, _mm256_add_epi64(
+                  _mm256_srli_epi64(lolo, 32),
+                  _mm256_add_epi64(_mm256_and_si256(lohi, lowMask),
+                                   _mm256_and_si256(hilo, lowMask))));
+      a2 = _mm256_add_epi64(
+          a2, _mm256_add_epi64(
+                  _mm256_add_epi64(_mm256_srli_epi64(lohi, 32),
+                                   _mm256_srli_epi64(hilo, 32)),
+                  _mm256_and_si256(hihi, lowMask)));
+      a3 = _mm256_add_epi64(a3, _mm256_srli_epi64(hihi, 32));
+    }
+    alignas(32) uint64_t acc[4][4];
+    _mm256_store_si256(reinterpret_cast<__m256i *>(acc[0]), a0);
+    _mm256_store_si256(reinterpret_cast<__m256i *>(acc[1]), a1);
+    _mm256_store_si256(reinterpret_cast<__m256i *>(acc[2]), a2);
+    _mm256_store_si256(reinterpret_cast<__m256i *>(acc[3]), a3);
+    for (usint l = 0; l < 4; ++l) {
+      sum[k + l] = Combine(acc[0][l], acc[1][l], acc[2][l], acc[3][l]);
+    }
+  }
+  for (; k < count; ++k) {
+    DoubleNativeInt s = 0;
+    for (usint i = 0; i < sizeFrom; ++i) s += Mul128(rows[i][k], c[i]);
+    sum[k] = s;
+  }
+}
+
+PALISADE_TARGET_AVX512 void DotAVX512(const uint64_t *const *rows,
+                                      const uint64_t *c, usint sizeFrom,
+                                      usint count, DoubleNativeInt *sum) {
+  const __m512i lowMask = _mm512_set1_epi64(0xFFFFFFFF);
+  usint k = 0;
+  for (; k + 8 <= count; k += 8) {
+    __m512i a0 = _mm512_setzero_si512();
+    __m512i a1 = a0, a2 = a0, a3 = a0;
+    for (usint i = 0; i < sizeFrom; ++i) {
+      __m512i x = _mm512_loadu_si512(rows[i] + k);
+      __m512i xHi = _mm512_srli_epi64(x, 32);
+      __m512i cLo = _mm512_set1_epi64(c[i]);
+      __m512i cHi = _mm512_set1_epi64(c[i] >> 32);
+      __m512i lolo = _mm512_mul_epu32(x, cLo);
+      __m512i lohi = _mm512_mul_epu32(x, cHi);
+      __m512i hilo = _mm512_mul_epu32(xHi, cLo);
+      __m512i hihi = _mm512_mul_epu32(xHi, cHi);
+      a0 = _mm512_add_epi64(a0, _mm512_and_si512(lolo, lowMask));
+      a1 = _mm512_add_epi64(
+          a1, _mm512_add_epi64(
+                  _mm512_srli_epi64(lolo, 32),
+                  _mm512_add_epi64(_mm512_and_si512(lohi, lowMask),
+                                   _mm512_and_si512(hilo, lowMask))));
+      a2 = _mm512_add_epi64(
+          a2, _mm512_add_epi64(
+                  _mm512_add_epi64(_mm512_srli_epi64(lohi, 32),
+                                   _mm512_srli_epi64(hilo, 32)),
+                  _mm512_and_si512(hihi, lowMask)));
+      a3 = _mm512_add_epi64(a3, _mm512_srli_epi64(hihi, 32));
+    }
+    alignas(64) uint64_t acc[4][8];
+    _mm512_store_si512(acc[0], a0);
+    _mm512_store_si512(acc[1], a1);
+    _mm512_store_si512(acc[2], a2);
+    _mm512_store_si512(acc[3], a3);
+    for (usint l = 0; l < 8; ++l) {
+      sum[k + l] = Combine(acc[0][l], acc[1][l], acc[2][l], acc[3][l]);
+    }
+  }
+  for (; k < count; ++k) {
+    DoubleNativeInt s = 0;
+    for (usint i = 0; i < sizeFrom; ++i) s += Mul128(rows[i][k], c[i]);
+    sum[k] = s;
+  }
+}
+
+#endif
+
+DotFunc ActiveDot() {
+  switch (NumberTheoreticTransformNat::GetKernel()) {
+#ifdef PALISADE_BASECONV_X86_KERNELS
+    case NTT_AVX512:
+      return DotAVX512;
+    case NTT_AVX2:
+      return DotAVX2;
+#endif
+    default:
+      return DotScalar;
+  }
+}
+
+// [x * w]_q for w < q with the Shoup precomputation of w
+inline uint64_t MulModShoup(uint64_t x, uint64_t w, uint64_t wPrecon,
+                            uint64_t q) {
+  uint64_t hi = (uint64_t)(Mul128(x, wPrecon) >> 64);
+  uint64_t y = x * w - hi * q;
+  return (y >= q) ? y - q : y;
+}
+
+/*
+ * Converts the coefficients [k0, k0 + count) of one block; tw holds the
+ * twisted residues of the block (sizeFrom rows of BLOCK_SIZE values).
+ */
+void ConvertBlock(const RNSBaseConvItem &item, DotFunc dot, usint k0,
+                  usint count, uint64_t *tw, const uint64_t **rows) {
+  const usint stride = RNSBaseConversionNat::BLOCK_SIZE;
+  double nu[RNSBaseConversionNat::BLOCK_SIZE];
+  DoubleNativeInt sum[RNSBaseConversionNat::BLOCK_SIZE];
+
+  for (usint i = 0; i < item.sizeFrom; ++i) {
+    const uint64_t *x = item.from[i] + k0;
+    if (item.twist == nullptr) {
+      rows[i] = x;
+      continue;
+    }
+    const uint64_t w = item.twist[i];
+    const uint64_t wPrecon = item.twistPrecon[i];
+    const uint64_t q = item.fromModuli[i];
+    uint64_t *t = tw + i * stride;
+    for (usint k = 0; k < count; ++k) {
+      t[k] = MulModShoup(x[k], w, wPrecon, q);
+    }
+    rows[i] = t;
+  }
+
+  if (item.qModTo != nullptr) {
+    // number of q-overflows: \sum_i [x_i twist_i]_{q_i} / q_i
+    for (usint k = 0; k < count; ++k) {
+      nu[k] = 0.0;
+    }
+    for (usint i = 0; i < item.sizeFrom; ++i) {
+      const double q = (double)item.fromModuli[i];
+      for (usint k = 0; k < count; ++k) {
+        nu[k] += (double)rows[i][k] / q;
+      }
+    }
+  }
+
+  for (usint j = 0; j < item.sizeTo; ++j) {
+    dot(rows, item.matrix + (size_t)j * item.sizeFrom, item.sizeFrom, count,
+        sum);
+    const uint64_t p = item.toModuli[j];
+    const DoubleNativeInt &mu = item.toModuliMu[j];
+    uint64_t *y = item.to[j] + k0;
+    if (item.qModTo == nullptr) {
+      for (usint k = 0; k < count; ++k) {
+        y[k] = BarrettUint128ModUint64(sum[k], p, mu);
+      }
+    } else {
+      const uint64_t qModp = item.qModTo[j];
+      for (usint k = 0; k < count; ++k) {
+        uint64_t value = BarrettUint128ModUint64(sum[k], p, mu);
+        uint64_t alpha = std::llround(nu[k]);
+        uint64_t overflow =
+            BarrettUint128ModUint64(Mul128(alpha, qModp), p, mu);
+        y[k] = (value >= overflow) ? value - overflow : value + p - overflow;
+      }
+    }
+  }
+}
+
+}  // namespace
+
+void RNSBaseConversionNat::FastBaseConv(const RNSBaseConvItem &item) {
+  if (item.n == 0 || item.sizeTo == 0) {
+    return;
+  }
+
+  DotFunc dot = ActiveDot();
+  usint blocks = (item.n + BLOCK_SIZE - 1) / BLOCK_SIZE;
+  bool parallel = !omp_in_parallel() && omp_get_max_threads() > 1;
+
+#pragma omp parallel if (parallel && blocks > 1)
+  {
+    size_t twBytes = (size_t)item.sizeFrom * BLOCK_SIZE * sizeof(uint64_t);
+    size_t rowBytes = (size_t)item.sizeFrom * sizeof(const uint64_t *);
+    uint64_t *tw = static_cast<uint64_t *>(
+        twBytes > 0 ? VectorMemoryPool::Allocate(twBytes) : nullptr);
+    const uint64_t **rows = static_cast<const uint64_t **>(
+        rowBytes > 0 ? VectorMemoryPool::Allocate(rowBytes) : nullptr);
+
+#pragma omp for schedule(static)
+    for (usint b = 0; b < blocks; ++b) {
+      usint k0 = b * BLOCK_SIZE;
+      usint count = (item.n - k0 < BLOCK_SIZE) ? item.n - k0 : BLOCK_SIZE;
+      ConvertBlock(item, dot, k0, count, tw, rows);
+    }
+
+    if (tw != nullptr) VectorMemoryPool::Deallocate(tw, twBytes);
+    if (rows != nullptr) VectorMemoryPool::Deallocate(rows, rowBytes);
+  }
+}
+
+}  // namespace lbcrypto
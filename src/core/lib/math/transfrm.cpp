@@ -28,6 +28,7 @@
 #include <mutex>
 
 #include "math/transfrm.h"
+#include "math/transfrmnat.h"
 #include "utils/defines.h"
 
 #ifdef WITH_INTEL_HEXL
@@ -36,38 +37,111 @@
 
 namespace lbcrypto {
 
-template <typename VecType>
-std::map<typename VecType::Integer, VecType>
-    ChineseRemainderTransformFTT<VecType>::m_cycloOrderInverseTableByModulus;
+namespace {
 
+// The lazy-butterfly kernels of NumberTheoreticTransformNat only exist for
+// native vectors; every other backend keeps the generic transforms. The
+// helpers return false when the caller has to fall back.
 template <typename VecType>
-std::map<typename VecType::Integer, NativeVector> ChineseRemainderTransformFTT<
-    VecType>::m_cycloOrderInversePreconTableByModulus;
+bool ForwardTransformNat(const VecType &rootOfUnityTable,
+                         const NativeVector &preconRootOfUnityTable,
+                         VecType *element) {
+  return false;
+}
 
-template <typename VecType>
-std::map<typename VecType::Integer, VecType>
-    ChineseRemainderTransformFTT<VecType>::m_rootOfUnityReverseTableByModulus;
+inline bool ForwardTransformNat(const NativeVector &rootOfUnityTable,
+                                const NativeVector &preconRootOfUnityTable,
+                                NativeVector *element) {
+  if (sizeof(NativeInteger) != sizeof(uint64_t) ||
+      !NumberTheoreticTransformNat::IsSupportedModulus(element->GetModulus())) {
+    return false;
+  }
+  NumberTheoreticTransformNat::ForwardTransformToBitReverseInPlace(
+      rootOfUnityTable, preconRootOfUnityTable, element);
+  return true;
+}
 
 template <typename VecType>
-std::map<typename VecType::Integer, VecType> ChineseRemainderTransformFTT<
-    VecType>::m_rootOfUnityInverseReverseTableByModulus;
+bool InverseTransformNat(const VecType &rootOfUnityInverseTable,
+                         const NativeVector &preconRootOfUnityInverseTable,
+                         const typename VecType::Integer &cycloOrderInv,
+                         const NativeInteger &preconCycloOrderInv,
+                         VecType *element) {
+  return false;
+}
 
-template <typename VecType>
-std::map<typename VecType::Integer, NativeVector> ChineseRemainderTransformFTT<
-    VecType>::m_rootOfUnityPreconReverseTableByModulus;
+inline bool InverseTransformNat(
+    const NativeVector &rootOfUnityInverseTable,
+    const NativeVector &preconRootOfUnityInverseTable,
+    const NativeInteger &cycloOrderInv,
+    const NativeInteger &preconCycloOrderInv, NativeVector *element) {
+  if (sizeof(NativeInteger) != sizeof(uint64_t) ||
+      !NumberTheoreticTransformNat::IsSupportedModulus(element->GetModulus())) {
+    return false;
+  }
+  NumberTheoreticTransformNat::InverseTransformFromBitReverseInPlace(
+      rootOfUnityInverseTable, preconRootOfUnityInverseTable, cycloOrderInv,
+      preconCycloOrderInv, element);
+  return true;
+}
 
+// Describes a batch of native transforms for the fused kernels; false if the
+// batch has to be transformed vector by vector.
 template <typename VecType>
-std::map<typename VecType::Integer, NativeVector> ChineseRemainderTransformFTT<
-    VecType>::m_rootOfUnityInversePreconReverseTableByModulus;
+bool BatchItemsNat(const std::vector<const NTTTables<VecType> *> &tables,
+                   const std::vector<VecType *> &elements, bool inverse,
+                   std::vector<NTTBatchItem> *items) {
+  return false;
+}
 
+inline bool BatchItemsNat(
+    const std::vector<const NTTTables<NativeVector> *> &tables,
+    const std::vector<NativeVector *> &elements, bool inverse,
+    std::vector<NTTBatchItem> *items) {
 #ifdef WITH_INTEL_HEXL
+  return false;
+#else
+  if (sizeof(NativeInteger) != sizeof(uint64_t)) {
+    return false;
+  }
+
+  usint n = elements[0]->GetLength();
+  items->resize(elements.size());
+  for (usint i = 0; i < elements.size(); i++) {
+    const NTTTables<NativeVector> &t = *tables[i];
+    if (elements[i]->GetLength() != n ||
+        !NumberTheoreticTransformNat::IsSupportedModulus(t.modulus)) {
+      return false;
+    }
+    const NativeVector &root =
+        inverse ? t.rootOfUnityInverseReverseTable : t.rootOfUnityReverseTable;
+    const NativeVector &precon = inverse
+                                     ? t.rootOfUnityInversePreconReverseTable
+                                     : t.rootOfUnityPreconReverseTable;
+    NTTBatchItem &item = (*items)[i];
+    item.rootOfUnity = reinterpret_cast<const uint64_t *>(&root[0]);
+    item.preconRoot = reinterpret_cast<const uint64_t *>(&precon[0]);
+    item.cycloOrderInv = t.cycloOrderInverse.ConvertToInt();
+    item.preconCycloOrderInv = t.cycloOrderInversePrecon.ConvertToInt();
+    item.modulus = t.modulus.ConvertToInt();
+    item.element = reinterpret_cast<uint64_t *>(&(*elements[i])[0]);
+  }
+  return true;
+#endif
+}
+
+}  // namespace
+
 template <typename VecType>
-// N, modulus
-std::unordered_map<std::pair<uint64_t, uint64_t>, intel::hexl::NTT, HashPair>
-    ChineseRemainderTransformFTT<VecType>::m_IntelNtt;
+std::atomic<const typename ChineseRemainderTransformFTT<VecType>::TablesSnapshot
+                *>
+    ChineseRemainderTransformFTT<VecType>::m_tables(nullptr);
+
 template <typename VecType>
-std::mutex ChineseRemainderTransformFTT<VecType>::m_mtxIntelNTT;
-#endif
+std::atomic<size_t> ChineseRemainderTransformFTT<VecType>::m_readers(0);
+
+template <typename VecType>
+std::mutex ChineseRemainderTransformFTT<VecType>::m_tablesMutex;
 
 template <typename VecType>
 std::map<typename VecType::Integer, VecType>
@@ -703,50 +777,32 @@ void ChineseRemainderTransformFTT<VecType>::ForwardTransformToBitReverseInPlace(
                    "element size must be equal to CyclotomicOrder / 2");
   }
 
-  IntType modulus = element->GetModulus();
+  ForwardTransformToBitReverseInPlace(
+      *GetTables(rootOfUnity, CycloOrder, element->GetModulus()), element);
+}
 
-  bool reCompute = false;
-  PALISADE_UNUSED(reCompute);  // Used only when WITH_INTEL_HEXL=ON
-  auto mapSearch = m_rootOfUnityReverseTableByModulus.find(modulus);
-  if (mapSearch == m_rootOfUnityReverseTableByModulus.end() ||
-      mapSearch->second.GetLength() != CycloOrderHf) {
-    PreCompute(rootOfUnity, CycloOrder, modulus);
-    reCompute = true;
-  }
+template <typename VecType>
+void ChineseRemainderTransformFTT<VecType>::ForwardTransformToBitReverseInPlace(
+    const NTTTables<VecType> &tables, VecType *element) {
+  CheckTables(tables, *element);
 
-  if (typeid(IntType) == typeid(NativeInteger)) {
+  if (std::is_same<IntType, NativeInteger>::value) {
 #ifdef WITH_INTEL_HEXL
-    if (std::is_same<VecType, NativeVector>::value) {
-      std::pair<uint64_t, uint64_t> key{element->GetLength(),
-                                        modulus.ConvertToInt()};
-      intel::hexl::NTT *p_ntt;
-      std::unique_lock<std::mutex> lock(m_mtxIntelNTT);
-      auto ntt_it = m_IntelNtt.find(key);
-      if (reCompute || ntt_it == m_IntelNtt.end()) {
-        intel::hexl::NTT ntt(element->GetLength(), modulus.ConvertToInt(),
-                             rootOfUnity.ConvertToInt());
-        m_IntelNtt[key] = std::move(ntt);
-        ntt_it = m_IntelNtt.find(key);
-      }
-      p_ntt = &ntt_it->second;
-      lock.unlock();
-
+    if (tables.intelNtt != nullptr) {
       auto *data = reinterpret_cast<uint64_t *>(&element->at(0));
-      p_ntt->ComputeForward(data, data, 1, 1);
-      element->SetModulus(modulus);
-    } else {
-      NumberTheoreticTransform<VecType>::ForwardTransformToBitReverseInPlace(
-          m_rootOfUnityReverseTableByModulus[modulus],
-          m_rootOfUnityPreconReverseTableByModulus[modulus], element);
+      tables.intelNtt->ComputeForward(data, data, 1, 1);
+      return;
     }
-#else
-    NumberTheoreticTransform<VecType>::ForwardTransformToBitReverseInPlace(
-        m_rootOfUnityReverseTableByModulus[modulus],
-        m_rootOfUnityPreconReverseTableByModulus[modulus], element);
 #endif
+    if (!ForwardTransformNat(tables.rootOfUnityReverseTable,
+                             tables.rootOfUnityPreconReverseTable, element)) {
+      NumberTheoreticTransform<VecType>::ForwardTransformToBitReverseInPlace(
+          tables.rootOfUnityReverseTable, tables.rootOfUnityPreconReverseTable,
+          element);
+    }
   } else {
     NumberTheoreticTransform<VecType>::ForwardTransformToBitReverseInPlace(
-        m_rootOfUnityReverseTableByModulus[modulus], element);
+        tables.rootOfUnityReverseTable, element);
   }
 }
 
@@ -769,27 +825,17 @@ void ChineseRemainderTransformFTT<VecType>::ForwardTransformToBitReverse(
                    "result size must be equal to CyclotomicOrder / 2");
   }
 
-  IntType modulus = element.GetModulus();
-
-  bool reCompute = false;
-  PALISADE_UNUSED(reCompute);  // Used only when WITH_INTEL_HEXL=ON
-  auto mapSearch = m_rootOfUnityReverseTableByModulus.find(modulus);
-  if (mapSearch == m_rootOfUnityReverseTableByModulus.end() ||
-      mapSearch->second.GetLength() < CycloOrderHf) {
-    PreCompute(rootOfUnity, CycloOrder, modulus);
-    reCompute = true;
-  }
+  const NTTTables<VecType> &tables =
+      *GetTables(rootOfUnity, CycloOrder, element.GetModulus());
 
-  if (typeid(IntType) == typeid(NativeInteger)) {
-    NumberTheoreticTransform<VecType>::ForwardTransformToBitReverse(
-        element, m_rootOfUnityReverseTableByModulus[modulus],
-        m_rootOfUnityPreconReverseTableByModulus[modulus], result);
+  if (std::is_same<IntType, NativeInteger>::value) {
+    *result = element;
+    ForwardTransformToBitReverseInPlace(tables, result);
   } else {
+    CheckTables(tables, element);
     NumberTheoreticTransform<VecType>::ForwardTransformToBitReverse(
-        element, m_rootOfUnityReverseTableByModulus[modulus], result);
+        element, tables.rootOfUnityReverseTable, result);
   }
-
-  return;
 }
 
 template <typename VecType>
@@ -811,55 +857,38 @@ void ChineseRemainderTransformFTT<
                    "element size must be equal to CyclotomicOrder / 2");
   }
 
-  IntType modulus = element->GetModulus();
+  InverseTransformFromBitReverseInPlace(
+      *GetTables(rootOfUnity, CycloOrder, element->GetModulus()), element);
+}
 
-  bool reCompute = false;
-  PALISADE_UNUSED(reCompute);  // Used only when WITH_INTEL_HEXL=ON
-  auto mapSearch = m_rootOfUnityReverseTableByModulus.find(modulus);
-  if (mapSearch == m_rootOfUnityReverseTableByModulus.end() ||
-      mapSearch->second.GetLength() != CycloOrderHf) {
-    PreCompute(rootOfUnity, CycloOrder, modulus);
-    reCompute = true;
-  }
+template <typename VecType>
+void ChineseRemainderTransformFTT<
+    VecType>::InverseTransformFromBitReverseInPlace(const NTTTables<VecType>
+                                                        &tables,
+                                                    VecType *element) {
+  CheckTables(tables, *element);
 
-  usint msb = GetMSB64(CycloOrderHf - 1);
-  if (typeid(IntType) == typeid(NativeInteger)) {
+  if (std::is_same<IntType, NativeInteger>::value) {
 #ifdef WITH_INTEL_HEXL
-    if (std::is_same<VecType, NativeVector>::value) {
-      std::pair<uint64_t, uint64_t> key{element->GetLength(),
-                                        modulus.ConvertToInt()};
-      intel::hexl::NTT *p_ntt;
-      std::unique_lock<std::mutex> lock(m_mtxIntelNTT);
-      auto ntt_it = m_IntelNtt.find(key);
-      if (reCompute || ntt_it == m_IntelNtt.end()) {
-        intel::hexl::NTT ntt(element->GetLength(), modulus.ConvertToInt(),
-                             rootOfUnity.ConvertToInt());
-        m_IntelNtt[key] = std::move(ntt);
-        ntt_it = m_IntelNtt.find(key);
-      }
-      p_ntt = &ntt_it->second;
-      lock.unlock();
+    if (tables.intelNtt != nullptr) {
       auto *data = reinterpret_cast<uint64_t *>(&element->at(0));
-      p_ntt->ComputeInverse(data, data, 1, 1);
-      element->SetModulus(modulus);
-    } else {
-      NumberTheoreticTransform<VecType>::InverseTransformFromBitReverseInPlace(
-          m_rootOfUnityInverseReverseTableByModulus[modulus],
-          m_rootOfUnityInversePreconReverseTableByModulus[modulus],
-          m_cycloOrderInverseTableByModulus[modulus][msb],
-          m_cycloOrderInversePreconTableByModulus[modulus][msb], element);
+      tables.intelNtt->ComputeInverse(data, data, 1, 1);
+      return;
     }
-#else
-    NumberTheoreticTransform<VecType>::InverseTransformFromBitReverseInPlace(
-        m_rootOfUnityInverseReverseTableByModulus[modulus],
-        m_rootOfUnityInversePreconReverseTableByModulus[modulus],
-        m_cycloOrderInverseTableByModulus[modulus][msb],
-        m_cycloOrderInversePreconTableByModulus[modulus][msb], element);
 #endif
+    if (!InverseTransformNat(tables.rootOfUnityInverseReverseTable,
+                             tables.rootOfUnityInversePreconReverseTable,
+                             tables.cycloOrderInverse,
+                             tables.cycloOrderInversePrecon, element)) {
+      NumberTheoreticTransform<VecType>::InverseTransformFromBitReverseInPlace(
+          tables.rootOfUnityInverseReverseTable,
+          tables.rootOfUnityInversePreconReverseTable, tables.cycloOrderInverse,
+          tables.cycloOrderInversePrecon, element);
+    }
   } else {
     NumberTheoreticTransform<VecType>::InverseTransformFromBitReverseInPlace(
-        m_rootOfUnityInverseReverseTableByModulus[modulus],
-        m_cycloOrderInverseTableByModulus[modulus][msb], element);
+        tables.rootOfUnityInverseReverseTable, tables.cycloOrderInverse,
+        element);
   }
 }
 
@@ -882,104 +911,252 @@ void ChineseRemainderTransformFTT<VecType>::InverseTransformFromBitReverse(
                    "result size must be equal to CyclotomicOrder / 2");
   }
 
-  IntType modulus = element.GetModulus();
-
-  bool reCompute = false;
-  PALISADE_UNUSED(reCompute);  // Used only when WITH_INTEL_HEXL=ON
-  auto mapSearch = m_rootOfUnityReverseTableByModulus.find(modulus);
-  if (mapSearch == m_rootOfUnityReverseTableByModulus.end() ||
-      mapSearch->second.GetLength() < CycloOrderHf) {
-    PreCompute(rootOfUnity, CycloOrder, modulus);
-    reCompute = true;
-  }
+  const NTTTables<VecType> &tables =
+      *GetTables(rootOfUnity, CycloOrder, element.GetModulus());
 
-  usint msb = GetMSB64(CycloOrderHf - 1);
-  if (typeid(IntType) == typeid(NativeInteger)) {
-    NumberTheoreticTransform<VecType>::InverseTransformFromBitReverse(
-        element, m_rootOfUnityInverseReverseTableByModulus[modulus],
-        m_rootOfUnityInversePreconReverseTableByModulus[modulus],
-        m_cycloOrderInverseTableByModulus[modulus][msb],
-        m_cycloOrderInversePreconTableByModulus[modulus][msb], result);
+  if (std::is_same<IntType, NativeInteger>::value) {
+    *result = element;
+    InverseTransformFromBitReverseInPlace(tables, result);
   } else {
+    CheckTables(tables, element);
     NumberTheoreticTransform<VecType>::InverseTransformFromBitReverse(
-        element, m_rootOfUnityInverseReverseTableByModulus[modulus],
-        m_cycloOrderInverseTableByModulus[modulus][msb], result);
+        element, tables.rootOfUnityInverseReverseTable,
+        tables.cycloOrderInverse, result);
   }
+}
 
-  return;
+template <typename VecType>
+void ChineseRemainderTransformFTT<VecType>::ForwardTransformToBitReverseInPlace(
+    const std::vector<const NTTTables<VecType> *> &tables,
+    const std::vector<VecType *> &elements) {
+  if (tables.size() != elements.size()) {
+    PALISADE_THROW(math_error,
+                   "the number of tables and elements must be the same");
+  }
+  if (elements.empty()) {
+    return;
+  }
+  for (usint i = 0; i < elements.size(); i++) {
+    CheckTables(*tables[i], *elements[i]);
+  }
+
+  std::vector<NTTBatchItem> items;
+  if (BatchItemsNat(tables, elements, false, &items)) {
+    NumberTheoreticTransformNat::ForwardTransformToBitReverseInPlace(
+        items, elements[0]->GetLength());
+    return;
+  }
+
+#pragma omp parallel for
+  for (usint i = 0; i < elements.size(); i++) {
+    ForwardTransformToBitReverseInPlace(*tables[i], elements[i]);
+  }
 }
 
 template <typename VecType>
-void ChineseRemainderTransformFTT<VecType>::PreCompute(
-    const IntType &rootOfUnity, const usint CycloOrder,
-    const IntType &modulus) {
-  usint CycloOrderHf = (CycloOrder >> 1);
+void ChineseRemainderTransformFTT<VecType>::
+    InverseTransformFromBitReverseInPlace(
+        const std::vector<const NTTTables<VecType> *> &tables,
+        const std::vector<VecType *> &elements) {
+  if (tables.size() != elements.size()) {
+    PALISADE_THROW(math_error,
+                   "the number of tables and elements must be the same");
+  }
+  if (elements.empty()) {
+    return;
+  }
+  for (usint i = 0; i < elements.size(); i++) {
+    CheckTables(*tables[i], *elements[i]);
+  }
 
-  auto mapSearch = m_rootOfUnityReverseTableByModulus.find(modulus);
-  if (mapSearch == m_rootOfUnityReverseTableByModulus.end() ||
-      mapSearch->second.GetLength() < CycloOrderHf) {
-#pragma omp critical
-    {
-      IntType x(1), xinv(1);
-      usint msb = GetMSB64(CycloOrderHf - 1);
-      IntType mu = modulus.ComputeMu();
-      VecType Table(CycloOrderHf, modulus);
-      VecType TableI(CycloOrderHf, modulus);
-      IntType rootOfUnityInverse = rootOfUnity.ModInverse(modulus);
-      usint iinv;
-      for (usint i = 0; i < CycloOrderHf; i++) {
-        iinv = ReverseBits(i, msb);
-        Table[iinv] = x;
-        TableI[iinv] = xinv;
-        x.ModMulEq(rootOfUnity, modulus, mu);
-        xinv.ModMulEq(rootOfUnityInverse, modulus, mu);
+  std::vector<NTTBatchItem> items;
+  if (BatchItemsNat(tables, elements, true, &items)) {
+    NumberTheoreticTransformNat::InverseTransformFromBitReverseInPlace(
+        items, elements[0]->GetLength());
+    return;
+  }
+
+#pragma omp parallel for
+  for (usint i = 0; i < elements.size(); i++) {
+    InverseTransformFromBitReverseInPlace(*tables[i], elements[i]);
+  }
+}
+
+template <typename VecType>
+void ChineseRemainderTransformFTT<VecType>::CheckTables(
+    const NTTTables<VecType> &tables, const VecType &element) {
+  if (element.GetLength() != (tables.cycloOrder >> 1)) {
+    PALISADE_THROW(math_error,
+                   "element size must be equal to CyclotomicOrder / 2");
+  }
+  if (element.GetModulus() != tables.modulus) {
+    PALISADE_THROW(math_error,
+                   "element modulus does not match the transform tables");
+  }
+}
+
+template <typename VecType>
+const NTTTables<VecType> *ChineseRemainderTransformFTT<VecType>::FindTables(
+    const IntType &modulus, const usint CycloOrder) {
+  // the reader count is raised before the snapshot is loaded, so a writer
+  // that sees no reader after publishing knows that nobody can still load
+  // the snapshot it retired
+  m_readers.fetch_add(1, std::memory_order_seq_cst);
+  const TablesSnapshot *snapshot = m_tables.load(std::memory_order_seq_cst);
+  const NTTTables<VecType> *result = nullptr;
+
+  if (snapshot != nullptr) {
+    // binary search over the sorted snapshot
+    size_t lo = 0;
+    size_t hi = snapshot->size();
+    while (lo < hi) {
+      size_t mid = (lo + hi) >> 1;
+      const TablesKey &key = (*snapshot)[mid].first;
+      if (key.first < modulus ||
+          (key.first == modulus && key.second < CycloOrder)) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
       }
-      m_rootOfUnityReverseTableByModulus[modulus] = Table;
-      m_rootOfUnityInverseReverseTableByModulus[modulus] = TableI;
+    }
 
-      VecType TableCOI(msb + 1, modulus);
-      for (usint i = 0; i < msb + 1; i++) {
-        IntType coInv(IntType(1 << i).ModInverse(modulus));
-        TableCOI[i] = coInv;
+    if (lo < snapshot->size()) {
+      const TablesKey &key = (*snapshot)[lo].first;
+      if (key.first == modulus && key.second == CycloOrder) {
+        result = (*snapshot)[lo].second;
       }
-      m_cycloOrderInverseTableByModulus[modulus] = TableCOI;
-
-      if (typeid(IntType) == typeid(NativeInteger)) {
-        NativeInteger nativeModulus = modulus.ConvertToInt();
-        NativeVector preconTable(CycloOrderHf, nativeModulus);
-        NativeVector preconTableI(CycloOrderHf, nativeModulus);
-
-        for (usint i = 0; i < CycloOrderHf; i++) {
-          preconTable[i] =
-              NativeInteger(m_rootOfUnityReverseTableByModulus[modulus]
-                                .
-                                operator[](i)
-                                .ConvertToInt())
-                  .PrepModMulConst(nativeModulus);
-          preconTableI[i] =
-              NativeInteger(m_rootOfUnityInverseReverseTableByModulus[modulus]
-                                .
-                                operator[](i)
-                                .ConvertToInt())
-                  .PrepModMulConst(nativeModulus);
-        }
+    }
+  }
 
-        NativeVector preconTableCOI(msb + 1, nativeModulus);
-        for (usint i = 0; i < msb + 1; i++) {
-          preconTableCOI[i] =
-              NativeInteger(m_cycloOrderInverseTableByModulus[modulus]
-                                .
-                                operator[](i)
-                                .ConvertToInt())
-                  .PrepModMulConst(nativeModulus);
-        }
+  m_readers.fetch_sub(1, std::memory_order_seq_cst);
+  return result;
+}
 
-        m_rootOfUnityPreconReverseTableByModulus[modulus] = preconTable;
-        m_rootOfUnityInversePreconReverseTableByModulus[modulus] = preconTableI;
-        m_cycloOrderInversePreconTableByModulus[modulus] = preconTableCOI;
-      }
+template <typename VecType>
+const NTTTables<VecType> *ChineseRemainderTransformFTT<VecType>::GetTables(
+    const IntType &rootOfUnity, const usint CycloOrder,
+    const IntType &modulus) {
+  const NTTTables<VecType> *tables = FindTables(modulus, CycloOrder);
+  if (tables != nullptr) {
+    return tables;
+  }
+  return AddTables(rootOfUnity, CycloOrder, modulus);
+}
+
+template <typename VecType>
+typename ChineseRemainderTransformFTT<VecType>::TablesStorage &
+ChineseRemainderTransformFTT<VecType>::Storage() {
+  static TablesStorage storage;
+  return storage;
+}
+
+template <typename VecType>
+void ChineseRemainderTransformFTT<VecType>::Publish(
+    std::unique_ptr<TablesSnapshot> next) {
+  TablesStorage &storage = Storage();
+  if (storage.current != nullptr) {
+    storage.retired.reserve(storage.retired.size() + 1);
+  }
+
+  m_tables.store(next.get(), std::memory_order_seq_cst);
+  if (storage.current != nullptr) {
+    storage.retired.push_back(std::move(storage.current));
+  }
+  storage.current = std::move(next);
+
+  // a lookup that starts after this check loads the new snapshot
+  if (m_readers.load(std::memory_order_seq_cst) == 0) {
+    storage.retired.clear();
+  }
+}
+
+template <typename VecType>
+const NTTTables<VecType> *ChineseRemainderTransformFTT<VecType>::AddTables(
+    const IntType &rootOfUnity, const usint CycloOrder,
+    const IntType &modulus) {
+  // the tables are built outside of the lock; if another thread registers
+  // the same tables in the meantime, ours are discarded
+  usint CycloOrderHf = (CycloOrder >> 1);
+  std::unique_ptr<NTTTables<VecType>> tables(new NTTTables<VecType>());
+  tables->modulus = modulus;
+  tables->rootOfUnity = rootOfUnity;
+  tables->cycloOrder = CycloOrder;
+
+  IntType x(1), xinv(1);
+  usint msb = GetMSB64(CycloOrderHf - 1);
+  IntType mu = modulus.ComputeMu();
+  VecType Table(CycloOrderHf, modulus);
+  VecType TableI(CycloOrderHf, modulus);
+  IntType rootOfUnityInverse = rootOfUnity.ModInverse(modulus);
+  usint iinv;
+  for (usint i = 0; i < CycloOrderHf; i++) {
+    iinv = ReverseBits(i, msb);
+    Table[iinv] = x;
+    TableI[iinv] = xinv;
+    x.ModMulEq(rootOfUnity, modulus, mu);
+    xinv.ModMulEq(rootOfUnityInverse, modulus, mu);
+  }
+  tables->cycloOrderInverse = IntType(CycloOrderHf).ModInverse(modulus);
+
+  if (std::is_same<IntType, NativeInteger>::value) {
+    NativeInteger nativeModulus = modulus.ConvertToInt();
+    NativeVector preconTable(CycloOrderHf, nativeModulus);
+    NativeVector preconTableI(CycloOrderHf, nativeModulus);
+
+    for (usint i = 0; i < CycloOrderHf; i++) {
+      preconTable[i] = NativeInteger(Table[i].ConvertToInt())
+                           .PrepModMulConst(nativeModulus);
+      preconTableI[i] = NativeInteger(TableI[i].ConvertToInt())
+                            .PrepModMulConst(nativeModulus);
     }
+
+    tables->rootOfUnityPreconReverseTable = std::move(preconTable);
+    tables->rootOfUnityInversePreconReverseTable = std::move(preconTableI);
+    tables->cycloOrderInversePrecon =
+        NativeInteger(tables->cycloOrderInverse.ConvertToInt())
+            .PrepModMulConst(nativeModulus);
+  }
+  tables->rootOfUnityReverseTable = std::move(Table);
+  tables->rootOfUnityInverseReverseTable = std::move(TableI);
+
+#ifdef WITH_INTEL_HEXL
+  if (std::is_same<VecType, NativeVector>::value) {
+    tables->intelNtt.reset(new intel::hexl::NTT(
+        CycloOrderHf, modulus.ConvertToInt(), rootOfUnity.ConvertToInt()));
+  }
+#endif
+
+  std::lock_guard<std::mutex> lock(m_tablesMutex);
+  const NTTTables<VecType> *existing = FindTables(modulus, CycloOrder);
+  if (existing != nullptr) {
+    return existing;
   }
+
+  // copy-on-write: readers keep using the previous snapshot until it is
+  // retired and no lookup is left in flight
+  TablesStorage &storage = Storage();
+  storage.tables.reserve(storage.tables.size() + 1);
+
+  const TablesSnapshot *current = storage.current.get();
+  std::unique_ptr<TablesSnapshot> next(
+      current != nullptr ? new TablesSnapshot(*current) : new TablesSnapshot());
+  TablesKey key(modulus, CycloOrder);
+  auto pos = next->begin();
+  while (pos != next->end() && pos->first < key) {
+    ++pos;
+  }
+  next->insert(pos, std::make_pair(key, tables.get()));
+
+  storage.tables.push_back(std::move(tables));
+  Publish(std::move(next));
+  return storage.tables.back().get();
+}
+
+template <typename VecType>
+void ChineseRemainderTransformFTT<VecType>::PreCompute(
+    const IntType &rootOfUnity, const usint CycloOrder,
+    const IntType &modulus) {
+  GetTables(rootOfUnity, CycloOrder, modulus);
 }
 
 template <typename VecType>
@@ -1004,12 +1181,8 @@ void ChineseRemainderTransformFTT<VecType>::PreCompute(
 
 template <typename VecType>
 void ChineseRemainderTransformFTT<VecType>::Reset() {
-  m_cycloOrderInverseTableByModulus.clear();
-  m_cycloOrderInversePreconTableByModulus.clear();
-  m_rootOfUnityReverseTableByModulus.clear();
-  m_rootOfUnityInverseReverseTableByModulus.clear();
-  m_rootOfUnityPreconReverseTableByModulus.clear();
-  m_rootOfUnityInversePreconReverseTableByModulus.clear();
+  std::lock_guard<std::mutex> lock(m_tablesMutex);
+  Publish(nullptr);
 }
 
 template <typename VecType>
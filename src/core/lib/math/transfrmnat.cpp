@@ -0,0 +1,643 @@
+/*
+ * @file transfrmnat.cpp This file contains the lazy-butterfly NTT kernels
+ * for native integer vectors.
+ * @author  TPOC: contact@palisade-crypto.org
+ *
+ * @copyright Copyright (c) 2019, New Jersey Institute of Technology (NJIT)
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution. THIS SOFTWARE IS
+ * PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#include "math/transfrmnat.h"
+#include "utils/exception.h"
+#include "utils/parallel.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define PALISADE_NTT_X86_KERNELS
+// g++ 12 reports the _mm512_undefined_* placeholders used by the set1
+// intrinsics as maybe-uninitialized
+#if !defined(__clang__) && __GNUC__ >= 12
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+#include <immintrin.h>
+#endif
+
+namespace lbcrypto {
+
+namespace {
+
+/*
+ * Every kernel is split into stage primitives that process the butterflies
+ * of groups [i0, i1) restricted to offsets [j0, j1) within each group. A full
+ * stage is i0 = 0, i1 = m, j0 = 0, j1 = t; the batched transforms use
+ * sub-ranges to split a vector into independent blocks. All range lengths
+ * are powers of two and j0 is a multiple of j1 - j0.
+ */
+typedef void (*StageFunc)(const uint64_t *root, const uint64_t *precon,
+                          uint64_t q, usint m, usint t, usint i0, usint i1,
+                          usint j0, usint j1, uint64_t *a);
+typedef void (*ReduceFunc)(uint64_t q, usint count, uint64_t *a);
+typedef void (*ScaleFunc)(uint64_t nInv, uint64_t nInvPrecon, uint64_t q,
+                          usint count, uint64_t *a);
+
+struct KernelOps {
+  StageFunc forwardStage;
+  StageFunc inverseStage;
+  ReduceFunc reduce;
+  ScaleFunc scale;
+};
+
+/*
+ * Shoup modular multiplication with a precomputed multiplicand. For any
+ * y < 2^64, the result is congruent to w*y mod q and lies in [0, 2q).
+ */
+inline uint64_t MulModLazy(uint64_t y, uint64_t w, uint64_t wPrecon,
+                           uint64_t q) {
+  uint64_t hi = static_cast<uint64_t>(
+      (static_cast<DoubleNativeInt>(y) * wPrecon) >> 64);
+  return w * y - hi * q;
+}
+
+inline uint64_t ReduceOnce(uint64_t x, uint64_t bound) {
+  return (x >= bound) ? x - bound : x;
+}
+
+/*
+ * Cooley-Tukey butterflies; values stay in [0, 4q).
+ */
+void ForwardStageScalar(const uint64_t *root, const uint64_t *precon,
+                        uint64_t q, usint m, usint t, usint i0, usint i1,
+                        usint j0, usint j1, uint64_t *a) {
+  const uint64_t twoQ = q << 1;
+  for (usint i = i0; i < i1; ++i) {
+    const uint64_t w = root[m + i];
+    const uint64_t wPrecon = precon[m + i];
+    uint64_t *x = a + 2 * i * t;
+    uint64_t *y = x + t;
+    for (usint j = j0; j < j1; ++j) {
+      uint64_t u = ReduceOnce(x[j], twoQ);
+      uint64_t v = MulModLazy(y[j], w, wPrecon, q);
+      x[j] = u + v;
+      y[j] = u - v + twoQ;
+    }
+  }
+}
+
+/*
+ * Gentleman-Sande butterflies; values stay in [0, 2q).
+ */
+void InverseStageScalar(const uint64_t *root, const uint64_t *precon,
+                        uint64_t q, usint m, usint t, usint i0, usint i1,
+                        usint j0, usint j1, uint64_t *a) {
+  const uint64_t twoQ = q << 1;
+  for (usint i = i0; i < i1; ++i) {
+    const uint64_t w = root[m + i];
+    const uint64_t wPrecon = precon[m + i];
+    uint64_t *x = a + 2 * i * t;
+    uint64_t *y = x + t;
+    for (usint j = j0; j < j1; ++j) {
+      uint64_t u = x[j];
+      uint64_t v = y[j];
+      x[j] = ReduceOnce(u + v, twoQ);
+      y[j] = MulModLazy(u - v + twoQ, w, wPrecon, q);
+    }
+  }
+}
+
+void ReduceScalar(uint64_t q, usint count, uint64_t *a) {
+  const uint64_t twoQ = q << 1;
+  for (usint i = 0; i < count; ++i) {
+    a[i] = ReduceOnce(ReduceOnce(a[i], twoQ), q);
+  }
+}
+
+void ScaleScalar(uint64_t nInv, uint64_t nInvPrecon, uint64_t q, usint count,
+                 uint64_t *a) {
+  for (usint i = 0; i < count; ++i) {
+    a[i] = ReduceOnce(MulModLazy(a[i], nInv, nInvPrecon, q), q);
+  }
+}
+
+const KernelOps SCALAR_OPS = {ForwardStageScalar, InverseStageScalar,
+                              ReduceScalar, ScaleScalar};
+
+#ifdef PALISADE_NTT_X86_KERNELS
+
+#define PALISADE_TARGET_AVX2 __attribute__((target("avx2")))
+#define PALISADE_TARGET_AVX512 __attribute__((target("avx512f,avx512dq")))
+
+/*
+ * AVX2 has neither unsigned 64-bit comparisons nor 64-bit multiplications,
+ * so both are emulated with 32x32->64 multiplies and sign-flipped compares.
+ */
+PALISADE_TARGET_AVX2 inline __m256i MulHi256(__m256i a, __m256i b) {
+  const __m256i lowMask = _mm256_set1_epi64x(0xFFFFFFFF);
+  __m256i aHi = _mm256_srli_epi64(a, 32);
+  __m256i bHi = _mm256_srli_epi64(b, 32);
+  __m256i lolo = _mm256_mul_epu32(a, b);
+  __m256i lohi = _mm256_mul_epu32(a, bHi);
+  __m256i hilo = _mm256_mul_epu32(aHi, b);
+  __m256i hihi = _mm256_mul_epu32(aHi, bHi);
+  __m256i cross = _mm256_add_epi64(
+      _mm256_srli_epi64(lolo, 32),
+      _mm256_add_epi64(_mm256_and_si256(lohi, lowMask),
+                       _mm256_and_si256(hilo, lowMask)));
+  return _mm256_add_epi64(
+      _mm256_add_epi64(hihi, _mm256_srli_epi64(cross, 32)),
+      _mm256_add_epi64(_mm256_srli_epi64(lohi, 32),
+                       _mm256_srli_epi64(hilo, 32)));
+}
+
+PALISADE_TARGET_AVX2 inline __m256i MulLo256(__m256i a, __m256i b) {
+  __m256i lolo = _mm256_mul_epu32(a, b);
+  __m256i cross =
+      _mm256_add_epi64(_mm256_mul_epu32(a, _mm256_srli_epi64(b, 32)),
+                       _mm256_mul_epu32(_mm256_srli_epi64(a, 32), b));
+  return _mm256_add_epi64(lolo, _mm256_slli_epi64(cross, 32));
+}
+
+PALISADE_TARGET_AVX2 inline __m256i ReduceOnce256(__m256i x, __m256i bound) {
+  const __m256i signBit = _mm256_set1_epi64x(0x8000000000000000LL);
+  __m256i lt = _mm256_cmpgt_epi64(_mm256_xor_si256(bound, signBit),
+                                  _mm256_xor_si256(x, signBit));
+  return _mm256_blendv_epi8(_mm256_sub_epi64(x, bound), x, lt);
+}
+
+PALISADE_TARGET_AVX2 inline __m256i MulModLazy256(__m256i y, __m256i w,
+                                                  __m256i wPrecon, __m256i q) {
+  __m256i hi = MulHi256(y, wPrecon);
+  return _mm256_sub_epi64(MulLo256(w, y), MulLo256(hi, q));
+}
+
+PALISADE_TARGET_AVX2 void ForwardStageAVX2(const uint64_t *root,
+                                           const uint64_t *precon, uint64_t q,
+                                           usint m, usint t, usint i0,
+                                           usint i1, usint j0, usint j1,
+                                           uint64_t *a) {
+  if (j1 - j0 < 4) {
+    ForwardStageScalar(root, precon, q, m, t, i0, i1, j0, j1, a);
+    return;
+  }
+  const __m256i vq = _mm256_set1_epi64x(q);
+  const __m256i v2q = _mm256_set1_epi64x(q << 1);
+  for (usint i = i0; i < i1; ++i) {
+    const __m256i w = _mm256_set1_epi64x(root[m + i]);
+    const __m256i wPrecon = _mm256_set1_epi64x(precon[m + i]);
+    uint64_t *x = a + 2 * i * t;
+    uint64_t *y = x + t;
+    for (usint j = j0; j < j1; j += 4) {
+      __m256i *px = reinterpret_cast<__m256i *>(x + j);
+      __m256i *py = reinterpret_cast<__m256i *>(y + j);
+      __m256i u = ReduceOnce256(_mm256_loadu_si256(px), v2q);
+      __m256i v = MulModLazy256(_mm256_loadu_si256(py), w, wPrecon, vq);
+      _mm256_storeu_si256(px, _mm256_add_epi64(u, v));
+      _mm256_storeu_si256(py, _mm256_add_epi64(_mm256_sub_epi64(u, v), v2q));
+    }
+  }
+}
+
+PALISADE_TARGET_AVX2 void InverseStageAVX2(const uint64_t *root,
+                                           const uint64_t *precon, uint64_t q,
+                                           usint m, usint t, usint i0,
+                                           usint i1, usint j0, usint j1,
+                                           uint64_t *a) {
+  if (j1 - j0 < 4) {
+    InverseStageScalar(root, precon, q, m, t, i0, i1, j0, j1, a);
+    return;
+  }
+  const __m256i vq = _mm256_set1_epi64x(q);
+  const __m256i v2q = _mm256_set1_epi64x(q << 1);
+  for (usint i = i0; i < i1; ++i) {
+    const __m256i w = _mm256_set1_epi64x(root[m + i]);
+    const __m256i wPrecon = _mm256_set1_epi64x(precon[m + i]);
+    uint64_t *x = a + 2 * i * t;
+    uint64_t *y = x + t;
+    for (usint j = j0; j < j1; j += 4) {
+      __m256i *px = reinterpret_cast<__m256i *>(x + j);
+      __m256i *py = reinterpret_cast<__m256i *>(y + j);
+      __m256i u = _mm256_loadu_si256(px);
+      __m256i v = _mm256_loadu_si256(py);
+      _mm256_storeu_si256(px, ReduceOnce256(_mm256_add_epi64(u, v), v2q));
+      __m256i diff = _mm256_add_epi64(_mm256_sub_epi64(u, v), v2q);
+      _mm256_storeu_si256(py, MulModLazy256(diff, w, wPrecon, vq));
+    }
+  }
+}
+
+PALISADE_TARGET_AVX2 void ReduceAVX2(uint64_t q, usint count, uint64_t *a) {
+  const __m256i vq = _mm256_set1_epi64x(q);
+  const __m256i v2q = _mm256_set1_epi64x(q << 1);
+  usint i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m256i *p = reinterpret_cast<__m256i *>(a + i);
+    __m256i x = _mm256_loadu_si256(p);
+    _mm256_storeu_si256(p, ReduceOnce256(ReduceOnce256(x, v2q), vq));
+  }
+  ReduceScalar(q, count - i, a + i);
+}
+
+PALISADE_TARGET_AVX2 void ScaleAVX2(uint64_t nInv, uint64_t nInvPrecon,
+                                    uint64_t q, usint count, uint64_t *a) {
+  const __m256i vq = _mm256_set1_epi64x(q);
+  const __m256i vnInv = _mm256_set1_epi64x(nInv);
+  const __m256i vnInvPrecon = _mm256_set1_epi64x(nInvPrecon);
+  usint i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m256i *p = reinterpret_cast<__m256i *>(a + i);
+    __m256i x = MulModLazy256(_mm256_loadu_si256(p), vnInv, vnInvPrecon, vq);
+    _mm256_storeu_si256(p, ReduceOnce256(x, vq));
+  }
+  ScaleScalar(nInv, nInvPrecon, q, count - i, a + i);
+}
+
+const KernelOps AVX2_OPS = {ForwardStageAVX2, InverseStageAVX2, ReduceAVX2,
+                            ScaleAVX2};
+
+/*
+ * AVX-512 provides unsigned 64-bit min and (with DQ) 64-bit low products;
+ * only the high half of the 64x64 product has to be emulated.
+ */
+PALISADE_TARGET_AVX512 inline __m512i MulHi512(__m512i a, __m512i b) {
+  const __m512i lowMask = _mm512_set1_epi64(0xFFFFFFFF);
+  __m512i aHi = _mm512_srli_epi64(a, 32);
+  __m512i bHi = _mm512_srli_epi64(b, 32);
+  __m512i lolo = _mm512_mul_epu32(a, b);
+  __m512i lohi = _mm512_mul_epu32(a, bHi);
+  __m512i hilo = _mm512_mul_epu32(aHi, b);
+  __m512i hihi = _mm512_mul_epu32(aHi, bHi);
+  __m512i cross = _mm512_add_epi64(
+      _mm512_srli_epi64(lolo, 32),
+      _mm512_add_epi64(_mm512_and_si512(lohi, lowMask),
+                       _mm512_and_si512(hilo, lowMask)));
+  return _mm512_add_epi64(
+      _mm512_add_epi64(hihi, _mm512_srli_epi64(cross, 32)),
+      _mm512_add_epi64(_mm512_srli_epi64(lohi, 32),
+                       _mm512_srli_epi64(hilo, 32)));
+}
+
+PALISADE_TARGET_AVX512 inline __m512i ReduceOnce512(__m512i x,
+                                                    __m512i bound) {
+  return _mm512_min_epu64(x, _mm512_sub_epi64(x, bound));
+}
+
+PALISADE_TARGET_AVX512 inline __m512i MulModLazy512(__m512i y, __m512i w,
+                                                    __m512i wPrecon,
+                                                    __m512i q) {
+  __m512i hi = MulHi512(y, wPrecon);
+  return _mm512_sub_epi64(_mm512_mullo_epi64(w, y), _mm512_mullo_epi64(hi, q));
+}
+
+PALISADE_TARGET_AVX512 void ForwardStageAVX512(const uint64_t *root,
+                                               const uint64_t *precon,
+                                               uint64_t q, usint m, usint t,
+                                               usint i0, usint i1, usint j0,
+                                               usint j1, uint64_t *a) {
+  if (j1 - j0 < 8) {
+    ForwardStageScalar(root, precon, q, m, t, i0, i1, j0, j1, a);
+    return;
+  }
+  const __m512i vq = _mm512_set1_epi64(q);
+  const __m512i v2q = _mm512_set1_epi64(q << 1);
+  for (usint i = i0; i < i1; ++i) {
+    const __m512i w = _mm512_set1_epi64(root[m + i]);
+    const __m512i wPrecon = _mm512_set1_epi64(precon[m + i]);
+    uint64_t *x = a + 2 * i * t;
+    uint64_t *y = x + t;
+    for (usint j = j0; j < j1; j += 8) {
+      __m512i u = ReduceOnce512(_mm512_loadu_si512(x + j), v2q);
+      __m512i v = MulModLazy512(_mm512_loadu_si512(y + j), w, wPrecon, vq);
+      _mm512_storeu_si512(x + j, _mm512_add_epi64(u, v));
+      _mm512_storeu_si512(y + j,
+                          _mm512_add_epi64(_mm512_sub_epi64(u, v), v2q));
+    }
+  }
+}
+
+PALISADE_TARGET_AVX512 void InverseStageAVX512(const uint64_t *root,
+                                               const uint64_t *precon,
+                                               uint64_t q, usint m, usint t,
+                                               usint i0, usint i1, usint j0,
+                                               usint j1, uint64_t *a) {
+  if (j1 - j0 < 8) {
+    InverseStageScalar(root, precon, q, m, t, i0, i1, j0, j1, a);
+    return;
+  }
+  const __m512i vq = _mm512_set1_epi64(q);
+  const __m512i v2q = _mm512_set1_epi64(q << 1);
+  for (usint i = i0; i < i1; ++i) {
+    const __m512i w = _mm512_set1_epi64(root[m + i]);
+    const __m512i wPrecon = _mm512_set1_epi64(precon[m + i]);
+    uint64_t *x = a + 2 * i * t;
+    uint64_t *y = x + t;
+    for (usint j = j0; j < j1; j += 8) {
+      __m512i u = _mm512_loadu_si512(x + j);
+      __m512i v = _mm512_loadu_si512(y + j);
+      _mm512_storeu_si512(x + j, ReduceOnce512(_mm512_add_epi64(u, v), v2q));
+      __m512i diff = _mm512_add_epi64(_mm512_sub_epi64(u, v), v2q);
+      _mm512_storeu_si512(y + j, MulModLazy512(diff, w, wPrecon, vq));
+    }
+  }
+}
+
+PALISADE_TARGET_AVX512 void ReduceAVX512(uint64_t q, usint count,
+                                         uint64_t *a) {
+  const __m512i vq = _mm512_set1_epi64(q);
+  const __m512i v2q = _mm512_set1_epi64(q << 1);
+  usint i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m512i x = _mm512_loadu_si512(a + i);
+    _mm512_storeu_si512(a + i, ReduceOnce512(ReduceOnce512(x, v2q), vq));
+  }
+  ReduceScalar(q, count - i, a + i);
+}
+
+PALISADE_TARGET_AVX512 void ScaleAVX512(uint64_t nInv, uint64_t nInvPrecon,
+                                        uint64_t q, usint count, uint64_t *a) {
+  const __m512i vq = _mm512_set1_epi64(q);
+  const __m512i vnInv = _mm512_set1_epi64(nInv);
+  const __m512i vnInvPrecon = _mm512_set1_epi64(nInvPrecon);
+  usint i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m512i x =
+        MulModLazy512(_mm512_loadu_si512(a + i), vnInv, vnInvPrecon, vq);
+    _mm512_storeu_si512(a + i, ReduceOnce512(x, vq));
+  }
+  ScaleScalar(nInv, nInvPrecon, q, count - i, a + i);
+}
+
+const KernelOps AVX512_OPS = {ForwardStageAVX512, InverseStageAVX512,
+                              ReduceAVX512, ScaleAVX512};
+
+#endif  // PALISADE_NTT_X86_KERNELS
+
+NTTKernelType &ActiveKernel() {
+  static NTTKernelType kernel =
+      NumberTheoreticTransformNat::GetBestAvailableKernel();
+  return kernel;
+}
+
+const KernelOps &ActiveOps() {
+  switch (ActiveKernel()) {
+#ifdef PALISADE_NTT_X86_KERNELS
+    case NTT_AVX512:
+      return AVX512_OPS;
+    case NTT_AVX2:
+      return AVX2_OPS;
+#endif
+    default:
+      return SCALAR_OPS;
+  }
+}
+
+/*
+ * Splitting a transform of length n into B blocks (B a power of two):
+ * stages with m >= B groups touch only the n/B contiguous coefficients of
+ * each block, so these "inner" stages of a block run independently of the
+ * other blocks. The log2(B) "outer" stages with m < B mix blocks; each of
+ * them is split into B equal slices of n/(2B) butterflies, with a barrier
+ * between consecutive outer stages.
+ */
+struct StageRange {
+  usint i0, i1, j0, j1;
+};
+
+inline StageRange BlockRange(usint n, usint m, usint t, usint blocks,
+                             usint b) {
+  StageRange r;
+  if (m >= blocks) {
+    usint groups = m / blocks;
+    r.i0 = b * groups;
+    r.i1 = r.i0 + groups;
+    r.j0 = 0;
+    r.j1 = t;
+  } else {
+    usint slices = blocks / m;
+    usint len = n / (blocks << 1);
+    r.i0 = b / slices;
+    r.i1 = r.i0 + 1;
+    r.j0 = (b % slices) * len;
+    r.j1 = r.j0 + len;
+  }
+  return r;
+}
+
+void ForwardOuterStage(const KernelOps &ops, const NTTBatchItem &item,
+                       usint n, usint m, usint blocks, usint b) {
+  usint t = n / (m << 1);
+  StageRange r = BlockRange(n, m, t, blocks, b);
+  ops.forwardStage(item.rootOfUnity, item.preconRoot, item.modulus, m, t,
+                   r.i0, r.i1, r.j0, r.j1, item.element);
+}
+
+void ForwardInnerStages(const KernelOps &ops, const NTTBatchItem &item,
+                        usint n, usint blocks, usint b) {
+  for (usint m = blocks, t = n / (blocks << 1); m < n; m <<= 1, t >>= 1) {
+    StageRange r = BlockRange(n, m, t, blocks, b);
+    ops.forwardStage(item.rootOfUnity, item.preconRoot, item.modulus, m, t,
+                     r.i0, r.i1, r.j0, r.j1, item.element);
+  }
+  usint len = n / blocks;
+  ops.reduce(item.modulus, len, item.element + b * len);
+}
+
+void InverseInnerStages(const KernelOps &ops, const NTTBatchItem &item,
+                        usint n, usint blocks, usint b) {
+  for (usint m = (n >> 1), t = 1; m >= blocks; m >>= 1, t <<= 1) {
+    StageRange r = BlockRange(n, m, t, blocks, b);
+    ops.inverseStage(item.rootOfUnity, item.preconRoot, item.modulus, m, t,
+                     r.i0, r.i1, r.j0, r.j1, item.element);
+  }
+  if (blocks == 1) {
+    ops.scale(item.cycloOrderInv, item.preconCycloOrderInv, item.modulus, n,
+              item.element);
+  }
+}
+
+void InverseOuterStage(const KernelOps &ops, const NTTBatchItem &item,
+                       usint n, usint m, usint blocks, usint b) {
+  usint t = n / (m << 1);
+  StageRange r = BlockRange(n, m, t, blocks, b);
+  ops.inverseStage(item.rootOfUnity, item.preconRoot, item.modulus, m, t,
+                   r.i0, r.i1, r.j0, r.j1, item.element);
+  if (m == 1) {
+    // the last stage leaves both halves of the slice final: scale them while
+    // they are still in cache
+    usint len = r.j1 - r.j0;
+    ops.scale(item.cycloOrderInv, item.preconCycloOrderInv, item.modulus, len,
+              item.element + r.j0);
+    ops.scale(item.cycloOrderInv, item.preconCycloOrderInv, item.modulus, len,
+              item.element + (n >> 1) + r.j0);
+  }
+}
+
+/*
+ * Number of blocks per vector: vectors are only split when there are fewer
+ * vectors than threads, and blocks are kept large enough to amortize the
+ * barriers between the outer stages.
+ */
+usint BatchBlocks(usint n, usint count, int threads) {
+  const usint MIN_BLOCK = 1 << 11;
+  usint blocks = 1;
+  while ((n / blocks) > MIN_BLOCK &&
+         static_cast<int>(blocks * count) < threads) {
+    blocks <<= 1;
+  }
+  return blocks;
+}
+
+}  // namespace
+
+bool NumberTheoreticTransformNat::IsKernelAvailable(NTTKernelType kernel) {
+  switch (kernel) {
+    case NTT_SCALAR:
+      return true;
+#ifdef PALISADE_NTT_X86_KERNELS
+    case NTT_AVX2:
+      return __builtin_cpu_supports("avx2");
+    case NTT_AVX512:
+      return __builtin_cpu_supports("avx512f") &&
+             __builtin_cpu_supports("avx512dq");
+#endif
+    default:
+      return false;
+  }
+}
+
+NTTKernelType NumberTheoreticTransformNat::GetBestAvailableKernel() {
+  if (IsKernelAvailable(NTT_AVX512)) return NTT_AVX512;
+  if (IsKernelAvailable(NTT_AVX2)) return NTT_AVX2;
+  return NTT_SCALAR;
+}
+
+NTTKernelType NumberTheoreticTransformNat::GetKernel() {
+  return ActiveKernel();
+}
+
+void NumberTheoreticTransformNat::SetKernel(NTTKernelType kernel) {
+  if (!IsKernelAvailable(kernel)) {
+    PALISADE_THROW(math_error,
+                   "the requested NTT kernel is not supported by this CPU");
+  }
+  ActiveKernel() = kernel;
+}
+
+void NumberTheoreticTransformNat::ForwardTransformToBitReverseInPlace(
+    const uint64_t *rootOfUnity, const uint64_t *preconRoot, uint64_t modulus,
+    usint n, uint64_t *element) {
+  NTTBatchItem item = {rootOfUnity, preconRoot, 0, 0, modulus, element};
+  ForwardInnerStages(ActiveOps(), item, n, 1, 0);
+}
+
+void NumberTheoreticTransformNat::InverseTransformFromBitReverseInPlace(
+    const uint64_t *rootOfUnityInverse, const uint64_t *preconRootInverse,
+    uint64_t cycloOrderInv, uint64_t preconCycloOrderInv, uint64_t modulus,
+    usint n, uint64_t *element) {
+  NTTBatchItem item = {rootOfUnityInverse, preconRootInverse, cycloOrderInv,
+                       preconCycloOrderInv, modulus, element};
+  InverseInnerStages(ActiveOps(), item, n, 1, 0);
+}
+
+void NumberTheoreticTransformNat::ForwardTransformToBitReverseInPlace(
+    const NativeVector &rootOfUnityTable,
+    const NativeVector &preconRootOfUnityTable, NativeVector *element) {
+  usint n = element->GetLength();
+  if (n < 2) {
+    return;
+  }
+  ForwardTransformToBitReverseInPlace(
+      reinterpret_cast<const uint64_t *>(&rootOfUnityTable[0]),
+      reinterpret_cast<const uint64_t *>(&preconRootOfUnityTable[0]),
+      element->GetModulus().ConvertToInt(), n,
+      reinterpret_cast<uint64_t *>(&(*element)[0]));
+}
+
+void NumberTheoreticTransformNat::InverseTransformFromBitReverseInPlace(
+    const NativeVector &rootOfUnityInverseTable,
+    const NativeVector &preconRootOfUnityInverseTable,
+    const NativeInteger &cycloOrderInv,
+    const NativeInteger &preconCycloOrderInv, NativeVector *element) {
+  usint n = element->GetLength();
+  if (n < 2) {
+    return;
+  }
+  InverseTransformFromBitReverseInPlace(
+      reinterpret_cast<const uint64_t *>(&rootOfUnityInverseTable[0]),
+      reinterpret_cast<const uint64_t *>(&preconRootOfUnityInverseTable[0]),
+      cycloOrderInv.ConvertToInt(), preconCycloOrderInv.ConvertToInt(),
+      element->GetModulus().ConvertToInt(), n,
+      reinterpret_cast<uint64_t *>(&(*element)[0]));
+}
+
+void NumberTheoreticTransformNat::ForwardTransformToBitReverseInPlace(
+    const std::vector<NTTBatchItem> &items, usint n) {
+  usint count = items.size();
+  if (n < 2 || count == 0) {
+    return;
+  }
+
+  const KernelOps &ops = ActiveOps();
+  bool parallel = !omp_in_parallel() && omp_get_max_threads() > 1;
+  usint blocks = BatchBlocks(n, count, parallel ? omp_get_max_threads() : 1);
+  usint tasks = count * blocks;
+
+#pragma omp parallel if (parallel && tasks > 1)
+  {
+    for (usint m = 1; m < blocks; m <<= 1) {
+#pragma omp for schedule(static)
+      for (usint k = 0; k < tasks; ++k) {
+        ForwardOuterStage(ops, items[k / blocks], n, m, blocks, k % blocks);
+      }
+    }
+#pragma omp for schedule(static)
+    for (usint k = 0; k < tasks; ++k) {
+      ForwardInnerStages(ops, items[k / blocks], n, blocks, k % blocks);
+    }
+  }
+}
+
+void NumberTheoreticTransformNat::InverseTransformFromBitReverseInPlace(
+    const std::vector<NTTBatchItem> &items, usint n) {
+  usint count = items.size();
+  if (n < 2 || count == 0) {
+    return;
+  }
+
+  const KernelOps &ops = ActiveOps();
+  bool parallel = !omp_in_parallel() && omp_get_max_threads() > 1;
+  usint blocks = BatchBlocks(n, count, parallel ? omp_get_max_threads() : 1);
+  usint tasks = count * blocks;
+
+#pragma omp parallel if (parallel && tasks > 1)
+  {
+#pragma omp for schedule(static)
+    for (usint k = 0; k < tasks; ++k) {
+      InverseInnerStages(ops, items[k / blocks], n, blocks, k % blocks);
+    }
+    for (usint m = (blocks >> 1); m >= 1; m >>= 1) {
+#pragma omp for schedule(static)
+      for (usint k = 0; k < tasks; ++k) {
+        InverseOuterStage(ops, items[k / blocks], n, m, blocks, k % blocks);
+      }
+    }
+  }
+}
+
+}  // namespace lbcrypto
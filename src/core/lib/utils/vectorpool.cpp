@@ -0,0 +1,142 @@
+/**
+ * @file vectorpool.cpp Per-thread pool for the storage of native vectors.
+ * @author  TPOC: contact@palisade-crypto.org
+ *
+ * @copyright Copyright (c) 2019, New Jersey Institute of Technology (NJIT)
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution. THIS SOFTWARE IS
+ * PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include "utils/vectorpool.h"
+
+#include <new>
+#include <vector>
+
+namespace lbcrypto {
+
+std::atomic<int> VectorMemoryPool::s_activeScopes(0);
+std::atomic<size_t> VectorMemoryPool::s_generation(0);
+std::atomic<size_t> VectorMemoryPool::s_maxCachedBytes(size_t(128) << 20);
+
+namespace {
+
+const size_t SIZE_CLASSES = 8 * sizeof(size_t);
+
+// true while the cache of the calling thread holds blocks; trivially
+// destructible, so it can be read at any point of the thread's lifetime
+thread_local bool t_cacheUsed = false;
+
+struct ThreadCache {
+  std::vector<void *> blocks[SIZE_CLASSES];
+  size_t cachedBytes = 0;
+  size_t generation = 0;
+
+  ~ThreadCache() { Clear(); }
+
+  void Clear() {
+    for (size_t i = 0; i < SIZE_CLASSES; i++) {
+      for (void *p : blocks[i]) {
+        ::operator delete(p);
+      }
+      blocks[i].clear();
+    }
+    cachedBytes = 0;
+    t_cacheUsed = false;
+  }
+};
+
+// the cache of the calling thread, emptied first if it was filled before the
+// last scope of the pool ended
+ThreadCache &GetThreadCache(size_t generation) {
+  static thread_local ThreadCache cache;
+  if (cache.generation != generation) {
+    cache.Clear();
+    cache.generation = generation;
+  }
+  return cache;
+}
+
+// index of the size class of bytes, or SIZE_CLASSES if it is not pooled
+size_t SizeClass(size_t bytes) {
+  if (bytes < VectorMemoryPool::MIN_POOLED_BYTES || (bytes & (bytes - 1))) {
+    return SIZE_CLASSES;
+  }
+  size_t index = 0;
+  while ((size_t(1) << index) != bytes) {
+    index++;
+  }
+  return index;
+}
+
+}  // namespace
+
+void *VectorMemoryPool::Allocate(size_t bytes) {
+  if (IsActive()) {
+    size_t index = SizeClass(bytes);
+    if (index < SIZE_CLASSES) {
+      ThreadCache &cache = GetThreadCache(GetGeneration());
+      if (!cache.blocks[index].empty()) {
+        void *p = cache.blocks[index].back();
+        cache.blocks[index].pop_back();
+        cache.cachedBytes -= bytes;
+        return p;
+      }
+    }
+  }
+  if (t_cacheUsed) {
+    // trims a cache left over from an ended scope
+    GetThreadCache(GetGeneration());
+  }
+  return ::operator new(bytes);
+}
+
+void VectorMemoryPool::Deallocate(void *p, size_t bytes) {
+  if (p != nullptr && IsActive()) {
+    size_t index = SizeClass(bytes);
+    if (index < SIZE_CLASSES) {
+      ThreadCache &cache = GetThreadCache(GetGeneration());
+      if (cache.cachedBytes + bytes <= GetMaxCachedBytes()) {
+        // deallocation runs in destructors, so a failure to grow the list
+        // frees the block instead of throwing
+        try {
+          cache.blocks[index].push_back(p);
+        } catch (const std::bad_alloc &) {
+          ::operator delete(p);
+          return;
+        }
+        cache.cachedBytes += bytes;
+        t_cacheUsed = true;
+        return;
+      }
+    }
+  }
+  if (t_cacheUsed) {
+    GetThreadCache(GetGeneration());
+  }
+  ::operator delete(p);
+}
+
+size_t VectorMemoryPool::GetCachedBytes() {
+  return GetThreadCache(GetGeneration()).cachedBytes;
+}
+
+void VectorMemoryPool::Release() { GetThreadCache(GetGeneration()).Clear(); }
+
+}  // namespace lbcrypto
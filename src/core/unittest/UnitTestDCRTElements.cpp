@@ -29,6 +29,7 @@ library.
 */
 
 #include "include/gtest/gtest.h"
+#include <algorithm>
 #include <iostream>
 #include <vector>
 
@@ -652,6 +653,133 @@ TEST(UTDCRTPoly, DCRT_mod_ops_on_two_elements) {
                     "DCRT DCRT_mod_ops_on_two_elements");
 }
 
+template <typename Element>
+void DCRT_flat_layout(const string& msg) {
+  usint order = 64;
+  usint nBits = 30;
+  usint towersize = 4;
+
+  shared_ptr<ILDCRTParams<typename Element::Integer>> ildcrtparams =
+      GenerateDCRTParams<typename Element::Integer>(order, towersize, nBits);
+
+  typename Element::DugType dug;
+
+  Element op1(dug, ildcrtparams);
+  Element op2(dug, ildcrtparams);
+  Element expectedSum = op1 + op2;
+  Element expectedProd = op1 * op2;
+
+  EXPECT_FALSE(op1.IsFlat()) << msg;
+  Element flat(op1);
+  flat.Flatten();
+  EXPECT_TRUE(flat.IsFlat()) << msg;
+  EXPECT_EQ(op1, flat) << msg << " Failure: Flatten changed the values";
+
+  // copies of a flat element are flat
+  Element copy(flat);
+  EXPECT_TRUE(copy.IsFlat()) << msg;
+  EXPECT_EQ(flat, copy) << msg;
+  EXPECT_NE(&flat.GetElementAtIndex(0).at(0), &copy.GetElementAtIndex(0).at(0))
+      << msg << " Failure: copy shares the slab";
+
+  Element assigned(dug, ildcrtparams);
+  assigned = flat;
+  EXPECT_TRUE(assigned.IsFlat()) << msg;
+  EXPECT_EQ(flat, assigned) << msg;
+
+  // in-place operations work on the slab and keep the layout
+  copy += op2;
+  EXPECT_EQ(expectedSum, copy) << msg << " Failure: += on flat element";
+  EXPECT_TRUE(copy.IsFlat()) << msg;
+
+  assigned = flat;
+  assigned *= op2;
+  EXPECT_EQ(expectedProd, assigned) << msg << " Failure: *= on flat element";
+
+  EXPECT_EQ(expectedSum, flat + op2) << msg << " Failure: + on flat element";
+
+  // the parallel tower loop acquires and releases regions concurrently
+  typename Element::Integer three(3);
+  EXPECT_EQ(op1.Times(three), flat.Times(three))
+      << msg << " Failure: Times on flat element";
+
+  copy = flat;
+  copy.SwitchFormat();
+  copy.SwitchFormat();
+  EXPECT_EQ(flat, copy) << msg << " Failure: SwitchFormat on flat element";
+  EXPECT_TRUE(copy.IsFlat()) << msg;
+}
+
+TEST(UTDCRTPoly, DCRT_flat_layout) {
+  RUN_BIG_DCRTPOLYS(DCRT_flat_layout, "DCRT_flat_layout");
+}
+
+template <typename Element>
+void DCRT_vector_pool(const string& msg) {
+  // towers of 1024 64-bit words are pooled
+  usint order = 2048;
+  usint nBits = 30;
+  usint towersize = 3;
+
+  shared_ptr<ILDCRTParams<typename Element::Integer>> ildcrtparams =
+      GenerateDCRTParams<typename Element::Integer>(order, towersize, nBits);
+
+  typename Element::DugType dug;
+
+  Element op1(dug, ildcrtparams);
+  Element op2(dug, ildcrtparams);
+  Element expectedSum = op1 + op2;
+  Element expectedProd = op1 * op2;
+
+  VectorMemoryPool::Release();
+  {
+    ScopedVectorPool pool;
+    EXPECT_TRUE(VectorMemoryPool::IsActive()) << msg;
+
+    const void* released;
+    {
+      Element tmp(op1);
+      released = &tmp.GetElementAtIndex(0).at(0);
+    }
+    EXPECT_GT(VectorMemoryPool::GetCachedBytes(), 0U)
+        << msg << " Failure: storage was not cached";
+
+    std::vector<const void*> reused;
+    for (size_t r = 0; r < 10; r++) {
+      Element tmp(op2);
+      reused.push_back(&tmp.GetElementAtIndex(0).at(0));
+      EXPECT_EQ(op2, tmp) << msg;
+    }
+    EXPECT_NE(std::find(reused.begin(), reused.end(), released), reused.end())
+        << msg << " Failure: cached storage was not reused";
+
+    for (size_t r = 0; r < 3; r++) {
+      EXPECT_EQ(expectedSum, op1 + op2) << msg << " Failure: pooled +";
+      EXPECT_EQ(expectedProd, op1 * op2) << msg << " Failure: pooled *";
+    }
+  }
+  EXPECT_FALSE(VectorMemoryPool::IsActive()) << msg;
+
+  // the blocks cached inside the ended scope are not handed out by the next
+  // scope: caching one block leaves exactly that block in the cache
+  {
+    ScopedVectorPool pool;
+    size_t bytes = 2 * VectorMemoryPool::MIN_POOLED_BYTES;
+    void* fresh = ::operator new(bytes);
+    VectorMemoryPool::Deallocate(fresh, bytes);
+    EXPECT_EQ(bytes, VectorMemoryPool::GetCachedBytes())
+        << msg << " Failure: cache outlived the pool scope";
+    void* p = VectorMemoryPool::Allocate(bytes);
+    EXPECT_EQ(fresh, p) << msg << " Failure: cached block was not reused";
+    VectorMemoryPool::Deallocate(p, bytes);
+  }
+  VectorMemoryPool::Release();
+}
+
+TEST(UTDCRTPoly, DCRT_vector_pool) {
+  RUN_BIG_DCRTPOLYS(DCRT_vector_pool, "DCRT_vector_pool");
+}
+
 // only need to try this with one
 void testDCRTPolyConstructorNegative(std::vector<NativePoly>& towers) {
   DCRTPoly expectException(towers);
@@ -41,6 +41,8 @@ IntPlainTextEncoding) work.
 #include "lattice/backend.h"
 #include "math/nbtheory.h"
 #include "math/distrgen.h"
+#include "math/rnsbaseconv.h"
+#include "math/transfrmnat.h"
 #include "utils/inttypes.h"
 #include "utils/utilities.h"
 
@@ -135,3 +137,269 @@ TEST(UTNTT, switch_format_simple_double_crt) {
   RUN_BIG_DCRTPOLYS(switch_format_simple_double_crt,
                     "switch_format_simple_double_crt")
 }
+
+// compares every native NTT kernel supported by the CPU against the generic
+// NumberTheoreticTransform implementation; the 60- and 61-bit moduli keep the
+// lazy [0, 4q) butterfly values close to the top of the 64-bit range
+TEST(UTNTT, native_kernels_match_generic) {
+  NTTKernelType defaultKernel = NumberTheoreticTransformNat::GetKernel();
+
+  for (usint m : {16, 64, 4096}) {
+    for (usint bits : {30, 59, 60, 61}) {
+      usint n = m / 2;
+      usint msb = GetMSB64(n - 1);
+      NativeInteger modulus = FirstPrime<NativeInteger>(bits, m);
+      NativeInteger root = RootOfUnity(m, modulus);
+      NativeInteger rootInv = root.ModInverse(modulus);
+
+      NativeVector rootTable(n, modulus), rootTableInv(n, modulus);
+      NativeVector preconTable(n, modulus), preconTableInv(n, modulus);
+      NativeInteger x(1), xinv(1);
+      for (usint i = 0; i < n; i++) {
+        usint iinv = ReverseBits(i, msb);
+        rootTable[iinv] = x;
+        rootTableInv[iinv] = xinv;
+        preconTable[iinv] = x.PrepModMulConst(modulus);
+        preconTableInv[iinv] = xinv.PrepModMulConst(modulus);
+        x.ModMulEq(root, modulus);
+        xinv.ModMulEq(rootInv, modulus);
+      }
+      NativeInteger nInv = NativeInteger(n).ModInverse(modulus);
+      NativeInteger nInvPrecon = nInv.PrepModMulConst(modulus);
+
+      DiscreteUniformGeneratorImpl<NativeVector> dug;
+      dug.SetModulus(modulus);
+      NativeVector input = dug.GenerateVector(n);
+
+      NativeVector expected(input);
+      NumberTheoreticTransform<NativeVector>::
+          ForwardTransformToBitReverseInPlace(rootTable, &expected);
+
+      for (NTTKernelType kernel : {NTT_SCALAR, NTT_AVX2, NTT_AVX512}) {
+        if (!NumberTheoreticTransformNat::IsKernelAvailable(kernel)) continue;
+        NumberTheoreticTransformNat::SetKernel(kernel);
+
+        NativeVector result(input);
+        NumberTheoreticTransformNat::ForwardTransformToBitReverseInPlace(
+            rootTable, preconTable, &result);
+        EXPECT_EQ(expected, result)
+            << "forward NTT mismatch for kernel " << kernel << ", n = " << n
+            << ", " << bits << "-bit modulus";
+
+        NumberTheoreticTransformNat::InverseTransformFromBitReverseInPlace(
+            rootTableInv, preconTableInv, nInv, nInvPrecon, &result);
+        EXPECT_EQ(input, result)
+            << "inverse NTT mismatch for kernel " << kernel << ", n = " << n
+            << ", " << bits << "-bit modulus";
+      }
+    }
+  }
+
+  NumberTheoreticTransformNat::SetKernel(defaultKernel);
+}
+
+TEST(UTNTT, fast_base_conversion_kernels) {
+  NTTKernelType defaultKernel = NumberTheoreticTransformNat::GetKernel();
+
+  // n is not a multiple of the block size or of the vector width
+  const usint n = 2 * RNSBaseConversionNat::BLOCK_SIZE + 13;
+  const usint sizeFrom = 5, sizeTo = 4;
+
+  std::vector<NativeInteger> qs, ps;
+  NativeInteger q = FirstPrime<NativeInteger>(59, 2 * n);
+  for (usint i = 0; i < sizeFrom + sizeTo; i++) {
+    q = NextPrime<NativeInteger>(q, 2 * n);
+    (i < sizeFrom ? qs : ps).push_back(q);
+  }
+
+  DiscreteUniformGeneratorImpl<NativeVector> dug;
+  std::vector<NativeVector> x;
+  std::vector<uint64_t> fromModuli, twist, twistPrecon;
+  std::vector<const uint64_t *> from;
+  for (usint i = 0; i < sizeFrom; i++) {
+    dug.SetModulus(qs[i]);
+    x.push_back(dug.GenerateVector(n));
+    NativeInteger w = dug.GenerateInteger();
+    fromModuli.push_back(qs[i].ConvertToInt());
+    twist.push_back(w.ConvertToInt());
+    twistPrecon.push_back(w.PrepModMulConst(qs[i]).ConvertToInt());
+  }
+  for (usint i = 0; i < sizeFrom; i++)
+    from.push_back(reinterpret_cast<const uint64_t *>(&x[i][0]));
+
+  std::vector<uint64_t> toModuli, matrix(sizeFrom * sizeTo), qModTo;
+  std::vector<DoubleNativeInt> toModuliMu;
+  for (usint j = 0; j < sizeTo; j++) {
+    dug.SetModulus(ps[j]);
+    toModuli.push_back(ps[j].ConvertToInt());
+    toModuliMu.push_back(~DoubleNativeInt(0) / ps[j].ConvertToInt());
+    qModTo.push_back(dug.GenerateInteger().ConvertToInt());
+    for (usint i = 0; i < sizeFrom; i++)
+      matrix[j * sizeFrom + i] = dug.GenerateInteger().ConvertToInt();
+  }
+
+  for (bool twisted : {false, true}) {
+    for (bool exact : {false, true}) {
+      // reference computed with the generic modular arithmetic
+      std::vector<NativeVector> expected;
+      for (usint j = 0; j < sizeTo; j++) {
+        NativeVector y(n, ps[j]);
+        for (usint k = 0; k < n; k++) {
+          NativeInteger sum(0);
+          double nu = 0.0;
+          for (usint i = 0; i < sizeFrom; i++) {
+            NativeInteger t =
+                twisted ? x[i][k].ModMul(twist[i], qs[i]) : x[i][k];
+            nu += t.ConvertToDouble() / qs[i].ConvertToDouble();
+            sum.ModAddEq(t.ModMul(matrix[j * sizeFrom + i], ps[j]), ps[j]);
+          }
+          if (exact) {
+            NativeInteger alpha(std::llround(nu));
+            sum.ModSubEq(alpha.ModMul(qModTo[j], ps[j]), ps[j]);
+          }
+          y[k] = sum;
+        }
+        expected.push_back(y);
+      }
+
+      for (NTTKernelType kernel : {NTT_SCALAR, NTT_AVX2, NTT_AVX512}) {
+        if (!NumberTheoreticTransformNat::IsKernelAvailable(kernel)) continue;
+        NumberTheoreticTransformNat::SetKernel(kernel);
+
+        std::vector<NativeVector> result;
+        std::vector<uint64_t *> to;
+        for (usint j = 0; j < sizeTo; j++) result.push_back(NativeVector(n));
+        for (usint j = 0; j < sizeTo; j++)
+          to.push_back(reinterpret_cast<uint64_t *>(&result[j][0]));
+
+        RNSBaseConvItem item = {n,
+                                sizeFrom,
+                                from.data(),
+                                fromModuli.data(),
+                                twisted ? twist.data() : nullptr,
+                                twisted ? twistPrecon.data() : nullptr,
+                                sizeTo,
+                                to.data(),
+                                toModuli.data(),
+                                toModuliMu.data(),
+                                matrix.data(),
+                                exact ? qModTo.data() : nullptr};
+        RNSBaseConversionNat::FastBaseConv(item);
+
+        for (usint j = 0; j < sizeTo; j++) {
+          for (usint k = 0; k < n; k++) {
+            EXPECT_EQ(expected[j][k], result[j][k])
+                << "base conversion mismatch for kernel " << kernel
+                << ", twisted " << twisted << ", exact " << exact
+                << ", target " << j << ", coefficient " << k;
+          }
+        }
+      }
+    }
+  }
+
+  NumberTheoreticTransformNat::SetKernel(defaultKernel);
+}
+
+TEST(UTNTT, ftt_tables_registry) {
+  usint m = 2048;
+  usint n = m / 2;
+  const usint numModuli = 8;
+
+  std::vector<NativeInteger> moduli(numModuli), roots(numModuli);
+  moduli[0] = FirstPrime<NativeInteger>(50, m);
+  roots[0] = RootOfUnity(m, moduli[0]);
+  for (usint i = 1; i < numModuli; i++) {
+    moduli[i] = NextPrime(moduli[i - 1], m);
+    roots[i] = RootOfUnity(m, moduli[i]);
+  }
+
+  // concurrent lookups of the same keys must agree on a single handle
+  std::vector<const NTTTables<NativeVector> *> handles(4 * numModuli);
+#pragma omp parallel for
+  for (usint i = 0; i < 4 * numModuli; i++) {
+    usint j = i % numModuli;
+    handles[i] = ChineseRemainderTransformFTT<NativeVector>::GetTables(
+        roots[j], m, moduli[j]);
+  }
+  for (usint i = 0; i < 4 * numModuli; i++) {
+    EXPECT_EQ(handles[i % numModuli], handles[i]) << "handle mismatch " << i;
+    EXPECT_EQ(moduli[i % numModuli], handles[i]->modulus);
+  }
+  EXPECT_EQ(handles[0], ChineseRemainderTransformFTT<NativeVector>::FindTables(
+                            moduli[0], m));
+
+  DiscreteUniformGeneratorImpl<NativeVector> dug;
+  dug.SetModulus(moduli[0]);
+  NativeVector input = dug.GenerateVector(n);
+
+  NativeVector expected(input);
+  ChineseRemainderTransformFTT<NativeVector>::
+      ForwardTransformToBitReverseInPlace(roots[0], m, &expected);
+
+  // handles stay valid after the registry is reset
+  ChineseRemainderTransformFTT<NativeVector>::Reset();
+  EXPECT_EQ(nullptr, ChineseRemainderTransformFTT<NativeVector>::FindTables(
+                         moduli[0], m));
+
+  NativeVector result(input);
+  ChineseRemainderTransformFTT<NativeVector>::
+      ForwardTransformToBitReverseInPlace(*handles[0], &result);
+  EXPECT_EQ(expected, result);
+  ChineseRemainderTransformFTT<NativeVector>::
+      InverseTransformFromBitReverseInPlace(*handles[0], &result);
+  EXPECT_EQ(input, result);
+
+  dug.SetModulus(moduli[1]);
+  NativeVector other = dug.GenerateVector(n);
+  EXPECT_THROW(ChineseRemainderTransformFTT<NativeVector>::
+                   ForwardTransformToBitReverseInPlace(*handles[0], &other),
+               math_error);
+}
+
+// the fused multi-tower transform of DCRTPoly::SwitchFormat must agree with
+// transforming every tower on its own; with more threads than towers every
+// tower is split into blocks
+TEST(UTNTT, dcrtpoly_batched_switch_format) {
+  int threads = omp_get_max_threads();
+  omp_set_num_threads(16);
+
+  usint m = 1 << 17;
+  usint towers = 3;
+
+  vector<NativeInteger> moduli(towers), roots(towers);
+  moduli[0] = FirstPrime<NativeInteger>(55, m);
+  roots[0] = RootOfUnity(m, moduli[0]);
+  for (usint i = 1; i < towers; i++) {
+    moduli[i] = NextPrime(moduli[i - 1], m);
+    roots[i] = RootOfUnity(m, moduli[i]);
+  }
+  shared_ptr<ILDCRTParams<BigInteger>> params(
+      new ILDCRTParams<BigInteger>(m, moduli, roots));
+
+  DCRTPoly::DugType dug;
+  DCRTPoly x(dug, params, Format::COEFFICIENT);
+  DCRTPoly y(dug, params, Format::EVALUATION);
+  DCRTPoly xClone(x), yClone(y);
+
+  std::vector<DCRTPoly *> polys = {&x, &y};
+  DCRTPoly::SwitchFormat(polys);
+  EXPECT_EQ(Format::EVALUATION, x.GetFormat());
+  EXPECT_EQ(Format::COEFFICIENT, y.GetFormat());
+
+  for (usint i = 0; i < towers; i++) {
+    NativePoly xTower = xClone.GetElementAtIndex(i);
+    NativePoly yTower = yClone.GetElementAtIndex(i);
+    xTower.SwitchFormat();
+    yTower.SwitchFormat();
+    EXPECT_EQ(xTower, x.GetElementAtIndex(i)) << "forward, tower " << i;
+    EXPECT_EQ(yTower, y.GetElementAtIndex(i)) << "inverse, tower " << i;
+  }
+
+  x.SwitchFormat();
+  y.SwitchFormat();
+  EXPECT_EQ(xClone, x);
+  EXPECT_EQ(yClone, y);
+
+  omp_set_num_threads(threads);
+}
@@ -174,6 +174,16 @@ void set_get_values(const string& msg) {
     bbv2 = bbv;
     ilvector2n2.SetValues(bbv2, Format::COEFFICIENT);
     EXPECT_EQ(ilvector2n, ilvector2n2) << msg << " Failure: SetValues EQ";
+
+    // both overloads reject parameters without a root of unity
+    shared_ptr<ParmType> noRootParams(
+        new ParmType(m, primeModulus, typename VecType::Integer(0)));
+    Element noRoot(noRootParams);
+    EXPECT_THROW(noRoot.SetValues(bbv, Format::COEFFICIENT), type_error)
+        << msg << " Failure: SetValues with a 0 root of unity";
+    EXPECT_THROW(noRoot.SetValues(std::move(bbv2), Format::COEFFICIENT),
+                 type_error)
+        << msg << " Failure: moving SetValues with a 0 root of unity";
   }
   {  // test GetValue() and at()
     Element ilvector2n(ilparams);
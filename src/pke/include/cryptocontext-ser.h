@@ -76,6 +76,7 @@ void Serial::Deserialize(std::shared_ptr<CryptoContextImpl<T>>& obj,
   obj = CryptoContextFactory<T>::GetContext(newob->GetCryptoParameters(),
                                             newob->GetEncryptionAlgorithm(),
                                             newob->getSchemeId());
+  obj->SetLazyRelinearization(newob->GetLazyRelinearization());
 }
 
 template void Serial::Deserialize(std::shared_ptr<CryptoContextImpl<Poly>>& obj,
@@ -179,6 +180,7 @@ void Serial::Deserialize(std::shared_ptr<CryptoContextImpl<T>>& obj,
   obj = CryptoContextFactory<T>::GetContext(newob->GetCryptoParameters(),
                                             newob->GetEncryptionAlgorithm(),
                                             newob->getSchemeId());
+  obj->SetLazyRelinearization(newob->GetLazyRelinearization());
 }
 
 template void Serial::Deserialize(std::shared_ptr<CryptoContextImpl<Poly>>& obj,
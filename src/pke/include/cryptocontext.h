@@ -89,6 +89,45 @@ class CryptoContextImpl : public Serializable {
 
   size_t m_keyGenLevel;
 
+  bool m_lazyRelin;
+
+  /**
+   * NormalizeLazy brings a ciphertext left unrelinearized by the lazy
+   * relinearization mode back to two elements, before an operation that
+   * key-switches it. With rescale set, the ciphertext is also rescaled to
+   * depth 1, as needed before a multiplication.
+   * @param ciphertext
+   * @param rescale
+   */
+  ConstCiphertext<Element> NormalizeLazy(ConstCiphertext<Element> ciphertext,
+                                         bool rescale = false) const {
+    if (!m_lazyRelin || ciphertext == NULL) return ciphertext;
+
+    std::shared_ptr<const CiphertextImpl<Element>> result = ciphertext;
+    if (result->GetElements().size() > 2)
+      result = GetEncryptionAlgorithm()->Relinearize(
+          result, GetEvalMultKeyVector(result->GetKeyTag()));
+    if (rescale) {
+      while (result->GetDepth() > 1)
+        result = GetEncryptionAlgorithm()->ModReduceInternal(result);
+    }
+    return result;
+  }
+
+  /**
+   * NormalizeLazy for every ciphertext of a list, in place
+   * @param ciphertexts
+   * @param rescale
+   */
+  void NormalizeLazy(vector<Ciphertext<Element>>& ciphertexts,
+                     bool rescale = false) const {
+    if (!m_lazyRelin) return;
+
+    for (auto& ct : ciphertexts)
+      ct = std::const_pointer_cast<CiphertextImpl<Element>>(
+          NormalizeLazy(ct, rescale));
+  }
+
   /**
    * TypeCheck makes sure that an operation between two ciphertexts is permitted
    * @param a
@@ -311,6 +350,7 @@ class CryptoContextImpl : public Serializable {
     this->timeSamples = 0;
     this->m_keyGenLevel = 0;
     this->m_schemeId = schemeId;
+    this->m_lazyRelin = false;
   }
 
   /**
@@ -327,6 +367,7 @@ class CryptoContextImpl : public Serializable {
     this->timeSamples = 0;
     this->m_keyGenLevel = 0;
     this->m_schemeId = schemeId;
+    this->m_lazyRelin = false;
   }
 
   /**
@@ -340,6 +381,7 @@ class CryptoContextImpl : public Serializable {
     timeSamples = c.timeSamples;
     this->m_keyGenLevel = 0;
     this->m_schemeId = c.m_schemeId;
+    this->m_lazyRelin = c.m_lazyRelin;
   }
 
   /**
@@ -354,6 +396,7 @@ class CryptoContextImpl : public Serializable {
     timeSamples = rhs.timeSamples;
     m_keyGenLevel = rhs.m_keyGenLevel;
     m_schemeId = rhs.m_schemeId;
+    m_lazyRelin = rhs.m_lazyRelin;
     return *this;
   }
 
@@ -805,6 +848,31 @@ class CryptoContextImpl : public Serializable {
 
   void SetKeyGenLevel(size_t level) { m_keyGenLevel = level; }
 
+  /**
+   * Enables or disables lazy relinearization (CKKS only). In this mode,
+   * EvalMult of two ciphertexts neither relinearizes nor rescales its
+   * result, so a sum of products costs a single key switch and a single
+   * rescale. A ciphertext is relinearized only when an operation needs it:
+   * before a rotation, an automorphism, an inner product, a linear weighted
+   * sum or a polynomial evaluation; before a multiplication, it is also
+   * rescaled to depth 1. Decryption accepts unrelinearized ciphertexts
+   * directly. The mode is saved with the context.
+   * @param enable
+   */
+  void SetLazyRelinearization(bool enable) {
+    if (enable && std::dynamic_pointer_cast<LPCryptoParametersCKKS<DCRTPoly>>(
+                      params) == nullptr)
+      PALISADE_THROW(config_error,
+                     "Lazy relinearization is supported only for CKKS");
+    m_lazyRelin = enable;
+  }
+
+  /**
+   * Getter for the lazy relinearization mode
+   * @return true if lazy relinearization is enabled
+   */
+  bool GetLazyRelinearization() const { return m_lazyRelin; }
+
   /**
    * Getter for element params
    * @return
@@ -1867,8 +1935,8 @@ class CryptoContextImpl : public Serializable {
     TimeVar t;
     if (doTiming) TIC(t);
 
-    Ciphertext<Element> newCiphertext =
-        GetEncryptionAlgorithm()->ReEncrypt(evalKey, ciphertext, publicKey);
+    Ciphertext<Element> newCiphertext = GetEncryptionAlgorithm()->ReEncrypt(
+        evalKey, NormalizeLazy(ciphertext), publicKey);
 
     if (doTiming) {
       timeSamples->push_back(TimingInfo(OpReEncrypt, TOC_US(t)));
@@ -2154,6 +2222,8 @@ class CryptoContextImpl : public Serializable {
    */
   Ciphertext<Element> EvalLinearWSum(vector<Ciphertext<Element>> ciphertexts,
                                      vector<double> constants) const {
+    NormalizeLazy(ciphertexts);
+
     TimeVar t;
     if (doTiming) TIC(t);
     auto rv = GetEncryptionAlgorithm()->EvalLinearWSum(ciphertexts, constants);
@@ -2174,6 +2244,8 @@ class CryptoContextImpl : public Serializable {
    */
   Ciphertext<Element> EvalLinearWSumMutable(
       vector<Ciphertext<Element>> ciphertexts, vector<double> constants) const {
+    NormalizeLazy(ciphertexts);
+
     TimeVar t;
     if (doTiming) TIC(t);
     auto rv =
@@ -2194,6 +2266,65 @@ class CryptoContextImpl : public Serializable {
     return EvalLinearWSumMutable(ciphertexts, constants);
   }
 
+  /**
+   * EvalPoly - PALISADE EvalPoly method to evaluate a polynomial on a
+   * ciphertext using the Paterson-Stockmeyer algorithm (CKKS only)
+   *
+   * @param ciphertext input ciphertext
+   * @param coefficients the polynomial coefficients, from the constant term
+   * up to the leading term
+   * @return new ciphertext containing the polynomial evaluation
+   */
+  Ciphertext<Element> EvalPoly(ConstCiphertext<Element> ciphertext,
+                               const std::vector<double>& coefficients) const {
+    if (ciphertext == NULL || Mismatched(ciphertext->GetCryptoContext()))
+      PALISADE_THROW(config_error,
+                     "Information passed to EvalPoly was not generated with "
+                     "this crypto context");
+
+    const auto& ek = GetEvalMultKeyVector(ciphertext->GetKeyTag());
+
+    TimeVar t;
+    if (doTiming) TIC(t);
+    auto rv = GetEncryptionAlgorithm()->EvalPoly(NormalizeLazy(ciphertext),
+                                                 coefficients, ek);
+    if (doTiming) {
+      timeSamples->push_back(TimingInfo(OpEvalPoly, TOC_US(t)));
+    }
+    return rv;
+  }
+
+  /**
+   * EvalChebyshevSeries - PALISADE EvalChebyshevSeries method to evaluate
+   * coefficients[0]/2 + sum_{i>0} coefficients[i] T_i(y) on a ciphertext,
+   * where y maps the interval [a, b] to [-1, 1] (CKKS only)
+   *
+   * @param ciphertext input ciphertext
+   * @param coefficients the Chebyshev series coefficients
+   * @param a the lower bound of the approximation interval
+   * @param b the upper bound of the approximation interval
+   * @return new ciphertext containing the series evaluation
+   */
+  Ciphertext<Element> EvalChebyshevSeries(
+      ConstCiphertext<Element> ciphertext,
+      const std::vector<double>& coefficients, double a, double b) const {
+    if (ciphertext == NULL || Mismatched(ciphertext->GetCryptoContext()))
+      PALISADE_THROW(config_error,
+                     "Information passed to EvalChebyshevSeries was not "
+                     "generated with this crypto context");
+
+    const auto& ek = GetEvalMultKeyVector(ciphertext->GetKeyTag());
+
+    TimeVar t;
+    if (doTiming) TIC(t);
+    auto rv = GetEncryptionAlgorithm()->EvalChebyshevSeries(
+        NormalizeLazy(ciphertext), coefficients, a, b, ek);
+    if (doTiming) {
+      timeSamples->push_back(TimingInfo(OpEvalChebyshevSeries, TOC_US(t)));
+    }
+    return rv;
+  }
+
   inline Ciphertext<Element> EvalAdd(
       ConstPlaintext plaintext, ConstCiphertext<Element> ciphertext) const {
     return EvalAdd(ciphertext, plaintext);
@@ -2308,6 +2439,8 @@ class CryptoContextImpl : public Serializable {
                                ConstCiphertext<Element> ct2) const {
     TypeCheck(ct1, ct2);
 
+    if (m_lazyRelin) return EvalMultLazy(ct1, ct2);
+
     auto ek = GetEvalMultKeyVector(ct1->GetKeyTag());
 
     TimeVar t;
@@ -2332,6 +2465,8 @@ class CryptoContextImpl : public Serializable {
                                       Ciphertext<Element>& ct2) const {
     TypeCheck(ct1, ct2);
 
+    if (m_lazyRelin) return EvalMultLazy(ct1, ct2);
+
     auto ek = GetEvalMultKeyVector(ct1->GetKeyTag());
 
     TimeVar t;
@@ -2343,6 +2478,27 @@ class CryptoContextImpl : public Serializable {
     return rv;
   }
 
+  /**
+   * EvalMult in lazy relinearization mode: the inputs are relinearized and
+   * rescaled if needed, and the product is left unrelinearized
+   * @param ct1
+   * @param ct2
+   * @return new ciphertext for ct1 * ct2
+   */
+  Ciphertext<Element> EvalMultLazy(ConstCiphertext<Element> ct1,
+                                   ConstCiphertext<Element> ct2) const {
+    auto c1 = NormalizeLazy(ct1, true);
+    auto c2 = NormalizeLazy(ct2, true);
+
+    TimeVar t;
+    if (doTiming) TIC(t);
+    auto rv = GetEncryptionAlgorithm()->EvalMult(c1, c2);
+    if (doTiming) {
+      timeSamples->push_back(TimingInfo(OpEvalMult, TOC_US(t)));
+    }
+    return rv;
+  }
+
   /**
    * EvalMult - PALISADE EvalMult method for a pair of ciphertexts - no key
    * switching (relinearization)
@@ -2354,6 +2510,8 @@ class CryptoContextImpl : public Serializable {
                                       ConstCiphertext<Element> ct2) const {
     TypeCheck(ct1, ct2);
 
+    if (m_lazyRelin) return EvalMultLazy(ct1, ct2);
+
     TimeVar t;
     if (doTiming) TIC(t);
     auto rv = GetEncryptionAlgorithm()->EvalMult(ct1, ct2);
@@ -2363,11 +2521,53 @@ class CryptoContextImpl : public Serializable {
     return rv;
   }
 
+  /**
+   * EvalSquare - PALISADE EvalSquare method for a ciphertext - with key
+   * switching. The result is the same as EvalMult(ct, ct), but the schemes
+   * that support it prepare the ciphertext for the tensor product only once.
+   * @param ct
+   * @return new ciphertext for ct * ct
+   */
+  Ciphertext<Element> EvalSquare(ConstCiphertext<Element> ct) const {
+    TypeCheck(ct, ct);
+
+    if (m_lazyRelin) return EvalSquareNoRelin(NormalizeLazy(ct, true));
+
+    auto ek = GetEvalMultKeyVector(ct->GetKeyTag());
+
+    TimeVar t;
+    if (doTiming) TIC(t);
+    auto rv = GetEncryptionAlgorithm()->EvalSquare(ct, ek[0]);
+    if (doTiming) {
+      timeSamples->push_back(TimingInfo(OpEvalMult, TOC_US(t)));
+    }
+    return rv;
+  }
+
+  /**
+   * EvalSquareNoRelin - PALISADE EvalSquare method for a ciphertext - no key
+   * switching (relinearization)
+   * @param ct
+   * @return new ciphertext for ct * ct
+   */
+  Ciphertext<Element> EvalSquareNoRelin(ConstCiphertext<Element> ct) const {
+    TypeCheck(ct, ct);
+
+    TimeVar t;
+    if (doTiming) TIC(t);
+    auto rv = GetEncryptionAlgorithm()->EvalSquare(ct);
+    if (doTiming) {
+      timeSamples->push_back(TimingInfo(OpEvalMult, TOC_US(t)));
+    }
+    return rv;
+  }
+
   /**
    * EvalMultMany - PALISADE function for evaluating multiplication on
    * ciphertext followed by relinearization operation (at the end). It computes
-   * the multiplication in a binary tree manner. Also, it reduces the number of
-   * elements in the ciphertext to two after each multiplication.
+   * the multiplication in a binary tree manner; the products of a level of the
+   * tree are computed in parallel. Also, it reduces the number of elements in
+   * the ciphertext to two after each multiplication.
    * Currently it assumes that the consecutive two input arguments have
    * total depth smaller than the supported depth. Otherwise, it throws an
    * error.
@@ -2380,9 +2580,12 @@ class CryptoContextImpl : public Serializable {
       const vector<Ciphertext<Element>>& ct) const {
     const auto ek = GetEvalMultKeyVector(ct[0]->GetKeyTag());
 
+    vector<Ciphertext<Element>> ciphertexts(ct);
+    NormalizeLazy(ciphertexts, true);
+
     TimeVar t;
     if (doTiming) TIC(t);
-    auto rv = GetEncryptionAlgorithm()->EvalMultMany(ct, ek);
+    auto rv = GetEncryptionAlgorithm()->EvalMultMany(ciphertexts, ek);
     if (doTiming) {
       timeSamples->push_back(TimingInfo(OpEvalMultMany, TOC_US(t)));
     }
@@ -2391,7 +2594,10 @@ class CryptoContextImpl : public Serializable {
 
   /**
    * EvalAddMany - Evaluate addition on a vector of ciphertexts.
-   * It computes the addition in a binary tree manner.
+   * Each thread accumulates a contiguous chunk of the vector, and the partial
+   * sums are added in a binary tree manner.
+   * As with EvalAdd, lazy products are added without relinearization, so a
+   * sum of lazy products still costs a single key switch.
    *
    * @param ctList is the list of ciphertexts.
    *
@@ -2410,7 +2616,7 @@ class CryptoContextImpl : public Serializable {
 
   /**
    * EvalAddManyInPlace - Evaluate addition on a vector of ciphertexts.
-   * Addition is computed in a binary tree manner. Difference with EvalAddMany
+   * Addition is computed as in EvalAddMany. Difference with EvalAddMany
    * is that EvalAddManyInPlace uses the input ciphertext vector to store
    * intermediate results, to avoid the overhead of using extra tepmorary
    * space.
@@ -2445,9 +2651,12 @@ class CryptoContextImpl : public Serializable {
       ConstCiphertext<Element> ct1, ConstCiphertext<Element> ct2) const {
     const auto ek = GetEvalMultKeyVector(ct1->GetKeyTag());
 
+    auto c1 = NormalizeLazy(ct1, true);
+    auto c2 = NormalizeLazy(ct2, true);
+
     TimeVar t;
     if (doTiming) TIC(t);
-    auto rv = GetEncryptionAlgorithm()->EvalMultAndRelinearize(ct1, ct2, ek);
+    auto rv = GetEncryptionAlgorithm()->EvalMultAndRelinearize(c1, c2, ek);
     if (doTiming) {
       timeSamples->push_back(TimingInfo(OpEvalMult, TOC_US(t)));
     }
@@ -2748,8 +2957,8 @@ class CryptoContextImpl : public Serializable {
 
     TimeVar t;
     if (doTiming) TIC(t);
-    auto rv =
-        GetEncryptionAlgorithm()->EvalAutomorphism(ciphertext, i, evalKeys);
+    auto rv = GetEncryptionAlgorithm()->EvalAutomorphism(
+        NormalizeLazy(ciphertext), i, evalKeys);
     if (doTiming) {
       timeSamples->push_back(TimingInfo(OpEvalAutomorphismI, TOC_US(t)));
     }
@@ -2783,17 +2992,43 @@ class CryptoContextImpl : public Serializable {
   }
 
   /**
-   * EvalSumKeyGen Generates the key map to be used by evalsum
+   * EvalSumKeyGen Generates the key map to be used by evalsum. EvalSum uses
+   * the strategy with the fewest stages that the generated keys support, so
+   * EVALSUM_RADIX4 and EVALSUM_RADIX8 trade key memory for latency.
    *
    * @param privateKey private key.
    * @param publicKey public key (used in NTRU schemes).
+   * @param strategy the EvalSum strategy the keys are generated for.
    */
   void EvalSumKeyGen(const LPPrivateKey<Element> privateKey,
-                     const LPPublicKey<Element> publicKey = nullptr);
+                     const LPPublicKey<Element> publicKey = nullptr,
+                     EvalSumStrategy strategy = EVALSUM_DOUBLING);
+
+  /**
+   * Returns the automorphism indices of the keys EvalSumKeyGen generates for
+   * a given strategy, so the key memory of the strategies can be compared.
+   *
+   * @param strategy the EvalSum strategy.
+   * @return the automorphism indices
+   */
+  std::vector<usint> EvalSumIndices(
+      EvalSumStrategy strategy = EVALSUM_DOUBLING) const;
 
   shared_ptr<std::map<usint, LPEvalKey<Element>>> EvalSumRowsKeyGen(
       const LPPrivateKey<Element> privateKey,
-      const LPPublicKey<Element> publicKey = nullptr, usint rowSize = 0);
+      const LPPublicKey<Element> publicKey = nullptr, usint rowSize = 0,
+      EvalSumStrategy strategy = EVALSUM_DOUBLING);
+
+  /**
+   * Returns the automorphism indices of the keys EvalSumRowsKeyGen generates
+   * for a given strategy (CKKS only).
+   *
+   * @param rowSize size of rows in the matrix
+   * @param strategy the EvalSum strategy.
+   * @return the automorphism indices
+   */
+  std::vector<usint> EvalSumRowsIndices(
+      usint rowSize, EvalSumStrategy strategy = EVALSUM_DOUBLING) const;
 
   shared_ptr<std::map<usint, LPEvalKey<Element>>> EvalSumColsKeyGen(
       const LPPrivateKey<Element> privateKey,
@@ -2812,7 +3047,9 @@ class CryptoContextImpl : public Serializable {
   GetAllEvalSumKeys();
 
   /**
-   * Function for evaluating a sum of all components
+   * Function for evaluating a sum of all components. The rotations are
+   * grouped into hoisted radix-4 or radix-8 stages when the keys generated
+   * by EvalSumKeyGen support it.
    *
    * @param ciphertext the input ciphertext.
    * @param batchSize size of the batch
@@ -2871,7 +3108,8 @@ class CryptoContextImpl : public Serializable {
       ConstCiphertext<Element> ct) const {
     TimeVar t;
     if (doTiming) TIC(t);
-    auto rv = GetEncryptionAlgorithm()->EvalFastRotationPrecompute(ct);
+    auto rv =
+        GetEncryptionAlgorithm()->EvalFastRotationPrecompute(NormalizeLazy(ct));
     if (doTiming) {
       timeSamples->push_back(TimingInfo(OpFastRotPrecomp, TOC_US(t)));
     }
@@ -2919,7 +3157,8 @@ class CryptoContextImpl : public Serializable {
       const shared_ptr<vector<Element>> digits) const {
     TimeVar t;
     if (doTiming) TIC(t);
-    auto rv = GetEncryptionAlgorithm()->EvalFastRotation(ct, index, m, digits);
+    auto rv = GetEncryptionAlgorithm()->EvalFastRotation(NormalizeLazy(ct),
+                                                         index, m, digits);
     if (doTiming) {
       timeSamples->push_back(TimingInfo(OpFastRot, TOC_US(t)));
     }
@@ -2961,6 +3200,79 @@ class CryptoContextImpl : public Serializable {
   Ciphertext<Element> EvalAtIndex(ConstCiphertext<Element> ciphertext,
                                   int32_t index) const;
 
+  /**
+   * Rotates a ciphertext by each index of a list. For schemes with hoisted
+   * automorphisms (CKKS and BFVrns over DCRTPoly), the digit decomposition
+   * of the ciphertext is computed once and shared by all indices, and the
+   * rotations are evaluated in parallel.
+   *
+   * @param ciphertext the input ciphertext.
+   * @param indexList the list of indices.
+   * @return the rotated ciphertexts, in the order of indexList
+   */
+  vector<Ciphertext<Element>> EvalAtIndexBatch(
+      ConstCiphertext<Element> ciphertext,
+      const std::vector<int32_t>& indexList) const;
+
+  /**
+   * Computes the sum of the rotations of a ciphertext by each index of a
+   * list. For CKKS with GHS or HYBRID key switching, the rotations are
+   * accumulated in the extended basis and scaled down once.
+   *
+   * @param ciphertext the input ciphertext.
+   * @param indexList the list of indices; must not be empty.
+   * @return the sum of the rotated ciphertexts
+   */
+  Ciphertext<Element> EvalAtIndexBatchSum(
+      ConstCiphertext<Element> ciphertext,
+      const std::vector<int32_t>& indexList) const;
+
+  /**
+   * Encodes the diagonals of a square matrix for EvalLinearTransform (CKKS
+   * only). The k-th diagonal holds M[i][(i+k) mod d]; it is pre-rotated for
+   * the baby-step giant-step schedule, replicated to fill all slots and
+   * stored in EVALUATION format at the requested depth and level, so no
+   * encoding or NTT is done at evaluation time. All-zero diagonals are
+   * returned as nullptr and skipped by the evaluation.
+   *
+   * @param matrix the d x d matrix; d must divide the number of slots.
+   * @param bStep the baby step; 0 selects ceil(sqrt(d)).
+   * @param depth the depth of the ciphertexts the transform is applied to.
+   * @param level the level of the ciphertexts the transform is applied to.
+   * @return the d encoded diagonals
+   */
+  std::vector<Plaintext> EvalLinearTransformPrecompute(
+      const std::vector<std::vector<std::complex<double>>>& matrix,
+      uint32_t bStep = 0, size_t depth = 1, uint32_t level = 0) const;
+
+  /**
+   * Returns the rotation indices needed by EvalLinearTransform for the given
+   * encoded diagonals: the baby steps and giant steps that touch at least
+   * one nonzero diagonal. The result can be passed to EvalAtIndexKeyGen.
+   *
+   * @param diagonals the output of EvalLinearTransformPrecompute.
+   * @param bStep the baby step used for the precomputation.
+   * @return the rotation indices
+   */
+  std::vector<int32_t> EvalLinearTransformIndices(
+      const std::vector<Plaintext>& diagonals, uint32_t bStep = 0) const;
+
+  /**
+   * Computes the product of a matrix and an encrypted vector using the
+   * baby-step giant-step algorithm: the baby-step rotations are hoisted
+   * through EvalAtIndexBatch and each giant step costs one rotation. The
+   * input slots must hold the vector replicated with period d, and the
+   * result is replicated in the same way.
+   *
+   * @param diagonals the output of EvalLinearTransformPrecompute.
+   * @param ciphertext the input ciphertext.
+   * @param bStep the baby step used for the precomputation.
+   * @return the transformed ciphertext
+   */
+  Ciphertext<Element> EvalLinearTransform(
+      const std::vector<Plaintext>& diagonals,
+      ConstCiphertext<Element> ciphertext, uint32_t bStep = 0) const;
+
   /**
    * Evaluates inner product in batched encoding
    *
@@ -3060,7 +3372,8 @@ class CryptoContextImpl : public Serializable {
 
     TimeVar t;
     if (doTiming) TIC(t);
-    auto rv = GetEncryptionAlgorithm()->KeySwitch(keySwitchHint, ciphertext);
+    auto rv = GetEncryptionAlgorithm()->KeySwitch(keySwitchHint,
+                                                  NormalizeLazy(ciphertext));
     if (doTiming) {
       timeSamples->push_back(TimingInfo(OpKeySwitch, TOC_US(t)));
     }
@@ -3230,6 +3543,7 @@ class CryptoContextImpl : public Serializable {
     ar(cereal::make_nvp("cc", params));
     ar(cereal::make_nvp("kt", scheme));
     ar(cereal::make_nvp("si", m_schemeId));
+    ar(cereal::make_nvp("lr", m_lazyRelin));
   }
 
   template <class Archive>
@@ -3242,6 +3556,8 @@ class CryptoContextImpl : public Serializable {
     ar(cereal::make_nvp("cc", params));
     ar(cereal::make_nvp("kt", scheme));
     ar(cereal::make_nvp("si", m_schemeId));
+    // contexts saved before version 2 have no lazy relinearization flag
+    if (version > 1) ar(cereal::make_nvp("lr", m_lazyRelin));
 
     // NOTE: a pointer to this object will be wrapped in a shared_ptr, and is a
     // "CryptoContext". PALISADE relies on the notion that identical
@@ -3252,7 +3568,7 @@ class CryptoContextImpl : public Serializable {
   }
 
   virtual std::string SerializedObjectName() const { return "CryptoContext"; }
-  static uint32_t SerializedVersion() { return 1; }
+  static uint32_t SerializedVersion() { return 2; }
 };
 
 /**
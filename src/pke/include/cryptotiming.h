@@ -114,7 +114,10 @@ enum OpType {
   OpEvalPoly,
   OpEvalChebyshevSeries,
   OpFastRot,
-  OpFastRotPrecomp
+  OpFastRotPrecomp,
+  OpEvalAtIndexBatch,
+  OpEvalBatchSum,
+  OpEvalLinearTransform
 };
 
 extern std::map<OpType, string> OperatorName;
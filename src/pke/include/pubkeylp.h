@@ -30,12 +30,15 @@
 // Includes Section
 #include <vector>
 #include <iomanip>
+#include <algorithm>
+#include <set>
 #include "lattice/elemparams.h"
 #include "lattice/ilparams.h"
 #include "lattice/ildcrtparams.h"
 #include "lattice/ilelement.h"
 #include "utils/inttypes.h"
 #include "utils/hashutil.h"
+#include "utils/parallel.h"
 #include "math/distrgen.h"
 #include "encoding/encodingparams.h"
 
@@ -52,6 +55,18 @@ namespace lbcrypto {
  */
 enum KeySwitchTechnique { BV, GHS, HYBRID };
 
+/* This enum holds the strategies supported by EvalSum for power-of-two
+ * cyclotomics. EVALSUM_DOUBLING adds one rotation per stage and needs
+ * log2(batchSize) keys. EVALSUM_RADIX4 and EVALSUM_RADIX8 add 3 or 7
+ * hoisted rotations per stage, which cuts the number of sequential stages
+ * by a factor of 2 or 3 at the cost of more automorphism keys.
+ */
+enum EvalSumStrategy {
+  EVALSUM_DOUBLING = 2,
+  EVALSUM_RADIX4 = 4,
+  EVALSUM_RADIX8 = 8
+};
+
 // forward declarations, used to resolve circular header dependencies
 template <typename Element>
 class CiphertextImpl;
@@ -1697,6 +1712,42 @@ class LPSHEAlgorithm {
     PALISADE_THROW(not_implemented_error, errMsg);
   }
 
+  /**
+   * Virtual function for evaluating a polynomial on a ciphertext.
+   *
+   * @param ciphertext input ciphertext.
+   * @param coefficients the polynomial coefficients, from the constant term
+   * up to the leading term.
+   * @param evalKeys the relinearization keys.
+   * @return the result of the polynomial evaluation.
+   */
+  virtual Ciphertext<Element> EvalPoly(
+      ConstCiphertext<Element> ciphertext,
+      const std::vector<double> &coefficients,
+      const vector<LPEvalKey<Element>> &evalKeys) const {
+    std::string errMsg = "EvalPoly is not implemented for this scheme.";
+    PALISADE_THROW(not_implemented_error, errMsg);
+  }
+
+  /**
+   * Virtual function for evaluating a Chebyshev series on a ciphertext.
+   *
+   * @param ciphertext input ciphertext.
+   * @param coefficients the Chebyshev series coefficients.
+   * @param a the lower bound of the approximation interval.
+   * @param b the upper bound of the approximation interval.
+   * @param evalKeys the relinearization keys.
+   * @return the result of the series evaluation.
+   */
+  virtual Ciphertext<Element> EvalChebyshevSeries(
+      ConstCiphertext<Element> ciphertext,
+      const std::vector<double> &coefficients, double a, double b,
+      const vector<LPEvalKey<Element>> &evalKeys) const {
+    std::string errMsg =
+        "EvalChebyshevSeries is not implemented for this scheme.";
+    PALISADE_THROW(not_implemented_error, errMsg);
+  }
+
   /**
    * Virtual function to define the interface for homomorphic subtraction of
    * ciphertexts.
@@ -1879,6 +1930,34 @@ class LPSHEAlgorithm {
                    "EvalMultMutable is not implemented for this scheme");
   }
 
+  /**
+   * Virtual function to define the interface for homomorphic squaring of a
+   * ciphertext. Schemes that can share work between the two operands of a
+   * multiplication override it; by default it is a multiplication of the
+   * ciphertext by itself.
+   *
+   * @param ciphertext the input ciphertext.
+   * @return the new ciphertext.
+   */
+  virtual Ciphertext<Element> EvalSquare(
+      ConstCiphertext<Element> ciphertext) const {
+    return EvalMult(ciphertext, ciphertext);
+  }
+
+  /**
+   * Virtual function to define the interface for homomorphic squaring of a
+   * ciphertext using the evaluation key.
+   *
+   * @param &ciphertext input ciphertext.
+   * @param &ek is the evaluation key to make the newCiphertext decryptable by
+   * the same secret key as that of ciphertext.
+   * @return the new ciphertext.
+   */
+  virtual Ciphertext<Element> EvalSquare(ConstCiphertext<Element> ciphertext,
+                                         const LPEvalKey<Element> ek) const {
+    return EvalMult(ciphertext, ciphertext, ek);
+  }
+
   /**
    * Virtual function for evaluating multiplication of a ciphertext list which
    * each multiplication is followed by relinearization operation.
@@ -1892,21 +1971,15 @@ class LPSHEAlgorithm {
       const vector<Ciphertext<Element>> &cipherTextList,
       const vector<LPEvalKey<Element>> &evalKeys) const {
     // default implementation if you don't have one in your scheme
+    if (cipherTextList.size() == 1)
+      return Ciphertext<Element>(
+          new CiphertextImpl<Element>(*(cipherTextList[0])));
 
-    const size_t inSize = cipherTextList.size();
-    const size_t lim = inSize * 2 - 2;
-    vector<Ciphertext<Element>> cipherTextResults;
-    cipherTextResults.resize(inSize - 1);
-    size_t ctrIndex = 0;
-
-    for (size_t i = 0; i < lim; i = i + 2) {
-      cipherTextResults[ctrIndex++] = this->EvalMult(
-          i < inSize ? cipherTextList[i] : cipherTextResults[i - inSize],
-          i + 1 < inSize ? cipherTextList[i + 1]
-                         : cipherTextResults[i + 1 - inSize]);
-    }
-
-    return cipherTextResults.back();
+    return EvalTreeReduce(
+        cipherTextList,
+        [this](ConstCiphertext<Element> ct1, ConstCiphertext<Element> ct2) {
+          return this->EvalMult(ct1, ct2);
+        });
   }
 
   /**
@@ -1918,20 +1991,14 @@ class LPSHEAlgorithm {
   virtual Ciphertext<Element> EvalAddMany(
       const vector<Ciphertext<Element>> &ctList) const {
     // default implementation if you don't have one in your scheme
+    vector<Ciphertext<Element>> partialSums(ctList);
+    Ciphertext<Element> sum = EvalAddChunks(partialSums);
 
-    const size_t inSize = ctList.size();
-    const size_t lim = inSize * 2 - 2;
-    vector<Ciphertext<Element>> cipherTextResults;
-    cipherTextResults.resize(inSize - 1);
-    size_t ctrIndex = 0;
-
-    for (size_t i = 0; i < lim; i = i + 2) {
-      cipherTextResults[ctrIndex++] = this->EvalAdd(
-          i < inSize ? ctList[i] : cipherTextResults[i - inSize],
-          i + 1 < inSize ? ctList[i + 1] : cipherTextResults[i + 1 - inSize]);
-    }
+    // with a single non-null entry, the sum is that entry
+    if (std::find(ctList.begin(), ctList.end(), sum) != ctList.end())
+      return Ciphertext<Element>(new CiphertextImpl<Element>(*sum));
 
-    return cipherTextResults.back();
+    return sum;
   }
 
   /**
@@ -1944,20 +2011,9 @@ class LPSHEAlgorithm {
   virtual Ciphertext<Element> EvalAddManyInPlace(
       vector<Ciphertext<Element>> &ctList) const {
     // default implementation if you don't have one in your scheme
-    for (size_t j = 1; j < ctList.size(); j = j * 2) {
-      for (size_t i = 0; i < ctList.size(); i = i + 2 * j) {
-        if ((i + j) < ctList.size()) {
-          if (ctList[i] != nullptr && ctList[i + j] != nullptr) {
-            ctList[i] = EvalAdd(ctList[i], ctList[i + j]);
-          } else if (ctList[i] == nullptr && ctList[i + j] != nullptr) {
-            ctList[i] = ctList[i + j];
-          }  // In all remaining cases (ctList[i+j]), ctList[i] needs to remain
-             // unchanged.
-        }
-      }
-    }
+    Ciphertext<Element> sum = EvalAddChunks(ctList);
 
-    Ciphertext<Element> result(new CiphertextImpl<Element>(*(ctList[0])));
+    Ciphertext<Element> result(new CiphertextImpl<Element>(*sum));
 
     return result;
   }
@@ -2297,6 +2353,65 @@ class LPSHEAlgorithm {
     return EvalAutomorphism(ciphertext, autoIndex, evalAtIndexKeys);
   }
 
+  /**
+   * Rotates a ciphertext by each index of a list. The default
+   * implementation evaluates the rotations in parallel; schemes that
+   * support hoisted automorphisms share the digit decomposition of the
+   * ciphertext across all indices.
+   *
+   * @param ciphertext the input ciphertext.
+   * @param indexList the list of indices.
+   * @param &evalAtIndexKeys - reference to the map of evaluation keys generated
+   * by EvalAtIndexKeyGen.
+   * @return the rotated ciphertexts, in the order of indexList
+   */
+  virtual vector<Ciphertext<Element>> EvalAtIndexBatch(
+      ConstCiphertext<Element> ciphertext,
+      const std::vector<int32_t> &indexList,
+      const std::map<usint, LPEvalKey<Element>> &evalAtIndexKeys) const {
+    vector<Ciphertext<Element>> result(indexList.size());
+
+    // a missing key throws inside the parallel loop
+    OMPExceptionHandler handler;
+#pragma omp parallel for
+    for (size_t i = 0; i < indexList.size(); i++) {
+      handler.Run([&] {
+        if (indexList[i] == 0)
+          result[i] = std::make_shared<CiphertextImpl<Element>>(*ciphertext);
+        else
+          result[i] = EvalAtIndex(ciphertext, indexList[i], evalAtIndexKeys);
+      });
+    }
+    handler.Rethrow();
+    return result;
+  }
+
+  /**
+   * Computes the sum of the rotations of a ciphertext by each index of a
+   * list. Schemes that support hoisted automorphisms accumulate the
+   * rotations before scaling down from the extended basis.
+   *
+   * @param ciphertext the input ciphertext.
+   * @param indexList the list of indices; must not be empty.
+   * @param &evalAtIndexKeys - reference to the map of evaluation keys generated
+   * by EvalAtIndexKeyGen.
+   * @return the sum of the rotated ciphertexts
+   */
+  virtual Ciphertext<Element> EvalAtIndexBatchSum(
+      ConstCiphertext<Element> ciphertext,
+      const std::vector<int32_t> &indexList,
+      const std::map<usint, LPEvalKey<Element>> &evalAtIndexKeys) const {
+    if (indexList.empty())
+      PALISADE_THROW(config_error, "EvalAtIndexBatchSum: empty index list");
+
+    auto rotated = EvalAtIndexBatch(ciphertext, indexList, evalAtIndexKeys);
+    Ciphertext<Element> result = rotated[0];
+    for (size_t i = 1; i < rotated.size(); i++) {
+      result = EvalAdd(result, rotated[i]);
+    }
+    return result;
+  }
+
   /**
    * Virtual function to generate automophism keys for a given private key; Uses
    * the private key for encryption
@@ -2314,12 +2429,43 @@ class LPSHEAlgorithm {
    * for packed encoding
    *
    * @param privateKey private key.
+   * @param publicKey public key.
+   * @param strategy the EvalSum strategy the keys are generated for.
    * @return returns the evaluation keys
    */
   virtual shared_ptr<std::map<usint, LPEvalKey<Element>>> EvalSumKeyGen(
       const LPPrivateKey<Element> privateKey,
-      const LPPublicKey<Element> publicKey) const {
-    const auto cryptoParams = privateKey->GetCryptoParameters();
+      const LPPublicKey<Element> publicKey,
+      EvalSumStrategy strategy = EVALSUM_DOUBLING) const {
+    auto ccInst = privateKey->GetCryptoContext();
+
+    // stores automorphism indices needed for EvalSum
+    std::vector<usint> indices =
+        EvalSumIndices(privateKey->GetCryptoParameters(),
+                       ccInst->getSchemeId() == "CKKS", strategy);
+
+    if (publicKey)
+      // NTRU-based scheme
+      return EvalAutomorphismKeyGen(publicKey, privateKey, indices);
+    else
+      // Regular RLWE scheme
+      return EvalAutomorphismKeyGen(privateKey, indices);
+  }
+
+  /**
+   * Returns the automorphism indices of the keys needed by EvalSum with a
+   * given strategy; works only for packed encoding. The radix strategies
+   * are only supported for power-of-two cyclotomics; EVALSUM_DOUBLING is
+   * used for arbitrary cyclotomics.
+   *
+   * @param cryptoParams the crypto parameters.
+   * @param ckksPacked true for CKKS packed encoding.
+   * @param strategy the EvalSum strategy.
+   * @return the automorphism indices
+   */
+  std::vector<usint> EvalSumIndices(
+      const shared_ptr<LPCryptoParameters<Element>> cryptoParams,
+      bool ckksPacked, EvalSumStrategy strategy = EVALSUM_DOUBLING) const {
     const auto encodingParams = cryptoParams->GetEncodingParams();
     const auto elementParams = cryptoParams->GetElementParams();
 
@@ -2331,11 +2477,10 @@ class LPSHEAlgorithm {
 
     if (!(m & (m - 1))) {  // Check if m is a power of 2
 
-      auto ccInst = privateKey->GetCryptoContext();
-      // CKKS Packing
-      //					if
-      //(string(typeid(*this).name()).find("CKKS")!=std::string::npos)
-      if (ccInst->getSchemeId() == "CKKS")
+      if (strategy != EVALSUM_DOUBLING)
+        indices = EvalSumStageIndices(EvalSumStages(batchSize, 1, strategy),
+                                      m, ckksPacked);
+      else if (ckksPacked)
         indices = GenerateIndices2nComplex(batchSize, m);
       else
         indices = GenerateIndices_2n(batchSize, m);
@@ -2349,12 +2494,7 @@ class LPSHEAlgorithm {
       }
     }
 
-    if (publicKey)
-      // NTRU-based scheme
-      return EvalAutomorphismKeyGen(publicKey, privateKey, indices);
-    else
-      // Regular RLWE scheme
-      return EvalAutomorphismKeyGen(privateKey, indices);
+    return indices;
   }
 
   /**
@@ -2364,12 +2504,13 @@ class LPSHEAlgorithm {
    * @param privateKey private key.
    * @param publicKey public key.
    * @param rowSize size of rows in the matrix
-   * @param colSize size of columns in the matrix
+   * @param strategy the EvalSum strategy the keys are generated for.
    * @return returns the evaluation keys
    */
   virtual shared_ptr<std::map<usint, LPEvalKey<Element>>> EvalSumRowsKeyGen(
       const LPPrivateKey<Element> privateKey,
-      const LPPublicKey<Element> publicKey, usint rowSize) const {
+      const LPPublicKey<Element> publicKey, usint rowSize,
+      EvalSumStrategy strategy = EVALSUM_DOUBLING) const {
     const auto cryptoParams = privateKey->GetCryptoParameters();
     const auto encodingParams = cryptoParams->GetEncodingParams();
     const auto elementParams = cryptoParams->GetElementParams();
@@ -2386,7 +2527,7 @@ class LPSHEAlgorithm {
       //					if
       //(string(typeid(*this).name()).find("CKKS")!=std::string::npos)
       if (ccInst->getSchemeId() == "CKKS")
-        indices = GenerateIndices2nComplexRows(rowSize, m);
+        indices = EvalSumRowsIndices(cryptoParams, rowSize, strategy);
       else
         PALISADE_THROW(config_error,
                        "Matrix summation of row-vectors is only supported for "
@@ -2407,6 +2548,28 @@ class LPSHEAlgorithm {
       return EvalAutomorphismKeyGen(privateKey, indices);
   }
 
+  /**
+   * Returns the automorphism indices of the keys needed by EvalSumRows with
+   * a given strategy; works only for CKKS packed encoding and power-of-two
+   * cyclotomics.
+   *
+   * @param cryptoParams the crypto parameters.
+   * @param rowSize size of rows in the matrix
+   * @param strategy the EvalSum strategy.
+   * @return the automorphism indices
+   */
+  std::vector<usint> EvalSumRowsIndices(
+      const shared_ptr<LPCryptoParameters<Element>> cryptoParams,
+      usint rowSize, EvalSumStrategy strategy = EVALSUM_DOUBLING) const {
+    usint m = cryptoParams->GetElementParams()->GetCyclotomicOrder();
+
+    if (strategy != EVALSUM_DOUBLING)
+      return EvalSumStageIndices(
+          EvalSumStages(m / (4 * rowSize), rowSize, strategy), m, true);
+
+    return GenerateIndices2nComplexRows(rowSize, m);
+  }
+
   /**
    * Virtual function to generate the automorphism keys for EvalSumCols; works
    * only for packed encoding
@@ -2458,7 +2621,8 @@ class LPSHEAlgorithm {
 
   /**
    * Sums all elements in log (batch size) time - works only with packed
-   * encoding
+   * encoding. For power-of-two cyclotomics, the strategy with the fewest
+   * stages whose keys are all present in evalKeys is used.
    *
    * @param ciphertext the input ciphertext.
    * @param batchSize size of the batch to be summed up
@@ -2486,7 +2650,14 @@ class LPSHEAlgorithm {
     else {
       if (!(m & (m - 1))) {  // Check if m is a power of 2
 
-        if (ciphertext->GetEncodingType() == CKKSPacked)
+        bool ckksPacked = ciphertext->GetEncodingType() == CKKSPacked;
+        EvalSumStrategy strategy =
+            SelectEvalSumStrategy(batchSize, 1, m, ckksPacked, evalKeys);
+
+        if (strategy != EVALSUM_DOUBLING)
+          newCiphertext = EvalSumStaged(
+              EvalSumStages(batchSize, 1, strategy), evalKeys, newCiphertext);
+        else if (ckksPacked)
           newCiphertext =
               EvalSum2nComplex(batchSize, m, evalKeys, newCiphertext);
         else
@@ -2515,7 +2686,8 @@ class LPSHEAlgorithm {
 
   /**
    * Sums all elements over row-vectors in a matrix - works only with packed
-   * encoding
+   * encoding. As in EvalSum, the strategy with the fewest stages whose keys
+   * are all present in evalKeys is used.
    *
    * @param ciphertext the input ciphertext.
    * @param rowSize size of rows in the matrix
@@ -2543,10 +2715,19 @@ class LPSHEAlgorithm {
     else {
       if (!(m & (m - 1))) {  // Check if m is a power of 2
 
-        if (ciphertext->GetEncodingType() == CKKSPacked)
-          newCiphertext =
-              EvalSum2nComplexRows(rowSize, m, evalKeys, newCiphertext);
-        else
+        if (ciphertext->GetEncodingType() == CKKSPacked) {
+          usint colSize = m / (4 * rowSize);
+          EvalSumStrategy strategy =
+              SelectEvalSumStrategy(colSize, rowSize, m, true, evalKeys);
+
+          if (strategy != EVALSUM_DOUBLING)
+            newCiphertext =
+                EvalSumStaged(EvalSumStages(colSize, rowSize, strategy),
+                              evalKeys, newCiphertext);
+          else
+            newCiphertext =
+                EvalSum2nComplexRows(rowSize, m, evalKeys, newCiphertext);
+        } else
           PALISADE_THROW(config_error,
                          "Matrix summation of row-vectors is only supported "
                          "for CKKS packed encoding.");
@@ -2848,6 +3029,95 @@ class LPSHEAlgorithm {
     PALISADE_THROW(not_implemented_error, errMsg);
   }
 
+ protected:
+  /**
+   * Reduces a list of ciphertexts with a binary operation in a binary tree.
+   * The tree is evaluated level by level: the operations of a level are
+   * independent, and run in parallel when there are several of them. The
+   * last levels, with a single operation, keep the parallelism of the
+   * operation itself.
+   *
+   * @param ctList the ciphertext list.
+   * @param op the binary operation.
+   * @return the reduced ciphertext.
+   */
+  template <typename BinaryOp>
+  Ciphertext<Element> EvalTreeReduce(const vector<Ciphertext<Element>> &ctList,
+                                     BinaryOp op) const {
+    if (ctList.empty())
+      PALISADE_THROW(config_error, "Cannot reduce an empty ciphertext list");
+
+    bool parallel = !omp_in_parallel() && omp_get_max_threads() > 1;
+
+    vector<Ciphertext<Element>> level(ctList);
+    while (level.size() > 1) {
+      size_t pairs = level.size() / 2;
+      vector<Ciphertext<Element>> next((level.size() + 1) / 2);
+
+      OMPExceptionHandler handler;
+#pragma omp parallel for schedule(dynamic) if (parallel && pairs > 1)
+      for (size_t i = 0; i < pairs; i++) {
+        handler.Run([&] { next[i] = op(level[2 * i], level[2 * i + 1]); });
+      }
+      handler.Rethrow();
+
+      if (level.size() % 2 == 1) next.back() = level.back();
+      level = std::move(next);
+    }
+
+    return level[0];
+  }
+
+  /**
+   * Adds up a list of ciphertexts in a single pass. The list is split into
+   * one contiguous chunk per thread; each thread accumulates its chunk, and
+   * the partial sums are stored in the first entry of the chunks, which
+   * makes the list the only buffer of the pass. The partial sums are then
+   * added in a binary tree. Null entries of the list are skipped.
+   *
+   * @param ctList the ciphertext list, overwritten with the partial sums.
+   * @return the sum of the ciphertexts.
+   */
+  Ciphertext<Element> EvalAddChunks(vector<Ciphertext<Element>> &ctList) const {
+    if (ctList.empty())
+      PALISADE_THROW(config_error, "Cannot add an empty ciphertext list");
+
+    size_t size = ctList.size();
+    bool parallel = !omp_in_parallel() && omp_get_max_threads() > 1;
+    size_t chunks =
+        parallel ? std::min<size_t>(size, omp_get_max_threads()) : 1;
+
+    OMPExceptionHandler handler;
+#pragma omp parallel for if (chunks > 1)
+    for (size_t c = 0; c < chunks; c++) {
+      size_t begin = c * size / chunks;
+      size_t end = (c + 1) * size / chunks;
+      handler.Run([&] {
+        Ciphertext<Element> sum = ctList[begin];
+        for (size_t i = begin + 1; i < end; i++) {
+          if (ctList[i] == nullptr) continue;
+          sum = (sum == nullptr) ? ctList[i] : EvalAdd(sum, ctList[i]);
+        }
+        ctList[begin] = sum;
+      });
+    }
+    handler.Rethrow();
+
+    vector<Ciphertext<Element>> partialSums;
+    for (size_t c = 0; c < chunks; c++) {
+      if (ctList[c * size / chunks] != nullptr)
+        partialSums.push_back(ctList[c * size / chunks]);
+    }
+    if (partialSums.empty())
+      PALISADE_THROW(config_error, "Cannot add a list of null ciphertexts");
+
+    return EvalTreeReduce(
+        partialSums,
+        [this](ConstCiphertext<Element> ct1, ConstCiphertext<Element> ct2) {
+          return this->EvalAdd(ct1, ct2);
+        });
+  }
+
  private:
   std::vector<usint> GenerateIndices_2n(usint batchSize, usint m) const {
     // stores automorphism indices needed for EvalSum
@@ -3019,6 +3289,99 @@ class LPSHEAlgorithm {
 
     return newCiphertext;
   }
+
+  /**
+   * Splits the sum of the rotations by 0, stride, ..., (count' - 1) * stride
+   * into radix stages, where count' is count rounded up to a power of two.
+   * Each stage lists the nonzero rotations whose sum with the identity is
+   * applied to the output of the previous stage; the last stage uses a
+   * smaller radix when log2(count') is not a multiple of log2(radix).
+   */
+  static std::vector<std::vector<int32_t>> EvalSumStages(
+      usint count, int32_t stride, EvalSumStrategy strategy) {
+    usint logRadix = 1;
+    if (strategy == EVALSUM_RADIX4)
+      logRadix = 2;
+    else if (strategy == EVALSUM_RADIX8)
+      logRadix = 3;
+
+    usint logCount = 0;
+    while ((1U << logCount) < count) logCount++;
+
+    std::vector<std::vector<int32_t>> stages;
+    for (usint done = 0; done < logCount; done += logRadix) {
+      usint radix = 1U << std::min(logRadix, logCount - done);
+      int32_t step = stride << done;
+
+      std::vector<int32_t> stage;
+      for (usint k = 1; k < radix; k++) stage.push_back(k * step);
+      stages.push_back(stage);
+    }
+
+    return stages;
+  }
+
+  /**
+   * Maps the rotations of all stages to automorphism indices, without
+   * duplicates.
+   */
+  std::vector<usint> EvalSumStageIndices(
+      const std::vector<std::vector<int32_t>> &stages, usint m,
+      bool ckksPacked) const {
+    std::set<usint> indices;
+    for (const auto &stage : stages) {
+      for (int32_t index : stage) {
+        if (ckksPacked)
+          indices.insert(FindAutomorphismIndex2nComplex(index, m));
+        else
+          indices.insert(FindAutomorphismIndex2n(index, m));
+      }
+    }
+    return std::vector<usint>(indices.begin(), indices.end());
+  }
+
+  /**
+   * Returns the radix strategy with the fewest stages whose keys are all in
+   * evalKeys, or EVALSUM_DOUBLING if there is none.
+   */
+  EvalSumStrategy SelectEvalSumStrategy(
+      usint count, int32_t stride, usint m, bool ckksPacked,
+      const std::map<usint, LPEvalKey<Element>> &evalKeys) const {
+    size_t doublingStages =
+        EvalSumStages(count, stride, EVALSUM_DOUBLING).size();
+
+    for (EvalSumStrategy strategy : {EVALSUM_RADIX8, EVALSUM_RADIX4}) {
+      auto stages = EvalSumStages(count, stride, strategy);
+      if (stages.size() >= doublingStages) continue;
+
+      auto indices = EvalSumStageIndices(stages, m, ckksPacked);
+      bool found = std::all_of(
+          indices.begin(), indices.end(),
+          [&evalKeys](usint i) { return evalKeys.find(i) != evalKeys.end(); });
+      if (found) return strategy;
+    }
+
+    return EVALSUM_DOUBLING;
+  }
+
+  /**
+   * Evaluates the stages computed by EvalSumStages. The rotations of each
+   * stage are hoisted through EvalAtIndexBatchSum, so a stage costs one
+   * digit decomposition however many rotations it holds.
+   */
+  Ciphertext<Element> EvalSumStaged(
+      const std::vector<std::vector<int32_t>> &stages,
+      const std::map<usint, LPEvalKey<Element>> &evalKeys,
+      ConstCiphertext<Element> ciphertext) const {
+    Ciphertext<Element> newCiphertext(new CiphertextImpl<Element>(*ciphertext));
+
+    for (const auto &stage : stages) {
+      newCiphertext = EvalAdd(
+          newCiphertext, EvalAtIndexBatchSum(newCiphertext, stage, evalKeys));
+    }
+
+    return newCiphertext;
+  }
 };
 
 /**
@@ -3518,6 +3881,32 @@ class LPPublicKeyEncryptionScheme {
     }
   }
 
+  virtual Ciphertext<Element> EvalPoly(
+      ConstCiphertext<Element> ciphertext,
+      const std::vector<double> &coefficients,
+      const vector<LPEvalKey<Element>> &evalKeys) const {
+    if (this->m_algorithmSHE) {
+      return this->m_algorithmSHE->EvalPoly(ciphertext, coefficients,
+                                            evalKeys);
+    } else {
+      PALISADE_THROW(config_error, "EvalPoly operation has not been enabled");
+    }
+  }
+
+  virtual Ciphertext<Element> EvalChebyshevSeries(
+      ConstCiphertext<Element> ciphertext,
+      const std::vector<double> &coefficients, double a, double b,
+      const vector<LPEvalKey<Element>> &evalKeys) const {
+    if (this->m_algorithmSHE) {
+      return this->m_algorithmSHE->EvalChebyshevSeries(ciphertext,
+                                                       coefficients, a, b,
+                                                       evalKeys);
+    } else {
+      PALISADE_THROW(config_error,
+                     "EvalChebyshevSeries operation has not been enabled");
+    }
+  }
+
   virtual Ciphertext<Element> EvalSub(
       ConstCiphertext<Element> ciphertext1,
       ConstCiphertext<Element> ciphertext2) const {
@@ -3654,6 +4043,25 @@ class LPPublicKeyEncryptionScheme {
     }
   }
 
+  virtual Ciphertext<Element> EvalSquare(
+      ConstCiphertext<Element> ciphertext) const {
+    if (this->m_algorithmSHE) {
+      return this->m_algorithmSHE->EvalSquare(ciphertext);
+    } else {
+      PALISADE_THROW(config_error, "EvalSquare operation has not been enabled");
+    }
+  }
+
+  virtual Ciphertext<Element> EvalSquare(
+      ConstCiphertext<Element> ciphertext,
+      const LPEvalKey<Element> evalKey) const {
+    if (this->m_algorithmSHE) {
+      return this->m_algorithmSHE->EvalSquare(ciphertext, evalKey);
+    } else {
+      PALISADE_THROW(config_error, "EvalSquare operation has not been enabled");
+    }
+  }
+
   virtual Ciphertext<Element> EvalMultMany(
       const vector<Ciphertext<Element>> &ciphertext,
       const vector<LPEvalKey<Element>> &evalKeys) const {
@@ -3745,6 +4153,30 @@ class LPPublicKeyEncryptionScheme {
                      "EvalAtIndex operation has not been enabled");
   }
 
+  virtual vector<Ciphertext<Element>> EvalAtIndexBatch(
+      ConstCiphertext<Element> ciphertext,
+      const std::vector<int32_t> &indexList,
+      const std::map<usint, LPEvalKey<Element>> &evalKeys) const {
+    if (this->m_algorithmSHE) {
+      return this->m_algorithmSHE->EvalAtIndexBatch(ciphertext, indexList,
+                                                    evalKeys);
+    } else
+      PALISADE_THROW(config_error,
+                     "EvalAtIndexBatch operation has not been enabled");
+  }
+
+  virtual Ciphertext<Element> EvalAtIndexBatchSum(
+      ConstCiphertext<Element> ciphertext,
+      const std::vector<int32_t> &indexList,
+      const std::map<usint, LPEvalKey<Element>> &evalKeys) const {
+    if (this->m_algorithmSHE) {
+      return this->m_algorithmSHE->EvalAtIndexBatchSum(ciphertext, indexList,
+                                                       evalKeys);
+    } else
+      PALISADE_THROW(config_error,
+                     "EvalAtIndexBatchSum operation has not been enabled");
+  }
+
   virtual shared_ptr<vector<Element>> EvalFastRotationPrecompute(
       ConstCiphertext<Element> ciphertext) const {
     if (this->m_algorithmSHE) {
@@ -3783,9 +4215,11 @@ class LPPublicKeyEncryptionScheme {
 
   virtual shared_ptr<std::map<usint, LPEvalKey<Element>>> EvalSumKeyGen(
       const LPPrivateKey<Element> privateKey,
-      const LPPublicKey<Element> publicKey) const {
+      const LPPublicKey<Element> publicKey,
+      EvalSumStrategy strategy = EVALSUM_DOUBLING) const {
     if (this->m_algorithmSHE) {
-      auto km = this->m_algorithmSHE->EvalSumKeyGen(privateKey, publicKey);
+      auto km = this->m_algorithmSHE->EvalSumKeyGen(privateKey, publicKey,
+                                                    strategy);
       for (auto &k : *km) {
         k.second->SetKeyTag(privateKey->GetKeyTag());
       }
@@ -3795,12 +4229,24 @@ class LPPublicKeyEncryptionScheme {
                      "EvalSumKeyGen operation has not been enabled");
   }
 
+  std::vector<usint> EvalSumIndices(
+      const shared_ptr<LPCryptoParameters<Element>> cryptoParams,
+      bool ckksPacked, EvalSumStrategy strategy = EVALSUM_DOUBLING) const {
+    if (this->m_algorithmSHE)
+      return this->m_algorithmSHE->EvalSumIndices(cryptoParams, ckksPacked,
+                                                  strategy);
+    else
+      PALISADE_THROW(config_error,
+                     "EvalSumIndices operation has not been enabled");
+  }
+
   virtual shared_ptr<std::map<usint, LPEvalKey<Element>>> EvalSumRowsKeyGen(
       const LPPrivateKey<Element> privateKey,
-      const LPPublicKey<Element> publicKey, usint rowSize) const {
+      const LPPublicKey<Element> publicKey, usint rowSize,
+      EvalSumStrategy strategy = EVALSUM_DOUBLING) const {
     if (this->m_algorithmSHE) {
       auto km = this->m_algorithmSHE->EvalSumRowsKeyGen(privateKey, publicKey,
-                                                        rowSize);
+                                                        rowSize, strategy);
       for (auto &k : *km) {
         k.second->SetKeyTag(privateKey->GetKeyTag());
       }
@@ -3810,6 +4256,17 @@ class LPPublicKeyEncryptionScheme {
                      "EvalSumRowsKeyGen operation has not been enabled");
   }
 
+  std::vector<usint> EvalSumRowsIndices(
+      const shared_ptr<LPCryptoParameters<Element>> cryptoParams,
+      usint rowSize, EvalSumStrategy strategy = EVALSUM_DOUBLING) const {
+    if (this->m_algorithmSHE)
+      return this->m_algorithmSHE->EvalSumRowsIndices(cryptoParams, rowSize,
+                                                      strategy);
+    else
+      PALISADE_THROW(config_error,
+                     "EvalSumRowsIndices operation has not been enabled");
+  }
+
   virtual shared_ptr<std::map<usint, LPEvalKey<Element>>> EvalSumColsKeyGen(
       const LPPrivateKey<Element> privateKey,
       const LPPublicKey<Element> publicKey) const {
@@ -616,9 +616,10 @@ class LPAlgorithmSHEBFV : public LPSHEAlgorithm<Element> {
   /**
    * Function for evaluating multiplication on ciphertext followed by
    * relinearization operation. It computes the multiplication in a binary tree
-   * manner. Also, it reduces the number of elements in the ciphertext to two
-   * after each multiplication. Currently it assumes that the consecutive two
-   * input arguments have total depth smaller than the supported depth.
+   * manner, with the products of a level computed in parallel. Also, it
+   * reduces the number of elements in the ciphertext to two after each
+   * multiplication. Currently it assumes that the consecutive two input
+   * arguments have total depth smaller than the supported depth.
    * Otherwise, it throws an error.
    *
    * @param cipherTextList  is the ciphertext list.
@@ -58,6 +58,8 @@
 #ifndef LBCRYPTO_CRYPTO_BFVRNS_H
 #define LBCRYPTO_CRYPTO_BFVRNS_H
 
+#include <mutex>
+
 #include "palisade.h"
 
 namespace lbcrypto {
@@ -365,6 +367,30 @@ class LPCryptoParametersBFVrns : public LPCryptoParametersRLWE<Element> {
     return m_CRTsModqiTable;
   }
 
+  /**
+   * Gets the precomputed table of floor(Q'*[Q'^{-1}]_qt/qt) mod qi, where qt
+   * is the last CRT modulus and Q'=Q/qt; used to drop the last tower of a
+   * ciphertext while scaling it down by qt
+   *
+   * @return the precomputed table
+   */
+  const std::vector<NativeInteger>& GetCRTRescaleTable() const {
+    return m_CRTRescaleTable;
+  }
+
+  /**
+   * Gets the parameters of a ciphertext in the leveled mode from which
+   * "level" towers have been dropped. The element parameters are the first
+   * towers of Q, the auxiliary basis S is the matching prefix of the full one,
+   * and all tables above are computed for these smaller bases. Level 0 is
+   * this object; the other levels are built on first use and then cached.
+   *
+   * @param level the number of dropped towers
+   * @return the parameters at this level
+   */
+  const LPCryptoParametersBFVrns<Element>& GetParamsAtLevel(
+      size_t level) const;
+
   /**
    * == operator to compare to this instance of LPCryptoParametersBFVrns object.
    *
@@ -407,6 +433,12 @@ class LPCryptoParametersBFVrns : public LPCryptoParametersRLWE<Element> {
   static uint32_t SerializedVersion() { return 1; }
 
  private:
+  /**
+   * Computes the tables for the current CRT basis Q and the auxiliary basis S
+   * @return true on success
+   */
+  bool PrecomputeBasisTables();
+
   // Auxiliary CRT basis S=s1*s2*..sn used in homomorphic multiplication
   shared_ptr<ILDCRTParams<BigInteger>> m_paramsS;
 
@@ -472,6 +504,15 @@ class LPCryptoParametersBFVrns : public LPCryptoParametersRLWE<Element> {
   // Stores a precomputed table of S mod qi table
   std::vector<NativeInteger> m_CRTsModqiTable;
 
+  // Stores a precomputed table of floor(Q'*[Q'^{-1}]_qt/qt) mod qi
+  std::vector<NativeInteger> m_CRTRescaleTable;
+
+  // Parameters of the leveled mode, indexed by the number of dropped towers;
+  // built on first use
+  mutable std::vector<shared_ptr<LPCryptoParametersBFVrns<Element>>>
+      m_paramsLevels;
+  mutable std::mutex m_paramsLevelsMutex;
+
   // Stores an NTL precomputation for the precomputed table of
   // floor[(p*[(Q/qi)^{-1}]_qi)/qi]_p
   std::vector<NativeInteger> m_CRTDecryptionIntPreconTable;
@@ -579,6 +620,18 @@ class LPAlgorithmSHEBFVrns : public LPAlgorithmSHEBFV<Element> {
    */
   LPAlgorithmSHEBFVrns() {}
 
+  /**
+   * Function for homomorphic addition of ciphertexts. In the leveled mode, the
+   * ciphertext with more towers is first scaled down to the towers of the
+   * other one.
+   *
+   * @param ct1 first input ciphertext.
+   * @param ct2 second input ciphertext.
+   * @return new ciphertext.
+   */
+  Ciphertext<Element> EvalAdd(ConstCiphertext<Element> ct1,
+                              ConstCiphertext<Element> ct2) const;
+
   /**
    * Function for homomorphic addition of ciphertext and plaintext.
    *
@@ -599,6 +652,18 @@ class LPAlgorithmSHEBFVrns : public LPAlgorithmSHEBFV<Element> {
   Ciphertext<Element> EvalSub(ConstCiphertext<Element> ct1,
                               ConstPlaintext pt) const;
 
+  /**
+   * Function for homomorphic subtraction of ciphertexts. In the leveled mode,
+   * the ciphertext with more towers is first scaled down to the towers of the
+   * other one.
+   *
+   * @param ct1 first input ciphertext.
+   * @param ct2 second input ciphertext.
+   * @return new ciphertext.
+   */
+  Ciphertext<Element> EvalSub(ConstCiphertext<Element> ct1,
+                              ConstCiphertext<Element> ct2) const;
+
   /**
    * Function for homomorphic evaluation of ciphertexts.
    * The multiplication is supported for a fixed level without keyswitching
@@ -612,6 +677,28 @@ class LPAlgorithmSHEBFVrns : public LPAlgorithmSHEBFV<Element> {
   Ciphertext<Element> EvalMult(ConstCiphertext<Element> ct1,
                                ConstCiphertext<Element> ct2) const;
 
+  /**
+   * Function for homomorphic squaring of a ciphertext without key switching.
+   * The result is the same as EvalMult(ct, ct), but the CRT basis of the
+   * input is expanded only once and the symmetric tensor product needs one
+   * product less.
+   *
+   * @param ct input ciphertext.
+   * @return resulting EvalSquare ciphertext.
+   */
+  Ciphertext<Element> EvalSquare(ConstCiphertext<Element> ct) const;
+
+  /**
+   * Function for multiplying a ciphertext by a plaintext. The plaintext is
+   * restricted to the towers of the ciphertext.
+   *
+   * @param ct input ciphertext.
+   * @param pt input plaintext.
+   * @return new ciphertext.
+   */
+  Ciphertext<Element> EvalMult(ConstCiphertext<Element> ct,
+                               ConstPlaintext pt) const;
+
   /**
    * Method for generating a KeySwitchHint using RLWE relinearization
    *
@@ -634,6 +721,23 @@ class LPAlgorithmSHEBFVrns : public LPAlgorithmSHEBFV<Element> {
   Ciphertext<Element> KeySwitch(const LPEvalKey<Element> keySwitchHint,
                                 ConstCiphertext<Element> cipherText) const;
 
+  /**
+   * Rotates a ciphertext by a list of indices using hoisted automorphisms:
+   * the second component of the ciphertext is decomposed into digits once,
+   * and the automorphism of each index is applied to the digits before key
+   * switching. The rotations are evaluated in parallel.
+   *
+   * @param ciphertext the input ciphertext.
+   * @param indexList the list of indices.
+   * @param &evalKeys - reference to the map of evaluation keys generated by
+   * EvalAtIndexKeyGen.
+   * @return the rotated ciphertexts, in the order of indexList
+   */
+  vector<Ciphertext<Element>> EvalAtIndexBatch(
+      ConstCiphertext<Element> ciphertext,
+      const std::vector<int32_t> &indexList,
+      const std::map<usint, LPEvalKey<Element>>& evalKeys) const;
+
   /**
    * Function for evaluating multiplication on ciphertext followed by
    * relinearization operation. Currently it assumes that the input arguments
@@ -651,6 +755,93 @@ class LPAlgorithmSHEBFVrns : public LPAlgorithmSHEBFV<Element> {
       const vector<LPEvalKey<Element>>& ek) const;
 };
 
+/**
+ * @brief Leveled SHE algorithms implementation for BFVrns. Enabling LEVELEDSHE
+ * turns on the leveled mode, in which the modulus of a ciphertext can be
+ * reduced after a multiplication once its noise allows it: ModReduce drops
+ * the last tower of Q and scales the ciphertext down by the dropped modulus,
+ * which keeps the plaintext and adds little noise. The following
+ * multiplications, key switches and rotations then run on fewer towers.
+ *
+ * The key-switching keys are generated at the full modulus and used at every
+ * level; this includes the re-encryption keys. Multiparty decryption restricts
+ * the secret key shares to the towers of the ciphertext.
+ *
+ * @tparam Element a ring element.
+ */
+template <class Element>
+class LPLeveledSHEAlgorithmBFVrns : public LPLeveledSHEAlgorithm<Element> {
+ public:
+  /**
+   * Default constructor
+   */
+  LPLeveledSHEAlgorithmBFVrns() {}
+
+  virtual ~LPLeveledSHEAlgorithmBFVrns() {}
+
+  /**
+   * Method for ModReducing CipherText. It calls ModReduceInternal.
+   *
+   * @param cipherText is the ciphertext to perform modreduce on.
+   * @return ciphertext after the modulus reduction performed.
+   */
+  virtual Ciphertext<Element> ModReduce(
+      ConstCiphertext<Element> cipherText) const;
+
+  /**
+   * Method for modulus switching: drops the last tower of the ciphertext and
+   * scales it down by the dropped modulus.
+   *
+   * @param cipherText is the ciphertext to perform modreduce on.
+   * @return ciphertext after the modulus reduction performed.
+   */
+  virtual Ciphertext<Element> ModReduceInternal(
+      ConstCiphertext<Element> cipherText) const;
+
+  /**
+   * Method for Composed EvalMult, which includes homomorphic multiplication,
+   * key switching, and modulo reduction.
+   *
+   * @param cipherText1 ciphertext1, first input ciphertext to perform
+   * multiplication on.
+   * @param cipherText2 cipherText2, second input ciphertext to perform
+   * multiplication on.
+   * @param quadKeySwitchHint is used for EvalMult operation.
+   * @return resulting ciphertext.
+   */
+  virtual Ciphertext<Element> ComposedEvalMult(
+      ConstCiphertext<Element> cipherText1,
+      ConstCiphertext<Element> cipherText2,
+      const LPEvalKey<Element> quadKeySwitchHint) const;
+
+  /**
+   * Method for level reduction in the BFVrns scheme. It calls
+   * LevelReduceInternal.
+   *
+   * @param cipherText1 is the original ciphertext to be level reduced.
+   * @param linearKeySwitchHint not used in the BFVrns scheme.
+   * @param levels the number of towers to drop.
+   * @return resulting ciphertext.
+   */
+  virtual Ciphertext<Element> LevelReduce(
+      ConstCiphertext<Element> cipherText1,
+      const LPEvalKey<Element> linearKeySwitchHint, size_t levels) const;
+
+  /**
+   * Method for level reduction in the BFVrns scheme. Unlike in CKKS, the
+   * towers cannot simply be dropped: the ciphertext is scaled down by every
+   * dropped modulus, as in "levels" calls to ModReduceInternal.
+   *
+   * @param cipherText1 is the original ciphertext to be level reduced.
+   * @param linearKeySwitchHint not used in the BFVrns scheme.
+   * @param levels the number of towers to drop.
+   * @return resulting ciphertext.
+   */
+  virtual Ciphertext<Element> LevelReduceInternal(
+      ConstCiphertext<Element> cipherText1,
+      const LPEvalKey<Element> linearKeySwitchHint, size_t levels) const;
+};
+
 /**
  * @brief PRE algorithms implementation for BFVrns.
  *
@@ -759,7 +950,32 @@ class LPAlgorithmMultipartyBFVrns : public LPAlgorithmMultipartyBFV<Element> {
   LPAlgorithmMultipartyBFVrns() {}
 
   /**
-   * Method for fusing the partially decrypted ciphertext.
+   * Method for main decryption operation run by most decryption clients for
+   * multiparty homomorphic encryption. In the leveled mode, only the towers
+   * of the secret key that are left in the ciphertext are used.
+   *
+   * @param privateKey private key used for decryption.
+   * @param ciphertext ciphertext id decrypted.
+   */
+  Ciphertext<Element> MultipartyDecryptMain(
+      const LPPrivateKey<Element> privateKey,
+      ConstCiphertext<Element> ciphertext) const;
+
+  /**
+   * Method for decryption operation run by the lead decryption client for
+   * multiparty homomorphic encryption. In the leveled mode, only the towers
+   * of the secret key that are left in the ciphertext are used.
+   *
+   * @param privateKey private key used for decryption.
+   * @param ciphertext ciphertext id decrypted.
+   */
+  Ciphertext<Element> MultipartyDecryptLead(
+      const LPPrivateKey<Element> privateKey,
+      ConstCiphertext<Element> ciphertext) const;
+
+  /**
+   * Method for fusing the partially decrypted ciphertext. All partial
+   * decryptions have to be at the same level.
    *
    * @param &ciphertextVec ciphertext id decrypted.
    * @param *plaintext the plaintext output.
@@ -630,6 +630,17 @@ class LPAlgorithmSHEBFVrnsB : public LPAlgorithmSHEBFV<Element> {
   Ciphertext<Element> EvalMult(ConstCiphertext<Element> ct1,
                                ConstCiphertext<Element> ct2) const;
 
+  /**
+   * Function for homomorphic squaring of a ciphertext without key switching.
+   * The result is the same as EvalMult(ct, ct), but the CRT basis of the
+   * input is expanded only once and the symmetric tensor product needs one
+   * product less.
+   *
+   * @param ct input ciphertext.
+   * @return resulting EvalSquare ciphertext.
+   */
+  Ciphertext<Element> EvalSquare(ConstCiphertext<Element> ct) const;
+
   /**
    * Method for generating a KeySwitchHint using RLWE relinearization
    *
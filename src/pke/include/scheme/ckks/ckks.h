@@ -241,6 +241,18 @@ class LPCryptoParametersCKKS : public LPCryptoParametersRLWE<Element> {
     return m_paramsQP;
   }
 
+  /**
+   * Used in GHS and HYBRID key switching, it returns the crypto parameters
+   * of the extended CRT basis {q_0, ..., q_l, p_0, ..., p_{K-1}} of a
+   * ciphertext with l+1 towers.
+   *
+   * @param l is the index of the last tower of the ciphertext.
+   * @return the parameters for basis Q_l union P.
+   */
+  const shared_ptr<ILDCRTParams<BigInteger>> &GetParamsQlP(uint32_t l) const {
+    return m_paramsQlP[l];
+  }
+
   /**
    * Used in GHS key switching, it returns the precomputed values
    * (P^-1 mod q_j). Result size is number of moduli in basis C.
@@ -452,6 +464,20 @@ class LPCryptoParametersCKKS : public LPCryptoParametersRLWE<Element> {
     return m_complementaryPartitions[numTowers][digit];
   }
 
+  /*
+   * Method that returns the element parameters corresponding to digit j of a
+   * ciphertext with l+1 towers. This is GetQPartition(j) for all digits but
+   * the last one, which only holds the towers q_{j*alpha}, ..., q_l.
+   *
+   * @param l is the index of the last tower of the ciphertext.
+   * @param digit is the index of the digit.
+   * @return the partition.
+   */
+  const shared_ptr<ILDCRTParams<BigInteger>> &GetQlPartition(
+      uint32_t l, uint32_t digit) const {
+    return m_partitionsModuliCl[l][digit];
+  }
+
   /*
    * Method that returns the number of partitions.
    *
@@ -579,6 +605,10 @@ class LPCryptoParametersCKKS : public LPCryptoParametersRLWE<Element> {
   vector<vector<shared_ptr<ILDCRTParams<BigInteger>>>>
       m_complementaryPartitions;
 
+  // Holds the partition of the moduli that correspond to digit j of a
+  // ciphertext with l+1 towers, used in HYBRID key switching
+  vector<vector<shared_ptr<ILDCRTParams<BigInteger>>>> m_partitionsModuliCl;
+
   // Holds the barret multiplication precomputation
   vector<vector<vector<DoubleNativeInt>>> m_modBarrettPreconComplPartition;
 
@@ -613,6 +643,9 @@ class LPCryptoParametersCKKS : public LPCryptoParametersRLWE<Element> {
   // Extended CRT basis QP=q1*q2*...*qL*p1*p2*..pk used in GHS key switching
   shared_ptr<ILDCRTParams<BigInteger>> m_paramsQP;
 
+  // Extended CRT bases Q_l P=q1*q2*...*ql*p1*p2*..pk for every level l
+  vector<shared_ptr<ILDCRTParams<BigInteger>>> m_paramsQlP;
+
   // Moduli product P (P=p1*p2*..pk) of the auxiliary CRT basis for GHS key
   // switching
   BigInteger m_modulusP;
@@ -938,6 +971,53 @@ class LPAlgorithmSHECKKS : public LPSHEAlgorithm<Element> {
     PALISADE_THROW(not_implemented_error, errMsg);
   }
 
+  /**
+   * Function for evaluating a polynomial on a ciphertext, using the
+   * Paterson-Stockmeyer algorithm. The input is split into blocks of
+   * k = O(sqrt(n)) coefficients; powers of the input are computed once in a
+   * cache with depth ceil(log2(e)) for x^e, the products of the blocks with
+   * the giant-step powers are summed before a single relinearization, and
+   * the result is rescaled once.
+   *
+   * @param ciphertext input ciphertext.
+   * @param coefficients the polynomial coefficients, from the constant term
+   * up to the leading term.
+   * @param evalKeys the relinearization keys.
+   * @return the result of the polynomial evaluation.
+   */
+  virtual Ciphertext<Element> EvalPoly(
+      ConstCiphertext<Element> ciphertext,
+      const std::vector<double> &coefficients,
+      const vector<LPEvalKey<Element>> &evalKeys) const {
+    std::string errMsg =
+        "LPAlgorithmSHECKKS::EvalPoly is only supported for DCRTPoly.";
+    PALISADE_THROW(not_implemented_error, errMsg);
+  }
+
+  /**
+   * Function for evaluating the Chebyshev series
+   * coefficients[0]/2 + sum_{i>0} coefficients[i] T_i(y), where
+   * y = (2x - (a + b)) / (b - a) maps [a, b] to [-1, 1]. It uses the same
+   * schedule as EvalPoly, after reducing the series modulo the giant-step
+   * Chebyshev polynomials.
+   *
+   * @param ciphertext input ciphertext.
+   * @param coefficients the Chebyshev series coefficients.
+   * @param a the lower bound of the approximation interval.
+   * @param b the upper bound of the approximation interval.
+   * @param evalKeys the relinearization keys.
+   * @return the result of the series evaluation.
+   */
+  virtual Ciphertext<Element> EvalChebyshevSeries(
+      ConstCiphertext<Element> ciphertext,
+      const std::vector<double> &coefficients, double a, double b,
+      const vector<LPEvalKey<Element>> &evalKeys) const {
+    std::string errMsg =
+        "LPAlgorithmSHECKKS::EvalChebyshevSeries is only supported for "
+        "DCRTPoly.";
+    PALISADE_THROW(not_implemented_error, errMsg);
+  }
+
   /**
    * Function for homomorphic subtraction of ciphertexts.
    *
@@ -1027,6 +1107,17 @@ class LPAlgorithmSHECKKS : public LPSHEAlgorithm<Element> {
   Ciphertext<Element> EvalMult(ConstCiphertext<Element> ciphertext1,
                                ConstCiphertext<Element> ciphertext2) const;
 
+  /**
+   * Function for homomorphic squaring of a ciphertext without key switching.
+   * The result is the same as EvalMult(ciphertext, ciphertext), but the
+   * symmetric tensor product needs one product less, and the input is not
+   * copied when it does not have to be rescaled.
+   *
+   * @param ciphertext input ciphertext.
+   * @return result of homomorphic squaring of the input ciphertext.
+   */
+  Ciphertext<Element> EvalSquare(ConstCiphertext<Element> ciphertext) const;
+
   /**
    * Function for homomorphic multiplication of ciphertexts without key
    * switching. Mutable version - input ciphertexts may get
@@ -1409,6 +1500,40 @@ class LPAlgorithmSHECKKS : public LPSHEAlgorithm<Element> {
       ConstCiphertext<Element> ciphertext, const usint index, const usint m,
       const shared_ptr<vector<Element>> precomp) const;
 
+  /**
+   * EvalAtIndexBatch rotates a ciphertext by a list of indices using hoisted
+   * automorphisms: the digit decomposition (and, for GHS and HYBRID, the
+   * ModUp to the extended basis) is computed once, and the automorphism and
+   * key switching of each index are done in parallel.
+   *
+   * @param ciphertext the input ciphertext.
+   * @param indexList the list of indices.
+   * @param &evalKeys - reference to the map of evaluation keys generated by
+   * EvalAtIndexKeyGen.
+   * @return the rotated ciphertexts, in the order of indexList
+   */
+  vector<Ciphertext<Element>> EvalAtIndexBatch(
+      ConstCiphertext<Element> ciphertext,
+      const std::vector<int32_t> &indexList,
+      const std::map<usint, LPEvalKey<Element>> &evalKeys) const;
+
+  /**
+   * EvalAtIndexBatchSum computes the sum of the rotations of a ciphertext by
+   * a list of indices. For GHS and HYBRID, the key-switched rotations are
+   * accumulated in the extended basis, so a single ModDown is performed for
+   * the whole sum.
+   *
+   * @param ciphertext the input ciphertext.
+   * @param indexList the list of indices; must not be empty.
+   * @param &evalKeys - reference to the map of evaluation keys generated by
+   * EvalAtIndexKeyGen.
+   * @return the sum of the rotated ciphertexts
+   */
+  Ciphertext<Element> EvalAtIndexBatchSum(
+      ConstCiphertext<Element> ciphertext,
+      const std::vector<int32_t> &indexList,
+      const std::map<usint, LPEvalKey<Element>> &evalKeys) const;
+
   /**
    * Function used in EXACTRESCALE to change the level of a ciphertext, while at
    * the same time adjusting the scaling factor of the target level.
@@ -1752,6 +1877,16 @@ class LPAlgorithmSHECKKS : public LPSHEAlgorithm<Element> {
   Ciphertext<Element> EvalMultCore(ConstCiphertext<Element> ciphertext1,
                                    ConstCiphertext<Element> ciphertext2) const;
 
+  /**
+   * Internal function for homomorphic squaring of a ciphertext: computes
+   * c0^2, 2*c0*c1 and c1^2 for a ciphertext of two elements.
+   *
+   * @param ciphertext input ciphertext.
+   * @return result of homomorphic squaring of the input ciphertext.
+   */
+  Ciphertext<Element> EvalSquareCore(
+      ConstCiphertext<Element> ciphertext) const;
+
   /**
    * Internal function for homomorphic multiplication of ciphertexts
    * in the APPROXRESCALE variant.
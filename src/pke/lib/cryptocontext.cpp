@@ -141,7 +141,7 @@ void CryptoContextImpl<Element>::InsertEvalMultKey(
 template <typename Element>
 void CryptoContextImpl<Element>::EvalSumKeyGen(
     const LPPrivateKey<Element> privateKey,
-    const LPPublicKey<Element> publicKey) {
+    const LPPublicKey<Element> publicKey, EvalSumStrategy strategy) {
   if (privateKey == NULL || Mismatched(privateKey->GetCryptoContext())) {
     PALISADE_THROW(config_error,
                    "Private key passed to EvalSumKeyGen were not generated "
@@ -157,7 +157,7 @@ void CryptoContextImpl<Element>::EvalSumKeyGen(
   double start = 0;
   if (doTiming) start = currentDateTime();
   auto evalKeys =
-      GetEncryptionAlgorithm()->EvalSumKeyGen(privateKey, publicKey);
+      GetEncryptionAlgorithm()->EvalSumKeyGen(privateKey, publicKey, strategy);
 
   if (doTiming) {
     timeSamples->push_back(
@@ -166,11 +166,19 @@ void CryptoContextImpl<Element>::EvalSumKeyGen(
   evalSumKeyMap[privateKey->GetKeyTag()] = evalKeys;
 }
 
+template <typename Element>
+std::vector<usint> CryptoContextImpl<Element>::EvalSumIndices(
+    EvalSumStrategy strategy) const {
+  return GetEncryptionAlgorithm()->EvalSumIndices(
+      GetCryptoParameters(), m_schemeId == "CKKS", strategy);
+}
+
 template <typename Element>
 shared_ptr<std::map<usint, LPEvalKey<Element>>>
 CryptoContextImpl<Element>::EvalSumRowsKeyGen(
     const LPPrivateKey<Element> privateKey,
-    const LPPublicKey<Element> publicKey, usint rowSize) {
+    const LPPublicKey<Element> publicKey, usint rowSize,
+    EvalSumStrategy strategy) {
   if (privateKey == NULL || Mismatched(privateKey->GetCryptoContext())) {
     PALISADE_THROW(config_error,
                    "Private key passed to EvalSumKeyGen were not generated "
@@ -186,7 +194,7 @@ CryptoContextImpl<Element>::EvalSumRowsKeyGen(
   double start = 0;
   if (doTiming) start = currentDateTime();
   auto evalKeys = GetEncryptionAlgorithm()->EvalSumRowsKeyGen(
-      privateKey, publicKey, rowSize);
+      privateKey, publicKey, rowSize, strategy);
 
   if (doTiming) {
     timeSamples->push_back(
@@ -196,6 +204,13 @@ CryptoContextImpl<Element>::EvalSumRowsKeyGen(
   return evalKeys;
 }
 
+template <typename Element>
+std::vector<usint> CryptoContextImpl<Element>::EvalSumRowsIndices(
+    usint rowSize, EvalSumStrategy strategy) const {
+  return GetEncryptionAlgorithm()->EvalSumRowsIndices(GetCryptoParameters(),
+                                                      rowSize, strategy);
+}
+
 template <typename Element>
 shared_ptr<std::map<usint, LPEvalKey<Element>>>
 CryptoContextImpl<Element>::EvalSumColsKeyGen(
@@ -380,8 +395,8 @@ Ciphertext<Element> CryptoContextImpl<Element>::EvalSum(
       CryptoContextImpl<Element>::GetEvalSumKeyMap(ciphertext->GetKeyTag());
   double start = 0;
   if (doTiming) start = currentDateTime();
-  auto rv =
-      GetEncryptionAlgorithm()->EvalSum(ciphertext, batchSize, evalSumKeys);
+  auto rv = GetEncryptionAlgorithm()->EvalSum(NormalizeLazy(ciphertext),
+                                              batchSize, evalSumKeys);
   if (doTiming) {
     timeSamples->push_back(TimingInfo(OpEvalSum, currentDateTime() - start));
   }
@@ -399,8 +414,8 @@ Ciphertext<Element> CryptoContextImpl<Element>::EvalSumRows(
 
   double start = 0;
   if (doTiming) start = currentDateTime();
-  auto rv =
-      GetEncryptionAlgorithm()->EvalSumRows(ciphertext, rowSize, evalSumKeys);
+  auto rv = GetEncryptionAlgorithm()->EvalSumRows(NormalizeLazy(ciphertext),
+                                                  rowSize, evalSumKeys);
   if (doTiming) {
     timeSamples->push_back(
         TimingInfo(OpEvalSumRows, currentDateTime() - start));
@@ -423,7 +438,7 @@ Ciphertext<Element> CryptoContextImpl<Element>::EvalSumCols(
   double start = 0;
   if (doTiming) start = currentDateTime();
   auto rv = GetEncryptionAlgorithm()->EvalSumCols(
-      ciphertext, rowSize, evalSumKeys, evalSumKeysRight);
+      NormalizeLazy(ciphertext), rowSize, evalSumKeys, evalSumKeysRight);
   if (doTiming) {
     timeSamples->push_back(
         TimingInfo(OpEvalSumCols, currentDateTime() - start));
@@ -444,8 +459,8 @@ Ciphertext<Element> CryptoContextImpl<Element>::EvalAtIndex(
           ciphertext->GetKeyTag());
   double start = 0;
   if (doTiming) start = currentDateTime();
-  auto rv = GetEncryptionAlgorithm()->EvalAtIndex(ciphertext, index,
-                                                  evalAutomorphismKeys);
+  auto rv = GetEncryptionAlgorithm()->EvalAtIndex(NormalizeLazy(ciphertext),
+                                                  index, evalAutomorphismKeys);
   if (doTiming) {
     timeSamples->push_back(
         TimingInfo(OpEvalAtIndex, currentDateTime() - start));
@@ -453,6 +468,234 @@ Ciphertext<Element> CryptoContextImpl<Element>::EvalAtIndex(
   return rv;
 }
 
+template <typename Element>
+vector<Ciphertext<Element>> CryptoContextImpl<Element>::EvalAtIndexBatch(
+    ConstCiphertext<Element> ciphertext,
+    const std::vector<int32_t>& indexList) const {
+  if (ciphertext == NULL || Mismatched(ciphertext->GetCryptoContext()))
+    PALISADE_THROW(config_error,
+                   "Information passed to EvalAtIndexBatch was not generated "
+                   "with this crypto context");
+
+  const auto& evalAutomorphismKeys =
+      CryptoContextImpl<Element>::GetEvalAutomorphismKeyMap(
+          ciphertext->GetKeyTag());
+  double start = 0;
+  if (doTiming) start = currentDateTime();
+  auto rv = GetEncryptionAlgorithm()->EvalAtIndexBatch(
+      NormalizeLazy(ciphertext), indexList, evalAutomorphismKeys);
+  if (doTiming) {
+    timeSamples->push_back(
+        TimingInfo(OpEvalAtIndexBatch, currentDateTime() - start));
+  }
+  return rv;
+}
+
+template <typename Element>
+Ciphertext<Element> CryptoContextImpl<Element>::EvalAtIndexBatchSum(
+    ConstCiphertext<Element> ciphertext,
+    const std::vector<int32_t>& indexList) const {
+  if (ciphertext == NULL || Mismatched(ciphertext->GetCryptoContext()))
+    PALISADE_THROW(config_error,
+                   "Information passed to EvalAtIndexBatchSum was not "
+                   "generated with this crypto context");
+
+  const auto& evalAutomorphismKeys =
+      CryptoContextImpl<Element>::GetEvalAutomorphismKeyMap(
+          ciphertext->GetKeyTag());
+  double start = 0;
+  if (doTiming) start = currentDateTime();
+  auto rv = GetEncryptionAlgorithm()->EvalAtIndexBatchSum(
+      NormalizeLazy(ciphertext), indexList, evalAutomorphismKeys);
+  if (doTiming) {
+    timeSamples->push_back(
+        TimingInfo(OpEvalBatchSum, currentDateTime() - start));
+  }
+  return rv;
+}
+
+// Returns the baby step of a BSGS linear transform of dimension dim
+static uint32_t LinearTransformBabyStep(uint32_t dim, uint32_t bStep) {
+  if (dim == 0)
+    PALISADE_THROW(config_error,
+                   "The linear transform dimension must be positive");
+  if (bStep == 0)
+    bStep = static_cast<uint32_t>(std::ceil(std::sqrt(dim)));
+  if (bStep > dim)
+    PALISADE_THROW(config_error,
+                   "The baby step cannot exceed the linear transform "
+                   "dimension");
+  return bStep;
+}
+
+template <typename Element>
+std::vector<Plaintext>
+CryptoContextImpl<Element>::EvalLinearTransformPrecompute(
+    const std::vector<std::vector<std::complex<double>>>& matrix,
+    uint32_t bStep, size_t depth, uint32_t level) const {
+  if (std::dynamic_pointer_cast<LPCryptoParametersCKKS<DCRTPoly>>(
+          this->GetCryptoParameters()) == nullptr)
+    PALISADE_THROW(config_error,
+                   "EvalLinearTransformPrecompute is supported only for CKKS");
+
+  uint32_t dim = matrix.size();
+  uint32_t n1 = LinearTransformBabyStep(dim, bStep);
+  uint32_t slots = GetRingDimension() / 2;
+  if (slots % dim != 0)
+    PALISADE_THROW(config_error,
+                   "The linear transform dimension must divide the number "
+                   "of slots");
+  for (const auto& row : matrix) {
+    if (row.size() != dim)
+      PALISADE_THROW(config_error,
+                     "The linear transform matrix must be square");
+  }
+
+  std::vector<Plaintext> diagonals(dim);
+  std::vector<std::complex<double>> diag(dim);
+  std::vector<std::complex<double>> values(slots);
+  for (uint32_t k = 0; k < dim; k++) {
+    bool isZero = true;
+    for (uint32_t i = 0; i < dim; i++) {
+      diag[i] = matrix[i][(i + k) % dim];
+      if (diag[i] != std::complex<double>(0.0, 0.0)) isZero = false;
+    }
+    if (isZero) continue;
+
+    // the giant-step rotation is applied after the product with the
+    // baby-step rotation, so the diagonal is rotated back by the same amount
+    uint32_t shift = dim - (k / n1) * n1 % dim;
+    for (uint32_t i = 0; i < slots; i++) values[i] = diag[(i + shift) % dim];
+
+    diagonals[k] = MakeCKKSPackedPlaintext(values, depth, level);
+    diagonals[k]->SetFormat(EVALUATION);
+  }
+
+  return diagonals;
+}
+
+template <typename Element>
+std::vector<int32_t> CryptoContextImpl<Element>::EvalLinearTransformIndices(
+    const std::vector<Plaintext>& diagonals, uint32_t bStep) const {
+  uint32_t dim = diagonals.size();
+  uint32_t n1 = LinearTransformBabyStep(dim, bStep);
+  uint32_t n2 = (dim + n1 - 1) / n1;
+
+  std::vector<bool> babyUsed(n1, false);
+  std::vector<bool> giantUsed(n2, false);
+  for (uint32_t k = 0; k < dim; k++) {
+    if (diagonals[k] == nullptr) continue;
+    babyUsed[k % n1] = true;
+    giantUsed[k / n1] = true;
+  }
+
+  std::vector<int32_t> indexList;
+  for (uint32_t b = 1; b < n1; b++)
+    if (babyUsed[b]) indexList.push_back(b);
+  for (uint32_t g = 1; g < n2; g++)
+    if (giantUsed[g]) indexList.push_back(g * n1);
+
+  return indexList;
+}
+
+template <typename Element>
+Ciphertext<Element> CryptoContextImpl<Element>::EvalLinearTransform(
+    const std::vector<Plaintext>& diagonals,
+    ConstCiphertext<Element> ciphertext, uint32_t bStep) const {
+  if (ciphertext == NULL || Mismatched(ciphertext->GetCryptoContext()))
+    PALISADE_THROW(config_error,
+                   "Information passed to EvalLinearTransform was not "
+                   "generated with this crypto context");
+
+  auto cryptoParamsCKKS =
+      std::dynamic_pointer_cast<LPCryptoParametersCKKS<DCRTPoly>>(
+          this->GetCryptoParameters());
+  if (cryptoParamsCKKS == nullptr)
+    PALISADE_THROW(config_error,
+                   "EvalLinearTransform is supported only for CKKS");
+
+  uint32_t dim = diagonals.size();
+  uint32_t n1 = LinearTransformBabyStep(dim, bStep);
+  uint32_t n2 = (dim + n1 - 1) / n1;
+
+  double start = 0;
+  if (doTiming) start = currentDateTime();
+
+  auto algo = GetEncryptionAlgorithm();
+
+  // rescale once here rather than in every plaintext multiplication
+  ConstCiphertext<Element> ct =
+      (cryptoParamsCKKS->GetRescalingTechnique() == EXACTRESCALE &&
+       ciphertext->GetDepth() > 1)
+          ? algo->ModReduceInternal(NormalizeLazy(ciphertext))
+          : NormalizeLazy(ciphertext);
+
+  std::vector<bool> babyUsed(n1, false);
+  for (uint32_t k = 0; k < dim; k++)
+    if (diagonals[k] != nullptr) babyUsed[k % n1] = true;
+
+  std::vector<int32_t> babyIndices;
+  std::vector<uint32_t> babyPosition(n1, 0);
+  for (uint32_t b = 0; b < n1; b++) {
+    if (!babyUsed[b]) continue;
+    babyPosition[b] = babyIndices.size();
+    babyIndices.push_back(b);
+  }
+  if (babyIndices.empty()) return algo->EvalMult(ct, 0.0);
+
+  const auto& evalKeys = GetEvalAutomorphismKeyMap(ct->GetKeyTag());
+
+  // the giant-step rotations run inside the parallel loop, so their keys are
+  // checked here
+  uint32_t m = cryptoParamsCKKS->GetElementParams()->GetCyclotomicOrder();
+  for (uint32_t g = 1; g < n2; g++) {
+    bool used = false;
+    for (uint32_t b = 0; b < n1 && g * n1 + b < dim; b++)
+      used = used || diagonals[g * n1 + b] != nullptr;
+    if (used &&
+        evalKeys.find(FindAutomorphismIndex2nComplex(g * n1, m)) ==
+            evalKeys.end())
+      PALISADE_THROW(config_error,
+                     "EvalLinearTransform: no rotation key for giant step " +
+                         std::to_string(g * n1));
+  }
+
+  auto babySteps = algo->EvalAtIndexBatch(ct, babyIndices, evalKeys);
+
+  std::vector<Ciphertext<Element>> giantSteps(n2);
+
+  OMPExceptionHandler handler;
+#pragma omp parallel for
+  for (uint32_t g = 0; g < n2; g++) {
+    handler.Run([&] {
+      Ciphertext<Element> inner;
+      for (uint32_t b = 0; b < n1 && g * n1 + b < dim; b++) {
+        const auto& diagonal = diagonals[g * n1 + b];
+        if (diagonal == nullptr) continue;
+        auto product = algo->EvalMult(babySteps[babyPosition[b]], diagonal);
+        inner = (inner == nullptr) ? product : algo->EvalAdd(inner, product);
+      }
+      if (inner != nullptr && g > 0)
+        inner = algo->EvalAtIndex(inner, g * n1, evalKeys);
+      giantSteps[g] = inner;
+    });
+  }
+  handler.Rethrow();
+
+  Ciphertext<Element> result;
+  for (const auto& giantStep : giantSteps) {
+    if (giantStep == nullptr) continue;
+    result =
+        (result == nullptr) ? giantStep : algo->EvalAdd(result, giantStep);
+  }
+
+  if (doTiming) {
+    timeSamples->push_back(
+        TimingInfo(OpEvalLinearTransform, currentDateTime() - start));
+  }
+  return result;
+}
+
 template <typename Element>
 Ciphertext<Element> CryptoContextImpl<Element>::EvalMerge(
     const vector<Ciphertext<Element>>& ciphertextVector) const {
@@ -465,11 +708,15 @@ Ciphertext<Element> CryptoContextImpl<Element>::EvalMerge(
   auto evalAutomorphismKeys =
       CryptoContextImpl<Element>::GetEvalAutomorphismKeyMap(
           ciphertextVector[0]->GetKeyTag());
+  // the merge rotates every ciphertext, so lazy products are relinearized
+  vector<Ciphertext<Element>> ciphertexts(ciphertextVector);
+  NormalizeLazy(ciphertexts);
+
   double start = 0;
   if (doTiming) start = currentDateTime();
 
-  auto rv = GetEncryptionAlgorithm()->EvalMerge(ciphertextVector,
-                                                evalAutomorphismKeys);
+  auto rv =
+      GetEncryptionAlgorithm()->EvalMerge(ciphertexts, evalAutomorphismKeys);
 
   if (doTiming) {
     timeSamples->push_back(TimingInfo(OpEvalMerge, currentDateTime() - start));
@@ -494,8 +741,8 @@ Ciphertext<Element> CryptoContextImpl<Element>::EvalInnerProduct(
 
   double start = 0;
   if (doTiming) start = currentDateTime();
-  auto rv = GetEncryptionAlgorithm()->EvalInnerProduct(ct1, ct2, batchSize,
-                                                       evalSumKeys, ek[0]);
+  auto rv = GetEncryptionAlgorithm()->EvalInnerProduct(
+      NormalizeLazy(ct1), NormalizeLazy(ct2), batchSize, evalSumKeys, ek[0]);
   if (doTiming) {
     timeSamples->push_back(
         TimingInfo(OpEvalInnerProduct, currentDateTime() - start));
@@ -516,8 +763,8 @@ Ciphertext<Element> CryptoContextImpl<Element>::EvalInnerProduct(
 
   double start = 0;
   if (doTiming) start = currentDateTime();
-  auto rv = GetEncryptionAlgorithm()->EvalInnerProduct(ct1, ct2, batchSize,
-                                                       evalSumKeys);
+  auto rv = GetEncryptionAlgorithm()->EvalInnerProduct(
+      NormalizeLazy(ct1), ct2, batchSize, evalSumKeys);
   if (doTiming) {
     timeSamples->push_back(
         TimingInfo(OpEvalInnerProduct, currentDateTime() - start));
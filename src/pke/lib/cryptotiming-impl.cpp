@@ -80,6 +80,8 @@ static struct FeatureMap FeatureMap[] = {
     {OpEvalSubPlain, "EvalSubPlain", SHE},
     {OpEvalMult, "EvalMult", SHE},
     {OpEvalMultMany, "EvalMultMany", SHE},
+    {OpEvalPoly, "EvalPoly", SHE},
+    {OpEvalChebyshevSeries, "EvalChebyshevSeries", SHE},
     {OpEvalMultMatrix, "EvalMultMatrix", SHE},
     {OpEvalAutomorphismKeyGen, "EvalAutomorphismKeyGen", SHE},
     {OpEvalAutomorphismI, "EvalAutomorphism(I,K)", SHE},
@@ -97,6 +99,9 @@ static struct FeatureMap FeatureMap[] = {
     {OpEvalAtIndexKeyGen, "EvalAtIndexKeyGen", SHE},
     {OpEvalSum, "EvalSum", SHE},
     {OpEvalAtIndex, "EvalAtIndex", SHE},
+    {OpEvalAtIndexBatch, "EvalAtIndexBatch", SHE},
+    {OpEvalBatchSum, "EvalAtIndexBatchSum", SHE},
+    {OpEvalLinearTransform, "EvalLinearTransform", SHE},
     {OpEvalInnerProduct, "EvalInnerProduct", SHE},
     {OpEvalCrossCorrelation, "EvalCrossCorrelation", SHE},
     {OpEvalLinRegressionBatched, "EvalLinRegressionBatched", SHE},
@@ -847,21 +847,17 @@ template <class Element>
 Ciphertext<Element> LPAlgorithmSHEBFV<Element>::EvalMultMany(
     const vector<Ciphertext<Element>> &cipherTextList,
     const vector<LPEvalKey<Element>> &evalKeys) const {
-  const size_t inSize = cipherTextList.size();
-  const size_t lim = inSize * 2 - 2;
-  vector<Ciphertext<Element>> cipherTextResults;
-  cipherTextResults.resize(inSize - 1);
-  size_t ctrIndex = 0;
-
-  for (size_t i = 0; i < lim; i = i + 2) {
-    cipherTextResults[ctrIndex++] = this->EvalMultAndRelinearize(
-        i < inSize ? cipherTextList[i] : cipherTextResults[i - inSize],
-        i + 1 < inSize ? cipherTextList[i + 1]
-                       : cipherTextResults[i + 1 - inSize],
-        evalKeys);
-  }
-
-  return cipherTextResults.back();
+  if (cipherTextList.size() == 1)
+    return Ciphertext<Element>(
+        new CiphertextImpl<Element>(*(cipherTextList[0])));
+
+  // the products of each level of the tree are computed in parallel
+  return this->EvalTreeReduce(
+      cipherTextList,
+      [this, &evalKeys](ConstCiphertext<Element> ct1,
+                        ConstCiphertext<Element> ct2) {
+        return this->EvalMultAndRelinearize(ct1, ct2, evalKeys);
+      });
 }
 
 template <class Element>
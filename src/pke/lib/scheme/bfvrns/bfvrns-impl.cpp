@@ -107,6 +107,28 @@ bool LPCryptoParametersBFVrns<NativePoly>::PrecomputeCRTTables() {
   NONATIVEPOLY
 }
 
+template <>
+bool LPCryptoParametersBFVrns<Poly>::PrecomputeBasisTables() {
+  NOPOLY
+}
+
+template <>
+bool LPCryptoParametersBFVrns<NativePoly>::PrecomputeBasisTables() {
+  NONATIVEPOLY
+}
+
+template <>
+const LPCryptoParametersBFVrns<Poly>&
+LPCryptoParametersBFVrns<Poly>::GetParamsAtLevel(size_t level) const {
+  NOPOLY
+}
+
+template <>
+const LPCryptoParametersBFVrns<NativePoly>&
+LPCryptoParametersBFVrns<NativePoly>::GetParamsAtLevel(size_t level) const {
+  NONATIVEPOLY
+}
+
 template <>
 LPPublicKeyEncryptionSchemeBFVrns<Poly>::LPPublicKeyEncryptionSchemeBFVrns() {
   NOPOLY
@@ -186,6 +208,54 @@ Ciphertext<NativePoly> LPAlgorithmSHEBFVrns<NativePoly>::EvalMult(
   NONATIVEPOLY
 }
 
+template <>
+Ciphertext<Poly> LPAlgorithmSHEBFVrns<Poly>::EvalSquare(
+    ConstCiphertext<Poly> ciphertext) const {
+  NOPOLY
+}
+
+template <>
+Ciphertext<NativePoly> LPAlgorithmSHEBFVrns<NativePoly>::EvalSquare(
+    ConstCiphertext<NativePoly> ciphertext) const {
+  NONATIVEPOLY
+}
+
+template <>
+Ciphertext<Poly> LPAlgorithmSHEBFVrns<Poly>::EvalMult(
+    ConstCiphertext<Poly> ciphertext, ConstPlaintext plaintext) const {
+  NOPOLY
+}
+
+template <>
+Ciphertext<NativePoly> LPAlgorithmSHEBFVrns<NativePoly>::EvalMult(
+    ConstCiphertext<NativePoly> ciphertext, ConstPlaintext plaintext) const {
+  NONATIVEPOLY
+}
+
+template <>
+Ciphertext<Poly> LPAlgorithmSHEBFVrns<Poly>::EvalAdd(
+    ConstCiphertext<Poly> ct1, ConstCiphertext<Poly> ct2) const {
+  NOPOLY
+}
+
+template <>
+Ciphertext<NativePoly> LPAlgorithmSHEBFVrns<NativePoly>::EvalAdd(
+    ConstCiphertext<NativePoly> ct1, ConstCiphertext<NativePoly> ct2) const {
+  NONATIVEPOLY
+}
+
+template <>
+Ciphertext<Poly> LPAlgorithmSHEBFVrns<Poly>::EvalSub(
+    ConstCiphertext<Poly> ct1, ConstCiphertext<Poly> ct2) const {
+  NOPOLY
+}
+
+template <>
+Ciphertext<NativePoly> LPAlgorithmSHEBFVrns<NativePoly>::EvalSub(
+    ConstCiphertext<NativePoly> ct1, ConstCiphertext<NativePoly> ct2) const {
+  NONATIVEPOLY
+}
+
 template <>
 Ciphertext<Poly> LPAlgorithmSHEBFVrns<Poly>::EvalAdd(ConstCiphertext<Poly> ct,
                                                      ConstPlaintext pt) const {
@@ -238,6 +308,22 @@ Ciphertext<NativePoly> LPAlgorithmSHEBFVrns<NativePoly>::KeySwitch(
   NONATIVEPOLY
 }
 
+template <>
+vector<Ciphertext<Poly>> LPAlgorithmSHEBFVrns<Poly>::EvalAtIndexBatch(
+    ConstCiphertext<Poly> ciphertext, const std::vector<int32_t> &indexList,
+    const std::map<usint, LPEvalKey<Poly>> &evalKeys) const {
+  NOPOLY
+}
+
+template <>
+vector<Ciphertext<NativePoly>>
+LPAlgorithmSHEBFVrns<NativePoly>::EvalAtIndexBatch(
+    ConstCiphertext<NativePoly> ciphertext,
+    const std::vector<int32_t> &indexList,
+    const std::map<usint, LPEvalKey<NativePoly>> &evalKeys) const {
+  NONATIVEPOLY
+}
+
 template <>
 Ciphertext<Poly> LPAlgorithmSHEBFVrns<Poly>::EvalMultAndRelinearize(
     ConstCiphertext<Poly> ct1, ConstCiphertext<Poly> ct,
@@ -252,6 +338,36 @@ Ciphertext<NativePoly> LPAlgorithmSHEBFVrns<NativePoly>::EvalMultAndRelinearize(
   NONATIVEPOLY
 }
 
+template <>
+Ciphertext<Poly> LPAlgorithmMultipartyBFVrns<Poly>::MultipartyDecryptMain(
+    const LPPrivateKey<Poly> privateKey,
+    ConstCiphertext<Poly> ciphertext) const {
+  NOPOLY
+}
+
+template <>
+Ciphertext<NativePoly>
+LPAlgorithmMultipartyBFVrns<NativePoly>::MultipartyDecryptMain(
+    const LPPrivateKey<NativePoly> privateKey,
+    ConstCiphertext<NativePoly> ciphertext) const {
+  NONATIVEPOLY
+}
+
+template <>
+Ciphertext<Poly> LPAlgorithmMultipartyBFVrns<Poly>::MultipartyDecryptLead(
+    const LPPrivateKey<Poly> privateKey,
+    ConstCiphertext<Poly> ciphertext) const {
+  NOPOLY
+}
+
+template <>
+Ciphertext<NativePoly>
+LPAlgorithmMultipartyBFVrns<NativePoly>::MultipartyDecryptLead(
+    const LPPrivateKey<NativePoly> privateKey,
+    ConstCiphertext<NativePoly> ciphertext) const {
+  NONATIVEPOLY
+}
+
 template <>
 DecryptResult LPAlgorithmMultipartyBFVrns<Poly>::MultipartyDecryptFusion(
     const vector<Ciphertext<Poly>> &ciphertextVec,
@@ -282,11 +398,27 @@ LPAlgorithmMultipartyBFVrns<NativePoly>::MultiKeySwitchGen(
   NONATIVEPOLY
 }
 
+template <>
+Ciphertext<Poly> LPLeveledSHEAlgorithmBFVrns<Poly>::LevelReduceInternal(
+    ConstCiphertext<Poly> cipherText1,
+    const LPEvalKey<Poly> linearKeySwitchHint, size_t levels) const {
+  NOPOLY
+}
+
+template <>
+Ciphertext<NativePoly>
+LPLeveledSHEAlgorithmBFVrns<NativePoly>::LevelReduceInternal(
+    ConstCiphertext<NativePoly> cipherText1,
+    const LPEvalKey<NativePoly> linearKeySwitchHint, size_t levels) const {
+  NONATIVEPOLY
+}
+
 template class LPCryptoParametersBFVrns<Poly>;
 template class LPPublicKeyEncryptionSchemeBFVrns<Poly>;
 template class LPAlgorithmBFVrns<Poly>;
 template class LPAlgorithmPREBFVrns<Poly>;
 template class LPAlgorithmSHEBFVrns<Poly>;
+template class LPLeveledSHEAlgorithmBFVrns<Poly>;
 template class LPAlgorithmMultipartyBFVrns<Poly>;
 template class LPAlgorithmParamsGenBFVrns<Poly>;
 
@@ -295,18 +427,17 @@ template class LPPublicKeyEncryptionSchemeBFVrns<NativePoly>;
 template class LPAlgorithmBFVrns<NativePoly>;
 template class LPAlgorithmPREBFVrns<NativePoly>;
 template class LPAlgorithmSHEBFVrns<NativePoly>;
+template class LPLeveledSHEAlgorithmBFVrns<NativePoly>;
 template class LPAlgorithmMultipartyBFVrns<NativePoly>;
 template class LPAlgorithmParamsGenBFVrns<NativePoly>;
 
 #undef NOPOLY
 #undef NONATIVEPOLY
 
-// Precomputation of CRT tables encryption, decryption, and homomorphic
-// multiplication
+// Precomputation of the tables for the CRT basis Q of the element parameters
+// and the auxiliary basis S
 template <>
-bool LPCryptoParametersBFVrns<DCRTPoly>::PrecomputeCRTTables() {
-  // read values for the CRT basis
-
+bool LPCryptoParametersBFVrns<DCRTPoly>::PrecomputeBasisTables() {
   size_t size = GetElementParams()->GetParams().size();
   size_t n = GetElementParams()->GetRingDimension();
 
@@ -317,30 +448,15 @@ bool LPCryptoParametersBFVrns<DCRTPoly>::PrecomputeCRTTables() {
     roots[i] = GetElementParams()->GetParams()[i]->GetRootOfUnity();
   }
 
-  ChineseRemainderTransformFTT<NativeVector>::PreCompute(roots, 2 * n, moduli);
-
-  // computes the auxiliary CRT basis S=s1*s2*..sn used in homomorphic
-  // multiplication
-
-  size_t sizeS = size + 1;
+  size_t sizeS = m_paramsS->GetParams().size();
 
   vector<NativeInteger> moduliS(sizeS);
   vector<NativeInteger> rootsS(sizeS);
-
-  moduliS[0] = PreviousPrime<NativeInteger>(moduli[size - 1], 2 * n);
-  rootsS[0] = RootOfUnity<NativeInteger>(2 * n, moduliS[0]);
-
-  for (size_t i = 1; i < sizeS; i++) {
-    moduliS[i] = PreviousPrime<NativeInteger>(moduliS[i - 1], 2 * n);
-    rootsS[i] = RootOfUnity<NativeInteger>(2 * n, moduliS[i]);
+  for (size_t i = 0; i < sizeS; i++) {
+    moduliS[i] = m_paramsS->GetParams()[i]->GetModulus();
+    rootsS[i] = m_paramsS->GetParams()[i]->GetRootOfUnity();
   }
 
-  m_paramsS = shared_ptr<ILDCRTParams<BigInteger>>(
-      new ILDCRTParams<BigInteger>(2 * n, moduliS, rootsS));
-
-  ChineseRemainderTransformFTT<NativeVector>::PreCompute(rootsS, 2 * n,
-                                                         moduliS);
-
   // stores the parameters for the auxiliary expanded CRT basis Q*S =
   // v1*v2*...*vn used in homomorphic multiplication
 
@@ -598,9 +714,232 @@ bool LPCryptoParametersBFVrns<DCRTPoly>::PrecomputeCRTTables() {
 
   m_CRTsModqiTable = sModqi;
 
+  // compute the floor(Q'*[Q'^{-1}]_qt/qt) mod qi table, where Q'=Q/qt - used
+  // to drop the last tower in the leveled mode
+
+  m_CRTRescaleTable.clear();
+  if (size > 1) {
+    const BigInteger qt(moduli[size - 1]);
+    const BigInteger modulusQPrime = modulusQ / qt;
+    const BigInteger result =
+        (modulusQPrime.ModInverse(qt) * modulusQPrime) / qt;
+    for (size_t i = 0; i < size - 1; i++)
+      m_CRTRescaleTable.push_back(result.Mod(moduli[i]).ConvertToInt());
+  }
+
   return true;
 }
 
+template <>
+const LPCryptoParametersBFVrns<DCRTPoly>&
+LPCryptoParametersBFVrns<DCRTPoly>::GetParamsAtLevel(size_t level) const {
+  if (level == 0) return *this;
+
+  size_t size = GetElementParams()->GetParams().size();
+  if (level >= size)
+    PALISADE_THROW(config_error,
+                   "BFVrns.GetParamsAtLevel: cannot drop all the towers of Q");
+
+  std::lock_guard<std::mutex> lock(m_paramsLevelsMutex);
+
+  if (m_paramsLevels.size() < size) m_paramsLevels.resize(size);
+
+  if (m_paramsLevels[level] == nullptr) {
+    auto params = std::make_shared<LPCryptoParametersBFVrns<DCRTPoly>>(*this);
+
+    // the bases of a level are prefixes of the full ones, so that their NTT
+    // tables are already precomputed
+    auto elementParams =
+        std::make_shared<typename DCRTPoly::Params>(*GetElementParams());
+    auto paramsS = std::make_shared<ILDCRTParams<BigInteger>>(*m_paramsS);
+    for (size_t i = 0; i < level; i++) {
+      elementParams->PopLastParam();
+      paramsS->PopLastParam();
+    }
+
+    params->SetElementParams(elementParams);
+    params->m_paramsS = paramsS;
+    params->PrecomputeBasisTables();
+
+    m_paramsLevels[level] = params;
+  }
+
+  return *m_paramsLevels[level];
+}
+
+// Precomputation of CRT tables encryption, decryption, and homomorphic
+// multiplication
+template <>
+bool LPCryptoParametersBFVrns<DCRTPoly>::PrecomputeCRTTables() {
+  // read values for the CRT basis
+
+  size_t size = GetElementParams()->GetParams().size();
+  size_t n = GetElementParams()->GetRingDimension();
+
+  vector<NativeInteger> moduli(size);
+  vector<NativeInteger> roots(size);
+  for (size_t i = 0; i < size; i++) {
+    moduli[i] = GetElementParams()->GetParams()[i]->GetModulus();
+    roots[i] = GetElementParams()->GetParams()[i]->GetRootOfUnity();
+  }
+
+  ChineseRemainderTransformFTT<NativeVector>::PreCompute(roots, 2 * n, moduli);
+
+  // computes the auxiliary CRT basis S=s1*s2*..sn used in homomorphic
+  // multiplication
+
+  size_t sizeS = size + 1;
+
+  vector<NativeInteger> moduliS(sizeS);
+  vector<NativeInteger> rootsS(sizeS);
+
+  moduliS[0] = PreviousPrime<NativeInteger>(moduli[size - 1], 2 * n);
+  rootsS[0] = RootOfUnity<NativeInteger>(2 * n, moduliS[0]);
+
+  for (size_t i = 1; i < sizeS; i++) {
+    moduliS[i] = PreviousPrime<NativeInteger>(moduliS[i - 1], 2 * n);
+    rootsS[i] = RootOfUnity<NativeInteger>(2 * n, moduliS[i]);
+  }
+
+  m_paramsS = shared_ptr<ILDCRTParams<BigInteger>>(
+      new ILDCRTParams<BigInteger>(2 * n, moduliS, rootsS));
+
+  ChineseRemainderTransformFTT<NativeVector>::PreCompute(rootsS, 2 * n,
+                                                         moduliS);
+
+  // the parameters of the leveled mode are rebuilt from the new tables
+  {
+    std::lock_guard<std::mutex> lock(m_paramsLevelsMutex);
+    m_paramsLevels.clear();
+  }
+
+  return PrecomputeBasisTables();
+}
+
+namespace {
+
+// Returns the number of towers dropped from Q in a ciphertext
+size_t LevelOf(const LPCryptoParametersBFVrns<DCRTPoly> &cryptoParams,
+               ConstCiphertext<DCRTPoly> ciphertext) {
+  return cryptoParams.GetElementParams()->GetParams().size() -
+         ciphertext->GetElements()[0].GetNumOfElements();
+}
+
+// Returns the elements of a ciphertext brought down to the given level: the
+// last towers are dropped and the elements are scaled down by every dropped
+// modulus. The scaled elements are in EVALUATION representation.
+std::vector<DCRTPoly> ElementsAtLevel(
+    const LPCryptoParametersBFVrns<DCRTPoly> &cryptoParams,
+    ConstCiphertext<DCRTPoly> ciphertext, size_t level) {
+  size_t currentLevel = LevelOf(cryptoParams, ciphertext);
+  if (level < currentLevel)
+    PALISADE_THROW(config_error,
+                   "BFVrns: towers that were dropped cannot be restored");
+
+  std::vector<DCRTPoly> c(ciphertext->GetElements());
+  if (level == currentLevel) return c;
+
+  for (size_t i = 0; i < c.size(); i++) {
+    c[i].SetFormat(EVALUATION);
+    for (size_t l = currentLevel; l < level; l++)
+      c[i].DropLastElementAndScale(
+          cryptoParams.GetParamsAtLevel(l).GetCRTRescaleTable());
+  }
+
+  return c;
+}
+
+// Returns the ciphertext brought down to the given level
+ConstCiphertext<DCRTPoly> CiphertextAtLevel(
+    const LPCryptoParametersBFVrns<DCRTPoly> &cryptoParams,
+    ConstCiphertext<DCRTPoly> ciphertext, size_t level) {
+  if (LevelOf(cryptoParams, ciphertext) == level) return ciphertext;
+
+  Ciphertext<DCRTPoly> result = ciphertext->CloneEmpty();
+  result->SetElements(ElementsAtLevel(cryptoParams, ciphertext, level));
+  result->SetDepth(ciphertext->GetDepth());
+  result->SetLevel(level);
+
+  return result;
+}
+
+// Returns the level at which two ciphertexts can be combined, i.e., the level
+// of the one with fewer towers
+size_t CommonLevel(const LPCryptoParametersBFVrns<DCRTPoly> &cryptoParams,
+                   ConstCiphertext<DCRTPoly> ciphertext1,
+                   ConstCiphertext<DCRTPoly> ciphertext2) {
+  return std::max(LevelOf(cryptoParams, ciphertext1),
+                  LevelOf(cryptoParams, ciphertext2));
+}
+
+// Returns a plaintext element restricted to the towers of a ciphertext at the
+// given level
+DCRTPoly PlaintextAtLevel(const DCRTPoly &element, size_t level) {
+  DCRTPoly result(element);
+  if (level > 0) result.DropLastElements(level);
+  return result;
+}
+
+// Multiplies a digit by a key-switching key element. In the leveled mode, the
+// key may have more towers than the digit; only the towers of the digit are
+// used.
+DCRTPoly MultiplyByKey(const DCRTPoly &digit, const DCRTPoly &key) {
+  if (digit.GetNumOfElements() == key.GetNumOfElements()) return digit * key;
+
+  DCRTPoly product(digit);
+#pragma omp parallel for
+  for (usint i = 0; i < product.GetNumOfElements(); i++)
+    product.ElementAtIndex(i) *= key.GetElementAtIndex(i);
+
+  return product;
+}
+
+// Expands the CRT basis of ciphertext elements from Q to Q*S in place; the
+// elements are output in EVALUATION representation
+void ExpandToQS(const LPCryptoParametersBFVrns<DCRTPoly> &cryptoParams,
+                std::vector<DCRTPoly> &c) {
+  const shared_ptr<ILDCRTParams<BigInteger>> paramsS =
+      cryptoParams.GetDCRTParamsS();
+  const shared_ptr<ILDCRTParams<BigInteger>> paramsQS =
+      cryptoParams.GetDCRTParamsQS();
+
+  for (size_t i = 0; i < c.size(); i++)
+    c[i].ExpandCRTBasis(paramsQS, paramsS, cryptoParams.GetCRTInverseTable(),
+                        cryptoParams.GetCRTqDivqiModsiTable(),
+                        cryptoParams.GetCRTqModsiTable(),
+                        cryptoParams.GetDCRTParamsSModulimu(),
+                        cryptoParams.GetCRTInversePreconTable());
+}
+
+// Scales the elements of a tensor product in the CRT basis Q*S by t/Q with
+// rounding, and brings them back to the CRT basis Q
+void ScaleAndRoundToQ(const LPCryptoParametersBFVrns<DCRTPoly> &cryptoParams,
+                      std::vector<DCRTPoly> &c) {
+  const shared_ptr<typename DCRTPoly::Params> elementParams =
+      cryptoParams.GetElementParams();
+  const shared_ptr<ILDCRTParams<BigInteger>> paramsS =
+      cryptoParams.GetDCRTParamsS();
+
+  for (size_t i = 0; i < c.size(); i++) {
+    // converts to coefficient representation before rounding
+    c[i].SwitchFormat();
+    // Performs the scaling by p/q followed by rounding; the result is in the
+    // CRT basis S
+    c[i] = c[i].ScaleAndRound(paramsS, cryptoParams.GetCRTMultIntTable(),
+                              cryptoParams.GetCRTMultFloatTable(),
+                              cryptoParams.GetDCRTParamsSModulimu());
+    // Converts from the CRT basis S to Q
+    c[i] = c[i].SwitchCRTBasis(elementParams,
+                               cryptoParams.GetCRTSInverseTable(),
+                               cryptoParams.GetCRTsDivsiModqiTable(),
+                               cryptoParams.GetCRTsModqiTable(),
+                               cryptoParams.GetDCRTParamsQModulimu(),
+                               cryptoParams.GetCRTSInversePreconTable());
+  }
+}
+
+}  // namespace
+
 // Parameter generation for BFV-RNS
 template <>
 bool LPAlgorithmParamsGenBFVrns<DCRTPoly>::ParamsGen(
@@ -1000,7 +1339,14 @@ DecryptResult LPAlgorithmBFVrns<DCRTPoly>::Decrypt(
 
   const std::vector<DCRTPoly> &c = ciphertext->GetElements();
 
-  const DCRTPoly &s = privateKey->GetPrivateElement();
+  // in the leveled mode, the key and the tables are restricted to the towers
+  // of the ciphertext
+  size_t level = LevelOf(*cryptoParams, ciphertext);
+  const LPCryptoParametersBFVrns<DCRTPoly> &paramsAtLevel =
+      cryptoParams->GetParamsAtLevel(level);
+
+  DCRTPoly s = privateKey->GetPrivateElement();
+  if (level > 0) s.DropLastElements(level);
   DCRTPoly sPower = s;
 
   DCRTPoly b = c[0];
@@ -1021,17 +1367,17 @@ DecryptResult LPAlgorithmBFVrns<DCRTPoly>::Decrypt(
   auto &p = cryptoParams->GetPlaintextModulus();
 
   const std::vector<double> &lyamTable =
-      cryptoParams->GetCRTDecryptionFloatTable();
+      paramsAtLevel.GetCRTDecryptionFloatTable();
   const std::vector<long double> &lyamExtTable =
-      cryptoParams->GetCRTDecryptionExtFloatTable();
+      paramsAtLevel.GetCRTDecryptionExtFloatTable();
 #ifndef NO_QUADMATH
   const std::vector<QuadFloat> &lyamQuadTable =
-      cryptoParams->GetCRTDecryptionQuadFloatTable();
+      paramsAtLevel.GetCRTDecryptionQuadFloatTable();
 #endif
   const std::vector<NativeInteger> &invTable =
-      cryptoParams->GetCRTDecryptionIntTable();
+      paramsAtLevel.GetCRTDecryptionIntTable();
   const std::vector<NativeInteger> &invPreconTable =
-      cryptoParams->GetCRTDecryptionIntPreconTable();
+      paramsAtLevel.GetCRTDecryptionIntPreconTable();
 
   // this is the resulting vector of coefficients;
 #ifndef NO_QUADMATH
@@ -1097,10 +1443,15 @@ Ciphertext<DCRTPoly> LPAlgorithmSHEBFVrns<DCRTPoly>::EvalAdd(
       std::dynamic_pointer_cast<LPCryptoParametersBFVrns<DCRTPoly>>(
           ciphertext->GetCryptoParameters());
 
+  size_t level = LevelOf(*cryptoParams, ciphertext);
   const std::vector<NativeInteger> &deltaTable =
-      cryptoParams->GetCRTDeltaTable();
+      cryptoParams->GetParamsAtLevel(level).GetCRTDeltaTable();
 
-  c[0] = cipherTextElements[0] + ptElement.Times(deltaTable);
+  if (level == 0)
+    c[0] = cipherTextElements[0] + ptElement.Times(deltaTable);
+  else
+    c[0] = cipherTextElements[0] +
+           PlaintextAtLevel(ptElement, level).Times(deltaTable);
 
   for (size_t i = 1; i < cipherTextElements.size(); i++) {
     c[i] = cipherTextElements[i];
@@ -1128,10 +1479,15 @@ Ciphertext<DCRTPoly> LPAlgorithmSHEBFVrns<DCRTPoly>::EvalSub(
       std::dynamic_pointer_cast<LPCryptoParametersBFVrns<DCRTPoly>>(
           ciphertext->GetCryptoParameters());
 
+  size_t level = LevelOf(*cryptoParams, ciphertext);
   const std::vector<NativeInteger> &deltaTable =
-      cryptoParams->GetCRTDeltaTable();
+      cryptoParams->GetParamsAtLevel(level).GetCRTDeltaTable();
 
-  c[0] = cipherTextElements[0] - ptElement.Times(deltaTable);
+  if (level == 0)
+    c[0] = cipherTextElements[0] - ptElement.Times(deltaTable);
+  else
+    c[0] = cipherTextElements[0] -
+           PlaintextAtLevel(ptElement, level).Times(deltaTable);
 
   for (size_t i = 1; i < cipherTextElements.size(); i++) {
     c[i] = cipherTextElements[i];
@@ -1142,6 +1498,66 @@ Ciphertext<DCRTPoly> LPAlgorithmSHEBFVrns<DCRTPoly>::EvalSub(
   return newCiphertext;
 }
 
+template <>
+Ciphertext<DCRTPoly> LPAlgorithmSHEBFVrns<DCRTPoly>::EvalSquare(
+    ConstCiphertext<DCRTPoly> ciphertext) const {
+  Ciphertext<DCRTPoly> newCiphertext = ciphertext->CloneEmpty();
+
+  const shared_ptr<LPCryptoParametersBFVrns<DCRTPoly>> cryptoParams =
+      std::dynamic_pointer_cast<LPCryptoParametersBFVrns<DCRTPoly>>(
+          ciphertext->GetCryptoContext()->GetCryptoParameters());
+
+  size_t level = LevelOf(*cryptoParams, ciphertext);
+  const LPCryptoParametersBFVrns<DCRTPoly> *cryptoParamsBFVrns =
+      &cryptoParams->GetParamsAtLevel(level);
+
+  // The elements are copied once, as the basis expansion is done in place
+  std::vector<DCRTPoly> cipherTextElements = ciphertext->GetElements();
+  ExpandToQS(*cryptoParamsBFVrns, cipherTextElements);
+
+  size_t cipherTextElementsSize = cipherTextElements.size();
+  size_t cipherTextRElementsSize = 2 * cipherTextElementsSize - 1;
+
+  std::vector<DCRTPoly> c(cipherTextRElementsSize);
+
+  if (cipherTextElementsSize == 2) {
+    // c0^2, 2*c0*c1 and c1^2; the expanded c0 is reused for the cross term
+    c[0] = cipherTextElements[0] * cipherTextElements[0];
+    c[2] = cipherTextElements[1] * cipherTextElements[1];
+
+    cipherTextElements[0] *= cipherTextElements[1];
+    cipherTextElements[0] += cipherTextElements[0];
+    c[1] = std::move(cipherTextElements[0]);
+  } else {
+    bool *isFirstAdd = new bool[cipherTextRElementsSize];
+    std::fill_n(isFirstAdd, cipherTextRElementsSize, true);
+
+    // Each cross product with i < j appears twice in the square
+    for (size_t i = 0; i < cipherTextElementsSize; i++) {
+      for (size_t j = i; j < cipherTextElementsSize; j++) {
+        DCRTPoly prod = cipherTextElements[i] * cipherTextElements[j];
+        if (i != j) prod += prod;
+        if (isFirstAdd[i + j] == true) {
+          c[i + j] = std::move(prod);
+          isFirstAdd[i + j] = false;
+        } else {
+          c[i + j] += prod;
+        }
+      }
+    }
+
+    delete[] isFirstAdd;
+  }
+
+  ScaleAndRoundToQ(*cryptoParamsBFVrns, c);
+
+  newCiphertext->SetElements(std::move(c));
+  newCiphertext->SetDepth(2 * ciphertext->GetDepth());
+  newCiphertext->SetLevel(level);
+
+  return newCiphertext;
+}
+
 template <>
 Ciphertext<DCRTPoly> LPAlgorithmSHEBFVrns<DCRTPoly>::EvalMult(
     ConstCiphertext<DCRTPoly> ciphertext1,
@@ -1153,15 +1569,25 @@ Ciphertext<DCRTPoly> LPAlgorithmSHEBFVrns<DCRTPoly>::EvalMult(
     PALISADE_THROW(config_error, errMsg);
   }
 
+  if (ciphertext1 == ciphertext2) return EvalSquare(ciphertext1);
+
   Ciphertext<DCRTPoly> newCiphertext = ciphertext1->CloneEmpty();
 
-  const shared_ptr<LPCryptoParametersBFVrns<DCRTPoly>> cryptoParamsBFVrns =
+  const shared_ptr<LPCryptoParametersBFVrns<DCRTPoly>> cryptoParams =
       std::dynamic_pointer_cast<LPCryptoParametersBFVrns<DCRTPoly>>(
           ciphertext1->GetCryptoContext()->GetCryptoParameters());
 
+  // In the leveled mode, the multiplication runs on the towers left in the
+  // ciphertexts, with the tables of their level
+  size_t level = CommonLevel(*cryptoParams, ciphertext1, ciphertext2);
+  const LPCryptoParametersBFVrns<DCRTPoly> *cryptoParamsBFVrns =
+      &cryptoParams->GetParamsAtLevel(level);
+
   // Get the ciphertext elements
-  std::vector<DCRTPoly> cipherText1Elements = ciphertext1->GetElements();
-  std::vector<DCRTPoly> cipherText2Elements = ciphertext2->GetElements();
+  std::vector<DCRTPoly> cipherText1Elements =
+      ElementsAtLevel(*cryptoParams, ciphertext1, level);
+  std::vector<DCRTPoly> cipherText2Elements =
+      ElementsAtLevel(*cryptoParams, ciphertext2, level);
 
   size_t cipherText1ElementsSize = cipherText1Elements.size();
   size_t cipherText2ElementsSize = cipherText2Elements.size();
@@ -1170,86 +1596,115 @@ Ciphertext<DCRTPoly> LPAlgorithmSHEBFVrns<DCRTPoly>::EvalMult(
 
   std::vector<DCRTPoly> c(cipherTextRElementsSize);
 
-  const shared_ptr<typename DCRTPoly::Params> elementParams =
-      cryptoParamsBFVrns->GetElementParams();
-  const shared_ptr<ILDCRTParams<BigInteger>> paramsS =
-      cryptoParamsBFVrns->GetDCRTParamsS();
-  const shared_ptr<ILDCRTParams<BigInteger>> paramsQS =
-      cryptoParamsBFVrns->GetDCRTParamsQS();
-
   // Expands the CRT basis to Q*S; Outputs the polynomials in EVALUATION
   // representation
-
-  for (size_t i = 0; i < cipherText1ElementsSize; i++)
-    cipherText1Elements[i].ExpandCRTBasis(
-        paramsQS, paramsS, cryptoParamsBFVrns->GetCRTInverseTable(),
-        cryptoParamsBFVrns->GetCRTqDivqiModsiTable(),
-        cryptoParamsBFVrns->GetCRTqModsiTable(),
-        cryptoParamsBFVrns->GetDCRTParamsSModulimu(),
-        cryptoParamsBFVrns->GetCRTInversePreconTable());
-
-  for (size_t i = 0; i < cipherText2ElementsSize; i++)
-    cipherText2Elements[i].ExpandCRTBasis(
-        paramsQS, paramsS, cryptoParamsBFVrns->GetCRTInverseTable(),
-        cryptoParamsBFVrns->GetCRTqDivqiModsiTable(),
-        cryptoParamsBFVrns->GetCRTqModsiTable(),
-        cryptoParamsBFVrns->GetDCRTParamsSModulimu(),
-        cryptoParamsBFVrns->GetCRTInversePreconTable());
+  ExpandToQS(*cryptoParamsBFVrns, cipherText1Elements);
+  ExpandToQS(*cryptoParamsBFVrns, cipherText2Elements);
 
   // Performs the multiplication itself
-  // Karatsuba technique is currently slower so it is commented out
-  /*if (cipherText1ElementsSize == 2 && cipherText2ElementsSize == 2) // size of
-  each ciphertxt = 2, use Karatsuba
-  {
-
-          c[0] = cipherText1Elements[0] * cipherText2Elements[0]; // a
-          c[2] = cipherText1Elements[1] * cipherText2Elements[1]; // b
-
-          c[1] = cipherText1Elements[0] + cipherText1Elements[1];
-          c[1] *= (cipherText2Elements[0] + cipherText2Elements[1]);
-          c[1] -= c[2];
-          c[1] -= c[0];
-
-  }
-  else // if size of any of the ciphertexts > 2
-  {*/
-
-  bool *isFirstAdd = new bool[cipherTextRElementsSize];
-  std::fill_n(isFirstAdd, cipherTextRElementsSize, true);
-
-  for (size_t i = 0; i < cipherText1ElementsSize; i++) {
-    for (size_t j = 0; j < cipherText2ElementsSize; j++) {
-      if (isFirstAdd[i + j] == true) {
-        c[i + j] = cipherText1Elements[i] * cipherText2Elements[j];
-        isFirstAdd[i + j] = false;
-      } else {
-        c[i + j] += cipherText1Elements[i] * cipherText2Elements[j];
+  if (cipherText1ElementsSize == 2 && cipherText2ElementsSize == 2) {
+    // Karatsuba: the middle term is (a0 + a1)(b0 + b1) - a0*b0 - a1*b1; the
+    // expanded a0 and b0 are local copies and hold the sums
+    c[0] = cipherText1Elements[0] * cipherText2Elements[0];
+    c[2] = cipherText1Elements[1] * cipherText2Elements[1];
+
+    cipherText1Elements[0] += cipherText1Elements[1];
+    cipherText2Elements[0] += cipherText2Elements[1];
+    c[1] = std::move(cipherText1Elements[0]);
+    c[1] *= cipherText2Elements[0];
+    c[1] -= c[0];
+    c[1] -= c[2];
+  } else {  // if size of any of the ciphertexts > 2
+    bool *isFirstAdd = new bool[cipherTextRElementsSize];
+    std::fill_n(isFirstAdd, cipherTextRElementsSize, true);
+
+    for (size_t i = 0; i < cipherText1ElementsSize; i++) {
+      for (size_t j = 0; j < cipherText2ElementsSize; j++) {
+        if (isFirstAdd[i + j] == true) {
+          c[i + j] = cipherText1Elements[i] * cipherText2Elements[j];
+          isFirstAdd[i + j] = false;
+        } else {
+          c[i + j] += cipherText1Elements[i] * cipherText2Elements[j];
+        }
       }
     }
+
+    delete[] isFirstAdd;
   }
 
-  delete[] isFirstAdd;
-  //};
+  ScaleAndRoundToQ(*cryptoParamsBFVrns, c);
 
-  for (size_t i = 0; i < cipherTextRElementsSize; i++) {
-    // converts to coefficient representation before rounding
-    c[i].SwitchFormat();
-    // Performs the scaling by p/q followed by rounding; the result is in the
-    // CRT basis S
-    c[i] = c[i].ScaleAndRound(paramsS, cryptoParamsBFVrns->GetCRTMultIntTable(),
-                              cryptoParamsBFVrns->GetCRTMultFloatTable(),
-                              cryptoParamsBFVrns->GetDCRTParamsSModulimu());
-    // Converts from the CRT basis S to Q
-    c[i] = c[i].SwitchCRTBasis(elementParams,
-                               cryptoParamsBFVrns->GetCRTSInverseTable(),
-                               cryptoParamsBFVrns->GetCRTsDivsiModqiTable(),
-                               cryptoParamsBFVrns->GetCRTsModqiTable(),
-                               cryptoParamsBFVrns->GetDCRTParamsQModulimu(),
-                               cryptoParamsBFVrns->GetCRTSInversePreconTable());
+  newCiphertext->SetElements(std::move(c));
+  newCiphertext->SetDepth((ciphertext1->GetDepth() + ciphertext2->GetDepth()));
+  newCiphertext->SetLevel(level);
+
+  return newCiphertext;
+}
+
+template <>
+Ciphertext<DCRTPoly> LPAlgorithmSHEBFVrns<DCRTPoly>::EvalMult(
+    ConstCiphertext<DCRTPoly> ciphertext, ConstPlaintext plaintext) const {
+  const shared_ptr<LPCryptoParametersBFVrns<DCRTPoly>> cryptoParams =
+      std::dynamic_pointer_cast<LPCryptoParametersBFVrns<DCRTPoly>>(
+          ciphertext->GetCryptoParameters());
+
+  size_t level = LevelOf(*cryptoParams, ciphertext);
+  if (level == 0)
+    return LPAlgorithmSHEBFV<DCRTPoly>::EvalMult(ciphertext, plaintext);
+
+  const std::vector<DCRTPoly> &cipherTextElements = ciphertext->GetElements();
+
+  plaintext->SetFormat(EVALUATION);
+  DCRTPoly ptElement =
+      PlaintextAtLevel(plaintext->GetElement<DCRTPoly>(), level);
+
+  if (cipherTextElements[0].GetFormat() == Format::COEFFICIENT) {
+    PALISADE_THROW(
+        type_error,
+        "LPAlgorithmSHEBFVrns::EvalMult cannot multiply in COEFFICIENT "
+        "domain.");
   }
 
-  newCiphertext->SetElements(c);
-  newCiphertext->SetDepth((ciphertext1->GetDepth() + ciphertext2->GetDepth()));
+  Ciphertext<DCRTPoly> newCiphertext = ciphertext->CloneEmpty();
+  newCiphertext->SetElements(
+      {cipherTextElements[0] * ptElement, cipherTextElements[1] * ptElement});
+  newCiphertext->SetLevel(level);
+
+  return newCiphertext;
+}
+
+template <>
+Ciphertext<DCRTPoly> LPAlgorithmSHEBFVrns<DCRTPoly>::EvalAdd(
+    ConstCiphertext<DCRTPoly> ciphertext1,
+    ConstCiphertext<DCRTPoly> ciphertext2) const {
+  const shared_ptr<LPCryptoParametersBFVrns<DCRTPoly>> cryptoParams =
+      std::dynamic_pointer_cast<LPCryptoParametersBFVrns<DCRTPoly>>(
+          ciphertext1->GetCryptoParameters());
+
+  size_t level = CommonLevel(*cryptoParams, ciphertext1, ciphertext2);
+
+  Ciphertext<DCRTPoly> newCiphertext = LPAlgorithmSHEBFV<DCRTPoly>::EvalAdd(
+      CiphertextAtLevel(*cryptoParams, ciphertext1, level),
+      CiphertextAtLevel(*cryptoParams, ciphertext2, level));
+  newCiphertext->SetLevel(level);
+
+  return newCiphertext;
+}
+
+template <>
+Ciphertext<DCRTPoly> LPAlgorithmSHEBFVrns<DCRTPoly>::EvalSub(
+    ConstCiphertext<DCRTPoly> ciphertext1,
+    ConstCiphertext<DCRTPoly> ciphertext2) const {
+  const shared_ptr<LPCryptoParametersBFVrns<DCRTPoly>> cryptoParams =
+      std::dynamic_pointer_cast<LPCryptoParametersBFVrns<DCRTPoly>>(
+          ciphertext1->GetCryptoParameters());
+
+  size_t level = CommonLevel(*cryptoParams, ciphertext1, ciphertext2);
+
+  Ciphertext<DCRTPoly> newCiphertext = LPAlgorithmSHEBFV<DCRTPoly>::EvalSub(
+      CiphertextAtLevel(*cryptoParams, ciphertext1, level),
+      CiphertextAtLevel(*cryptoParams, ciphertext2, level));
+  newCiphertext->SetLevel(level);
 
   return newCiphertext;
 }
@@ -1417,35 +1872,117 @@ Ciphertext<DCRTPoly> LPAlgorithmSHEBFVrns<DCRTPoly>::KeySwitch(
 
   // in the case of EvalMult, c[0] is initially in coefficient format and needs
   // to be switched to evaluation format
-  if (c.size() > 2) ct0.SwitchFormat();
+  ct0.SetFormat(EVALUATION);
 
   DCRTPoly ct1;
 
+  // In the leveled mode, the ciphertext may have fewer towers than the keys:
+  // the digits of its towers are the first digits of the keys
   if (c.size() == 2)  // case of automorphism or PRE
   {
     digitsC2 = c[1].CRTDecompose(relinWindow);
-    ct1 = digitsC2[0] * a[0];
+    ct1 = MultiplyByKey(digitsC2[0], a[0]);
   } else  // case of EvalMult
   {
     digitsC2 = c[2].CRTDecompose(relinWindow);
     ct1 = c[1];
     // Convert ct1 to evaluation representation
-    ct1.SwitchFormat();
-    ct1 += digitsC2[0] * a[0];
+    ct1.SetFormat(EVALUATION);
+    ct1 += MultiplyByKey(digitsC2[0], a[0]);
   }
 
-  ct0 += digitsC2[0] * b[0];
+  ct0 += MultiplyByKey(digitsC2[0], b[0]);
 
   for (usint i = 1; i < digitsC2.size(); ++i) {
-    ct0 += digitsC2[i] * b[i];
-    ct1 += digitsC2[i] * a[i];
+    ct0 += MultiplyByKey(digitsC2[i], b[i]);
+    ct1 += MultiplyByKey(digitsC2[i], a[i]);
   }
 
   newCiphertext->SetElements({ct0, ct1});
+  newCiphertext->SetLevel(cipherText->GetLevel());
 
   return newCiphertext;
 }
 
+template <>
+vector<Ciphertext<DCRTPoly>> LPAlgorithmSHEBFVrns<DCRTPoly>::EvalAtIndexBatch(
+    ConstCiphertext<DCRTPoly> ciphertext, const std::vector<int32_t> &indexList,
+    const std::map<usint, LPEvalKey<DCRTPoly>> &evalKeys) const {
+  const shared_ptr<LPCryptoParametersBFVrns<DCRTPoly>> cryptoParamsLWE =
+      std::dynamic_pointer_cast<LPCryptoParametersBFVrns<DCRTPoly>>(
+          ciphertext->GetCryptoParameters());
+
+  vector<Ciphertext<DCRTPoly>> result(indexList.size());
+  if (indexList.empty()) return result;
+
+  const std::vector<DCRTPoly> &c = ciphertext->GetElements();
+
+  // The hoisted automorphisms only apply to linear ciphertexts
+  if (c.size() != 2)
+    return LPSHEAlgorithm<DCRTPoly>::EvalAtIndexBatch(ciphertext, indexList,
+                                                      evalKeys);
+
+  uint32_t m = cryptoParamsLWE->GetElementParams()->GetCyclotomicOrder();
+
+  // Look up all keys first, so that missing keys are reported outside of the
+  // parallel loop
+  vector<usint> autoIndices(indexList.size());
+  vector<LPEvalKeyRelin<DCRTPoly>> keys(indexList.size());
+  for (size_t i = 0; i < indexList.size(); i++) {
+    if (indexList[i] == 0) continue;
+
+    if (!(m & (m - 1)))  // power-of-two cyclotomics
+      autoIndices[i] = FindAutomorphismIndex2n(indexList[i], m);
+    else  // cyclic-group cyclotomics
+      autoIndices[i] = FindAutomorphismIndexCyclic(
+          indexList[i], m,
+          cryptoParamsLWE->GetEncodingParams()->GetPlaintextGenerator());
+
+    auto fk = evalKeys.find(autoIndices[i]);
+    if (fk == evalKeys.end()) {
+      PALISADE_THROW(config_error, "Could not find an EvalKey for index " +
+                                       std::to_string(autoIndices[i]));
+    }
+    keys[i] = std::static_pointer_cast<LPEvalKeyRelinImpl<DCRTPoly>>(
+        fk->second);
+  }
+
+  // The automorphism of a digit decomposition of c1 is a digit decomposition
+  // of the automorphism of c1 with the same bound, so c1 is decomposed once
+  // for all indices.
+  std::vector<DCRTPoly> digitsC1 =
+      c[1].CRTDecompose(cryptoParamsLWE->GetRelinWindow());
+
+#pragma omp parallel for
+  for (size_t i = 0; i < indexList.size(); i++) {
+    if (indexList[i] == 0) {
+      result[i] = std::make_shared<CiphertextImpl<DCRTPoly>>(*ciphertext);
+      continue;
+    }
+
+    const std::vector<DCRTPoly> &b = keys[i]->GetAVector();
+    const std::vector<DCRTPoly> &a = keys[i]->GetBVector();
+
+    DCRTPoly ct0(c[0].AutomorphismTransform(autoIndices[i]));
+    DCRTPoly ct1;
+
+    for (usint k = 0; k < digitsC1.size(); ++k) {
+      DCRTPoly digit(digitsC1[k].AutomorphismTransform(autoIndices[i]));
+      ct0 += MultiplyByKey(digit, b[k]);
+      if (k == 0)
+        ct1 = MultiplyByKey(digit, a[k]);
+      else
+        ct1 += MultiplyByKey(digit, a[k]);
+    }
+
+    result[i] = ciphertext->CloneEmpty();
+    result[i]->SetElements({std::move(ct0), std::move(ct1)});
+    result[i]->SetLevel(ciphertext->GetLevel());
+  }
+
+  return result;
+}
+
 template <>
 Ciphertext<DCRTPoly> LPAlgorithmSHEBFVrns<DCRTPoly>::EvalMultAndRelinearize(
     ConstCiphertext<DCRTPoly> ciphertext1,
@@ -1481,12 +2018,37 @@ Ciphertext<DCRTPoly> LPAlgorithmSHEBFVrns<DCRTPoly>::EvalMultAndRelinearize(
     std::vector<DCRTPoly> digitsC2 = c[index + 2].CRTDecompose();
 
     for (usint i = 0; i < digitsC2.size(); ++i) {
-      ct0 += digitsC2[i] * b[i];
-      ct1 += digitsC2[i] * a[i];
+      ct0 += MultiplyByKey(digitsC2[i], b[i]);
+      ct1 += MultiplyByKey(digitsC2[i], a[i]);
     }
   }
 
   newCiphertext->SetElements({ct0, ct1});
+  newCiphertext->SetLevel(cipherText->GetLevel());
+
+  return newCiphertext;
+}
+
+template <>
+Ciphertext<DCRTPoly> LPLeveledSHEAlgorithmBFVrns<DCRTPoly>::LevelReduceInternal(
+    ConstCiphertext<DCRTPoly> cipherText1,
+    const LPEvalKey<DCRTPoly> linearKeySwitchHint, size_t levels) const {
+  const shared_ptr<LPCryptoParametersBFVrns<DCRTPoly>> cryptoParams =
+      std::dynamic_pointer_cast<LPCryptoParametersBFVrns<DCRTPoly>>(
+          cipherText1->GetCryptoParameters());
+
+  size_t level = LevelOf(*cryptoParams, cipherText1) + levels;
+  if (level >= cryptoParams->GetElementParams()->GetParams().size()) {
+    PALISADE_THROW(config_error,
+                   "There are not enough towers in the current ciphertext to "
+                   "perform the modulus reduction");
+  }
+
+  Ciphertext<DCRTPoly> newCiphertext = cipherText1->CloneEmpty();
+  newCiphertext->SetElements(
+      ElementsAtLevel(*cryptoParams, cipherText1, level));
+  newCiphertext->SetDepth(cipherText1->GetDepth());
+  newCiphertext->SetLevel(level);
 
   return newCiphertext;
 }
@@ -1498,6 +2060,10 @@ LPEvalKey<DCRTPoly> LPAlgorithmPREBFVrns<DCRTPoly>::ReKeyGen(
   // Get crypto context of new public key.
   auto cc = newPK->GetCryptoContext();
 
+  // The key is generated for all towers of Q; KeySwitch uses only the towers
+  // of the digits of a ciphertext, so the key also re-encrypts ciphertexts
+  // with dropped towers.
+
   // Create an evaluation key that will contain all the re-encryption key
   // elements.
   LPEvalKeyRelin<DCRTPoly> ek(new LPEvalKeyRelinImpl<DCRTPoly>(cc));
@@ -1638,7 +2204,8 @@ Ciphertext<DCRTPoly> LPAlgorithmPREBFVrns<DCRTPoly>::ReEncrypt(
 
     zeroCiphertext->SetElements({c0, c1});
 
-    // Add the encryption of zero for re-randomization purposes
+    // Add the encryption of zero for re-randomization purposes; EvalAdd brings
+    // the fresh encryption down to the level of the ciphertext
     auto c = ciphertext->GetCryptoContext()->GetEncryptionAlgorithm()->EvalAdd(
         ciphertext, zeroCiphertext);
 
@@ -1646,6 +2213,58 @@ Ciphertext<DCRTPoly> LPAlgorithmPREBFVrns<DCRTPoly>::ReEncrypt(
   }
 }
 
+template <>
+Ciphertext<DCRTPoly>
+LPAlgorithmMultipartyBFVrns<DCRTPoly>::MultipartyDecryptMain(
+    const LPPrivateKey<DCRTPoly> privateKey,
+    ConstCiphertext<DCRTPoly> ciphertext) const {
+  const shared_ptr<LPCryptoParametersBFVrns<DCRTPoly>> cryptoParams =
+      std::dynamic_pointer_cast<LPCryptoParametersBFVrns<DCRTPoly>>(
+          privateKey->GetCryptoParameters());
+
+  const std::vector<DCRTPoly> &c = ciphertext->GetElements();
+
+  // in the leveled mode, the key is restricted to the towers of the
+  // ciphertext
+  size_t level = LevelOf(*cryptoParams, ciphertext);
+  DCRTPoly s = privateKey->GetPrivateElement();
+  if (level > 0) s.DropLastElements(level);
+
+  DCRTPoly b = s * c[1];
+  b.SwitchFormat();
+
+  Ciphertext<DCRTPoly> newCiphertext = ciphertext->CloneEmpty();
+  newCiphertext->SetElements({b});
+
+  return newCiphertext;
+}
+
+template <>
+Ciphertext<DCRTPoly>
+LPAlgorithmMultipartyBFVrns<DCRTPoly>::MultipartyDecryptLead(
+    const LPPrivateKey<DCRTPoly> privateKey,
+    ConstCiphertext<DCRTPoly> ciphertext) const {
+  const shared_ptr<LPCryptoParametersBFVrns<DCRTPoly>> cryptoParams =
+      std::dynamic_pointer_cast<LPCryptoParametersBFVrns<DCRTPoly>>(
+          privateKey->GetCryptoParameters());
+
+  const std::vector<DCRTPoly> &c = ciphertext->GetElements();
+
+  // in the leveled mode, the key is restricted to the towers of the
+  // ciphertext
+  size_t level = LevelOf(*cryptoParams, ciphertext);
+  DCRTPoly s = privateKey->GetPrivateElement();
+  if (level > 0) s.DropLastElements(level);
+
+  DCRTPoly b = c[0] + s * c[1];
+  b.SwitchFormat();
+
+  Ciphertext<DCRTPoly> newCiphertext = ciphertext->CloneEmpty();
+  newCiphertext->SetElements({b});
+
+  return newCiphertext;
+}
+
 template <>
 DecryptResult LPAlgorithmMultipartyBFVrns<DCRTPoly>::MultipartyDecryptFusion(
     const vector<Ciphertext<DCRTPoly>> &ciphertextVec,
@@ -1653,32 +2272,39 @@ DecryptResult LPAlgorithmMultipartyBFVrns<DCRTPoly>::MultipartyDecryptFusion(
   const shared_ptr<LPCryptoParametersBFVrns<DCRTPoly>> cryptoParams =
       std::dynamic_pointer_cast<LPCryptoParametersBFVrns<DCRTPoly>>(
           ciphertextVec[0]->GetCryptoParameters());
-  const shared_ptr<typename DCRTPoly::Params> elementParams =
-      cryptoParams->GetElementParams();
 
   const auto &p = cryptoParams->GetPlaintextModulus();
 
+  // the partial decryptions have the towers of the decrypted ciphertext
+  size_t level = LevelOf(*cryptoParams, ciphertextVec[0]);
+  const LPCryptoParametersBFVrns<DCRTPoly> &paramsAtLevel =
+      cryptoParams->GetParamsAtLevel(level);
+
   const std::vector<DCRTPoly> &cElem = ciphertextVec[0]->GetElements();
   DCRTPoly b = cElem[0];
 
   size_t numCipher = ciphertextVec.size();
   for (size_t i = 1; i < numCipher; i++) {
+    if (LevelOf(*cryptoParams, ciphertextVec[i]) != level)
+      PALISADE_THROW(config_error,
+                     "BFVrns: the partial decryptions passed to "
+                     "MultipartyDecryptFusion are at different levels");
     const std::vector<DCRTPoly> &c2 = ciphertextVec[i]->GetElements();
     b += c2[0];
   }
 
   const std::vector<double> &lyamTable =
-      cryptoParams->GetCRTDecryptionFloatTable();
+      paramsAtLevel.GetCRTDecryptionFloatTable();
   const std::vector<long double> &lyamExtTable =
-      cryptoParams->GetCRTDecryptionExtFloatTable();
+      paramsAtLevel.GetCRTDecryptionExtFloatTable();
 #ifndef NO_QUADMATH
   const std::vector<QuadFloat> &lyamQuadTable =
-      cryptoParams->GetCRTDecryptionQuadFloatTable();
+      paramsAtLevel.GetCRTDecryptionQuadFloatTable();
 #endif
   const std::vector<NativeInteger> &invTable =
-      cryptoParams->GetCRTDecryptionIntTable();
+      paramsAtLevel.GetCRTDecryptionIntTable();
   const std::vector<NativeInteger> &invPreconTable =
-      cryptoParams->GetCRTDecryptionIntPreconTable();
+      paramsAtLevel.GetCRTDecryptionIntPreconTable();
 
   // this is the resulting vector of coefficients;
 #ifndef NO_QUADMATH
@@ -1696,6 +2322,7 @@ template class LPPublicKeyEncryptionSchemeBFVrns<DCRTPoly>;
 template class LPAlgorithmBFVrns<DCRTPoly>;
 template class LPAlgorithmPREBFVrns<DCRTPoly>;
 template class LPAlgorithmSHEBFVrns<DCRTPoly>;
+template class LPLeveledSHEAlgorithmBFVrns<DCRTPoly>;
 template class LPAlgorithmMultipartyBFVrns<DCRTPoly>;
 template class LPAlgorithmParamsGenBFVrns<DCRTPoly>;
 
@@ -165,8 +165,14 @@ void LPPublicKeyEncryptionSchemeBFVrns<Element>::Enable(
       PALISADE_THROW(not_implemented_error,
                      "FHE feature not supported for BFVrns scheme");
     case LEVELEDSHE:
-      PALISADE_THROW(not_implemented_error,
-                     "LEVELEDSHE feature not supported for BFVrns scheme");
+      if (this->m_algorithmEncryption == NULL)
+        this->m_algorithmEncryption.reset(new LPAlgorithmBFVrns<Element>());
+      if (this->m_algorithmSHE == NULL)
+        this->m_algorithmSHE.reset(new LPAlgorithmSHEBFVrns<Element>());
+      if (this->m_algorithmLeveledSHE == NULL)
+        this->m_algorithmLeveledSHE.reset(
+            new LPLeveledSHEAlgorithmBFVrns<Element>());
+      break;
     case ADVANCEDSHE:
       PALISADE_THROW(not_implemented_error,
                      "ADVANCEDSHE feature not supported for BFVrns scheme");
@@ -196,6 +202,35 @@ Ciphertext<Element> LPAlgorithmPREBFVrns<Element>::ReEncrypt(
   return LPAlgorithmPREBFV<Element>::ReEncrypt(EK, ciphertext, publicKey);
 }
 
+template <class Element>
+Ciphertext<Element> LPLeveledSHEAlgorithmBFVrns<Element>::ModReduce(
+    ConstCiphertext<Element> cipherText) const {
+  return ModReduceInternal(cipherText);
+}
+
+template <class Element>
+Ciphertext<Element> LPLeveledSHEAlgorithmBFVrns<Element>::ModReduceInternal(
+    ConstCiphertext<Element> cipherText) const {
+  return LevelReduceInternal(cipherText, nullptr, 1);
+}
+
+template <class Element>
+Ciphertext<Element> LPLeveledSHEAlgorithmBFVrns<Element>::ComposedEvalMult(
+    ConstCiphertext<Element> cipherText1, ConstCiphertext<Element> cipherText2,
+    const LPEvalKey<Element> quadKeySwitchHint) const {
+  auto algo = cipherText1->GetCryptoContext()->GetEncryptionAlgorithm();
+
+  return ModReduceInternal(
+      algo->EvalMult(cipherText1, cipherText2, quadKeySwitchHint));
+}
+
+template <class Element>
+Ciphertext<Element> LPLeveledSHEAlgorithmBFVrns<Element>::LevelReduce(
+    ConstCiphertext<Element> cipherText1,
+    const LPEvalKey<Element> linearKeySwitchHint, size_t levels) const {
+  return LevelReduceInternal(cipherText1, linearKeySwitchHint, levels);
+}
+
 }  // namespace lbcrypto
 
 #endif
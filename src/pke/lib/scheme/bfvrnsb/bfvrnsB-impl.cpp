@@ -28,8 +28,6 @@
 #include "cryptocontext.h"
 #include "bfvrnsB.cpp"
 
-//#define USE_KARATSUBA
-
 namespace lbcrypto {
 
 #define NOPOLY                                                                 \
@@ -196,6 +194,18 @@ Ciphertext<NativePoly> LPAlgorithmSHEBFVrnsB<NativePoly>::EvalMult(
   NONATIVEPOLY
 }
 
+template <>
+Ciphertext<Poly> LPAlgorithmSHEBFVrnsB<Poly>::EvalSquare(
+    ConstCiphertext<Poly> ciphertext) const {
+  NOPOLY
+}
+
+template <>
+Ciphertext<NativePoly> LPAlgorithmSHEBFVrnsB<NativePoly>::EvalSquare(
+    ConstCiphertext<NativePoly> ciphertext) const {
+  NONATIVEPOLY
+}
+
 template <>
 Ciphertext<Poly> LPAlgorithmSHEBFVrnsB<Poly>::EvalAdd(ConstCiphertext<Poly> ct,
                                                       ConstPlaintext pt) const {
@@ -1163,6 +1173,120 @@ Ciphertext<DCRTPoly> LPAlgorithmSHEBFVrnsB<DCRTPoly>::EvalSub(
   return newCiphertext;
 }
 
+namespace {
+
+// Expands the CRT basis of ciphertext elements from q to {q U Bsk} in place;
+// the elements are output in EVALUATION representation
+void ExpandToBsk(const LPCryptoParametersBFVrnsB<DCRTPoly> &cryptoParams,
+                 std::vector<DCRTPoly> &c) {
+  for (size_t i = 0; i < c.size(); i++) {
+    c[i].FastBaseConvqToBskMontgomery(
+        cryptoParams.GetDCRTParamsBsk(), cryptoParams.GetDCRTParamsqModuli(),
+        cryptoParams.GetDCRTParamsBskmtildeModuli(),
+        cryptoParams.GetDCRTParamsBskmtildeModulimu(),
+        cryptoParams.GetDCRTParamsmtildeqDivqiModqi(),
+        cryptoParams.GetDCRTParamsmtildeqDivqiModqiPrecon(),
+        cryptoParams.GetDCRTParamsqDivqiModBskmtilde(),
+        cryptoParams.GetDCRTParamsqModBski(),
+        cryptoParams.GetDCRTParamsqModBskiPrecon(),
+        cryptoParams.GetDCRTParamsnegqInvModmtilde(),
+        cryptoParams.GetDCRTParamsnegqInvModmtildePrecon(),
+        cryptoParams.GetDCRTParamsmtildeInvModBskiTable(),
+        cryptoParams.GetDCRTParamsmtildeInvModBskiPreconTable());
+    if (c[i].GetFormat() == COEFFICIENT) {
+      c[i].SwitchFormat();
+    }
+  }
+}
+
+// Performs the RNS approximate flooring of t/q times the elements of a tensor
+// product in {q U Bsk}, and brings the result back to the CRT basis q
+void FloorToq(const LPCryptoParametersBFVrnsB<DCRTPoly> &cryptoParams,
+              std::vector<DCRTPoly> &c) {
+  for (size_t i = 0; i < c.size(); i++) {
+    // converts to coefficient representation before rounding
+    c[i].SwitchFormat();
+    // Performs the scaling by t/q followed by rounding; the result is in the
+    // CRT basis Bsk
+    c[i].FastRNSFloorq(cryptoParams.GetPlaintextModulus(),
+                       cryptoParams.GetDCRTParamsqModuli(),
+                       cryptoParams.GetDCRTParamsBskModuli(),
+                       cryptoParams.GetDCRTParamsBskModulimu(),
+                       cryptoParams.GetDCRTParamstqDivqiModqiTable(),
+                       cryptoParams.GetDCRTParamstqDivqiModqiPreconTable(),
+                       cryptoParams.GetDCRTParamsqDivqiModBskmtilde(),
+                       cryptoParams.GetDCRTParamsqInvModBiTable(),
+                       cryptoParams.GetDCRTParamsqInvModBiPreconTable());
+    // Converts from the CRT basis Bsk to q
+    c[i].FastBaseConvSK(
+        cryptoParams.GetDCRTParamsqModuli(),
+        cryptoParams.GetDCRTParamsqModulimu(),
+        cryptoParams.GetDCRTParamsBskModuli(),
+        cryptoParams.GetDCRTParamsBskModulimu(), cryptoParams.GetBDivBiModBi(),
+        cryptoParams.GetBDivBiModBiPrecon(), cryptoParams.GetBDivBiModmsk(),
+        cryptoParams.GetBInvModmsk(), cryptoParams.GetBInvModmskPrecon(),
+        cryptoParams.GetBDivBiModqj(), cryptoParams.GetBModqi(),
+        cryptoParams.GetBModqiPrecon());
+  }
+}
+
+}  // namespace
+
+template <>
+Ciphertext<DCRTPoly> LPAlgorithmSHEBFVrnsB<DCRTPoly>::EvalSquare(
+    ConstCiphertext<DCRTPoly> ciphertext) const {
+  Ciphertext<DCRTPoly> newCiphertext = ciphertext->CloneEmpty();
+
+  const shared_ptr<LPCryptoParametersBFVrnsB<DCRTPoly>> cryptoParamsBFVrnsB =
+      std::dynamic_pointer_cast<LPCryptoParametersBFVrnsB<DCRTPoly>>(
+          ciphertext->GetCryptoContext()->GetCryptoParameters());
+
+  // The elements are copied once, as the basis expansion is done in place
+  std::vector<DCRTPoly> cipherTextElements = ciphertext->GetElements();
+  ExpandToBsk(*cryptoParamsBFVrnsB, cipherTextElements);
+
+  size_t cipherTextElementsSize = cipherTextElements.size();
+  size_t cipherTextRElementsSize = 2 * cipherTextElementsSize - 1;
+
+  std::vector<DCRTPoly> c(cipherTextRElementsSize);
+
+  if (cipherTextElementsSize == 2) {
+    // c0^2, 2*c0*c1 and c1^2; the expanded c0 is reused for the cross term
+    c[0] = cipherTextElements[0] * cipherTextElements[0];
+    c[2] = cipherTextElements[1] * cipherTextElements[1];
+
+    cipherTextElements[0] *= cipherTextElements[1];
+    cipherTextElements[0] += cipherTextElements[0];
+    c[1] = std::move(cipherTextElements[0]);
+  } else {
+    bool *isFirstAdd = new bool[cipherTextRElementsSize];
+    std::fill_n(isFirstAdd, cipherTextRElementsSize, true);
+
+    // Each cross product with i < j appears twice in the square
+    for (size_t i = 0; i < cipherTextElementsSize; i++) {
+      for (size_t j = i; j < cipherTextElementsSize; j++) {
+        DCRTPoly prod = cipherTextElements[i] * cipherTextElements[j];
+        if (i != j) prod += prod;
+        if (isFirstAdd[i + j] == true) {
+          c[i + j] = std::move(prod);
+          isFirstAdd[i + j] = false;
+        } else {
+          c[i + j] += prod;
+        }
+      }
+    }
+
+    delete[] isFirstAdd;
+  }
+
+  FloorToq(*cryptoParamsBFVrnsB, c);
+
+  newCiphertext->SetElements(std::move(c));
+  newCiphertext->SetDepth(2 * ciphertext->GetDepth());
+
+  return newCiphertext;
+}
+
 template <>
 Ciphertext<DCRTPoly> LPAlgorithmSHEBFVrnsB<DCRTPoly>::EvalMult(
     ConstCiphertext<DCRTPoly> ciphertext1,
@@ -1174,6 +1298,8 @@ Ciphertext<DCRTPoly> LPAlgorithmSHEBFVrnsB<DCRTPoly>::EvalMult(
     PALISADE_THROW(config_error, errMsg);
   }
 
+  if (ciphertext1 == ciphertext2) return EvalSquare(ciphertext1);
+
   Ciphertext<DCRTPoly> newCiphertext = ciphertext1->CloneEmpty();
 
   const shared_ptr<LPCryptoParametersBFVrnsB<DCRTPoly>> cryptoParamsBFVrnsB =
@@ -1191,88 +1317,25 @@ Ciphertext<DCRTPoly> LPAlgorithmSHEBFVrnsB<DCRTPoly>::EvalMult(
 
   std::vector<DCRTPoly> c(cipherTextRElementsSize);
 
-  const shared_ptr<typename DCRTPoly::Params> elementParams =
-      cryptoParamsBFVrnsB->GetElementParams();
-  const shared_ptr<ILDCRTParams<BigInteger>> paramsBsk =
-      cryptoParamsBFVrnsB->GetDCRTParamsBsk();
-  const std::vector<NativeInteger> &paramsqModuli =
-      cryptoParamsBFVrnsB->GetDCRTParamsqModuli();
-  const std::vector<DoubleNativeInt> &paramsqModulimu =
-      cryptoParamsBFVrnsB->GetDCRTParamsqModulimu();
-  const std::vector<NativeInteger> &paramsBskModuli =
-      cryptoParamsBFVrnsB->GetDCRTParamsBskModuli();
-  const std::vector<DoubleNativeInt> &paramsBskModulimu =
-      cryptoParamsBFVrnsB->GetDCRTParamsBskModulimu();
-  const std::vector<NativeInteger> &paramsBskmtildeModuli =
-      cryptoParamsBFVrnsB->GetDCRTParamsBskmtildeModuli();
-  const std::vector<DoubleNativeInt> &paramsBskmtildeModulimu =
-      cryptoParamsBFVrnsB->GetDCRTParamsBskmtildeModulimu();
-  const std::vector<NativeInteger> &paramsmtildeqDivqiModqi =
-      cryptoParamsBFVrnsB->GetDCRTParamsmtildeqDivqiModqi();
-  const std::vector<NativeInteger> &paramsmtildeqDivqiModqiPrecon =
-      cryptoParamsBFVrnsB->GetDCRTParamsmtildeqDivqiModqiPrecon();
-  const std::vector<std::vector<NativeInteger>> &paramsqDivqiModBskmtilde =
-      cryptoParamsBFVrnsB->GetDCRTParamsqDivqiModBskmtilde();
-  const std::vector<NativeInteger> &paramsqModBski =
-      cryptoParamsBFVrnsB->GetDCRTParamsqModBski();
-  const std::vector<NativeInteger> &paramsqModBskiPrecon =
-      cryptoParamsBFVrnsB->GetDCRTParamsqModBskiPrecon();
-  const NativeInteger &paramsnegqInvModmtilde =
-      cryptoParamsBFVrnsB->GetDCRTParamsnegqInvModmtilde();
-  const NativeInteger &paramsnegqInvModmtildePrecon =
-      cryptoParamsBFVrnsB->GetDCRTParamsnegqInvModmtildePrecon();
-  const std::vector<NativeInteger> &paramsmtildeInvModBskiTable =
-      cryptoParamsBFVrnsB->GetDCRTParamsmtildeInvModBskiTable();
-  const std::vector<NativeInteger> &paramsmtildeInvModBskiPreconTable =
-      cryptoParamsBFVrnsB->GetDCRTParamsmtildeInvModBskiPreconTable();
-
-  // Expands the CRT basis to q*Bsk; Outputs the polynomials in coeff
+  // Expands the CRT basis to q*Bsk; Outputs the polynomials in EVALUATION
   // representation
-
-  for (size_t i = 0; i < cipherText1ElementsSize; i++) {
-    cipherText1Elements[i].FastBaseConvqToBskMontgomery(
-        paramsBsk, paramsqModuli, paramsBskmtildeModuli,
-        paramsBskmtildeModulimu, paramsmtildeqDivqiModqi,
-        paramsmtildeqDivqiModqiPrecon, paramsqDivqiModBskmtilde, paramsqModBski,
-        paramsqModBskiPrecon, paramsnegqInvModmtilde,
-        paramsnegqInvModmtildePrecon, paramsmtildeInvModBskiTable,
-        paramsmtildeInvModBskiPreconTable);
-    if (cipherText1Elements[i].GetFormat() == COEFFICIENT) {
-      cipherText1Elements[i].SwitchFormat();
-    }
-  }
-
-  for (size_t i = 0; i < cipherText2ElementsSize; i++) {
-    cipherText2Elements[i].FastBaseConvqToBskMontgomery(
-        paramsBsk, paramsqModuli, paramsBskmtildeModuli,
-        paramsBskmtildeModulimu, paramsmtildeqDivqiModqi,
-        paramsmtildeqDivqiModqiPrecon, paramsqDivqiModBskmtilde, paramsqModBski,
-        paramsqModBskiPrecon, paramsnegqInvModmtilde,
-        paramsnegqInvModmtildePrecon, paramsmtildeInvModBskiTable,
-        paramsmtildeInvModBskiPreconTable);
-    if (cipherText2Elements[i].GetFormat() == COEFFICIENT) {
-      cipherText2Elements[i].SwitchFormat();
-    }
-  }
+  ExpandToBsk(*cryptoParamsBFVrnsB, cipherText1Elements);
+  ExpandToBsk(*cryptoParamsBFVrnsB, cipherText2Elements);
 
   // Performs the multiplication itself
-
-#ifdef USE_KARATSUBA
-
-  if (cipherText1ElementsSize == 2 &&
-      cipherText2ElementsSize ==
-          2)  // size of each ciphertxt = 2, use Karatsuba
-  {
-    c[0] = cipherText1Elements[0] * cipherText2Elements[0];  // a
-    c[2] = cipherText1Elements[1] * cipherText2Elements[1];  // b
-
-    c[1] = cipherText1Elements[0] + cipherText1Elements[1];
-    c[1] *= (cipherText2Elements[0] + cipherText2Elements[1]);
-    c[1] -= c[2];
+  if (cipherText1ElementsSize == 2 && cipherText2ElementsSize == 2) {
+    // Karatsuba: the middle term is (a0 + a1)(b0 + b1) - a0*b0 - a1*b1; the
+    // expanded a0 and b0 are local copies and hold the sums
+    c[0] = cipherText1Elements[0] * cipherText2Elements[0];
+    c[2] = cipherText1Elements[1] * cipherText2Elements[1];
+
+    cipherText1Elements[0] += cipherText1Elements[1];
+    cipherText2Elements[0] += cipherText2Elements[1];
+    c[1] = std::move(cipherText1Elements[0]);
+    c[1] *= cipherText2Elements[0];
     c[1] -= c[0];
-
-  } else  // if size of any of the ciphertexts > 2
-  {
+    c[1] -= c[2];
+  } else {  // if size of any of the ciphertexts > 2
     bool *isFirstAdd = new bool[cipherTextRElementsSize];
     std::fill_n(isFirstAdd, cipherTextRElementsSize, true);
 
@@ -1290,71 +1353,10 @@ Ciphertext<DCRTPoly> LPAlgorithmSHEBFVrnsB<DCRTPoly>::EvalMult(
     delete[] isFirstAdd;
   }
 
-#else
-  bool *isFirstAdd = new bool[cipherTextRElementsSize];
-  std::fill_n(isFirstAdd, cipherTextRElementsSize, true);
-
-  for (size_t i = 0; i < cipherText1ElementsSize; i++) {
-    for (size_t j = 0; j < cipherText2ElementsSize; j++) {
-      if (isFirstAdd[i + j] == true) {
-        c[i + j] = cipherText1Elements[i] * cipherText2Elements[j];
-        isFirstAdd[i + j] = false;
-      } else {
-        c[i + j] += cipherText1Elements[i] * cipherText2Elements[j];
-      }
-    }
-  }
+  // perform RNS approximate Flooring and convert back to q
+  FloorToq(*cryptoParamsBFVrnsB, c);
 
-  delete[] isFirstAdd;
-#endif
-
-  // perfrom RNS approximate Flooring
-  const NativeInteger &paramsPlaintextModulus =
-      cryptoParamsBFVrnsB->GetPlaintextModulus();
-  const std::vector<NativeInteger> &paramstqDivqiModqi =
-      cryptoParamsBFVrnsB->GetDCRTParamstqDivqiModqiTable();
-  const std::vector<NativeInteger> &paramstqDivqiModqiPrecon =
-      cryptoParamsBFVrnsB->GetDCRTParamstqDivqiModqiPreconTable();
-  const std::vector<NativeInteger> &paramsqInvModBi =
-      cryptoParamsBFVrnsB->GetDCRTParamsqInvModBiTable();
-  const std::vector<NativeInteger> &paramsqInvModBiPrecon =
-      cryptoParamsBFVrnsB->GetDCRTParamsqInvModBiPreconTable();
-
-  // perform FastBaseConvSK
-  const std::vector<NativeInteger> &paramsBDivBiModBi =
-      cryptoParamsBFVrnsB->GetBDivBiModBi();
-  const std::vector<NativeInteger> &paramsBDivBiModBiPrecon =
-      cryptoParamsBFVrnsB->GetBDivBiModBiPrecon();
-  const std::vector<NativeInteger> &paramsBDivBiModmsk =
-      cryptoParamsBFVrnsB->GetBDivBiModmsk();
-  const NativeInteger &paramsBInvModmsk = cryptoParamsBFVrnsB->GetBInvModmsk();
-  const NativeInteger &paramsBInvModmskPrecon =
-      cryptoParamsBFVrnsB->GetBInvModmskPrecon();
-  const std::vector<std::vector<NativeInteger>> &paramsBDivBiModqj =
-      cryptoParamsBFVrnsB->GetBDivBiModqj();
-  const std::vector<NativeInteger> &paramsBModqi =
-      cryptoParamsBFVrnsB->GetBModqi();
-  const std::vector<NativeInteger> &paramsBModqiPrecon =
-      cryptoParamsBFVrnsB->GetBModqiPrecon();
-
-  for (size_t i = 0; i < cipherTextRElementsSize; i++) {
-    // converts to coefficient representation before rounding
-    c[i].SwitchFormat();
-    // Performs the scaling by t/q followed by rounding; the result is in the
-    // CRT basis Bsk
-    c[i].FastRNSFloorq(paramsPlaintextModulus, paramsqModuli, paramsBskModuli,
-                       paramsBskModulimu, paramstqDivqiModqi,
-                       paramstqDivqiModqiPrecon, paramsqDivqiModBskmtilde,
-                       paramsqInvModBi, paramsqInvModBiPrecon);
-    // Converts from the CRT basis Bsk to q
-    c[i].FastBaseConvSK(paramsqModuli, paramsqModulimu, paramsBskModuli,
-                        paramsBskModulimu, paramsBDivBiModBi,
-                        paramsBDivBiModBiPrecon, paramsBDivBiModmsk,
-                        paramsBInvModmsk, paramsBInvModmskPrecon,
-                        paramsBDivBiModqj, paramsBModqi, paramsBModqiPrecon);
-  }
-
-  newCiphertext->SetElements(c);
+  newCiphertext->SetElements(std::move(c));
   newCiphertext->SetDepth((ciphertext1->GetDepth() + ciphertext2->GetDepth()));
 
   return newCiphertext;
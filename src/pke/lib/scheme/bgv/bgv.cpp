@@ -530,7 +530,13 @@ Ciphertext<Element> LPAlgorithmSHEBGV<Element>::EvalAutomorphism(
 
   permutedCiphertext->SetElements(std::move(cNew));
 
-  return this->KeySwitch(evalKeys.find(i)->second, permutedCiphertext);
+  auto fk = evalKeys.find(i);
+  if (fk == evalKeys.end()) {
+    PALISADE_THROW(config_error,
+                   "Could not find an EvalKey for index " + std::to_string(i));
+  }
+
+  return this->KeySwitch(fk->second, permutedCiphertext);
 }
 
 template <class Element>
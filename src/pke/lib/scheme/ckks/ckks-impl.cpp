@@ -608,6 +608,23 @@ bool LPCryptoParametersCKKS<DCRTPoly>::PrecomputeCRTTables(
     m_paramsQP = shared_ptr<ILDCRTParams<BigInteger>>(
         new ILDCRTParams<BigInteger>(2 * n, moduliExpanded, rootsExpanded));
 
+    // 7a./H.8a. Create the extended CRT bases Q_l P of every level
+    m_paramsQlP = vector<shared_ptr<ILDCRTParams<BigInteger>>>(numPrimesQ);
+    for (size_t l = 0; l < numPrimesQ; l++) {
+      vector<NativeInteger> moduliQlP(l + 1 + numPrimesP);
+      vector<NativeInteger> rootsQlP(l + 1 + numPrimesP);
+      for (size_t i = 0; i <= l; i++) {
+        moduliQlP[i] = moduliQ[i];
+        rootsQlP[i] = rootsQ[i];
+      }
+      for (size_t i = 0; i < numPrimesP; i++) {
+        moduliQlP[l + 1 + i] = moduliP[i];
+        rootsQlP[l + 1 + i] = rootsP[i];
+      }
+      m_paramsQlP[l] = shared_ptr<ILDCRTParams<BigInteger>>(
+          new ILDCRTParams<BigInteger>(2 * n, moduliQlP, rootsQlP));
+    }
+
     // 8./H.9. Pre-compute CRT::FFT values for P
     ChineseRemainderTransformFTT<NativeVector>::PreCompute(rootsP, 2 * n,
                                                            moduliP);
@@ -715,12 +732,16 @@ bool LPCryptoParametersCKKS<DCRTPoly>::PrecomputeCRTTables(
           vector<vector<shared_ptr<ILDCRTParams<BigInteger>>>>(numPrimesQ);
       this->m_modBarrettPreconComplPartition =
           vector<vector<vector<DoubleNativeInt>>>(numPrimesQ);
+      this->m_partitionsModuliCl =
+          vector<vector<shared_ptr<ILDCRTParams<BigInteger>>>>(numPrimesQ);
       for (int32_t l = numPrimesQ - 1; l >= 0; l--) {
         uint32_t beta = ceil((double)(l + 1) / alpha);
         this->m_complementaryPartitions[l] =
             vector<shared_ptr<ILDCRTParams<BigInteger>>>(beta);
         this->m_modBarrettPreconComplPartition[l] =
             vector<vector<DoubleNativeInt>>(beta);
+        this->m_partitionsModuliCl[l] =
+            vector<shared_ptr<ILDCRTParams<BigInteger>>>(beta);
 
         for (uint32_t j = 0; j < beta; j++) {
           const shared_ptr<ILDCRTParams<BigInteger>> digitPartition =
@@ -729,6 +750,22 @@ bool LPCryptoParametersCKKS<DCRTPoly>::PrecomputeCRTTables(
 
           uint32_t digitPartitionSize = digitPartition->GetParams().size();
           if (j == beta - 1) digitPartitionSize = (l + 1) - j * alpha;
+
+          // H.17a. Pre-compute the partition of digit j at level l
+          if (digitPartitionSize == digitPartition->GetParams().size()) {
+            this->m_partitionsModuliCl[l][j] = digitPartition;
+          } else {
+            vector<NativeInteger> moduliDigit(digitPartitionSize);
+            vector<NativeInteger> rootsDigit(digitPartitionSize);
+            for (uint32_t i = 0; i < digitPartitionSize; i++) {
+              moduliDigit[i] = digitPartition->GetParams()[i]->GetModulus();
+              rootsDigit[i] = digitPartition->GetParams()[i]->GetRootOfUnity();
+            }
+            this->m_partitionsModuliCl[l][j] =
+                make_shared<typename DCRTPoly::Params>(cyclOrder, moduliDigit,
+                                                       rootsDigit);
+          }
+
           // Compl basis size = (l+1) - digitPartition.size() + numPrimesP
           uint32_t complementaryBasisSize =
               (l + 1) - digitPartitionSize + numPrimesP;
@@ -1424,6 +1461,11 @@ LPEvalKey<DCRTPoly> LPAlgorithmSHECKKS<DCRTPoly>::KeySwitchHybridGen(
 template <>
 Ciphertext<DCRTPoly> LPAlgorithmSHECKKS<DCRTPoly>::KeySwitchHybrid(
     const LPEvalKey<DCRTPoly> ek, ConstCiphertext<DCRTPoly> cipherText) const {
+  // reuse the storage of the temporaries over the digits of this call; the
+  // caches are dropped when the last scope ends, so nothing is kept between
+  // calls that are not nested in an outer scope
+  ScopedVectorPool pool;
+
   Ciphertext<DCRTPoly> newCiphertext = cipherText->CloneEmpty();
 
   const shared_ptr<LPCryptoParametersCKKS<DCRTPoly>> cryptoParamsLWE =
@@ -1467,38 +1509,17 @@ Ciphertext<DCRTPoly> LPAlgorithmSHECKKS<DCRTPoly>::KeySwitchHybrid(
   // uint32_t digits = cryptoParamsLWE->GetNumberOfDigits();
   if (beta > cryptoParamsLWE->GetNumberOfQPartitions())
     beta = cryptoParamsLWE->GetNumberOfQPartitions();
+  const shared_ptr<typename DCRTPoly::Params> paramsQlP =
+      cryptoParamsLWE->GetParamsQlP(l);
 
   vector<DCRTPoly> digitsCTmp(beta);
 
   // Digit decomposition
   // Zero-padding and split
-  uint32_t numTowersLastDigit =
-      cryptoParamsLWE->GetQPartition(beta - 1)->GetParams().size();
+  uint32_t numTowersLastDigit = cipherTowers - alpha * (beta - 1);
   for (uint32_t j = 0; j < beta; j++) {
-    if (j == beta - 1) {
-      auto part = cryptoParamsLWE->GetQPartition(j);
-      part->GetParams();
-
-      numTowersLastDigit = cipherTowers - alpha * j;
-
-      vector<NativeInteger> moduli(numTowersLastDigit);
-      vector<NativeInteger> roots(numTowersLastDigit);
-
-      for (uint32_t i = 0; i < numTowersLastDigit; i++) {
-        moduli[i] = part->GetParams()[i]->GetModulus();
-        roots[i] = part->GetParams()[i]->GetRootOfUnity();
-      }
-
-      auto params = DCRTPoly::Params(part->GetCyclotomicOrder(), moduli, roots,
-                                     {}, {}, 0);
-
-      digitsCTmp[j] =
-          DCRTPoly(std::make_shared<typename DCRTPoly::Params>(params),
-                   EVALUATION, true);
-
-    } else
-      digitsCTmp[j] =
-          DCRTPoly(cryptoParamsLWE->GetQPartition(j), Format::EVALUATION, true);
+    digitsCTmp[j] = DCRTPoly(cryptoParamsLWE->GetQlPartition(l, j),
+                             Format::EVALUATION, true);
 
     uint32_t iters = (j == beta - 1) ? numTowersLastDigit : alpha;
     for (uint32_t i = 0; i < iters; i++) {
@@ -1540,8 +1561,7 @@ Ciphertext<DCRTPoly> LPAlgorithmSHECKKS<DCRTPoly>::KeySwitchHybrid(
 
     pPartExtC[j].SetFormat(Format::EVALUATION);
 
-    expandedC[j] =
-        DCRTPoly(cTmp.GetExtendedCRTBasis(paramsP), Format::EVALUATION, true);
+    expandedC[j] = DCRTPoly(paramsQlP, Format::EVALUATION, true);
 
     for (usint i = 0; i < cipherTowers; i++) {
       if (i / alpha == j)
@@ -1565,8 +1585,8 @@ Ciphertext<DCRTPoly> LPAlgorithmSHECKKS<DCRTPoly>::KeySwitchHybrid(
     }
   }
 
-  DCRTPoly cTilda0(cTmp.GetExtendedCRTBasis(paramsP), Format::EVALUATION, true);
-  DCRTPoly cTilda1(cTmp.GetExtendedCRTBasis(paramsP), Format::EVALUATION, true);
+  DCRTPoly cTilda0(paramsQlP, Format::EVALUATION, true);
+  DCRTPoly cTilda1(paramsQlP, Format::EVALUATION, true);
 
   for (uint32_t j = 0; j < digitsCTmp.size(); j++) {
     for (usint i = 0; i < expandedC[j].GetNumOfElements(); i++) {
@@ -1738,8 +1758,8 @@ Ciphertext<DCRTPoly> LPAlgorithmSHECKKS<DCRTPoly>::KeySwitchGHS(
       cryptoParamsLWE->GetModBarretPreconPTable());
   pPartExtC.SetFormat(Format::EVALUATION);
 
-  DCRTPoly expandedC(cTmp.GetExtendedCRTBasis(paramsP), Format::EVALUATION,
-                     true);
+  DCRTPoly expandedC(cryptoParamsLWE->GetParamsQlP(cipherTowers - 1),
+                     Format::EVALUATION, true);
   for (usint i = 0; i < expandedC.GetNumOfElements(); i++) {
     if (i < cipherTowers)
       expandedC.SetElementAtIndex(i, cOrig.GetElementAtIndex(i));
@@ -3146,19 +3166,53 @@ Ciphertext<DCRTPoly> LPAlgorithmSHECKKS<DCRTPoly>::EvalMultMutable(
   }
 }
 
+template <>
+Ciphertext<DCRTPoly> LPAlgorithmSHECKKS<DCRTPoly>::EvalSquare(
+    ConstCiphertext<DCRTPoly> ciphertext) const {
+  const shared_ptr<LPCryptoParametersCKKS<DCRTPoly>> cryptoParams =
+      std::dynamic_pointer_cast<LPCryptoParametersCKKS<DCRTPoly>>(
+          ciphertext->GetCryptoParameters());
+
+  // In the case of EXACT RNS rescaling, the input is first brought to depth 1
+  if (cryptoParams->GetRescalingTechnique() == EXACTRESCALE &&
+      ciphertext->GetDepth() > 1) {
+    auto algo = ciphertext->GetCryptoContext()->GetEncryptionAlgorithm();
+    return LPAlgorithmSHECKKS<DCRTPoly>::EvalSquareCore(
+        algo->ModReduceInternal(ciphertext));
+  }
+
+  return LPAlgorithmSHECKKS<DCRTPoly>::EvalSquareCore(ciphertext);
+}
+
 template <>
 Ciphertext<DCRTPoly> LPAlgorithmSHECKKS<DCRTPoly>::EvalMult(
     ConstCiphertext<DCRTPoly> ciphertext1,
     ConstCiphertext<DCRTPoly> ciphertext2) const {
+  if (ciphertext1 == ciphertext2) return EvalSquare(ciphertext1);
+
   const shared_ptr<LPCryptoParametersCKKS<DCRTPoly>> cryptoParams =
       std::dynamic_pointer_cast<LPCryptoParametersCKKS<DCRTPoly>>(
           ciphertext1->GetCryptoParameters());
 
   if (cryptoParams->GetRescalingTechnique() == EXACTRESCALE) {
-    Ciphertext<DCRTPoly> c1 = ciphertext1->Clone();
-    Ciphertext<DCRTPoly> c2 = ciphertext2->Clone();
+    // Rescaling produces new ciphertexts, so the inputs are only copied for
+    // EvalMultMutable when one of them has to be brought to the level of the
+    // other
+    CryptoContext<DCRTPoly> cc = ciphertext1->GetCryptoContext();
+    auto algo = cc->GetEncryptionAlgorithm();
 
-    return EvalMultMutable(c1, c2);
+    ConstCiphertext<DCRTPoly> c1 = ciphertext1;
+    ConstCiphertext<DCRTPoly> c2 = ciphertext2;
+    if (c1->GetDepth() > 1) c1 = algo->ModReduceInternal(c1);
+    if (c2->GetDepth() > 1) c2 = algo->ModReduceInternal(c2);
+
+    if (c1->GetLevel() == c2->GetLevel())
+      return LPAlgorithmSHECKKS<DCRTPoly>::EvalMultCore(c1, c2);
+
+    Ciphertext<DCRTPoly> m1 = c1->Clone();
+    Ciphertext<DCRTPoly> m2 = c2->Clone();
+
+    return EvalMultMutable(m1, m2);
 
   } else {  // Approximate rescaling
     return EvalMultApprox(ciphertext1, ciphertext2);
@@ -3430,6 +3484,196 @@ Ciphertext<DCRTPoly> LPAlgorithmSHECKKS<DCRTPoly>::EvalLinearWSum(
   return EvalLinearWSumMutable(cts, constants);
 }
 
+// Adds a real constant to a ciphertext; EvalAdd(ciphertext, double) scales
+// the constant into an unsigned integer, so negative constants are
+// subtracted instead
+static Ciphertext<DCRTPoly> AddConstant(
+    const shared_ptr<LPPublicKeyEncryptionScheme<DCRTPoly>> &algo,
+    ConstCiphertext<DCRTPoly> ciphertext, double constant) {
+  return (constant >= 0) ? algo->EvalAdd(ciphertext, constant)
+                         : algo->EvalSub(ciphertext, -constant);
+}
+
+// Returns x^e, or T_e(x) for the Chebyshev basis, from the cache of powers.
+// A missing power is computed from two cached powers of at most half its
+// degree, so x^e consumes ceil(log2(e)) levels.
+static Ciphertext<DCRTPoly> GetCachedPower(
+    std::map<uint32_t, Ciphertext<DCRTPoly>> *powers, uint32_t e,
+    bool chebyshev,
+    const shared_ptr<LPPublicKeyEncryptionScheme<DCRTPoly>> &algo,
+    const LPEvalKey<DCRTPoly> &evalKey) {
+  auto it = powers->find(e);
+  if (it != powers->end()) return it->second;
+
+  // e = a + b, where a is the smallest power of two with 2a >= e
+  uint32_t a = 1;
+  while (2 * a < e) a <<= 1;
+  uint32_t b = e - a;
+
+  auto xa = GetCachedPower(powers, a, chebyshev, algo, evalKey);
+  auto xb = GetCachedPower(powers, b, chebyshev, algo, evalKey);
+  auto result = algo->ModReduceInternal(algo->EvalMult(xa, xb, evalKey));
+
+  if (chebyshev) {
+    // T_{a+b} = 2 T_a T_b - T_{a-b}
+    result = algo->EvalAdd(result, result);
+    if (a == b)
+      result = algo->EvalSub(result, 1.0);
+    else
+      result = algo->EvalSub(
+          result, GetCachedPower(powers, a - b, chebyshev, algo, evalKey));
+  }
+
+  (*powers)[e] = result;
+  return result;
+}
+
+// Splits the coefficients of a polynomial of degree < k * m into m blocks
+// q_i of k coefficients such that p = sum_i q_i * x^{k i}, or
+// p = sum_i q_i * T_{k i} for the Chebyshev basis.
+static std::vector<std::vector<double>> SplitCoefficients(
+    std::vector<double> coefficients, uint32_t k, uint32_t m, bool chebyshev) {
+  coefficients.resize(k * m, 0.0);
+  std::vector<std::vector<double>> blocks(m, std::vector<double>(k, 0.0));
+
+  for (uint32_t i = m - 1; i > 0; i--) {
+    uint32_t d = k * i;
+    if (chebyshev) {
+      // divide by T_d using T_j T_d = (T_{d+j} + T_{d-j}) / 2; the
+      // remainder is left in the coefficients below d
+      for (uint32_t j = k - 1; j > 0; j--) {
+        blocks[i][j] = 2 * coefficients[d + j];
+        coefficients[d - j] -= coefficients[d + j];
+      }
+      blocks[i][0] = coefficients[d];
+    } else {
+      for (uint32_t j = 0; j < k; j++) blocks[i][j] = coefficients[d + j];
+    }
+  }
+  for (uint32_t j = 0; j < k; j++) blocks[0][j] = coefficients[j];
+
+  return blocks;
+}
+
+// Evaluates a polynomial of degree n >= 1, given in the monomial or the
+// Chebyshev basis, on a ciphertext of depth 1 with the Paterson-Stockmeyer
+// schedule.
+static Ciphertext<DCRTPoly> EvalPowerSeries(
+    ConstCiphertext<DCRTPoly> ciphertext,
+    const std::vector<double> &coefficients, bool chebyshev,
+    const vector<LPEvalKey<DCRTPoly>> &evalKeys) {
+  auto algo = ciphertext->GetCryptoContext()->GetEncryptionAlgorithm();
+
+  uint32_t n = coefficients.size() - 1;
+  uint32_t k = 1;
+  while (k * k < n + 1) k <<= 1;
+  uint32_t m = (n + k) / k;
+
+  auto blocks = SplitCoefficients(coefficients, k, m, chebyshev);
+
+  std::map<uint32_t, Ciphertext<DCRTPoly>> powers;
+  powers[1] = ciphertext->Clone();
+
+  // All terms are accumulated at depth 2 without relinearization, so the
+  // whole sum needs one key switch and one rescale.
+  Ciphertext<DCRTPoly> sum;
+  for (uint32_t i = 0; i < m; i++) {
+    vector<Ciphertext<DCRTPoly>> babySteps;
+    vector<double> weights;
+    for (uint32_t j = 1; j < k; j++) {
+      if (blocks[i][j] == 0) continue;
+      babySteps.push_back(
+          GetCachedPower(&powers, j, chebyshev, algo, evalKeys[0]));
+      weights.push_back(blocks[i][j]);
+    }
+
+    Ciphertext<DCRTPoly> term;
+    if (i == 0) {
+      if (babySteps.empty()) continue;
+      term = algo->EvalLinearWSum(babySteps, weights);
+    } else if (babySteps.empty()) {
+      if (blocks[i][0] == 0) continue;
+      auto giantStep =
+          GetCachedPower(&powers, k * i, chebyshev, algo, evalKeys[0]);
+      term = algo->EvalLinearWSum({giantStep}, {blocks[i][0]});
+    } else {
+      auto giantStep =
+          GetCachedPower(&powers, k * i, chebyshev, algo, evalKeys[0]);
+      auto inner = algo->EvalLinearWSum(babySteps, weights);
+      if (blocks[i][0] != 0) inner = AddConstant(algo, inner, blocks[i][0]);
+      term = algo->EvalMult(algo->ModReduceInternal(inner), giantStep);
+    }
+
+    sum = (sum == nullptr) ? term : algo->EvalAdd(sum, term);
+  }
+
+  if (sum->GetElements().size() > 2) sum = algo->Relinearize(sum, evalKeys);
+  if (blocks[0][0] != 0) sum = AddConstant(algo, sum, blocks[0][0]);
+
+  return algo->ModReduceInternal(sum);
+}
+
+// Removes the trailing zero coefficients and rescales the input to depth 1
+static Ciphertext<DCRTPoly> PrepareSeriesInput(
+    ConstCiphertext<DCRTPoly> ciphertext, std::vector<double> *coefficients) {
+  if (coefficients->empty())
+    PALISADE_THROW(config_error,
+                   "The coefficient vector of a polynomial cannot be empty");
+  while (coefficients->size() > 1 && coefficients->back() == 0)
+    coefficients->pop_back();
+
+  auto algo = ciphertext->GetCryptoContext()->GetEncryptionAlgorithm();
+  Ciphertext<DCRTPoly> x = ciphertext->Clone();
+  while (x->GetDepth() > 1) x = algo->ModReduceInternal(x);
+  return x;
+}
+
+template <>
+Ciphertext<DCRTPoly> LPAlgorithmSHECKKS<DCRTPoly>::EvalPoly(
+    ConstCiphertext<DCRTPoly> ciphertext,
+    const std::vector<double> &coefficients,
+    const vector<LPEvalKey<DCRTPoly>> &evalKeys) const {
+  std::vector<double> coeffs(coefficients);
+  auto x = PrepareSeriesInput(ciphertext, &coeffs);
+
+  if (coeffs.size() == 1) {
+    auto algo = ciphertext->GetCryptoContext()->GetEncryptionAlgorithm();
+    auto constant = AddConstant(algo, algo->EvalMult(x, 0.0), coeffs[0]);
+    return algo->ModReduceInternal(constant);
+  }
+
+  return EvalPowerSeries(x, coeffs, false, evalKeys);
+}
+
+template <>
+Ciphertext<DCRTPoly> LPAlgorithmSHECKKS<DCRTPoly>::EvalChebyshevSeries(
+    ConstCiphertext<DCRTPoly> ciphertext,
+    const std::vector<double> &coefficients, double a, double b,
+    const vector<LPEvalKey<DCRTPoly>> &evalKeys) const {
+  if (!(a < b))
+    PALISADE_THROW(config_error,
+                   "The interval of a Chebyshev series must satisfy a < b");
+
+  std::vector<double> coeffs(coefficients);
+  auto x = PrepareSeriesInput(ciphertext, &coeffs);
+  coeffs[0] /= 2;
+
+  auto algo = ciphertext->GetCryptoContext()->GetEncryptionAlgorithm();
+  if (coeffs.size() == 1) {
+    auto constant = AddConstant(algo, algo->EvalMult(x, 0.0), coeffs[0]);
+    return algo->ModReduceInternal(constant);
+  }
+
+  // map [a, b] to [-1, 1]; this costs a level unless [a, b] = [-1, 1]
+  Ciphertext<DCRTPoly> y = x;
+  if (a != -1 || b != 1) {
+    y = algo->EvalMult(x, 2 / (b - a));
+    y = algo->ModReduceInternal(AddConstant(algo, y, -(a + b) / (b - a)));
+  }
+
+  return EvalPowerSeries(y, coeffs, true, evalKeys);
+}
+
 template <>
 Ciphertext<DCRTPoly> LPAlgorithmSHECKKS<DCRTPoly>::EvalMultAndRelinearize(
     ConstCiphertext<DCRTPoly> ciphertext1,
@@ -3674,8 +3918,8 @@ LPAlgorithmSHECKKS<DCRTPoly>::EvalFastRotationPrecomputeGHS(
       cryptoParamsLWE->GetModBarretPreconPTable());
   pPartExtC.SetFormat(Format::EVALUATION);
 
-  DCRTPoly expandedC(cTmp.GetExtendedCRTBasis(paramsP), Format::EVALUATION,
-                     true);
+  DCRTPoly expandedC(cryptoParamsLWE->GetParamsQlP(cipherTowers - 1),
+                     Format::EVALUATION, true);
   for (usint i = 0; i < expandedC.GetNumOfElements(); i++) {
     if (i < cipherTowers)
       expandedC.SetElementAtIndex(i, c[1].GetElementAtIndex(i));
@@ -3697,6 +3941,8 @@ template <>
 shared_ptr<vector<DCRTPoly>>
 LPAlgorithmSHECKKS<DCRTPoly>::EvalFastRotationPrecomputeHybrid(
     ConstCiphertext<DCRTPoly> ciphertext) const {
+  ScopedVectorPool pool;
+
   Ciphertext<DCRTPoly> newCiphertext = ciphertext->CloneEmpty();
 
   const shared_ptr<LPCryptoParametersCKKS<DCRTPoly>> cryptoParamsLWE =
@@ -3723,38 +3969,17 @@ LPAlgorithmSHECKKS<DCRTPoly>::EvalFastRotationPrecomputeHybrid(
            alpha);  // The number of digits of the current ciphertext
   if (beta > cryptoParamsLWE->GetNumberOfQPartitions())
     beta = cryptoParamsLWE->GetNumberOfQPartitions();
+  const shared_ptr<typename DCRTPoly::Params> paramsQlP =
+      cryptoParamsLWE->GetParamsQlP(l);
 
   vector<DCRTPoly> digitsCTmp(beta);
 
   // Digit decomposition
   // Zero-padding and split
-  uint32_t numTowersLastDigit =
-      cryptoParamsLWE->GetQPartition(beta - 1)->GetParams().size();
+  uint32_t numTowersLastDigit = cipherTowers - alpha * (beta - 1);
   for (uint32_t j = 0; j < beta; j++) {
-    if (j == beta - 1) {
-      auto part = cryptoParamsLWE->GetQPartition(j);
-      part->GetParams();
-
-      numTowersLastDigit = cipherTowers - alpha * j;
-
-      vector<NativeInteger> moduli(numTowersLastDigit);
-      vector<NativeInteger> roots(numTowersLastDigit);
-
-      for (uint32_t i = 0; i < numTowersLastDigit; i++) {
-        moduli[i] = part->GetParams()[i]->GetModulus();
-        roots[i] = part->GetParams()[i]->GetRootOfUnity();
-      }
-
-      auto params = DCRTPoly::Params(part->GetCyclotomicOrder(), moduli, roots,
-                                     {}, {}, 0);
-
-      digitsCTmp[j] =
-          DCRTPoly(std::make_shared<typename DCRTPoly::Params>(params),
-                   EVALUATION, true);
-
-    } else
-      digitsCTmp[j] =
-          DCRTPoly(cryptoParamsLWE->GetQPartition(j), Format::EVALUATION, true);
+    digitsCTmp[j] = DCRTPoly(cryptoParamsLWE->GetQlPartition(l, j),
+                             Format::EVALUATION, true);
 
     uint32_t iters = (j == beta - 1) ? numTowersLastDigit : alpha;
     for (uint32_t i = 0; i < iters; i++) {
@@ -3796,8 +4021,7 @@ LPAlgorithmSHECKKS<DCRTPoly>::EvalFastRotationPrecomputeHybrid(
 
     pPartExtC[j].SetFormat(Format::EVALUATION);
 
-    expandedC[j] =
-        DCRTPoly(cTmp.GetExtendedCRTBasis(paramsP), Format::EVALUATION, true);
+    expandedC[j] = DCRTPoly(paramsQlP, Format::EVALUATION, true);
     for (usint i = 0; i < cipherTowers; i++) {
       if (i / alpha == j)
         expandedC[j].SetElementAtIndex(
@@ -3853,6 +4077,8 @@ Ciphertext<DCRTPoly> LPAlgorithmSHECKKS<DCRTPoly>::EvalFastRotationHybrid(
     ConstCiphertext<DCRTPoly> ciphertext, const usint index, const usint m,
     const shared_ptr<vector<DCRTPoly>> expandedCiphertext,
     LPEvalKey<DCRTPoly> evalKey) const {
+  ScopedVectorPool pool;
+
   // Find the automorphism index that corresponds to rotation index index.
   usint autoIndex = FindAutomorphismIndex2nComplex(index, m);
 
@@ -4157,6 +4383,205 @@ Ciphertext<DCRTPoly> LPAlgorithmSHECKKS<DCRTPoly>::EvalFastRotation(
   }
 }
 
+// Returns the key of automorphism autoIndex, or throws if it was not generated.
+static LPEvalKey<DCRTPoly> FindAutomorphismKey(
+    const std::map<usint, LPEvalKey<DCRTPoly>> &evalKeys, usint autoIndex) {
+  auto key = evalKeys.find(autoIndex);
+  if (key == evalKeys.end()) {
+    PALISADE_THROW(config_error,
+                   "Could not find an EvalKey for index " +
+                       std::to_string(autoIndex));
+  }
+  return key->second;
+}
+
+// Applies automorphism autoIndex to the digits of a ciphertext in the
+// extended basis (as created by EvalFastRotationPrecomputeGHS/Hybrid), and
+// adds their products with the key switching key to cTilda0 and cTilda1.
+static void AccumulateHoistedKeySwitch(
+    const vector<DCRTPoly> &expandedCiphertext, usint autoIndex,
+    const LPEvalKey<DCRTPoly> &evalKey, size_t cipherTowers,
+    size_t towersToSkip, DCRTPoly *cTilda0, DCRTPoly *cTilda1) {
+  const std::vector<DCRTPoly> &b = evalKey->GetBVector();
+  const std::vector<DCRTPoly> &a = evalKey->GetAVector();
+
+  for (uint32_t j = 0; j < expandedCiphertext.size(); j++) {
+    DCRTPoly expandedC(expandedCiphertext[j].AutomorphismTransform(autoIndex));
+    expandedC.SetFormat(Format::EVALUATION);
+
+    for (usint i = 0; i < expandedC.GetNumOfElements(); i++) {
+      // The following skips the switch key elements that are missing from the
+      // ciphertext
+      usint idx = (i < cipherTowers) ? i : i + towersToSkip;
+      const DCRTPoly::PolyType &c_i = expandedC.GetElementAtIndex(i);
+      cTilda0->ElementAtIndex(i) += c_i * b[j].GetElementAtIndex(idx);
+      cTilda1->ElementAtIndex(i) += c_i * a[j].GetElementAtIndex(idx);
+    }
+  }
+}
+
+template <>
+vector<Ciphertext<DCRTPoly>> LPAlgorithmSHECKKS<DCRTPoly>::EvalAtIndexBatch(
+    ConstCiphertext<DCRTPoly> ciphertext, const std::vector<int32_t> &indexList,
+    const std::map<usint, LPEvalKey<DCRTPoly>> &evalKeys) const {
+  const shared_ptr<LPCryptoParametersCKKS<DCRTPoly>> cryptoParamsLWE =
+      std::dynamic_pointer_cast<LPCryptoParametersCKKS<DCRTPoly>>(
+          ciphertext->GetCryptoParameters());
+  usint m = cryptoParamsLWE->GetElementParams()->GetCyclotomicOrder();
+
+  vector<Ciphertext<DCRTPoly>> result(indexList.size());
+  if (indexList.empty()) return result;
+
+  // The hoisted automorphisms only apply to linear ciphertexts
+  if (ciphertext->GetElements().size() != 2)
+    return LPSHEAlgorithm<DCRTPoly>::EvalAtIndexBatch(ciphertext, indexList,
+                                                      evalKeys);
+
+  // Look up all keys first, so that missing keys are reported outside of the
+  // parallel loop
+  vector<LPEvalKey<DCRTPoly>> keys(indexList.size());
+  for (size_t i = 0; i < indexList.size(); i++) {
+    if (indexList[i] != 0)
+      keys[i] = FindAutomorphismKey(
+          evalKeys, FindAutomorphismIndex2nComplex(indexList[i], m));
+  }
+
+  ScopedVectorPool pool;
+
+  shared_ptr<vector<DCRTPoly>> precomp = EvalFastRotationPrecompute(ciphertext);
+  KeySwitchTechnique ksTech = cryptoParamsLWE->GetKeySwitchTechnique();
+
+#pragma omp parallel for
+  for (size_t i = 0; i < indexList.size(); i++) {
+    if (indexList[i] == 0) {
+      result[i] = std::make_shared<CiphertextImpl<DCRTPoly>>(*ciphertext);
+    } else if (ksTech == BV) {
+      result[i] =
+          EvalFastRotationBV(ciphertext, indexList[i], m, precomp, keys[i]);
+    } else if (ksTech == GHS) {
+      result[i] =
+          EvalFastRotationGHS(ciphertext, indexList[i], m, precomp, keys[i]);
+    } else {
+      result[i] = EvalFastRotationHybrid(ciphertext, indexList[i], m, precomp,
+                                         keys[i]);
+    }
+  }
+
+  return result;
+}
+
+template <>
+Ciphertext<DCRTPoly> LPAlgorithmSHECKKS<DCRTPoly>::EvalAtIndexBatchSum(
+    ConstCiphertext<DCRTPoly> ciphertext, const std::vector<int32_t> &indexList,
+    const std::map<usint, LPEvalKey<DCRTPoly>> &evalKeys) const {
+  if (indexList.empty())
+    PALISADE_THROW(config_error, "EvalAtIndexBatchSum: empty index list");
+
+  const shared_ptr<LPCryptoParametersCKKS<DCRTPoly>> cryptoParamsLWE =
+      std::dynamic_pointer_cast<LPCryptoParametersCKKS<DCRTPoly>>(
+          ciphertext->GetCryptoParameters());
+
+  // BV key switching has no extended basis to accumulate in
+  if (cryptoParamsLWE->GetKeySwitchTechnique() == BV ||
+      ciphertext->GetElements().size() != 2)
+    return LPSHEAlgorithm<DCRTPoly>::EvalAtIndexBatchSum(ciphertext, indexList,
+                                                         evalKeys);
+
+  usint m = cryptoParamsLWE->GetElementParams()->GetCyclotomicOrder();
+
+  vector<usint> autoIndices(indexList.size());
+  vector<LPEvalKey<DCRTPoly>> keys(indexList.size());
+  for (size_t i = 0; i < indexList.size(); i++) {
+    if (indexList[i] != 0) {
+      autoIndices[i] = FindAutomorphismIndex2nComplex(indexList[i], m);
+      keys[i] = FindAutomorphismKey(evalKeys, autoIndices[i]);
+    }
+  }
+
+  ScopedVectorPool pool;
+
+  shared_ptr<vector<DCRTPoly>> precomp = EvalFastRotationPrecompute(ciphertext);
+
+  const std::vector<DCRTPoly> &c = ciphertext->GetElements();
+
+  const shared_ptr<typename DCRTPoly::Params> paramsQ = c[0].GetParams();
+  const shared_ptr<typename DCRTPoly::Params> paramsP =
+      cryptoParamsLWE->GetAuxElementParams();
+  const shared_ptr<typename DCRTPoly::Params> paramsQlP =
+      (*precomp)[0].GetParams();
+
+  size_t cipherTowers = paramsQ->GetParams().size();
+  size_t towersToSkip =
+      cryptoParamsLWE->GetElementParams()->GetParams().size() - cipherTowers;
+
+  // (sum0, sum1) accumulates the automorphed first components and the
+  // unrotated terms; (cTilda0, cTilda1) accumulates the key-switched second
+  // components in the extended basis.
+  DCRTPoly sum0(paramsQ, Format::EVALUATION, true);
+  DCRTPoly sum1(paramsQ, Format::EVALUATION, true);
+  DCRTPoly cTilda0(paramsQlP, Format::EVALUATION, true);
+  DCRTPoly cTilda1(paramsQlP, Format::EVALUATION, true);
+
+#pragma omp parallel
+  {
+    DCRTPoly localSum0(paramsQ, Format::EVALUATION, true);
+    DCRTPoly localSum1(paramsQ, Format::EVALUATION, true);
+    DCRTPoly localTilda0(paramsQlP, Format::EVALUATION, true);
+    DCRTPoly localTilda1(paramsQlP, Format::EVALUATION, true);
+
+#pragma omp for nowait
+    for (size_t i = 0; i < indexList.size(); i++) {
+      if (indexList[i] == 0) {
+        localSum0 += c[0];
+        localSum1 += c[1];
+      } else {
+        localSum0 += c[0].AutomorphismTransform(autoIndices[i]);
+        AccumulateHoistedKeySwitch(*precomp, autoIndices[i], keys[i],
+                                   cipherTowers, towersToSkip, &localTilda0,
+                                   &localTilda1);
+      }
+    }
+
+#pragma omp critical
+    {
+      sum0 += localSum0;
+      sum1 += localSum1;
+      cTilda0 += localTilda0;
+      cTilda1 += localTilda1;
+    }
+  }
+
+  cTilda0.SetFormat(Format::COEFFICIENT);
+  cTilda1.SetFormat(Format::COEFFICIENT);
+
+  DCRTPoly cHat0 = cTilda0.ApproxModDown(
+      paramsQ, paramsP, cryptoParamsLWE->GetPInvModQTable(),
+      cryptoParamsLWE->GetPInvModQPreconTable(),
+      cryptoParamsLWE->GetPHatInvModPTable(),
+      cryptoParamsLWE->GetPHatInvModPPreconTable(),
+      cryptoParamsLWE->GetPHatModQTable(),
+      cryptoParamsLWE->GetModBarretPreconQTable());
+
+  DCRTPoly cHat1 = cTilda1.ApproxModDown(
+      paramsQ, paramsP, cryptoParamsLWE->GetPInvModQTable(),
+      cryptoParamsLWE->GetPInvModQPreconTable(),
+      cryptoParamsLWE->GetPHatInvModPTable(),
+      cryptoParamsLWE->GetPHatInvModPPreconTable(),
+      cryptoParamsLWE->GetPHatModQTable(),
+      cryptoParamsLWE->GetModBarretPreconQTable());
+
+  cHat0.SetFormat(Format::EVALUATION);
+  cHat1.SetFormat(Format::EVALUATION);
+
+  Ciphertext<DCRTPoly> result = ciphertext->CloneEmpty();
+  result->SetElements({sum0 + cHat0, sum1 + cHat1});
+  result->SetDepth(ciphertext->GetDepth());
+  result->SetLevel(ciphertext->GetLevel());
+  result->SetScalingFactor(ciphertext->GetScalingFactor());
+
+  return result;
+}
+
 template <>
 LPEvalKey<DCRTPoly> LPAlgorithmPRECKKS<DCRTPoly>::ReKeyGenBV(
     const LPPublicKey<DCRTPoly> newPK,
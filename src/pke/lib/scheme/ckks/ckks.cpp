@@ -247,16 +247,72 @@ Ciphertext<Element> LPAlgorithmSHECKKS<Element>::EvalMultCore(
 
   std::vector<Element> c(cResultSize);
 
+  if (c1.size() == 2 && c2.size() == 2) {
+    // Karatsuba: the middle term is (a0 + a1)(b0 + b1) - a0*b0 - a1*b1
+    c[0] = c1[0] * c2[0];
+    c[2] = c1[1] * c2[1];
+
+    c[1] = c1[0] + c1[1];
+    c[1] *= (c2[0] + c2[1]);
+    c[1] -= c[0];
+    c[1] -= c[2];
+  } else {
+    bool *isFirstAdd = new bool[cResultSize];
+    std::fill_n(isFirstAdd, cResultSize, true);
+
+    for (size_t i = 0; i < c1.size(); i++) {
+      for (size_t j = 0; j < c2.size(); j++) {
+        if (isFirstAdd[i + j] == true) {
+          c[i + j] = c1[i] * c2[j];
+          isFirstAdd[i + j] = false;
+        } else {
+          c[i + j] += c1[i] * c2[j];
+        }
+      }
+    }
+
+    delete[] isFirstAdd;
+  }
+
+  newCiphertext->SetElements(std::move(c));
+
+  newCiphertext->SetDepth(ciphertext1->GetDepth() + ciphertext2->GetDepth());
+  newCiphertext->SetScalingFactor(ciphertext1->GetScalingFactor() *
+                                  ciphertext2->GetScalingFactor());
+  newCiphertext->SetLevel(ciphertext1->GetLevel());
+
+  return newCiphertext;
+}
+
+template <class Element>
+Ciphertext<Element> LPAlgorithmSHECKKS<Element>::EvalSquareCore(
+    ConstCiphertext<Element> ciphertext) const {
+  if (ciphertext->GetElements()[0].GetFormat() == Format::COEFFICIENT) {
+    PALISADE_THROW(not_available_error,
+                   "EvalSquare cannot multiply in COEFFICIENT domain.");
+  }
+
+  Ciphertext<Element> newCiphertext = ciphertext->CloneEmpty();
+
+  const std::vector<Element> &c1 = ciphertext->GetElements();
+
+  size_t cResultSize = 2 * c1.size() - 1;
+
+  std::vector<Element> c(cResultSize);
+
   bool *isFirstAdd = new bool[cResultSize];
   std::fill_n(isFirstAdd, cResultSize, true);
 
+  // Each cross product c1[i] * c1[j] with i < j appears twice in the square
   for (size_t i = 0; i < c1.size(); i++) {
-    for (size_t j = 0; j < c2.size(); j++) {
+    for (size_t j = i; j < c1.size(); j++) {
+      Element prod = c1[i] * c1[j];
+      if (i != j) prod += prod;
       if (isFirstAdd[i + j] == true) {
-        c[i + j] = c1[i] * c2[j];
+        c[i + j] = std::move(prod);
         isFirstAdd[i + j] = false;
       } else {
-        c[i + j] += c1[i] * c2[j];
+        c[i + j] += prod;
       }
     }
   }
@@ -265,10 +321,10 @@ Ciphertext<Element> LPAlgorithmSHECKKS<Element>::EvalMultCore(
 
   newCiphertext->SetElements(std::move(c));
 
-  newCiphertext->SetDepth(ciphertext1->GetDepth() + ciphertext2->GetDepth());
-  newCiphertext->SetScalingFactor(ciphertext1->GetScalingFactor() *
-                                  ciphertext2->GetScalingFactor());
-  newCiphertext->SetLevel(ciphertext1->GetLevel());
+  newCiphertext->SetDepth(2 * ciphertext->GetDepth());
+  newCiphertext->SetScalingFactor(ciphertext->GetScalingFactor() *
+                                  ciphertext->GetScalingFactor());
+  newCiphertext->SetLevel(ciphertext->GetLevel());
 
   return newCiphertext;
 }
@@ -422,6 +478,12 @@ Ciphertext<Element> LPAlgorithmSHECKKS<Element>::EvalMult(
   return LPAlgorithmSHECKKS<Element>::EvalMultCore(ciphertext1, ciphertext2);
 }
 
+template <class Element>
+Ciphertext<Element> LPAlgorithmSHECKKS<Element>::EvalSquare(
+    ConstCiphertext<Element> ciphertext) const {
+  return LPAlgorithmSHECKKS<Element>::EvalSquareCore(ciphertext);
+}
+
 template <class Element>
 Ciphertext<Element> LPAlgorithmSHECKKS<Element>::EvalMult(
     ConstCiphertext<Element> ciphertext, ConstPlaintext plaintext) const {
@@ -1178,6 +1240,22 @@ Ciphertext<Element> LPAlgorithmSHECKKS<Element>::EvalFastRotationGHS(
   PALISADE_THROW(not_available_error, errMsg);
 }
 
+template <class Element>
+vector<Ciphertext<Element>> LPAlgorithmSHECKKS<Element>::EvalAtIndexBatch(
+    ConstCiphertext<Element> ciphertext, const std::vector<int32_t> &indexList,
+    const std::map<usint, LPEvalKey<Element>> &evalKeys) const {
+  return LPSHEAlgorithm<Element>::EvalAtIndexBatch(ciphertext, indexList,
+                                                   evalKeys);
+}
+
+template <class Element>
+Ciphertext<Element> LPAlgorithmSHECKKS<Element>::EvalAtIndexBatchSum(
+    ConstCiphertext<Element> ciphertext, const std::vector<int32_t> &indexList,
+    const std::map<usint, LPEvalKey<Element>> &evalKeys) const {
+  return LPSHEAlgorithm<Element>::EvalAtIndexBatchSum(ciphertext, indexList,
+                                                      evalKeys);
+}
+
 // Enable for LPPublicKeyEncryptionSchemeLTV
 template <class Element>
 void LPPublicKeyEncryptionSchemeCKKS<Element>::Enable(
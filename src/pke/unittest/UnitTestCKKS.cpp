@@ -978,6 +978,471 @@ GENERATE_TEST_CASES_FUNC_GHS(UTCKKS, UnitTest_EvalAtIndex, ORDER, SCALE,
 GENERATE_TEST_CASES_FUNC_HYBRID(UTCKKS, UnitTest_EvalAtIndex, ORDER, SCALE,
                                 NUMPRIME, RELIN, BATCH)
 
+/**
+ * Tests whether EvalAtIndexBatch and EvalAtIndexBatchSum for CKKS work
+ * properly.
+ */
+template <class Element>
+static void UnitTest_EvalAtIndexBatch(const CryptoContext<Element> cc,
+                                      const string& failmsg) {
+  int vecSize = 8;
+  const std::vector<int32_t> indexList = {2, -2, 0, 1, 3};
+
+  double eps = 0.000000001;
+
+  std::vector<std::complex<double>> vectorOfInts1(vecSize);
+  for (int i = 0; i < vecSize; i++) {
+    vectorOfInts1[i] = i + 1;
+  }
+  Plaintext plaintext1 = cc->MakeCKKSPackedPlaintext(vectorOfInts1);
+
+  std::vector<std::complex<double>> vOnes(vecSize, 1);
+  Plaintext pOnes = cc->MakeCKKSPackedPlaintext(vOnes);
+
+  // expected rotations and their sum
+  std::vector<std::vector<std::complex<double>>> vRotated(indexList.size());
+  std::vector<std::complex<double>> vSum(vecSize);
+  for (size_t k = 0; k < indexList.size(); k++) {
+    vRotated[k] = std::vector<std::complex<double>>(vecSize);
+    for (int i = 0; i < vecSize; i++) {
+      int j = i + indexList[k];
+      vRotated[k][i] = (j >= 0 && j < vecSize) ? vectorOfInts1[j] : 0;
+      vSum[i] += vRotated[k][i];
+    }
+  }
+
+  LPKeyPair<Element> kp = cc->KeyGen();
+  cc->EvalMultKeyGen(kp.secretKey);
+  cc->EvalAtIndexKeyGen(kp.secretKey, {2, -2, 1, 3});
+
+  Ciphertext<Element> ciphertext1 = cc->Encrypt(kp.publicKey, plaintext1);
+  Ciphertext<Element> cOnes = cc->Encrypt(kp.publicKey, pOnes);
+  Plaintext results;
+
+  // See UnitTest_EvalAtIndex for why the rotations are applied to a product.
+  ciphertext1 *= cOnes;
+
+  auto cRotated = cc->EvalAtIndexBatch(ciphertext1, indexList);
+  ASSERT_EQ(cRotated.size(), indexList.size()) << failmsg;
+  for (size_t k = 0; k < indexList.size(); k++) {
+    cc->Decrypt(kp.secretKey, cRotated[k], &results);
+    results->SetLength(vecSize);
+    auto tmp_b = results->GetCKKSPackedValue();
+    checkApproximateEquality(vRotated[k], tmp_b, vecSize, eps,
+                             failmsg + " EvalAtIndexBatch(" +
+                                 std::to_string(indexList[k]) + ") fails");
+  }
+
+  auto cSum = cc->EvalAtIndexBatchSum(ciphertext1, indexList);
+  cc->Decrypt(kp.secretKey, cSum, &results);
+  results->SetLength(vecSize);
+  auto tmp_b = results->GetCKKSPackedValue();
+  checkApproximateEquality(vSum, tmp_b, vecSize, eps,
+                           failmsg + " EvalAtIndexBatchSum fails");
+}
+
+GENERATE_TEST_CASES_FUNC_BV(UTCKKS, UnitTest_EvalAtIndexBatch, ORDER, SCALE,
+                            NUMPRIME, RELIN, BATCH)
+GENERATE_TEST_CASES_FUNC_GHS(UTCKKS, UnitTest_EvalAtIndexBatch, ORDER, SCALE,
+                             NUMPRIME, RELIN, BATCH)
+GENERATE_TEST_CASES_FUNC_HYBRID(UTCKKS, UnitTest_EvalAtIndexBatch, ORDER,
+                                SCALE, NUMPRIME, RELIN, BATCH)
+
+/**
+ * Tests whether EvalLinearTransform for CKKS works properly.
+ */
+template <class Element>
+static void UnitTest_EvalLinearTransform(const CryptoContext<Element> cc,
+                                         const string& failmsg) {
+  uint32_t dim = 8;
+  uint32_t slots = cc->GetRingDimension() / 2;
+
+  // With EXACTRESCALE the baby steps rotate a rescaled ciphertext, so the
+  // BV rotation noise is not hidden by a second scaling factor.
+  double eps = 0.00001;
+
+  // the fifth diagonal is left empty to exercise the sparse path
+  std::vector<std::vector<std::complex<double>>> matrix(
+      dim, std::vector<std::complex<double>>(dim));
+  for (uint32_t i = 0; i < dim; i++) {
+    for (uint32_t j = 0; j < dim; j++) {
+      if ((j + dim - i) % dim != 5)
+        matrix[i][j] = static_cast<double>((3 * i + 5 * j) % 7) / 4 - 0.75;
+    }
+  }
+
+  std::vector<std::complex<double>> vInput(dim);
+  for (uint32_t i = 0; i < dim; i++) vInput[i] = 0.5 * i - 1;
+
+  std::vector<std::complex<double>> vExpected(dim);
+  for (uint32_t i = 0; i < dim; i++) {
+    for (uint32_t j = 0; j < dim; j++) vExpected[i] += matrix[i][j] * vInput[j];
+  }
+
+  // the input is replicated with period dim over all slots
+  std::vector<std::complex<double>> vReplicated(slots);
+  for (uint32_t i = 0; i < slots; i++) vReplicated[i] = vInput[i % dim];
+  Plaintext plaintext1 = cc->MakeCKKSPackedPlaintext(vReplicated);
+
+  std::vector<std::complex<double>> vOnes(slots, 1);
+  Plaintext pOnes = cc->MakeCKKSPackedPlaintext(vOnes);
+
+  // with EXACTRESCALE the transform rescales its input first
+  const auto cryptoParams =
+      std::dynamic_pointer_cast<LPCryptoParametersCKKS<DCRTPoly>>(
+          cc->GetCryptoParameters());
+  uint32_t level =
+      (cryptoParams->GetRescalingTechnique() == EXACTRESCALE) ? 1 : 0;
+  auto diagonals = cc->EvalLinearTransformPrecompute(matrix, 0, 1, level);
+  EXPECT_EQ(diagonals[5], nullptr) << failmsg;
+
+  auto indexList = cc->EvalLinearTransformIndices(diagonals);
+  EXPECT_EQ(indexList, std::vector<int32_t>({1, 2, 3, 6})) << failmsg;
+
+  LPKeyPair<Element> kp = cc->KeyGen();
+  cc->EvalMultKeyGen(kp.secretKey);
+  cc->EvalAtIndexKeyGen(kp.secretKey, indexList);
+
+  Ciphertext<Element> ciphertext1 = cc->Encrypt(kp.publicKey, plaintext1);
+  Ciphertext<Element> cOnes = cc->Encrypt(kp.publicKey, pOnes);
+  Plaintext results;
+
+  // See UnitTest_EvalAtIndex for why the rotations are applied to a product.
+  ciphertext1 *= cOnes;
+
+  auto cResult = cc->EvalLinearTransform(diagonals, ciphertext1);
+  cc->Decrypt(kp.secretKey, cResult, &results);
+  results->SetLength(dim);
+  auto tmp_b = results->GetCKKSPackedValue();
+  checkApproximateEquality(vExpected, tmp_b, dim, eps,
+                           failmsg + " EvalLinearTransform fails");
+
+  // a missing giant-step key is reported instead of terminating the process
+  LPKeyPair<Element> kpBaby = cc->KeyGen();
+  cc->EvalAtIndexKeyGen(kpBaby.secretKey, {1, 2, 3});
+  Ciphertext<Element> ciphertext2 = cc->Encrypt(kpBaby.publicKey, plaintext1);
+  EXPECT_THROW(cc->EvalLinearTransform(diagonals, ciphertext2), config_error)
+      << failmsg << " EvalLinearTransform without the giant-step key";
+}
+
+GENERATE_TEST_CASES_FUNC_BV(UTCKKS, UnitTest_EvalLinearTransform, ORDER, SCALE,
+                            NUMPRIME, RELIN, BATCH)
+GENERATE_TEST_CASES_FUNC_GHS(UTCKKS, UnitTest_EvalLinearTransform, ORDER,
+                             SCALE, NUMPRIME, RELIN, BATCH)
+GENERATE_TEST_CASES_FUNC_HYBRID(UTCKKS, UnitTest_EvalLinearTransform, ORDER,
+                                SCALE, NUMPRIME, RELIN, BATCH)
+
+/**
+ * Tests whether EvalPoly and EvalChebyshevSeries for CKKS work properly.
+ */
+template <class Element>
+static void UnitTest_EvalPoly(const CryptoContext<Element> cc,
+                              const string& failmsg) {
+  int vecSize = 8;
+
+  double eps = 0.000001;
+
+  std::vector<std::complex<double>> vInput(vecSize);
+  for (int i = 0; i < vecSize; i++) vInput[i] = 0.25 * i - 0.9;
+  Plaintext plaintext1 = cc->MakeCKKSPackedPlaintext(vInput);
+
+  // degree 12: the block of x^8..x^11 is empty and the one of x^12 is a
+  // constant times the giant step
+  std::vector<double> coefficients = {0.5,  -1.25, 0.75, 0.125, -0.5,
+                                      0.25, 0.375, 0,    0,     0,
+                                      0,    0,     -0.625};
+  std::vector<std::complex<double>> vPoly(vecSize);
+  for (int i = 0; i < vecSize; i++) {
+    double x = vInput[i].real();
+    double power = 1;
+    double value = 0;
+    for (auto c : coefficients) {
+      value += c * power;
+      power *= x;
+    }
+    vPoly[i] = value;
+  }
+
+  // Chebyshev series on [-2, 3]
+  double a = -2;
+  double b = 3;
+  std::vector<double> chebCoefficients = {1.5,  -0.75, 0.5,  0.25,
+                                          -0.125, 0.375, 0.0625, -0.25,
+                                          0.125,  0.5,   -0.375};
+  std::vector<std::complex<double>> vCheb(vecSize);
+  for (int i = 0; i < vecSize; i++) {
+    double y = (2 * vInput[i].real() - (a + b)) / (b - a);
+    double tPrev = 1;
+    double tCurr = y;
+    double value = chebCoefficients[0] / 2 + chebCoefficients[1] * y;
+    for (size_t j = 2; j < chebCoefficients.size(); j++) {
+      double tNext = 2 * y * tCurr - tPrev;
+      value += chebCoefficients[j] * tNext;
+      tPrev = tCurr;
+      tCurr = tNext;
+    }
+    vCheb[i] = value;
+  }
+
+  LPKeyPair<Element> kp = cc->KeyGen();
+  cc->EvalMultKeyGen(kp.secretKey);
+
+  Ciphertext<Element> ciphertext1 = cc->Encrypt(kp.publicKey, plaintext1);
+  Plaintext results;
+
+  auto cPoly = cc->EvalPoly(ciphertext1, coefficients);
+  cc->Decrypt(kp.secretKey, cPoly, &results);
+  results->SetLength(vecSize);
+  auto tmp_b = results->GetCKKSPackedValue();
+  checkApproximateEquality(vPoly, tmp_b, vecSize, eps,
+                           failmsg + " EvalPoly fails");
+
+  auto cCheb = cc->EvalChebyshevSeries(ciphertext1, chebCoefficients, a, b);
+  cc->Decrypt(kp.secretKey, cCheb, &results);
+  results->SetLength(vecSize);
+  tmp_b = results->GetCKKSPackedValue();
+  checkApproximateEquality(vCheb, tmp_b, vecSize, eps,
+                           failmsg + " EvalChebyshevSeries fails");
+}
+
+GENERATE_TEST_CASES_FUNC_BV(UTCKKS, UnitTest_EvalPoly, ORDER, SCALE, NUMPRIME,
+                            RELIN, BATCH)
+GENERATE_TEST_CASES_FUNC_GHS(UTCKKS, UnitTest_EvalPoly, ORDER, SCALE, NUMPRIME,
+                             RELIN, BATCH)
+GENERATE_TEST_CASES_FUNC_HYBRID(UTCKKS, UnitTest_EvalPoly, ORDER, SCALE,
+                                NUMPRIME, RELIN, BATCH)
+
+/**
+ * Tests whether the lazy relinearization mode for CKKS works properly.
+ */
+template <class Element>
+static void UnitTest_LazyRelinearization(const CryptoContext<Element> cc,
+                                         const string& failmsg) {
+  int vecSize = 8;
+  int numTerms = 16;
+
+  double eps = 0.0000001;
+
+  LPKeyPair<Element> kp = cc->KeyGen();
+  cc->EvalMultKeyGen(kp.secretKey);
+  cc->EvalAtIndexKeyGen(kp.secretKey, {1, -1});
+
+  std::vector<Ciphertext<Element>> cA(numTerms);
+  std::vector<Ciphertext<Element>> cB(numTerms);
+  std::vector<std::complex<double>> vDot(vecSize);
+  for (int k = 0; k < numTerms; k++) {
+    std::vector<std::complex<double>> vA(vecSize);
+    std::vector<std::complex<double>> vB(vecSize);
+    for (int i = 0; i < vecSize; i++) {
+      vA[i] = 0.125 * ((k + i) % 5) - 0.25;
+      vB[i] = 0.0625 * ((3 * k + 2 * i) % 7);
+      vDot[i] += vA[i] * vB[i];
+    }
+    cA[k] = cc->Encrypt(kp.publicKey, cc->MakeCKKSPackedPlaintext(vA));
+    cB[k] = cc->Encrypt(kp.publicKey, cc->MakeCKKSPackedPlaintext(vB));
+  }
+
+  std::vector<std::complex<double>> vRotated(vecSize);
+  std::vector<std::complex<double>> vSquare(vecSize);
+  std::vector<std::complex<double>> vMerged(vecSize);
+  for (int i = 0; i < vecSize; i++) {
+    vRotated[i] = (i + 1 < vecSize) ? vDot[i + 1] : 0;
+    vSquare[i] = vDot[i] * vDot[i];
+    vMerged[i] = (i < 2) ? vDot[0] : 0;
+  }
+
+  cc->SetLazyRelinearization(true);
+
+  Ciphertext<Element> cDot = cc->EvalMult(cA[0], cB[0]);
+  for (int k = 1; k < numTerms; k++)
+    cDot = cc->EvalAdd(cDot, cc->EvalMult(cA[k], cB[k]));
+  EXPECT_EQ(cDot->GetElements().size(), 3U)
+      << failmsg << " the products were relinearized";
+
+  Plaintext results;
+  cc->Decrypt(kp.secretKey, cDot, &results);
+  results->SetLength(vecSize);
+  auto tmp_b = results->GetCKKSPackedValue();
+  checkApproximateEquality(vDot, tmp_b, vecSize, eps,
+                           failmsg + " lazy dot product fails");
+
+  auto cRotated = cc->EvalAtIndex(cDot, 1);
+  cc->Decrypt(kp.secretKey, cRotated, &results);
+  results->SetLength(vecSize);
+  tmp_b = results->GetCKKSPackedValue();
+  checkApproximateEquality(vRotated, tmp_b, vecSize, eps,
+                           failmsg + " rotation of a lazy product fails");
+
+  auto cSquare = cc->EvalMult(cDot, cDot);
+  cc->Decrypt(kp.secretKey, cSquare, &results);
+  results->SetLength(vecSize);
+  tmp_b = results->GetCKKSPackedValue();
+  checkApproximateEquality(vSquare, tmp_b, vecSize, eps,
+                           failmsg + " product of lazy products fails");
+
+  auto cMerged = cc->EvalMerge({cDot, cDot});
+  cc->Decrypt(kp.secretKey, cMerged, &results);
+  results->SetLength(vecSize);
+  tmp_b = results->GetCKKSPackedValue();
+  checkApproximateEquality(vMerged, tmp_b, vecSize, eps,
+                           failmsg + " merge of lazy products fails");
+
+  LPKeyPair<Element> kp2 = cc->KeyGen();
+  auto keySwitchHint = cc->KeySwitchGen(kp.secretKey, kp2.secretKey);
+  auto cSwitched = cc->KeySwitch(keySwitchHint, cDot);
+  cc->Decrypt(kp2.secretKey, cSwitched, &results);
+  results->SetLength(vecSize);
+  tmp_b = results->GetCKKSPackedValue();
+  checkApproximateEquality(vDot, tmp_b, vecSize, eps,
+                           failmsg + " key switching of a lazy product fails");
+
+  std::vector<Ciphertext<Element>> cProducts(numTerms);
+  for (int k = 0; k < numTerms; k++) cProducts[k] = cc->EvalMult(cA[k], cB[k]);
+
+  auto cSum = cc->EvalAddMany(cProducts);
+  EXPECT_EQ(cSum->GetElements().size(), 3U)
+      << failmsg << " EvalAddMany relinearized the products";
+  cc->Decrypt(kp.secretKey, cSum, &results);
+  results->SetLength(vecSize);
+  tmp_b = results->GetCKKSPackedValue();
+  checkApproximateEquality(vDot, tmp_b, vecSize, eps,
+                           failmsg + " EvalAddMany of lazy products fails");
+
+  std::vector<Ciphertext<Element>> cProductsCopy(cProducts);
+  cSum = cc->EvalAddManyInPlace(cProductsCopy);
+  cc->Decrypt(kp.secretKey, cSum, &results);
+  results->SetLength(vecSize);
+  tmp_b = results->GetCKKSPackedValue();
+  checkApproximateEquality(
+      vDot, tmp_b, vecSize, eps,
+      failmsg + " EvalAddManyInPlace of lazy products fails");
+
+  auto cMultMany = cc->EvalMultMany({cDot, cDot});
+  cc->Decrypt(kp.secretKey, cMultMany, &results);
+  results->SetLength(vecSize);
+  tmp_b = results->GetCKKSPackedValue();
+  checkApproximateEquality(vSquare, tmp_b, vecSize, eps,
+                           failmsg + " EvalMultMany of lazy products fails");
+
+  auto cRelin = cc->EvalMultAndRelinearize(cDot, cDot);
+  EXPECT_EQ(cRelin->GetElements().size(), 2U)
+      << failmsg << " EvalMultAndRelinearize left extra elements";
+  cc->Decrypt(kp.secretKey, cRelin, &results);
+  results->SetLength(vecSize);
+  tmp_b = results->GetCKKSPackedValue();
+  checkApproximateEquality(
+      vSquare, tmp_b, vecSize, eps,
+      failmsg + " EvalMultAndRelinearize of lazy products fails");
+
+  auto cNoRelin = cc->EvalMultNoRelin(cDot, cDot);
+  cc->Decrypt(kp.secretKey, cNoRelin, &results);
+  results->SetLength(vecSize);
+  tmp_b = results->GetCKKSPackedValue();
+  checkApproximateEquality(
+      vSquare, tmp_b, vecSize, eps,
+      failmsg + " EvalMultNoRelin of lazy products fails");
+
+  std::vector<std::complex<double>> vWSum(vecSize);
+  for (int i = 0; i < vecSize; i++) vWSum[i] = 1.5 * vDot[i];
+
+  auto cWSum = cc->EvalLinearWSum({cDot, cDot}, {1.0, 0.5});
+  cc->Decrypt(kp.secretKey, cWSum, &results);
+  results->SetLength(vecSize);
+  tmp_b = results->GetCKKSPackedValue();
+  checkApproximateEquality(
+      vWSum, tmp_b, vecSize, eps,
+      failmsg + " EvalLinearWSum of lazy products fails");
+
+  cWSum = cc->EvalLinearWSumMutable({cSum, cc->EvalAddMany(cProducts)},
+                                    {1.0, 0.5});
+  cc->Decrypt(kp.secretKey, cWSum, &results);
+  results->SetLength(vecSize);
+  tmp_b = results->GetCKKSPackedValue();
+  checkApproximateEquality(
+      vWSum, tmp_b, vecSize, eps,
+      failmsg + " EvalLinearWSumMutable of lazy products fails");
+
+  cc->SetLazyRelinearization(false);
+}
+
+GENERATE_TEST_CASES_FUNC_BV(UTCKKS, UnitTest_LazyRelinearization, ORDER,
+                            SCALE, NUMPRIME, RELIN, BATCH)
+GENERATE_TEST_CASES_FUNC_GHS(UTCKKS, UnitTest_LazyRelinearization, ORDER,
+                             SCALE, NUMPRIME, RELIN, BATCH)
+GENERATE_TEST_CASES_FUNC_HYBRID(UTCKKS, UnitTest_LazyRelinearization, ORDER,
+                                SCALE, NUMPRIME, RELIN, BATCH)
+
+/**
+ * Tests whether EvalSquare and the tensor product of EvalMult for CKKS work
+ * properly.
+ */
+template <class Element>
+static void UnitTest_EvalSquare(const CryptoContext<Element> cc,
+                                const string& failmsg) {
+  int vecSize = 8;
+
+  double eps = 0.0000001;
+
+  LPKeyPair<Element> kp = cc->KeyGen();
+  cc->EvalMultKeyGen(kp.secretKey);
+
+  std::vector<std::complex<double>> vA(vecSize);
+  std::vector<std::complex<double>> vB(vecSize);
+  std::vector<std::complex<double>> vSquare(vecSize);
+  std::vector<std::complex<double>> vFourth(vecSize);
+  std::vector<std::complex<double>> vProduct(vecSize);
+  for (int i = 0; i < vecSize; i++) {
+    vA[i] = 0.125 * (i % 5) - 0.25;
+    vB[i] = 0.0625 * ((2 * i + 1) % 7);
+    vSquare[i] = vA[i] * vA[i];
+    vFourth[i] = vSquare[i] * vSquare[i];
+    vProduct[i] = vA[i] * vB[i];
+  }
+
+  auto cA = cc->Encrypt(kp.publicKey, cc->MakeCKKSPackedPlaintext(vA));
+  auto cB = cc->Encrypt(kp.publicKey, cc->MakeCKKSPackedPlaintext(vB));
+
+  Plaintext results;
+  auto cSquare = cc->EvalSquare(cA);
+  cc->Decrypt(kp.secretKey, cSquare, &results);
+  results->SetLength(vecSize);
+  auto tmp_b = results->GetCKKSPackedValue();
+  checkApproximateEquality(vSquare, tmp_b, vecSize, eps,
+                           failmsg + " EvalSquare fails");
+
+  cc->Decrypt(kp.secretKey, cc->EvalSquareNoRelin(cA), &results);
+  results->SetLength(vecSize);
+  tmp_b = results->GetCKKSPackedValue();
+  checkApproximateEquality(vSquare, tmp_b, vecSize, eps,
+                           failmsg + " EvalSquareNoRelin fails");
+
+  auto cFourth = cc->EvalSquare(cc->Rescale(cSquare));
+  cc->Decrypt(kp.secretKey, cFourth, &results);
+  results->SetLength(vecSize);
+  tmp_b = results->GetCKKSPackedValue();
+  checkApproximateEquality(vFourth, tmp_b, vecSize, eps,
+                           failmsg + " EvalSquare of a square fails");
+
+  cc->Decrypt(kp.secretKey, cc->EvalMult(cA, cA), &results);
+  results->SetLength(vecSize);
+  tmp_b = results->GetCKKSPackedValue();
+  checkApproximateEquality(vSquare, tmp_b, vecSize, eps,
+                           failmsg + " EvalMult of a ciphertext by itself");
+
+  cc->Decrypt(kp.secretKey, cc->EvalMult(cA, cB), &results);
+  results->SetLength(vecSize);
+  tmp_b = results->GetCKKSPackedValue();
+  checkApproximateEquality(vProduct, tmp_b, vecSize, eps,
+                           failmsg + " Karatsuba EvalMult fails");
+}
+
+GENERATE_TEST_CASES_FUNC_BV(UTCKKS, UnitTest_EvalSquare, ORDER, SCALE,
+                            NUMPRIME, RELIN, BATCH)
+GENERATE_TEST_CASES_FUNC_GHS(UTCKKS, UnitTest_EvalSquare, ORDER, SCALE,
+                             NUMPRIME, RELIN, BATCH)
+GENERATE_TEST_CASES_FUNC_HYBRID(UTCKKS, UnitTest_EvalSquare, ORDER, SCALE,
+                                NUMPRIME, RELIN, BATCH)
+
 /**
  * Tests whether EvalMerge for CKKS works properly.
  */
@@ -498,6 +498,57 @@ static void UnitTest_EvalAtIndex(const CryptoContext<Element> cc,
 
 GENERATE_TEST_CASES_FUNC_EVALATINDEX(UTSHE, UnitTest_EvalAtIndex, 512, 65537)
 
+template <class Element>
+static void UnitTest_EvalAtIndexBatch(const CryptoContext<Element> cc,
+                                      const string& failmsg) {
+  std::vector<int64_t> vectorOfInts1 = {1, 2,  3,  4,  5,  6,  7,  8,
+                                        9, 10, 11, 12, 13, 14, 15, 16};
+
+  // Expected results after evaluating EvalAtIndex(3), EvalAtIndex(-3) and
+  // EvalAtIndex(0), and their sum
+  std::vector<std::vector<int64_t>> vectorsOfIntsRotated = {
+      {4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 0, 0, 0},
+      {0, 0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13},
+      vectorOfInts1};
+  std::vector<int64_t> vectorOfIntsSum = {5,  7,  9,  12, 15, 18, 21, 24,
+                                          27, 30, 33, 36, 39, 25, 27, 29};
+
+  Plaintext intArray1 = cc->MakePackedPlaintext(vectorOfInts1);
+
+  LPKeyPair<Element> kp = cc->KeyGen();
+
+  Ciphertext<Element> ciphertext1 = cc->Encrypt(kp.publicKey, intArray1);
+
+  cc->EvalAtIndexKeyGen(kp.secretKey, {3, -3});
+
+  auto cResults = cc->EvalAtIndexBatch(ciphertext1, {3, -3, 0});
+  ASSERT_EQ(cResults.size(), vectorsOfIntsRotated.size()) << failmsg;
+
+  Plaintext results;
+  for (size_t k = 0; k < cResults.size(); k++) {
+    cc->Decrypt(kp.secretKey, cResults[k], &results);
+    results->SetLength(vectorsOfIntsRotated[k].size());
+    EXPECT_EQ(vectorsOfIntsRotated[k], results->GetPackedValue())
+        << failmsg << " EvalAtIndexBatch fails for index " << k;
+  }
+
+  auto cSum = cc->EvalAtIndexBatchSum(ciphertext1, {3, -3, 0});
+  cc->Decrypt(kp.secretKey, cSum, &results);
+  results->SetLength(vectorOfIntsSum.size());
+  EXPECT_EQ(vectorOfIntsSum, results->GetPackedValue())
+      << failmsg << " EvalAtIndexBatchSum fails";
+
+  // a missing key is rethrown after the parallel loop instead of terminating
+  // the process; the Null scheme does not use keys
+  if (!std::dynamic_pointer_cast<LPCryptoParametersNull<Element>>(
+          cc->GetCryptoParameters()))
+    EXPECT_THROW(cc->EvalAtIndexBatch(ciphertext1, {3, 5}), config_error)
+        << failmsg << " EvalAtIndexBatch with a missing key";
+}
+
+GENERATE_TEST_CASES_FUNC_EVALATINDEX(UTSHE, UnitTest_EvalAtIndexBatch, 512,
+                                     65537)
+
 template <class Element>
 static void UnitTest_EvalMerge(const CryptoContext<Element> cc,
                                const string& failmsg) {
@@ -651,6 +702,337 @@ TEST_F(UTSHE, UnitTest_EvalSum_BFVrns_All) {
       << " BFVrns EvalSum for batch size = All failed";
 }
 
+TEST_F(UTSHE, UnitTest_EvalSum_Strategies_BFVrns) {
+  uint32_t batchSize = 1 << 12;
+
+  EncodingParams encodingParams(new EncodingParamsImpl(65537));
+  encodingParams->SetBatchSize(batchSize);
+  CryptoContext<DCRTPoly> cc =
+      CryptoContextFactory<DCRTPoly>::genCryptoContextBFVrns(
+          encodingParams, HEStd_128_classic, 3.2, 0, 2, 0, OPTIMIZED, 2, 20, 60,
+          batchSize);
+  cc->Enable(ENCRYPTION);
+  cc->Enable(SHE);
+
+  LPKeyPair<DCRTPoly> kp = cc->KeyGen();
+
+  uint32_t n = cc->GetRingDimension();
+
+  std::vector<int64_t> vectorOfInts1 = {1, 2, 3, 4, 5, 6, 7, 8};
+  uint32_t dim = vectorOfInts1.size();
+  vectorOfInts1.resize(n);
+  for (uint32_t i = n - dim; i < n; i++) vectorOfInts1[i] = i;
+
+  auto ct1 = cc->Encrypt(kp.publicKey, cc->MakePackedPlaintext(vectorOfInts1));
+
+  std::vector<int64_t> sumAll(dim, 32768);
+  std::vector<int64_t> sum8 = {36, 35, 33, 30, 26, 21, 15, 8};
+
+  auto doubling = cc->EvalSumIndices(EVALSUM_DOUBLING);
+  std::vector<EvalSumStrategy> strategies = {EVALSUM_DOUBLING, EVALSUM_RADIX4,
+                                             EVALSUM_RADIX8};
+  size_t prevKeys = 0;
+  for (auto strategy : strategies) {
+    string failmsg = " BFVrns EvalSum with radix " + std::to_string(strategy);
+
+    // a radix strategy needs more keys, which include the doubling keys
+    auto indices = cc->EvalSumIndices(strategy);
+    EXPECT_GT(indices.size(), prevKeys) << failmsg;
+    for (auto index : doubling)
+      EXPECT_NE(std::find(indices.begin(), indices.end(), index),
+                indices.end())
+          << failmsg << " misses automorphism key " << index;
+    prevKeys = indices.size();
+
+    cc->EvalSumKeyGen(kp.secretKey, nullptr, strategy);
+
+    Plaintext results;
+    cc->Decrypt(kp.secretKey, cc->EvalSum(ct1, batchSize), &results);
+    results->SetLength(dim);
+    EXPECT_EQ(sumAll, results->GetPackedValue())
+        << failmsg << " for batch size = All failed";
+
+    cc->Decrypt(kp.secretKey, cc->EvalSum(ct1, dim), &results);
+    results->SetLength(dim);
+    EXPECT_EQ(sum8, results->GetPackedValue())
+        << failmsg << " for batch size = 8 failed";
+  }
+}
+
+TEST_F(UTSHE, UnitTest_ModReduce_BFVrns) {
+  CryptoContext<DCRTPoly> cc =
+      CryptoContextFactory<DCRTPoly>::genCryptoContextBFVrns(
+          65537, HEStd_128_classic, 3.2, 0, 6, 0, OPTIMIZED, 2, 0, 40);
+  cc->Enable(ENCRYPTION);
+  cc->Enable(SHE);
+  cc->Enable(LEVELEDSHE);
+
+  LPKeyPair<DCRTPoly> kp = cc->KeyGen();
+  cc->EvalMultKeyGen(kp.secretKey);
+  cc->EvalAtIndexKeyGen(kp.secretKey, {1});
+
+  size_t towers = cc->GetElementParams()->GetParams().size();
+  ASSERT_GE(towers, 5U) << "not enough towers for the test";
+
+  std::vector<int64_t> vectorOfInts = {1, 2, 3, 4, 5, 6, 7, 8};
+  std::vector<int64_t> vectorOfIntsMult = {3, 1, 4, 1, 5, 9, 2, 6};
+  Plaintext plaintext = cc->MakePackedPlaintext(vectorOfInts);
+  Plaintext plaintextMult = cc->MakePackedPlaintext(vectorOfIntsMult);
+
+  Ciphertext<DCRTPoly> ciphertext = cc->Encrypt(kp.publicKey, plaintext);
+  Ciphertext<DCRTPoly> ciphertextMult =
+      cc->Encrypt(kp.publicKey, plaintextMult);
+
+  // the parameters support more multiplications than the circuit needs, so
+  // a tower can be dropped after each multiplication
+  std::vector<int64_t> expected = vectorOfInts;
+  Ciphertext<DCRTPoly> result = ciphertext;
+  for (size_t level = 1; level <= 2; level++) {
+    result = cc->ModReduce(cc->EvalMult(result, ciphertextMult));
+    for (size_t i = 0; i < expected.size(); i++)
+      expected[i] = expected[i] * vectorOfIntsMult[i] % 65537;
+
+    EXPECT_EQ(towers - level, result->GetElements()[0].GetNumOfElements());
+    EXPECT_EQ(level, result->GetLevel());
+
+    Plaintext results;
+    cc->Decrypt(kp.secretKey, result, &results);
+    results->SetLength(expected.size());
+    EXPECT_EQ(expected, results->GetPackedValue())
+        << "EvalMult and ModReduce fail at level " << level;
+  }
+
+  // operations between ciphertexts at different levels
+  Ciphertext<DCRTPoly> sum = cc->EvalAdd(result, ciphertext);
+  Ciphertext<DCRTPoly> product = cc->EvalMult(ciphertext, result);
+  Ciphertext<DCRTPoly> ptProduct = cc->EvalMult(result, plaintextMult);
+  Ciphertext<DCRTPoly> ptSum = cc->EvalAdd(result, plaintextMult);
+  Ciphertext<DCRTPoly> rotated = cc->EvalAtIndex(result, 1);
+
+  Plaintext results;
+  cc->Decrypt(kp.secretKey, sum, &results);
+  results->SetLength(expected.size());
+  for (size_t i = 0; i < expected.size(); i++)
+    EXPECT_EQ(expected[i] + vectorOfInts[i], results->GetPackedValue()[i])
+        << "EvalAdd across levels fails";
+
+  cc->Decrypt(kp.secretKey, product, &results);
+  results->SetLength(expected.size());
+  for (size_t i = 0; i < expected.size(); i++)
+    EXPECT_EQ(expected[i] * vectorOfInts[i] % 65537,
+              results->GetPackedValue()[i])
+        << "EvalMult across levels fails";
+
+  cc->Decrypt(kp.secretKey, ptProduct, &results);
+  results->SetLength(expected.size());
+  for (size_t i = 0; i < expected.size(); i++)
+    EXPECT_EQ(expected[i] * vectorOfIntsMult[i] % 65537,
+              results->GetPackedValue()[i])
+        << "EvalMult by a plaintext fails after ModReduce";
+
+  cc->Decrypt(kp.secretKey, ptSum, &results);
+  results->SetLength(expected.size());
+  for (size_t i = 0; i < expected.size(); i++)
+    EXPECT_EQ(expected[i] + vectorOfIntsMult[i], results->GetPackedValue()[i])
+        << "EvalAdd of a plaintext fails after ModReduce";
+
+  cc->Decrypt(kp.secretKey, rotated, &results);
+  results->SetLength(expected.size() - 1);
+  for (size_t i = 0; i < expected.size() - 1; i++)
+    EXPECT_EQ(expected[i + 1], results->GetPackedValue()[i])
+        << "EvalAtIndex fails after ModReduce";
+
+  // LevelReduce drops several towers at once
+  Ciphertext<DCRTPoly> reduced = cc->LevelReduce(ciphertext, nullptr, 2);
+  EXPECT_EQ(towers - 2, reduced->GetElements()[0].GetNumOfElements());
+  cc->Decrypt(kp.secretKey, reduced, &results);
+  results->SetLength(vectorOfInts.size());
+  EXPECT_EQ(vectorOfInts, results->GetPackedValue())
+      << "LevelReduce fails";
+}
+
+TEST_F(UTSHE, UnitTest_ModReduce_PRE_Multiparty_BFVrns) {
+  CryptoContext<DCRTPoly> cc =
+      CryptoContextFactory<DCRTPoly>::genCryptoContextBFVrns(
+          65537, HEStd_128_classic, 3.2, 0, 6, 0, OPTIMIZED, 2, 0, 40);
+  cc->Enable(ENCRYPTION);
+  cc->Enable(SHE);
+  cc->Enable(LEVELEDSHE);
+  cc->Enable(PRE);
+  cc->Enable(MULTIPARTY);
+
+  LPKeyPair<DCRTPoly> kp1 = cc->KeyGen();
+  LPKeyPair<DCRTPoly> kp2 = cc->MultipartyKeyGen(kp1.publicKey);
+
+  std::vector<int64_t> vectorOfInts = {1, 2, 3, 4, 5, 6, 7, 8};
+  Plaintext plaintext = cc->MakePackedPlaintext(vectorOfInts);
+
+  // a ciphertext with two dropped towers
+  Ciphertext<DCRTPoly> ciphertext =
+      cc->LevelReduce(cc->Encrypt(kp2.publicKey, plaintext), nullptr, 2);
+
+  // the shares of both parties are restricted to the remaining towers
+  auto partial1 = cc->MultipartyDecryptLead(kp1.secretKey, {ciphertext});
+  auto partial2 = cc->MultipartyDecryptMain(kp2.secretKey, {ciphertext});
+  Plaintext results;
+  cc->MultipartyDecryptFusion({partial1[0], partial2[0]}, &results);
+  results->SetLength(vectorOfInts.size());
+  EXPECT_EQ(vectorOfInts, results->GetPackedValue())
+      << "Multiparty decryption fails after LevelReduce";
+
+  // partial decryptions at different levels cannot be fused
+  auto partialFull = cc->MultipartyDecryptMain(
+      kp2.secretKey, {cc->Encrypt(kp2.publicKey, plaintext)});
+  EXPECT_THROW(cc->MultipartyDecryptFusion({partial1[0], partialFull[0]},
+                                           &results),
+               config_error);
+
+  // re-encryption to a third key, with and without re-randomization
+  LPKeyPair<DCRTPoly> kp3 = cc->KeyGen();
+  LPKeyPair<DCRTPoly> kpSingle = cc->KeyGen();
+  Ciphertext<DCRTPoly> single =
+      cc->LevelReduce(cc->Encrypt(kpSingle.publicKey, plaintext), nullptr, 2);
+  LPEvalKey<DCRTPoly> reKey = cc->ReKeyGen(kp3.publicKey, kpSingle.secretKey);
+
+  cc->Decrypt(kp3.secretKey, cc->ReEncrypt(reKey, single), &results);
+  results->SetLength(vectorOfInts.size());
+  EXPECT_EQ(vectorOfInts, results->GetPackedValue())
+      << "ReEncrypt fails after LevelReduce";
+
+  cc->Decrypt(kp3.secretKey,
+              cc->ReEncrypt(reKey, single, kpSingle.publicKey), &results);
+  results->SetLength(vectorOfInts.size());
+  EXPECT_EQ(vectorOfInts, results->GetPackedValue())
+      << "HRA-secure ReEncrypt fails after LevelReduce";
+}
+
+TEST_F(UTSHE, UnitTest_EvalSquare_BFVrns) {
+  std::vector<CryptoContext<DCRTPoly>> contexts = {
+      CryptoContextFactory<DCRTPoly>::genCryptoContextBFVrns(
+          65537, HEStd_128_classic, 3.2, 0, 3, 0, OPTIMIZED, 3),
+      CryptoContextFactory<DCRTPoly>::genCryptoContextBFVrnsB(
+          65537, HEStd_128_classic, 3.2, 0, 3, 0, OPTIMIZED, 3)};
+  std::vector<std::string> names = {"BFVrns", "BFVrnsB"};
+
+  std::vector<int64_t> vectorOfInts = {1, 2, 3, 4, 5, 6, 7, 8};
+  std::vector<int64_t> vectorOfIntsMult = {3, 1, 4, 1, 5, 9, 2, 6};
+  std::vector<int64_t> square(vectorOfInts.size());
+  std::vector<int64_t> product(vectorOfInts.size());
+  std::vector<int64_t> cube(vectorOfInts.size());
+  for (size_t i = 0; i < vectorOfInts.size(); i++) {
+    square[i] = vectorOfInts[i] * vectorOfInts[i];
+    product[i] = vectorOfInts[i] * vectorOfIntsMult[i];
+    cube[i] = square[i] * vectorOfIntsMult[i];
+  }
+
+  for (size_t k = 0; k < contexts.size(); k++) {
+    CryptoContext<DCRTPoly> cc = contexts[k];
+    cc->Enable(ENCRYPTION);
+    cc->Enable(SHE);
+
+    LPKeyPair<DCRTPoly> kp = cc->KeyGen();
+    cc->EvalMultKeyGen(kp.secretKey);
+
+    Ciphertext<DCRTPoly> ciphertext =
+        cc->Encrypt(kp.publicKey, cc->MakePackedPlaintext(vectorOfInts));
+    Ciphertext<DCRTPoly> ciphertextMult =
+        cc->Encrypt(kp.publicKey, cc->MakePackedPlaintext(vectorOfIntsMult));
+
+    Plaintext results;
+    cc->Decrypt(kp.secretKey, cc->EvalSquare(ciphertext), &results);
+    results->SetLength(square.size());
+    EXPECT_EQ(square, results->GetPackedValue())
+        << names[k] << " EvalSquare fails";
+
+    Ciphertext<DCRTPoly> squareNoRelin = cc->EvalSquareNoRelin(ciphertext);
+    EXPECT_EQ(3U, squareNoRelin->GetElements().size());
+    cc->Decrypt(kp.secretKey, squareNoRelin, &results);
+    results->SetLength(square.size());
+    EXPECT_EQ(square, results->GetPackedValue())
+        << names[k] << " EvalSquareNoRelin fails";
+
+    cc->Decrypt(kp.secretKey, cc->EvalMult(ciphertext, ciphertext), &results);
+    results->SetLength(square.size());
+    EXPECT_EQ(square, results->GetPackedValue())
+        << names[k] << " EvalMult of a ciphertext by itself fails";
+
+    cc->Decrypt(kp.secretKey, cc->EvalMult(ciphertext, ciphertextMult),
+                &results);
+    results->SetLength(product.size());
+    EXPECT_EQ(product, results->GetPackedValue())
+        << names[k] << " Karatsuba EvalMult fails";
+
+    // a three-element ciphertext goes through the schoolbook tensor product
+    cc->Decrypt(kp.secretKey,
+                cc->EvalMultNoRelin(squareNoRelin, ciphertextMult), &results);
+    results->SetLength(cube.size());
+    EXPECT_EQ(cube, results->GetPackedValue())
+        << names[k] << " EvalMult of a three-element ciphertext fails";
+  }
+}
+
+TEST_F(UTSHE, UnitTest_EvalAddMany_BFVrns) {
+  CryptoContext<DCRTPoly> cc =
+      CryptoContextFactory<DCRTPoly>::genCryptoContextBFVrns(
+          65537, HEStd_128_classic, 3.2, 0, 3, 0, OPTIMIZED, 2);
+  cc->Enable(ENCRYPTION);
+  cc->Enable(SHE);
+
+  LPKeyPair<DCRTPoly> kp = cc->KeyGen();
+  cc->EvalMultKeyGen(kp.secretKey);
+
+  // the chunks and the tree levels only run in parallel with several
+  // threads, which single-core machines do not provide by default
+  int threads = omp_get_max_threads();
+  omp_set_num_threads(4);
+
+  // an odd number of ciphertexts, so that the chunks and the levels of the
+  // reduction trees are uneven
+  size_t numCiphertexts = 37;
+  std::vector<int64_t> sum(8);
+  std::vector<Ciphertext<DCRTPoly>> ciphertexts;
+  for (size_t k = 0; k < numCiphertexts; k++) {
+    std::vector<int64_t> vectorOfInts(8);
+    for (size_t i = 0; i < vectorOfInts.size(); i++) {
+      vectorOfInts[i] = (3 * k + i) % 11;
+      sum[i] += vectorOfInts[i];
+    }
+    ciphertexts.push_back(
+        cc->Encrypt(kp.publicKey, cc->MakePackedPlaintext(vectorOfInts)));
+  }
+
+  Plaintext results;
+  cc->Decrypt(kp.secretKey, cc->EvalAddMany(ciphertexts), &results);
+  results->SetLength(sum.size());
+  EXPECT_EQ(sum, results->GetPackedValue()) << "EvalAddMany fails";
+
+  // null entries are skipped by EvalAddManyInPlace
+  std::vector<Ciphertext<DCRTPoly>> inPlace(ciphertexts);
+  inPlace.push_back(nullptr);
+  inPlace.insert(inPlace.begin(), nullptr);
+  cc->Decrypt(kp.secretKey, cc->EvalAddManyInPlace(inPlace), &results);
+  results->SetLength(sum.size());
+  EXPECT_EQ(sum, results->GetPackedValue()) << "EvalAddManyInPlace fails";
+
+  std::vector<int64_t> product(8, 1);
+  std::vector<Ciphertext<DCRTPoly>> factors;
+  for (size_t k = 0; k < 3; k++) {
+    std::vector<int64_t> vectorOfInts(8);
+    for (size_t i = 0; i < vectorOfInts.size(); i++) {
+      vectorOfInts[i] = (k + i) % 5 + 1;
+      product[i] *= vectorOfInts[i];
+    }
+    factors.push_back(
+        cc->Encrypt(kp.publicKey, cc->MakePackedPlaintext(vectorOfInts)));
+  }
+
+  cc->Decrypt(kp.secretKey, cc->EvalMultMany(factors), &results);
+  results->SetLength(product.size());
+  EXPECT_EQ(product, results->GetPackedValue()) << "EvalMultMany fails";
+
+  omp_set_num_threads(threads);
+}
+
 TEST_F(UTSHE, keyswitch_SingleCRT) {
   usint m = 512;
 
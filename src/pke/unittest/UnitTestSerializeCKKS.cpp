@@ -171,6 +171,42 @@ static void UnitTestContext(CryptoContext<T> cc, const string& failmsg) {
 GENERATE_TEST_CASES_FUNC(UTCKKSSer, UnitTestContext, ORDER, SCALE, NUMPRIME,
                          RELIN, BATCH)
 
+template <typename T, typename ST>
+static void UnitTestLazyRelinWithSertype(CryptoContext<T> cc,
+                                         const ST& sertype, string msg) {
+  cc->SetLazyRelinearization(true);
+
+  stringstream s;
+  Serial::Serialize(cc, s, sertype);
+  CryptoContextFactory<T>::ReleaseAllContexts();
+
+  CryptoContext<T> newcc;
+  Serial::Deserialize(newcc, s, sertype);
+  ASSERT_TRUE(newcc) << msg << " Deserialize failed";
+  EXPECT_TRUE(newcc->GetLazyRelinearization())
+      << msg << " Lazy relinearization lost after ser/deser";
+
+  newcc->SetLazyRelinearization(false);
+  s.str("");
+  s.clear();
+  Serial::Serialize(newcc, s, sertype);
+  CryptoContextFactory<T>::ReleaseAllContexts();
+
+  Serial::Deserialize(newcc, s, sertype);
+  ASSERT_TRUE(newcc) << msg << " Deserialize failed";
+  EXPECT_FALSE(newcc->GetLazyRelinearization())
+      << msg << " Lazy relinearization set after ser/deser";
+}
+
+template <typename T>
+static void UnitTestLazyRelin(CryptoContext<T> cc, const string& failmsg) {
+  UnitTestLazyRelinWithSertype(cc, SerType::JSON, "json");
+  UnitTestLazyRelinWithSertype(cc, SerType::BINARY, "binary");
+}
+
+GENERATE_TEST_CASES_FUNC(UTCKKSSer, UnitTestLazyRelin, ORDER, SCALE, NUMPRIME,
+                         RELIN, BATCH)
+
 template <typename T, typename ST>
 static void TestKeysAndCiphertexts(CryptoContext<T> cc, const ST& sertype,
                                    const string& failmsg) {